@@ -1,9 +1,12 @@
-QT       += core gui serialbus serialport openglwidgets dbus
+QT       += core gui serialbus serialport network openglwidgets dbus
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Compile out the TRACE_* instrumentation (utils/trace.h)
+#DEFINES += EL7ARESS_NO_TRACE
+
 #CONFIG += opengles2
 
 #INCLUDEPATH += "/usr/include/vpi3"
@@ -36,7 +39,7 @@ PKGCONFIG += gstreamer-video-1.0
 #LIBS += -lfreetype
 #LIBS += -L/usr/local/lib -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_videoio
 LIBS += -lgstreamer-1.0 -lgstapp-1.0 -lgstbase-1.0 -lgobject-2.0 -lglib-2.0
-LIBS += -L/usr/local/lib -lopencv_core -lopencv_imgcodecs -lopencv_highgui -lopencv_imgproc
+LIBS += -L/usr/local/lib -lopencv_core -lopencv_imgcodecs -lopencv_highgui -lopencv_imgproc -lopencv_dnn
 
 PKGCONFIG += gstreamer-gl-1.0
 
@@ -44,8 +47,14 @@ PKGCONFIG += gstreamer-gl-1.0
 SOURCES += \
     controllers/cameracontroller.cpp \
     controllers/gimbalcontroller.cpp \
+    controllers/losstabilizer.cpp \
+    controllers/leadcomputer.cpp \
+    controllers/safetyinterlock.cpp \
     controllers/joystickcontroller.cpp \
+    controllers/motion_modes/gimbalmotionmodebase.cpp \
     controllers/motion_modes/manualmotionmode.cpp \
+    controllers/motion_modes/patternmotionmode.cpp \
+    controllers/motion_modes/positionmotionmode.cpp \
     controllers/motion_modes/trackingmotionmode.cpp \
     controllers/weaponcontroller.cpp \
     core/systemcontroller.cpp \
@@ -66,19 +75,47 @@ SOURCES += \
     devices/joystickdevice.cpp \
     devices/lensdevice.cpp \
     devices/servodriverdevice.cpp \
+    devices/gimbalpollgroup.cpp \
+    devices/servoalarmservice.cpp \
     devices/gyrodevice.cpp \
     models/joystickdatamodel.cpp \
     models/systemstatemodel.cpp \
     utils/cameracontainerwidget.cpp \
     utils/dcftrackervpi.cpp \
+    utils/motionprofile.cpp \
+    utils/scantrajectory.cpp \
+    utils/ballistics.cpp \
+    utils/cameracalibration.cpp \
+    utils/edgedescriptor.cpp \
+    utils/targetfeatures.cpp \
+    utils/reacquisition.cpp \
+    utils/detectionfusion.cpp \
+    utils/inferencebackend.cpp \
+    utils/latencymonitor.cpp \
+    utils/trace.cpp \
+    utils/metricsregistry.cpp \
+    utils/modbusmetrics.cpp \
+    utils/modbuslinkmonitor.cpp \
+    utils/modbustransport.cpp \
+    utils/deepstreaminference.cpp \
+    utils/cpuinference.cpp \
+    utils/roiinference.cpp \
+    utils/pipelinebuilder.cpp \
+    utils/pipelinecatalog.cpp \
+    utils/cpuosd.cpp \
     utils/videoglwidget_gl.cpp
 
 HEADERS += \
     controllers/cameracontroller.h \
     controllers/gimbalcontroller.h \
+    controllers/losstabilizer.h \
+    controllers/leadcomputer.h \
+    controllers/safetyinterlock.h \
     controllers/joystickcontroller.h \
     controllers/motion_modes/gimbalmotionmodebase.h \
     controllers/motion_modes/manualmotionmode.h \
+    controllers/motion_modes/patternmotionmode.h \
+    controllers/motion_modes/positionmotionmode.h \
     controllers/motion_modes/trackingmotionmode.h \
     controllers/weaponcontroller.h \
     core/systemcontroller.h \
@@ -101,6 +138,8 @@ HEADERS += \
     devices/joystickdevice.h \
     devices/lensdevice.h \
     devices/servodriverdevice.h \
+    devices/gimbalpollgroup.h \
+    devices/servoalarmservice.h \
     devices/gyrodevice.h \
     models/daycameradatamodel.h \
     models/joystickdatamodel.h \
@@ -115,12 +154,59 @@ HEADERS += \
     utils/millenious.h \
     utils/dcftrackervpi.h \
     utils/targetstate.h \
+    utils/pidcontroller.h \
+    utils/stepresponse.h \
+    utils/gyrobinaryparser.h \
+    utils/spscqueue.h \
+    utils/scantrajectory.h \
+    utils/motionprofile.h \
+    utils/ballistics.h \
+    utils/cameracalibration.h \
+    utils/edgedescriptor.h \
+    utils/simd.h \
+    utils/targetfeatures.h \
+    utils/reacquisition.h \
+    utils/detectionfusion.h \
+    utils/inferencebackend.h \
+    utils/latencymonitor.h \
+    utils/trace.h \
+    utils/metricsregistry.h \
+    utils/modbusmetrics.h \
+    utils/modbuslinkmonitor.h \
+    utils/modbustransport.h \
+    utils/safetyinputs.h \
+    utils/deepstreaminference.h \
+    utils/cpuinference.h \
+    utils/roiinference.h \
+    utils/pipelinebuilder.h \
+    utils/pipelinecatalog.h \
+    utils/cpuosd.h \
     utils/videoglwidget_gl.h
 
 FORMS += \
     ui/mainwindow.ui
 
+# Hot-path benchmark suite (benchmarks/benchmarks.pro, QtTest, no CUDA/VPI/
+# DeepStream). "make benchmarks" builds it into <build dir>/benchmarks;
+# run benchmarks/el7aress_bench there (see benchmarks/main.cpp).
+benchmarks.commands = $(MKDIR) $$shell_path($$OUT_PWD/benchmarks) && \
+                      cd $$shell_path($$OUT_PWD/benchmarks) && \
+                      $$shell_quote($$QMAKE_QMAKE) $$shell_path($$PWD/benchmarks/benchmarks.pro) && \
+                      $(MAKE)
+QMAKE_EXTRA_TARGETS += benchmarks
+
+# Runtime configuration is read from <binary dir>/config: copy it next to
+# the build output and install it next to the target
+CONFIG += file_copies
+COPIES += runtime_config
+runtime_config.files = $$files($$PWD/config/*.json)
+runtime_config.path = $$OUT_PWD/config
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
+
+config.files = $$files($$PWD/config/*.json)
+config.path = $$target.path/config
+!isEmpty(target.path): INSTALLS += config
@@ -0,0 +1,268 @@
+#include "benchsupport.h"
+#include "controllers/gimbalcontroller.h"
+#include "controllers/leadcomputer.h"
+#include "controllers/motion_modes/trackingmotionmode.h"
+#include "controllers/losstabilizer.h"
+#include "utils/ballistics.h"
+#include "utils/pidcontroller.h"
+#include "utils/stepresponse.h"
+#include <QtTest>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double CONTROL_DT = GimbalController::UPDATE_PERIOD_MS / 1000.0;
+constexpr double IMU_DT = 0.01; // 100 Hz IMU
+constexpr double PI = 3.14159265358979323846;
+
+double standardDeviation(const std::vector<double> &values)
+{
+    if (values.size() < 2)
+        return 0.0;
+    double mean = 0.0;
+    for (double v : values)
+        mean += v;
+    mean /= values.size();
+    double sq = 0.0;
+    for (double v : values)
+        sq += (v - mean) * (v - mean);
+    return std::sqrt(sq / (values.size() - 1));
+}
+
+} // namespace
+
+/**
+ * @class BenchControl
+ * @brief Control-loop code: PID step, LOS stabilisation, ballistic lookups and
+ *        the lead computer, with their quality figures as metrics.
+ */
+class BenchControl : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pidCompute()
+    {
+        PidController pid({2.0, 0.3, 0.0, 1.0, 0.0}, {48.0, 2.0, 60.0, 0.0});
+        double error = 1.0, output = 0.0;
+        QBENCHMARK {
+            output = pid.compute(error, CONTROL_DT, 0.5, 0.0);
+            error = -error * 0.999;
+        }
+        QVERIFY(std::isfinite(output));
+    }
+
+    void pidStepResponse_data()
+    {
+        QTest::addColumn<double>("step");
+        QTest::addColumn<int>("delaySteps");
+        QTest::newRow("1 deg, 1 period delay") << 1.0 << 1;
+        QTest::newRow("10 deg, 1 period delay") << 10.0 << 1;
+        QTest::newRow("1 deg, 3 period delay") << 1.0 << 3;
+    }
+
+    // Position-mode gains (PositionMotionMode) closing the loop around the
+    // plant model; the timing is for a whole 10 s simulated step
+    void pidStepResponse()
+    {
+        QFETCH(double, step);
+        QFETCH(int, delaySteps);
+        constexpr int SAMPLES = 200;
+        std::vector<double> samples(SAMPLES);
+        StepResponseMetrics metrics;
+        QBENCHMARK {
+            PidController pid({2.0, 0.3, 0.0, 1.0, 0.0}, {48.0, 2.0, 96.0, 0.0});
+            AxisPlantModel plant;
+            plant.delaySteps = delaySteps;
+            plant.reset();
+            for (int i = 0; i < SAMPLES; ++i) {
+                plant.step(pid.compute(step - plant.position, CONTROL_DT), CONTROL_DT);
+                samples[i] = plant.position;
+            }
+            metrics = analyzeStepResponse(samples.data(), SAMPLES, CONTROL_DT, 0.0, step);
+        }
+        const QString prefix = QStringLiteral("pidStep.%1deg.delay%2.").arg(step).arg(delaySteps);
+        reportMetric(prefix + QStringLiteral("riseTime"), metrics.riseTime, QStringLiteral("s"));
+        reportMetric(prefix + QStringLiteral("overshoot"), metrics.overshootPercent, QStringLiteral("%"));
+        reportMetric(prefix + QStringLiteral("settlingTime"), metrics.settlingTime, QStringLiteral("s"));
+        reportMetric(prefix + QStringLiteral("steadyStateError"), metrics.steadyStateError, QStringLiteral("deg"));
+    }
+
+    void trackingStepResponse_data()
+    {
+        QTest::addColumn<double>("hfov");
+        QTest::addColumn<double>("step");
+        QTest::addColumn<double>("maxOvershoot");
+        QTest::addColumn<double>("maxSettling");
+        // Limits 15-25% above the current tuning; 5% band, 1 period delay
+        QTest::newRow("hfov 2, 1 deg") << 2.0 << 1.0 << 18.0 << 8.5;
+        QTest::newRow("hfov 2, 10 deg") << 2.0 << 10.0 << 18.0 << 8.5;
+        QTest::newRow("hfov 10, 1 deg") << 10.0 << 1.0 << 18.0 << 10.5;
+        QTest::newRow("hfov 30, 1 deg") << 30.0 << 1.0 << 15.0 << 14.5;
+        QTest::newRow("hfov 60, 1 deg") << 60.0 << 1.0 << 15.0 << 20.0;
+    }
+
+    // Tracking-mode gains (TrackingMotionMode) on the plant model. A detuned
+    // schedule fails here instead of only changing the reported figures.
+    void trackingStepResponse()
+    {
+        QFETCH(double, hfov);
+        QFETCH(double, step);
+        QFETCH(double, maxOvershoot);
+        QFETCH(double, maxSettling);
+        constexpr int SAMPLES = 500; // 25 s
+        std::vector<double> samples(SAMPLES);
+        StepResponseMetrics metrics;
+        QBENCHMARK {
+            PidController pid(TrackingMotionMode::defaultGainSchedule().gainsFor(hfov),
+                              TrackingMotionMode::defaultLimits());
+            AxisPlantModel plant;
+            plant.reset();
+            for (int i = 0; i < SAMPLES; ++i) {
+                plant.step(pid.compute(step - plant.position, CONTROL_DT), CONTROL_DT);
+                samples[i] = plant.position;
+            }
+            metrics = analyzeStepResponse(samples.data(), SAMPLES, CONTROL_DT, 0.0, step, 0.05);
+        }
+        const QString prefix = QStringLiteral("trackingStep.hfov%1.%2deg.").arg(hfov).arg(step);
+        reportMetric(prefix + QStringLiteral("riseTime"), metrics.riseTime, QStringLiteral("s"));
+        reportMetric(prefix + QStringLiteral("overshoot"), metrics.overshootPercent, QStringLiteral("%"));
+        reportMetric(prefix + QStringLiteral("settlingTime"), metrics.settlingTime, QStringLiteral("s"));
+        QVERIFY(metrics.overshootPercent <= maxOvershoot);
+        QVERIFY(metrics.settlingTime >= 0.0 && metrics.settlingTime <= maxSettling);
+    }
+
+    void losCompensation()
+    {
+        LosStabilizer stabilizer;
+        double t = 0.0;
+        for (int i = 0; i < 10; ++i, t += 0.01)
+            stabilizer.addBodyRateSample({0.5, 1.0, 2.0}, t);
+        double azRate = 0.0, elRate = 0.0;
+        bool ok = false;
+        QBENCHMARK {
+            ok = stabilizer.compensation(30.0, 10.0, t, azRate, elRate);
+        }
+        QVERIFY(ok);
+    }
+
+    // Vehicle yaw/pitch oscillation (1 Hz, 3 deg) with a 100 Hz IMU; the
+    // metric is the RMS of the line of sight in world axes
+    void losResidual()
+    {
+        const double rmsOff = simulateLos(false);
+        const double rmsOn = simulateLos(true);
+        reportMetric(QStringLiteral("los.residualRms.unstabilized"), rmsOff, QStringLiteral("deg"));
+        reportMetric(QStringLiteral("los.residualRms.stabilized"), rmsOn, QStringLiteral("deg"));
+        QVERIFY(rmsOn < rmsOff);
+    }
+
+    void ballisticBuild()
+    {
+        std::shared_ptr<const BallisticTable> table;
+        QBENCHMARK {
+            table = BallisticTable::build(AmmunitionProfile::m33Ball(), BallisticConditions(), 2000.0, 5.0);
+        }
+        QVERIFY(table);
+    }
+
+    void ballisticLookup()
+    {
+        const auto table = BallisticTable::build(AmmunitionProfile::m33Ball());
+        QVERIFY(table);
+        double range = 100.0, sink = 0.0;
+        QBENCHMARK {
+            sink += table->solve(range).timeOfFlight;
+            range = range > 1900.0 ? 100.0 : range + 7.3;
+        }
+        QVERIFY(sink > 0.0);
+    }
+
+    void leadSolve()
+    {
+        const auto table = BallisticTable::build(AmmunitionProfile::m33Ball());
+        LeadComputer lead;
+        double t = 0.0;
+        for (int i = 0; i < 30; ++i, t += 1.0 / 30.0) {
+            lead.addGimbalSample(0.0, 0.0, t);
+            lead.addObservation(0.0667 * i, 0.0, t);
+        }
+        LeadSolution solution;
+        QBENCHMARK {
+            solution = lead.solve(1000.0, table.get(), 96.0, t);
+        }
+        QVERIFY(solution.valid);
+    }
+
+    // Crossing target at 2 deg/s observed at 30 Hz with 1 px tracker noise;
+    // the metric is the frame-to-frame jitter of the lead angle
+    void leadJitter()
+    {
+        const auto table = BallisticTable::build(AmmunitionProfile::m33Ball());
+        constexpr double PX_PER_DEG = 96.0; // 960 px over a 10 deg field of view
+        constexpr double TARGET_RATE = 2.0;
+        std::mt19937 rng(41);
+        std::normal_distribution<double> pixelNoise(0.0, 1.0);
+
+        LeadComputer lead;
+        std::vector<double> leads;
+        double bias = 0.0;
+        for (int i = 0; i < 300; ++i) {
+            const double t = i / 30.0;
+            lead.addGimbalSample(0.0, 0.0, t);
+            lead.addObservation(TARGET_RATE * t + pixelNoise(rng) / PX_PER_DEG,
+                                pixelNoise(rng) / PX_PER_DEG, t);
+            const LeadSolution solution = lead.solve(1000.0, table.get(), PX_PER_DEG, t);
+            if (i >= 60 && solution.valid) { // after two seconds of settling
+                leads.push_back(solution.azDeg);
+                bias += solution.azDeg - TARGET_RATE * solution.timeOfFlight;
+            }
+        }
+        QVERIFY(!leads.empty());
+        reportMetric(QStringLiteral("lead.jitterStdDev"), standardDeviation(leads) * PX_PER_DEG, QStringLiteral("px"));
+        reportMetric(QStringLiteral("lead.meanError"), bias / leads.size() * PX_PER_DEG, QStringLiteral("px"));
+    }
+
+private:
+    static double simulateLos(bool stabilized)
+    {
+        LosStabilizer stabilizer;
+        AxisPlantModel azAxis, elAxis;
+        azAxis.reset();
+        elAxis.reset();
+        const double amplitude = 3.0, omega = 2.0 * PI * 1.0;
+        double sumSq = 0.0;
+        int samples = 0;
+        for (int step = 0; step < 500; ++step) {
+            const double t = step * CONTROL_DT;
+            // IMU samples of the last control period
+            const int imuSamples = int(std::lround(CONTROL_DT / IMU_DT));
+            for (int k = imuSamples - 1; k >= 0; --k) {
+                const double ts = t - k * IMU_DT;
+                const double rate = amplitude * omega * std::cos(omega * ts);
+                stabilizer.addBodyRateSample({0.0, rate * 0.5, rate}, ts);
+            }
+            double azRate = 0.0, elRate = 0.0;
+            if (stabilized)
+                stabilizer.compensation(azAxis.position, elAxis.position, t, azRate, elRate);
+            azAxis.step(azRate, CONTROL_DT);
+            elAxis.step(elRate, CONTROL_DT);
+
+            const double yaw = amplitude * std::sin(omega * (t + CONTROL_DT));
+            const double pitch = 0.5 * yaw;
+            if (step >= 100) {
+                const double azError = yaw + azAxis.position;
+                const double elError = pitch + elAxis.position;
+                sumSq += azError * azError + elError * elError;
+                ++samples;
+            }
+        }
+        return std::sqrt(sumSq / samples);
+    }
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchControl);
+
+#include "bench_control.moc"
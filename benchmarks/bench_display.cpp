@@ -0,0 +1,112 @@
+#include "benchsupport.h"
+#include "devices/videodisplaywidget.h"
+#include "utils/cpuosd.h"
+#include <QtTest>
+#include <random>
+
+/**
+ * @class BenchDisplay
+ * @brief Frame decoration and presentation: the CPU OSD renderer and the
+ *        VideoDisplayWidget scale-and-paint path.
+ *
+ * The DeepStream OSD builds NvDsDisplayMeta and needs the DeepStream SDK, so
+ * the CPU OSD (same content, drawn with QPainter) stands in for it.
+ */
+class BenchDisplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        m_frame = syntheticFrame(960, 720, 21);
+    }
+
+    void cpuOsd_data()
+    {
+        QTest::addColumn<int>("detections");
+        QTest::newRow("reticle only") << 0;
+        QTest::newRow("8 detections") << 8;
+        QTest::newRow("32 detections") << 32;
+    }
+
+    void cpuOsd()
+    {
+        QFETCH(int, detections);
+        CpuOsdContent content;
+        content.reticle = QPoint(480, 360);
+        content.trackedBox = QRect(440, 330, 80, 60);
+        content.statusLines << QStringLiteral("TRACK") << QStringLiteral("RNG 1250 m")
+                            << QStringLiteral("AZ 123.4  EL 5.6");
+        std::mt19937 rng(22);
+        std::uniform_int_distribution<int> x(0, 880), y(0, 660);
+        for (int i = 0; i < detections; ++i) {
+            FusionDetection d;
+            d.box = QRect(x(rng), y(rng), 60, 45);
+            d.trackId = i;
+            d.classId = i % 3;
+            d.confidence = 0.7f;
+            content.detections.push_back(d);
+        }
+
+        CpuOsd osd;
+        QImage frame = m_frame.copy();
+        QBENCHMARK {
+            osd.render(frame, content);
+        }
+        QVERIFY(frame != m_frame);
+    }
+
+    void displayScaling_data()
+    {
+        QTest::addColumn<QSize>("widgetSize");
+        QTest::newRow("640x480") << QSize(640, 480);
+        QTest::newRow("1024x768") << QSize(1024, 768);
+        QTest::newRow("1920x1080") << QSize(1920, 1080);
+    }
+
+    // What one repaint of the video widget costs: frame copy, smooth scaling
+    // to the widget and the draw, rendered off screen
+    void displayScaling()
+    {
+        QFETCH(QSize, widgetSize);
+        VideoDisplayWidget widget;
+        widget.resize(widgetSize);
+        widget.updateFrame(m_frame);
+        QImage target(widgetSize, QImage::Format_ARGB32_Premultiplied);
+        QBENCHMARK {
+            widget.render(&target);
+        }
+        QVERIFY(!target.isNull());
+    }
+
+    // The scaling step alone, smooth (as painted) vs nearest neighbour
+    void frameScale_data()
+    {
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<bool>("smooth");
+        QTest::newRow("1024x768 smooth") << QSize(1024, 768) << true;
+        QTest::newRow("1024x768 fast") << QSize(1024, 768) << false;
+        QTest::newRow("1920x1080 smooth") << QSize(1920, 1080) << true;
+        QTest::newRow("1920x1080 fast") << QSize(1920, 1080) << false;
+    }
+
+    void frameScale()
+    {
+        QFETCH(QSize, size);
+        QFETCH(bool, smooth);
+        QImage scaled;
+        QBENCHMARK {
+            scaled = m_frame.scaled(size, Qt::KeepAspectRatio,
+                                    smooth ? Qt::SmoothTransformation : Qt::FastTransformation);
+        }
+        QCOMPARE(scaled.height(), size.height());
+    }
+
+private:
+    QImage m_frame;
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchDisplay);
+
+#include "bench_display.moc"
@@ -0,0 +1,297 @@
+#include "benchsupport.h"
+#include "utils/cpuinference.h"
+#include "utils/roiinference.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtTest>
+#include <random>
+#include <vector>
+
+namespace {
+
+// YOLOv8 output for a 640x640 input: 8400 anchors, 4 box + 80 class channels,
+// with @p objects clusters of overlapping high scores
+std::vector<float> yoloOutput(int anchors, int classes, int objects, quint32 seed)
+{
+    const int channels = 4 + classes;
+    std::vector<float> data(static_cast<size_t>(channels) * anchors, 0.0f);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(40.0f, 600.0f);
+    std::uniform_real_distribution<float> low(0.0f, 0.05f);
+    std::uniform_int_distribution<int> anchor(0, anchors - 8);
+    std::uniform_int_distribution<int> cls(0, classes - 1);
+
+    for (int a = 0; a < anchors; ++a) {
+        data[0 * anchors + a] = position(rng);
+        data[1 * anchors + a] = position(rng);
+        data[2 * anchors + a] = 30.0f;
+        data[3 * anchors + a] = 30.0f;
+        for (int c = 0; c < classes; ++c)
+            data[(4 + c) * anchors + a] = low(rng);
+    }
+    for (int o = 0; o < objects; ++o) {
+        const int first = anchor(rng);
+        const int c = cls(rng);
+        const float cx = position(rng), cy = position(rng);
+        for (int k = 0; k < 8; ++k) { // neighbouring anchors fire on the same object
+            data[0 * anchors + first + k] = cx + k;
+            data[1 * anchors + first + k] = cy - k;
+            data[2 * anchors + first + k] = 60.0f;
+            data[3 * anchors + first + k] = 45.0f;
+            data[(4 + c) * anchors + first + k] = 0.9f - 0.05f * k;
+        }
+    }
+    return data;
+}
+
+struct LabelledFrame {
+    QImage image;
+    std::vector<QRect> truth; ///< Ground-truth boxes, frame pixels.
+};
+
+// EL7ARESS_BENCH_DATASET: images with YOLO-format labels next to them
+// (<name>.txt, one "class cx cy w h" line per object, normalised). Without it
+// the synthetic frame and its painted target are the only sample.
+std::vector<LabelledFrame> loadDataset(const QImage &fallback, const QRect &fallbackTruth)
+{
+    std::vector<LabelledFrame> frames;
+    const QByteArray dir = qgetenv("EL7ARESS_BENCH_DATASET");
+    if (dir.isEmpty()) {
+        frames.push_back({fallback, {fallbackTruth}});
+        return frames;
+    }
+
+    const QFileInfoList images = QDir(QString::fromLocal8Bit(dir))
+            .entryInfoList({"*.jpg", "*.jpeg", "*.png"}, QDir::Files, QDir::Name);
+    for (const QFileInfo &info : images) {
+        QFile labels(info.path() + "/" + info.completeBaseName() + ".txt");
+        if (!labels.open(QIODevice::ReadOnly | QIODevice::Text))
+            continue;
+        LabelledFrame frame;
+        frame.image = QImage(info.filePath()).convertToFormat(QImage::Format_RGBA8888);
+        if (frame.image.isNull())
+            continue;
+        QTextStream in(&labels);
+        while (!in.atEnd()) {
+            const QStringList f = in.readLine().split(' ', Qt::SkipEmptyParts);
+            if (f.size() < 5)
+                continue;
+            const double w = f[3].toDouble() * frame.image.width();
+            const double h = f[4].toDouble() * frame.image.height();
+            frame.truth.push_back(QRectF(f[1].toDouble() * frame.image.width() - w / 2,
+                                         f[2].toDouble() * frame.image.height() - h / 2, w, h).toRect());
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+double iou(const QRect &a, const QRect &b)
+{
+    const QRect overlap = a.intersected(b);
+    if (overlap.isEmpty())
+        return 0.0;
+    const double inter = double(overlap.width()) * overlap.height();
+    return inter / (double(a.width()) * a.height() + double(b.width()) * b.height() - inter);
+}
+
+bool detected(const QRect &truth, const std::vector<FusionDetection> &detections)
+{
+    for (const FusionDetection &d : detections) {
+        if (iou(truth, d.box) >= 0.5)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @class BenchInference
+ * @brief CPU detector stages: letterbox, YOLO decode, NMS, ROI planning and,
+ *        when a model is given, the whole OpenCV DNN detect().
+ *
+ * Set EL7ARESS_BENCH_MODEL to an ONNX model to compare full-frame against
+ * windowed inference (ms per frame and recall); without it those rows are
+ * skipped. EL7ARESS_BENCH_DATASET adds labelled images for the recall.
+ */
+class BenchInference : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        m_frame = syntheticFrame(960, 720, 31);
+        paintTarget(m_frame, TARGET, 32);
+    }
+
+    void letterbox_data()
+    {
+        QTest::addColumn<QRect>("region");
+        QTest::addColumn<int>("size");
+        QTest::newRow("full frame -> 640") << QRect(0, 0, 960, 720) << 640;
+        QTest::newRow("full frame -> 320") << QRect(0, 0, 960, 720) << 320;
+        QTest::newRow("320 window -> 320") << QRect(320, 200, 320, 320) << 320;
+    }
+
+    void letterbox()
+    {
+        QFETCH(QRect, region);
+        QFETCH(int, size);
+        Letterbox letterbox;
+        std::vector<float> planes(3 * size * size);
+        LetterboxTransform transform;
+        bool ok = false;
+        const RgbaImageView view = imageView(m_frame);
+        QBENCHMARK {
+            ok = letterbox.run(view, region, size, size, planes.data(), transform);
+        }
+        QVERIFY(ok);
+    }
+
+    void yoloDecode_data()
+    {
+        QTest::addColumn<int>("anchors");
+        QTest::newRow("640 input (8400 anchors)") << 8400;
+        QTest::newRow("320 input (2100 anchors)") << 2100;
+    }
+
+    void yoloDecode()
+    {
+        QFETCH(int, anchors);
+        constexpr int CLASSES = 80;
+        const std::vector<float> output = yoloOutput(anchors, CLASSES, 16, 33);
+        YoloDecoder decoder;
+        std::vector<DetectionCandidate> candidates;
+        QBENCHMARK {
+            decoder.decode(output.data(), anchors, 4 + CLASSES, YoloDecoder::Layout::ChannelsFirst,
+                           0.25f, candidates);
+        }
+        QVERIFY(!candidates.empty());
+    }
+
+    void nms_data()
+    {
+        QTest::addColumn<int>("objects");
+        QTest::addColumn<bool>("classAgnostic");
+        QTest::newRow("16 objects per class") << 16 << false;
+        QTest::newRow("16 objects agnostic") << 16 << true;
+        QTest::newRow("128 objects per class") << 128 << false;
+    }
+
+    void nms()
+    {
+        QFETCH(int, objects);
+        QFETCH(bool, classAgnostic);
+        constexpr int ANCHORS = 8400, CLASSES = 80;
+        const std::vector<float> output = yoloOutput(ANCHORS, CLASSES, objects, 34);
+        YoloDecoder decoder;
+        std::vector<DetectionCandidate> candidates;
+        decoder.decode(output.data(), ANCHORS, 4 + CLASSES, YoloDecoder::Layout::ChannelsFirst, 0.25f, candidates);
+
+        DetectionNms nms;
+        std::vector<int> keep;
+        QBENCHMARK {
+            nms.run(candidates, 0.45f, classAgnostic, 64, keep);
+        }
+        QVERIFY(!keep.empty());
+        QVERIFY(keep.size() < candidates.size());
+    }
+
+    void roiPlanner()
+    {
+        RoiInferencePlanner planner;
+        planner.setEnabled(true);
+        planner.setFullFrameInterval(10);
+        const QSize frame(960, 720);
+        QPoint reticle(480, 360);
+        InferenceRegion region;
+        QBENCHMARK {
+            reticle.rx() = (reticle.x() + 7) % 960;
+            region = planner.next(frame, reticle, QRect(reticle - QPoint(40, 30), QSize(80, 60)));
+        }
+        QVERIFY(region.region.isValid());
+    }
+
+    void modelDetect_data()
+    {
+        QTest::addColumn<int>("windowSize");
+        QTest::newRow("full frame") << 0;
+        QTest::newRow("160 window") << 160;
+        QTest::newRow("256 window") << 256;
+        QTest::newRow("320 window") << 320;
+        QTest::newRow("480 window") << 480;
+    }
+
+    // Detector ms/frame and recall (IoU >= 0.5) per ROI size. Windowed rows
+    // run one inference per ground-truth box, on the window the tracker
+    // would use around it (RoiInferencePlanner::window).
+    void modelDetect()
+    {
+        QFETCH(int, windowSize);
+        const QByteArray model = qgetenv("EL7ARESS_BENCH_MODEL");
+        if (model.isEmpty())
+            QSKIP("EL7ARESS_BENCH_MODEL is not set");
+
+        InferenceConfig config;
+        config.modelPath = model.toStdString();
+        config.roiInputWidth = 320;
+        config.roiInputHeight = 320;
+        OpenCvDnnBackend backend;
+        QVERIFY(backend.load(config));
+
+        const std::vector<LabelledFrame> frames = loadDataset(m_frame, TARGET);
+        QVERIFY(!frames.empty());
+        const bool windowed = windowSize > 0;
+        RoiInferencePlanner planner;
+        planner.setWindowSize(QSize(windowSize, windowSize));
+
+        // Timing on the first sample
+        const LabelledFrame &first = frames.front();
+        const RgbaImageView firstView = imageView(first.image);
+        const QRect firstWindow = planner.window(first.image.size(), first.image.rect().center(),
+                                                 first.truth.empty() ? QRect() : first.truth.front());
+        std::vector<FusionDetection> detections;
+        QBENCHMARK {
+            QVERIFY(backend.detect(&firstView, windowed ? &firstWindow : nullptr, 1, &detections));
+        }
+
+        // Recall over the whole set
+        backend.resetStats();
+        int truths = 0;
+        int hits = 0;
+        for (const LabelledFrame &frame : frames) {
+            const RgbaImageView view = imageView(frame.image);
+            if (!windowed) {
+                QVERIFY(backend.detect(&view, nullptr, 1, &detections));
+                for (const QRect &truth : frame.truth)
+                    hits += detected(truth, detections) ? 1 : 0;
+                truths += static_cast<int>(frame.truth.size());
+                continue;
+            }
+            for (const QRect &truth : frame.truth) {
+                const QRect window = planner.window(frame.image.size(), frame.image.rect().center(), truth);
+                QVERIFY(backend.detect(&view, &window, 1, &detections));
+                hits += detected(truth, detections) ? 1 : 0;
+                ++truths;
+            }
+        }
+
+        const QString row = windowed ? QStringLiteral("modelDetect.window%1").arg(windowSize)
+                                     : QStringLiteral("modelDetect.fullFrame");
+        reportMetric(row + ".meanMs", backend.stats().meanMs(), QStringLiteral("ms"));
+        reportMetric(row + ".recall", truths > 0 ? double(hits) / truths : 0.0, QStringLiteral("ratio"));
+        reportMetric(row + ".groundTruth", truths, QStringLiteral("boxes"));
+    }
+
+private:
+    static constexpr QRect TARGET = QRect(440, 330, 80, 60);
+    QImage m_frame;
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchInference);
+
+#include "bench_inference.moc"
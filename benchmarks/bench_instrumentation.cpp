@@ -0,0 +1,146 @@
+#include "benchsupport.h"
+#include "utils/latencymonitor.h"
+#include "utils/trace.h"
+#include <QElapsedTimer>
+#include <QtTest>
+
+namespace {
+
+// Instrumentation points one frame passes through (capture, processing,
+// tracker, detector, OSD, display, control), see utils/trace.h users
+constexpr int SCOPES_PER_FRAME = 15;
+constexpr double FRAME_BUDGET_NS = 33.3e6;
+
+// Keeps the traced body from being optimised away
+volatile int s_sink = 0;
+
+void tracedWork()
+{
+    TRACE_SCOPE("bench", "scope");
+    s_sink = s_sink + 1;
+}
+
+} // namespace
+
+/**
+ * @class BenchInstrumentation
+ * @brief Cost of the always-on instrumentation: latency histograms and the
+ *        TRACE_* scopes, with the per-frame overhead as a metric.
+ */
+class BenchInstrumentation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase()
+    {
+        Tracer::instance().setEnabled(true);
+    }
+
+    void histogramRecord()
+    {
+        LatencyHistogram histogram;
+        qint64 value = 1;
+        QBENCHMARK {
+            histogram.record(value);
+            value = (value * 13 + 7) % 200000;
+        }
+        QVERIFY(histogram.count() > 0);
+    }
+
+    void histogramPercentile()
+    {
+        LatencyHistogram histogram;
+        for (qint64 us = 1; us < 100000; us += 17)
+            histogram.record(us);
+        qint64 p99 = 0;
+        QBENCHMARK {
+            p99 = histogram.percentile(99.0);
+        }
+        QVERIFY(p99 > 90000);
+    }
+
+    void latencyFrameRecord()
+    {
+        LatencyMonitor &monitor = LatencyMonitor::instance();
+        const int source = monitor.registerSource(QStringLiteral("bench"));
+        QBENCHMARK {
+            const qint64 now = LatencyMonitor::nowUs();
+            const quint64 id = monitor.beginFrame(source, now - 20000, now - 5000);
+            monitor.markProcessed(id, true);
+            monitor.markPublished(id);
+            monitor.markPresented(id);
+        }
+    }
+
+    // Tracked frame -> control loop -> servo command: one GlassToServo sample
+    // per tracked frame, however many loop ticks reuse it
+    void glassToServo()
+    {
+        LatencyMonitor &monitor = LatencyMonitor::instance();
+        const int source = monitor.registerSource(QStringLiteral("bench"));
+        const LatencyHistogram &histogram = monitor.histogram(source, LatencyStage::GlassToServo);
+        const quint64 before = histogram.count();
+        constexpr int FRAMES = 100;
+        QBENCHMARK_ONCE {
+            for (int i = 0; i < FRAMES; ++i) {
+                const qint64 now = LatencyMonitor::nowUs();
+                const quint64 id = monitor.beginFrame(source, now - 20000, now - 5000);
+                monitor.markProcessed(id, true);
+                monitor.markServoCommand();
+                monitor.markServoCommand();
+            }
+        }
+        QCOMPARE(histogram.count() - before, quint64(FRAMES));
+        QVERIFY(histogram.percentile(50.0) >= 20000);
+    }
+
+    void traceScope_data()
+    {
+        QTest::addColumn<bool>("enabled");
+        QTest::newRow("enabled") << true;
+        QTest::newRow("disabled at runtime") << false;
+    }
+
+    void traceScope()
+    {
+        QFETCH(bool, enabled);
+        Tracer::instance().setEnabled(enabled);
+        QBENCHMARK {
+            tracedWork();
+        }
+        Tracer::instance().setEnabled(true);
+    }
+
+    // Target: under 1% of a 30 fps frame for all scopes a frame goes through
+    void traceOverhead()
+    {
+        constexpr int ITERATIONS = 1000000;
+        Tracer::instance().setEnabled(true);
+        for (int i = 0; i < ITERATIONS / 10; ++i) // warm the ring and caches
+            tracedWork();
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ITERATIONS; ++i)
+            tracedWork();
+        const double tracedNs = double(timer.nsecsElapsed()) / ITERATIONS;
+
+        Tracer::instance().setEnabled(false);
+        timer.restart();
+        for (int i = 0; i < ITERATIONS; ++i)
+            tracedWork();
+        const double disabledNs = double(timer.nsecsElapsed()) / ITERATIONS;
+        Tracer::instance().setEnabled(true);
+
+        const double overhead = tracedNs * SCOPES_PER_FRAME / FRAME_BUDGET_NS * 100.0;
+        reportMetric(QStringLiteral("trace.scopeNs"), tracedNs, QStringLiteral("ns"));
+        reportMetric(QStringLiteral("trace.disabledScopeNs"), disabledNs, QStringLiteral("ns"));
+        reportMetric(QStringLiteral("trace.frameOverhead"), overhead, QStringLiteral("%"));
+        QVERIFY(overhead < 1.0);
+    }
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchInstrumentation);
+
+#include "bench_instrumentation.moc"
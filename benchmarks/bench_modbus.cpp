@@ -0,0 +1,288 @@
+#include "benchsupport.h"
+#include "controllers/safetyinterlock.h"
+#include "devices/plc42device.h"
+#include "devices/servodriverdevice.h"
+#include "utils/latencymonitor.h"
+#include "utils/modbustransport.h"
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHash>
+#include <QModbusTcpServer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest>
+#include <memory>
+
+namespace {
+
+constexpr int SERVER_ID = 1;
+constexpr int STATUS_START = 196; // ServoDriverDevice status block
+constexpr int STATUS_COUNT = 50;
+constexpr int PIPELINE_DEPTH = 64;
+constexpr int ESTOP_ROUNDS = 50;
+constexpr int SERVO_COMMAND_REGISTER = 0x007D;
+constexpr quint16 SERVO_STOP = 0x0020;
+
+quint16 freePort()
+{
+    QTcpServer probe;
+    probe.listen(QHostAddress::LocalHost, 0);
+    return probe.serverPort();
+}
+
+// Modbus TCP server on a free local port holding @p map
+bool startServer(QModbusTcpServer &server, const QModbusDataUnitMap &map, quint16 &port)
+{
+    port = freePort();
+    server.setConnectionParameter(QModbusDevice::NetworkAddressParameter, QStringLiteral("127.0.0.1"));
+    server.setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+    server.setServerAddress(SERVER_ID);
+    server.setMap(map);
+    return server.connectDevice();
+}
+
+QString tcpEndpoint(quint16 port)
+{
+    return QStringLiteral("tcp://127.0.0.1:%1").arg(port);
+}
+
+// RTU-over-TCP gateway stand-in: answers read-holding-register frames with
+// register i = i
+class RtuOverTcpServer
+{
+public:
+    bool listen()
+    {
+        QObject::connect(&m_server, &QTcpServer::newConnection, &m_server, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection())
+                QObject::connect(socket, &QTcpSocket::readyRead, &m_server, [this, socket]() { serve(socket); });
+        });
+        return m_server.listen(QHostAddress::LocalHost, 0);
+    }
+    quint16 port() const { return m_server.serverPort(); }
+
+private:
+    void serve(QTcpSocket *socket)
+    {
+        // Request: address, 0x03, start (2), count (2), CRC (2)
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        while (buffer.size() >= 8) {
+            const QByteArray request = buffer.left(8);
+            buffer.remove(0, 8);
+            const int count = (static_cast<quint8>(request.at(4)) << 8) | static_cast<quint8>(request.at(5));
+            QByteArray response;
+            response.append(request.at(0)).append(request.at(1)).append(char(count * 2));
+            for (int i = 0; i < count; ++i)
+                response.append(char(i >> 8)).append(char(i & 0xFF));
+            const quint16 crc = RtuOverTcpTransport::crc16(response);
+            response.append(char(crc & 0xFF)).append(char(crc >> 8));
+            socket->write(response);
+        }
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+};
+
+// Waits until all @p replies finished; true if every one succeeded
+bool waitForReplies(const QList<QModbusReply *> &replies)
+{
+    int pending = 0;
+    QEventLoop loop;
+    for (QModbusReply *reply : replies) {
+        if (!reply->isFinished()) {
+            ++pending;
+            QObject::connect(reply, &QModbusReply::finished, &loop, [&pending, &loop]() {
+                if (--pending == 0)
+                    loop.quit();
+            });
+        }
+    }
+    if (pending > 0)
+        loop.exec();
+
+    bool ok = true;
+    for (QModbusReply *reply : replies) {
+        ok = ok && reply->error() == QModbusDevice::NoError && reply->result().valueCount() == STATUS_COUNT;
+        delete reply;
+    }
+    return ok;
+}
+
+bool sendBatch(ModbusTransport *transport, int depth)
+{
+    const QModbusDataUnit status(QModbusDataUnit::HoldingRegisters, STATUS_START, STATUS_COUNT);
+    QList<QModbusReply *> replies;
+    for (int i = 0; i < depth; ++i) {
+        QModbusReply *reply = transport->sendReadRequest(status, SERVER_ID);
+        if (!reply)
+            return false;
+        replies << reply;
+    }
+    return waitForReplies(replies);
+}
+
+} // namespace
+
+/**
+ * @class BenchModbus
+ * @brief Modbus transports against local servers: a servo status read
+ *        (50 holding registers) one at a time and PIPELINE_DEPTH queued.
+ *        Without a serial line in the way this shows the cost of the
+ *        client stack itself. Also the E-stop path on simulated slaves.
+ */
+class BenchModbus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        QModbusDataUnitMap map;
+        map.insert(QModbusDataUnit::HoldingRegisters, {QModbusDataUnit::HoldingRegisters, 0, 512});
+        QVERIFY(startServer(m_tcpServer, map, m_tcpPort));
+        QVERIFY(m_rtuServer.listen());
+    }
+
+    void rtuCrc()
+    {
+        const QByteArray frame = QByteArrayLiteral("\x01\x03\x00\xC4\x00\x32");
+        quint16 crc = 0;
+        QBENCHMARK {
+            crc ^= RtuOverTcpTransport::crc16(frame);
+        }
+        // CRC-16/MODBUS check value
+        QCOMPARE(RtuOverTcpTransport::crc16(QByteArrayLiteral("123456789")), quint16(0x4B37));
+        Q_UNUSED(crc);
+    }
+
+    void readStatus_data() { addEndpointRows(); }
+    void readStatus()
+    {
+        QFETCH(QString, endpoint);
+        std::unique_ptr<ModbusTransport> transport(connectTo(endpoint));
+        QVERIFY(transport);
+        QBENCHMARK {
+            QVERIFY(sendBatch(transport.get(), 1));
+        }
+    }
+
+    void readStatusPipelined_data() { addEndpointRows(); }
+    void readStatusPipelined()
+    {
+        QFETCH(QString, endpoint);
+        std::unique_ptr<ModbusTransport> transport(connectTo(endpoint));
+        QVERIFY(transport);
+        QBENCHMARK {
+            QVERIFY(sendBatch(transport.get(), PIPELINE_DEPTH));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(sendBatch(transport.get(), PIPELINE_DEPTH));
+        const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+        reportMetric(QStringLiteral("modbus.%1.requestsPerSecond").arg(QTest::currentDataTag()),
+                     PIPELINE_DEPTH * 1e9 / elapsedNs, QStringLiteral("1/s"));
+    }
+
+    // E-stop input to STOP at both drives, on simulated hardware: PLC42 and
+    // the drives are local Modbus TCP servers, devices and interlock are the
+    // production classes. Includes the phase of the 20 ms safety poll.
+    void emergencyStopLatency()
+    {
+        QModbusDataUnitMap plcMap;
+        plcMap.insert(QModbusDataUnit::DiscreteInputs, {QModbusDataUnit::DiscreteInputs, 0, 16});
+        plcMap.insert(QModbusDataUnit::HoldingRegisters, {QModbusDataUnit::HoldingRegisters, 0, 32});
+        QModbusDataUnitMap servoMap;
+        servoMap.insert(QModbusDataUnit::HoldingRegisters, {QModbusDataUnit::HoldingRegisters, 0, 0x0500});
+
+        QModbusTcpServer plcServer, azServer, elServer;
+        quint16 plcPort = 0, azPort = 0, elPort = 0;
+        QVERIFY(startServer(plcServer, plcMap, plcPort));
+        QVERIFY(startServer(azServer, servoMap, azPort));
+        QVERIFY(startServer(elServer, servoMap, elPort));
+
+        Plc42Device plc42(tcpEndpoint(plcPort), 0, SERVER_ID);
+        ServoDriverDevice azServo(QStringLiteral("bench_az"), tcpEndpoint(azPort), 0, SERVER_ID);
+        ServoDriverDevice elServo(QStringLiteral("bench_el"), tcpEndpoint(elPort), 0, SERVER_ID);
+        SafetyInterlock interlock(&plc42, &azServo, &elServo);
+
+        bool azConnected = false, elConnected = false;
+        QObject::connect(&azServo, &ServoDriverDevice::servoDataChanged, &azServo,
+                         [&azConnected](const ServoData &data) { azConnected = data.isConnected; });
+        QObject::connect(&elServo, &ServoDriverDevice::servoDataChanged, &elServo,
+                         [&elConnected](const ServoData &data) { elConnected = data.isConnected; });
+
+        // Both drives have seen STOP: the moment the second one is written
+        int stops = 0;
+        qint64 stoppedUs = 0;
+        for (QModbusTcpServer *server : {&azServer, &elServer}) {
+            QObject::connect(server, &QModbusServer::dataWritten, server,
+                             [server, &stops, &stoppedUs](QModbusDataUnit::RegisterType table, int address, int size) {
+                quint16 value = 0;
+                if (table == QModbusDataUnit::HoldingRegisters && address <= SERVO_COMMAND_REGISTER &&
+                    SERVO_COMMAND_REGISTER < address + size &&
+                    server->data(QModbusDataUnit::HoldingRegisters, SERVO_COMMAND_REGISTER, &value) &&
+                    value == SERVO_STOP && ++stops == 2)
+                    stoppedUs = LatencyMonitor::nowUs();
+            });
+        }
+
+        QVERIFY(plc42.connectDevice());
+        QVERIFY(azServo.connectDevice());
+        QVERIFY(elServo.connectDevice());
+        QVERIFY(QTest::qWaitFor([&azConnected, &elConnected]() { return azConnected && elConnected; }, 2000));
+        QTest::qWait(100); // first safety polls
+
+        LatencyHistogram latency;
+        for (int round = 0; round < ESTOP_ROUNDS; ++round) {
+            // Spread the press over the safety poll period
+            QTest::qWait(5 + (round * 7) % 20);
+
+            stops = 0;
+            const qint64 pressedUs = LatencyMonitor::nowUs();
+            QVERIFY(plcServer.setData(QModbusDataUnit::DiscreteInputs, int(SafetyInput::EmergencyStop), 1));
+            QVERIFY(QTest::qWaitFor([&stops]() { return stops >= 2; }, 1000));
+            latency.record(stoppedUs - pressedUs);
+
+            QVERIFY(plcServer.setData(QModbusDataUnit::DiscreteInputs, int(SafetyInput::EmergencyStop), 0));
+            QVERIFY(QTest::qWaitFor([&interlock]() { return !interlock.emergencyStopActive(); }, 1000));
+        }
+
+        reportMetric(QStringLiteral("estop.stopLatency.p50"), latency.percentile(50.0) / 1000.0, QStringLiteral("ms"));
+        reportMetric(QStringLiteral("estop.stopLatency.p99"), latency.percentile(99.0) / 1000.0, QStringLiteral("ms"));
+        reportMetric(QStringLiteral("estop.stopLatency.max"), latency.max() / 1000.0, QStringLiteral("ms"));
+    }
+
+private:
+    void addEndpointRows()
+    {
+        QTest::addColumn<QString>("endpoint");
+        QTest::newRow("tcp") << tcpEndpoint(m_tcpPort);
+        QTest::newRow("rtu+tcp") << QStringLiteral("rtu+tcp://127.0.0.1:%1").arg(m_rtuServer.port());
+    }
+
+    ModbusTransport *connectTo(const QString &endpoint)
+    {
+        ModbusTransport *transport =
+            ModbusTransport::create(ModbusEndpoint::parse(endpoint, 0, QSerialPort::NoParity));
+        transport->setTimeout(500);
+        transport->setNumberOfRetries(0);
+        if (!transport->connectDevice()
+            || !QTest::qWaitFor([transport]() { return transport->state() == QModbusDevice::ConnectedState; },
+                                2000)) {
+            delete transport;
+            return nullptr;
+        }
+        return transport;
+    }
+
+    QModbusTcpServer m_tcpServer;
+    quint16 m_tcpPort = 0;
+    RtuOverTcpServer m_rtuServer;
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchModbus);
+
+#include "bench_modbus.moc"
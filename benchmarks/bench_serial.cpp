@@ -0,0 +1,237 @@
+#include "benchsupport.h"
+#include "devices/daycameracontroldevice.h"
+#include "devices/gyrodevice.h"
+#include "devices/lrfdevice.h"
+#include "devices/nightcameracontroldevice.h"
+#include "utils/gyrobinaryparser.h"
+#include <QtTest>
+#include <cstring>
+
+namespace {
+
+constexpr int FRAMES_PER_CHUNK = 64;
+
+// LRF ranging response: EB 90 len | 03 03 status dist(2) decimals pad(5) | sum
+QByteArray lrfStream(int frames)
+{
+    QByteArray stream;
+    for (int i = 0; i < frames; ++i) {
+        QByteArray packet;
+        const quint16 distance = static_cast<quint16>(500 + i);
+        packet.append(char(0xEB)).append(char(0x90)).append(char(0x0B));
+        packet.append(char(0x03)).append(char(0x03)).append(char(0x00));
+        packet.append(char(distance >> 8)).append(char(distance & 0xFF)).append(char(0x01));
+        packet.append(QByteArray(5, '\0'));
+        quint8 sum = 0;
+        for (char c : packet)
+            sum += static_cast<quint8>(c);
+        packet.append(char(sum));
+        stream += packet;
+    }
+    return stream;
+}
+
+// Pelco-D zoom position replies (RESP2 0xA7), a new position every frame
+QByteArray pelcoDStream(int frames)
+{
+    QByteArray stream;
+    for (int i = 0; i < frames; ++i) {
+        const quint16 zoom = static_cast<quint16>(0x1000 + 37 * i);
+        const quint8 addr = 0x01, resp1 = 0x00, resp2 = 0xA7;
+        const quint8 d1 = static_cast<quint8>(zoom >> 8);
+        const quint8 d2 = static_cast<quint8>(zoom & 0xFF);
+        stream.append(char(0xFF)).append(char(addr)).append(char(resp1)).append(char(resp2));
+        stream.append(char(d1)).append(char(d2)).append(char((addr + resp1 + resp2 + d1 + d2) & 0xFF));
+    }
+    return stream;
+}
+
+// Tau2 video mode replies (function 0x0F, two data bytes), both CRCs valid
+QByteArray tau2Stream(int frames)
+{
+    QByteArray stream;
+    for (int i = 0; i < frames; ++i) {
+        QByteArray packet;
+        packet.append(char(0x6E)).append(char(0x00)).append(char(0x00)).append(char(0x0F));
+        packet.append(char(0x00)).append(char(0x02));
+        const quint16 crc1 = NightCameraControlDevice::calculateCRC(packet, 6);
+        packet.append(char(crc1 >> 8)).append(char(crc1 & 0xFF));
+        packet.append(char(0x00)).append(char(i & 0x03));
+        const quint16 crc2 = NightCameraControlDevice::calculateCRC(packet, packet.size());
+        packet.append(char(crc2 >> 8)).append(char(crc2 & 0xFF));
+        stream += packet;
+    }
+    return stream;
+}
+
+QByteArray gyroBinaryStream(int frames)
+{
+    QByteArray stream;
+    for (int i = 0; i < frames; ++i) {
+        quint8 frame[GyroBinaryParser::FRAME_SIZE] = {GyroBinaryParser::SYNC1, GyroBinaryParser::SYNC2,
+                                                     static_cast<quint8>(GyroBinaryParser::PAYLOAD_SIZE)};
+        const qint32 values[6] = {1234 + i, -560, 123400 + 10 * i, 15, -3, 250};
+        std::memcpy(frame + 3, values, sizeof(values)); // little-endian host
+        quint8 sum = 0;
+        for (std::size_t b = 0; b < GyroBinaryParser::PAYLOAD_SIZE; ++b)
+            sum = static_cast<quint8>(sum + frame[3 + b]);
+        frame[3 + GyroBinaryParser::PAYLOAD_SIZE] = sum;
+        stream.append(reinterpret_cast<const char *>(frame), sizeof(frame));
+    }
+    return stream;
+}
+
+QByteArray gyroTextStream(int frames)
+{
+    QByteArray stream;
+    for (int i = 0; i < frames; ++i)
+        stream += QStringLiteral("R:%1,P:-0.560,Y:%2\n").arg(1.234 + i * 0.001, 0, 'f', 3)
+                      .arg(123.4 + i * 0.01, 0, 'f', 3).toLatin1();
+    return stream;
+}
+
+// Replays @p stream in chunks of @p chunk bytes, as successive port reads
+template <typename Feed>
+void feedChunks(const QByteArray &stream, int chunk, Feed &&feed)
+{
+    if (chunk <= 0) {
+        feed(stream);
+        return;
+    }
+    for (int offset = 0; offset < stream.size(); offset += chunk)
+        feed(stream.mid(offset, chunk));
+}
+
+void addChunkRows()
+{
+    QTest::addColumn<int>("chunk");
+    QTest::newRow("whole reads") << 0;
+    QTest::newRow("5-byte reads") << 5;
+}
+
+} // namespace
+
+/**
+ * @class BenchSerial
+ * @brief Serial framers and checksums, fed from synthetic byte streams of
+ *        FRAMES_PER_CHUNK valid frames (timings are per stream).
+ */
+class BenchSerial : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lrfFramer_data() { addChunkRows(); }
+    void lrfFramer()
+    {
+        QFETCH(int, chunk);
+        LRFDevice device;
+        int updates = 0;
+        connect(&device, &LRFDevice::lrfDataChanged, this, [&updates](const LrfData &) { ++updates; });
+        const QByteArray stream = lrfStream(FRAMES_PER_CHUNK);
+        QBENCHMARK {
+            feedChunks(stream, chunk, [&device](const QByteArray &bytes) { device.processData(bytes); });
+        }
+        QVERIFY(updates > 0);
+    }
+
+    void pelcoDFramer_data() { addChunkRows(); }
+    void pelcoDFramer()
+    {
+        QFETCH(int, chunk);
+        DayCameraControlDevice device;
+        int updates = 0;
+        connect(&device, &DayCameraControlDevice::dayCameraDataChanged, this,
+                [&updates](const DayCameraData &) { ++updates; });
+        const QByteArray stream = pelcoDStream(FRAMES_PER_CHUNK);
+        QBENCHMARK {
+            feedChunks(stream, chunk, [&device](const QByteArray &bytes) { device.processData(bytes); });
+        }
+        QVERIFY(updates > 0);
+    }
+
+    void tau2Framer_data() { addChunkRows(); }
+    void tau2Framer()
+    {
+        QFETCH(int, chunk);
+        NightCameraControlDevice device;
+        int responses = 0;
+        connect(&device, &NightCameraControlDevice::responseReceived, this,
+                [&responses](const QByteArray &) { ++responses; });
+        const QByteArray stream = tau2Stream(FRAMES_PER_CHUNK);
+        QBENCHMARK {
+            feedChunks(stream, chunk, [&device](const QByteArray &bytes) { device.processData(bytes); });
+        }
+        QVERIFY(responses > 0);
+    }
+
+    void tau2Crc_data()
+    {
+        QTest::addColumn<int>("bytes");
+        QTest::newRow("header (6 B)") << 6;
+        QTest::newRow("64 B") << 64;
+        QTest::newRow("1 KiB") << 1024;
+    }
+
+    void tau2Crc()
+    {
+        QFETCH(int, bytes);
+        QByteArray data(bytes, Qt::Uninitialized);
+        for (int i = 0; i < bytes; ++i)
+            data[i] = char(i * 31 + 7);
+        quint16 crc = 0;
+        QBENCHMARK {
+            crc ^= NightCameraControlDevice::calculateCRC(data, data.size());
+        }
+        // CRC-16/XMODEM check value
+        QCOMPARE(NightCameraControlDevice::calculateCRC(QByteArrayLiteral("123456789"), 9), quint16(0x31C3));
+        Q_UNUSED(crc);
+    }
+
+    void gyroBinaryParser()
+    {
+        const QByteArray stream = gyroBinaryStream(FRAMES_PER_CHUNK);
+        GyroBinaryParser parser;
+        double sink = 0.0;
+        QBENCHMARK {
+            parser.feed(stream.constData(), static_cast<std::size_t>(stream.size()), 0,
+                        [&sink](const GyroSample &sample) { sink += sample.yaw; });
+        }
+        QCOMPARE(parser.checksumErrors(), std::uint64_t(0));
+        QVERIFY(sink != 0.0);
+    }
+
+    // Text vs binary through GyroDevice, including the sample queue and the
+    // decimated model update
+    void gyroDevice_data()
+    {
+        QTest::addColumn<bool>("binary");
+        QTest::newRow("text") << false;
+        QTest::newRow("binary") << true;
+    }
+
+    void gyroDevice()
+    {
+        QFETCH(bool, binary);
+        GyroDevice device;
+        device.setProtocol(binary ? GyroDevice::Protocol::Binary : GyroDevice::Protocol::Text);
+        const QByteArray stream = binary ? gyroBinaryStream(FRAMES_PER_CHUNK) : gyroTextStream(FRAMES_PER_CHUNK);
+        qint64 timestampNs = 0;
+        int samples = 0;
+        GyroSample sample;
+        QBENCHMARK {
+            timestampNs += 10000000;
+            device.processData(stream, timestampNs);
+            while (device.popSample(sample))
+                ++samples;
+        }
+        QVERIFY(samples > 0);
+        reportMetric(binary ? QStringLiteral("gyroDevice.binary.bytesPerSample")
+                            : QStringLiteral("gyroDevice.text.bytesPerSample"),
+                     double(stream.size()) / FRAMES_PER_CHUNK, QStringLiteral("B"));
+    }
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchSerial);
+
+#include "bench_serial.moc"
@@ -0,0 +1,98 @@
+#include "benchsupport.h"
+#include "models/systemstatemodel.h"
+#include <QtTest>
+#include <memory>
+#include <vector>
+
+/**
+ * @class BenchState
+ * @brief SystemStateData copy/compare and the SystemStateModel fan-out that
+ *        every device update goes through.
+ */
+class BenchState : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void dataCopy()
+    {
+        SystemStateData source;
+        source.weaponSystemStatus = QStringLiteral("Armed");
+        source.targetInformation = QStringLiteral("Track 3");
+        SystemStateData copy;
+        QBENCHMARK {
+            copy = source;
+            source.gimbalAz += 0.01; // keep the copy from being hoisted
+        }
+        QVERIFY(copy.weaponSystemStatus == source.weaponSystemStatus);
+    }
+
+    void dataCompare_data()
+    {
+        QTest::addColumn<bool>("equal");
+        QTest::newRow("equal") << true;
+        QTest::newRow("first field differs") << false;
+    }
+
+    void dataCompare()
+    {
+        QFETCH(bool, equal);
+        SystemStateData a;
+        SystemStateData b;
+        if (!equal)
+            b.dayZoomPosition = 1.0;
+        bool result = false;
+        QBENCHMARK {
+            result = (a == b);
+        }
+        QCOMPARE(result, equal);
+    }
+
+    void updateDataFanOut_data()
+    {
+        QTest::addColumn<int>("subscribers");
+        QTest::newRow("1 subscriber") << 1;
+        QTest::newRow("8 subscribers") << 8;
+        QTest::newRow("32 subscribers") << 32;
+    }
+
+    // Each device update copies the state, changes a field and calls
+    // updateData(), which compares and emits to every subscriber by value
+    void updateDataFanOut()
+    {
+        QFETCH(int, subscribers);
+        SystemStateModel model;
+        std::vector<std::unique_ptr<QObject>> receivers;
+        double sink = 0.0;
+        for (int i = 0; i < subscribers; ++i) {
+            receivers.push_back(std::make_unique<QObject>());
+            connect(&model, &SystemStateModel::dataChanged, receivers.back().get(),
+                    [&sink](const SystemStateData &data) { sink += data.gimbalAz; });
+        }
+
+        double az = 0.0;
+        QBENCHMARK {
+            SystemStateData next = model.data();
+            az += 0.001;
+            next.gimbalAz = az;
+            model.updateData(next);
+        }
+        QVERIFY(sink > 0.0);
+    }
+
+    void updateDataUnchanged()
+    {
+        SystemStateModel model;
+        QObject receiver;
+        int calls = 0;
+        connect(&model, &SystemStateModel::dataChanged, &receiver, [&calls](const SystemStateData &) { ++calls; });
+        QBENCHMARK {
+            model.updateData(model.data());
+        }
+        QCOMPARE(calls, 0);
+    }
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchState);
+
+#include "bench_state.moc"
@@ -0,0 +1,181 @@
+#include "benchsupport.h"
+#include "utils/detectionfusion.h"
+#include <QtTest>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// @p count boxes of vehicle-like size spread over a 960x720 frame
+std::vector<QRect> scatteredBoxes(int count, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> x(0, 960 - 120);
+    std::uniform_int_distribution<int> y(0, 720 - 90);
+    std::uniform_int_distribution<int> size(24, 90);
+    std::vector<QRect> boxes;
+    boxes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int w = size(rng);
+        boxes.emplace_back(x(rng), y(rng), w, w * 3 / 4);
+    }
+    return boxes;
+}
+
+// Detections for @p tracks, each box jittered by a few pixels, plus clutter
+std::vector<FusionDetection> detectionsFor(const std::vector<QRect> &tracks, int clutter, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> jitter(-3, 3);
+    std::vector<FusionDetection> detections;
+    for (const QRect &box : tracks) {
+        FusionDetection d;
+        d.box = box.translated(jitter(rng), jitter(rng)).adjusted(0, 0, jitter(rng), jitter(rng));
+        d.classId = 2;
+        d.confidence = 0.8f;
+        detections.push_back(d);
+    }
+    for (const QRect &box : scatteredBoxes(clutter, seed + 1)) {
+        FusionDetection d;
+        d.box = box;
+        d.classId = 0;
+        d.confidence = 0.4f;
+        detections.push_back(d);
+    }
+    return detections;
+}
+
+double centerError(const QRect &a, const QRect &b)
+{
+    const QPointF d = QRectF(a).center() - QRectF(b).center();
+    return std::hypot(d.x(), d.y());
+}
+
+} // namespace
+
+/**
+ * @class BenchTracking
+ * @brief The CPU side of tracking: IoU association, the detection tracker
+ *        used without nvtracker and the DCF/detector fusion.
+ *
+ * The VPI DCF itself needs CUDA and is not benchmarked here.
+ */
+class BenchTracking : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void associate_data()
+    {
+        QTest::addColumn<int>("method");
+        QTest::addColumn<int>("tracks");
+        QTest::addColumn<int>("clutter");
+        const int greedy = int(AssociationMethod::Greedy);
+        const int hungarian = int(AssociationMethod::Hungarian);
+        QTest::newRow("greedy 1x4") << greedy << 1 << 3;
+        QTest::newRow("hungarian 1x4") << hungarian << 1 << 3;
+        QTest::newRow("greedy 8x16") << greedy << 8 << 8;
+        QTest::newRow("hungarian 8x16") << hungarian << 8 << 8;
+        QTest::newRow("greedy 32x64") << greedy << 32 << 32;
+        QTest::newRow("hungarian 32x64") << hungarian << 32 << 32;
+    }
+
+    void associate()
+    {
+        QFETCH(int, method);
+        QFETCH(int, tracks);
+        QFETCH(int, clutter);
+        const std::vector<QRect> trackBoxes = scatteredBoxes(tracks, 3);
+        const std::vector<FusionDetection> detections = detectionsFor(trackBoxes, clutter, 4);
+        IouAssociator associator(tracks, tracks + clutter);
+        associator.setMethod(AssociationMethod(method));
+        std::vector<FusionMatch> matches;
+        int matched = 0;
+        QBENCHMARK {
+            matched = associator.associate(trackBoxes, detections, matches);
+        }
+        QVERIFY(matched > 0);
+    }
+
+    void detectionTracker_data()
+    {
+        QTest::addColumn<int>("objects");
+        QTest::newRow("4 objects") << 4;
+        QTest::newRow("32 objects") << 32;
+    }
+
+    // One inference worth of detections through the tracker that assigns ids
+    // when nvtracker is not in the pipeline
+    void detectionTracker()
+    {
+        QFETCH(int, objects);
+        std::vector<QRect> truth = scatteredBoxes(objects, 7);
+        DetectionTracker tracker(objects);
+        std::vector<FusionDetection> frame;
+        quint32 seed = 0;
+        QBENCHMARK {
+            for (QRect &box : truth)
+                box.translate(1, 0);
+            frame = detectionsFor(truth, 0, ++seed);
+            tracker.update(frame);
+        }
+        QVERIFY(tracker.activeTracks() > 0);
+        QVERIFY(frame.front().trackId >= 0);
+    }
+
+    void fusionUpdate()
+    {
+        const std::vector<QRect> truth = scatteredBoxes(8, 9);
+        const std::vector<FusionDetection> detections = detectionsFor(truth, 8, 10);
+        DetectionFusion fusion;
+        const QRect dcfBox = truth.front().translated(4, -3);
+        FusionCorrection correction;
+        QBENCHMARK {
+            correction = fusion.update(dcfBox, detections);
+        }
+        QVERIFY(correction.matched);
+    }
+
+    // A drifting DCF box with the detector running every third frame; the
+    // metric is the centre error with and without fusion
+    void fusionDriftReplay()
+    {
+        std::mt19937 rng(12);
+        std::normal_distribution<double> drift(0.25, 0.6);
+        std::uniform_int_distribution<int> jitter(-2, 2);
+
+        DetectionFusion fusion;
+        QRect truth(420, 320, 80, 60);
+        QRect rawDcf = truth;
+        QRect fusedDcf = truth;
+        double rawSq = 0.0, fusedSq = 0.0;
+        constexpr int FRAMES = 300;
+        for (int i = 0; i < FRAMES; ++i) {
+            truth.translate(2, i % 4 == 0 ? 1 : 0);
+            const int dx = 2 + int(std::lround(drift(rng)));
+            const int dy = (i % 4 == 0 ? 1 : 0) + int(std::lround(drift(rng) * 0.5));
+            rawDcf.translate(dx, dy);
+            fusedDcf.translate(dx, dy);
+
+            if (i % 3 == 0) {
+                std::vector<FusionDetection> detections(1);
+                detections[0].box = truth.translated(jitter(rng), jitter(rng));
+                detections[0].classId = 2;
+                detections[0].confidence = 0.8f;
+                const FusionCorrection correction = fusion.update(fusedDcf, detections);
+                if (correction.matched)
+                    fusedDcf = correction.box;
+            }
+            rawSq += std::pow(centerError(rawDcf, truth), 2);
+            fusedSq += std::pow(centerError(fusedDcf, truth), 2);
+        }
+        reportMetric(QStringLiteral("fusion.dcfOnlyRmsPx"), std::sqrt(rawSq / FRAMES), QStringLiteral("px"));
+        reportMetric(QStringLiteral("fusion.fusedRmsPx"), std::sqrt(fusedSq / FRAMES), QStringLiteral("px"));
+        reportMetric(QStringLiteral("fusion.reseeds"), fusion.reseeds(), QStringLiteral("count"));
+    }
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchTracking);
+
+#include "bench_tracking.moc"
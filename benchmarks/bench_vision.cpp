@@ -0,0 +1,256 @@
+#include "benchsupport.h"
+#include "utils/edgedescriptor.h"
+#include "utils/reacquisition.h"
+#include "utils/targetfeatures.h"
+#include <QtTest>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int FRAME_WIDTH = 960;
+constexpr int FRAME_HEIGHT = 720;
+constexpr double FRAME_PERIOD = 1.0 / 30.0;
+
+double percentile(std::vector<double> values, double percent)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * values.size()));
+    return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+double centerDistance(const QRect &a, const QRect &b)
+{
+    const QPointF d = QRectF(a).center() - QRectF(b).center();
+    return std::hypot(d.x(), d.y());
+}
+
+} // namespace
+
+/**
+ * @class BenchVision
+ * @brief Appearance code on the tracking path: the target feature extractor,
+ *        the day/night handoff edge search and lost-track re-acquisition.
+ */
+class BenchVision : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        m_background = syntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 1);
+    }
+
+    void extractTargetFeatures_data()
+    {
+        QTest::addColumn<QRect>("box");
+        QTest::newRow("32x32") << QRect(464, 344, 32, 32);
+        QTest::newRow("160x120") << QRect(400, 300, 160, 120);
+        QTest::newRow("400x300") << QRect(280, 210, 400, 300);
+    }
+
+    // Cost of one descriptor: ReacquisitionEngine computes it per template
+    // refresh and per re-acquisition candidate
+    void extractTargetFeatures()
+    {
+        QFETCH(QRect, box);
+        QImage frame = m_background.copy();
+        paintTarget(frame, box, 2);
+        const RgbaImageView view = imageView(frame);
+        TargetFeatureExtractor extractor;
+        TargetFeatures features{};
+        bool ok = false;
+        QBENCHMARK {
+            ok = extractor.extract(view, box.x(), box.y(), box.width(), box.height(), features);
+        }
+        QVERIFY(ok);
+    }
+
+    void targetFeatureSimilarity()
+    {
+        QImage frame = m_background.copy();
+        const QRect box(400, 300, 160, 120);
+        paintTarget(frame, box, 2);
+        TargetFeatureExtractor extractor;
+        TargetFeatures a{}, b{};
+        QVERIFY(extractor.extract(imageView(frame), box.x(), box.y(), box.width(), box.height(), a));
+        QVERIFY(extractor.extract(imageView(frame), box.x() + 4, box.y() + 3, box.width(), box.height(), b));
+        float similarity = 0.0f;
+        QBENCHMARK {
+            similarity = ::targetFeatureSimilarity(a, b);
+        }
+        QVERIFY(similarity > 0.5f);
+    }
+
+    void edgeMapBuild()
+    {
+        const QImage gray = targetFrame(QRect(400, 300, 120, 80)).convertToFormat(QImage::Format_Grayscale8);
+        EdgeOrientationMap map;
+        const QRect region(300, 220, 320, 240);
+        bool ok = false;
+        QBENCHMARK {
+            ok = map.build(grayView(gray), region);
+        }
+        QVERIFY(ok);
+    }
+
+    // Day -> night handoff: the reference comes from the day frame, the search
+    // runs on a polarity-inverted, noisier frame with a transfer error
+    void handoffSearch()
+    {
+        const QRect truth(400, 300, 120, 80);
+        const QImage day = targetFrame(truth).convertToFormat(QImage::Format_Grayscale8);
+        QImage night = nightFrame(truth, 7);
+
+        EdgeOrientationMap dayMap;
+        QVERIFY(dayMap.build(grayView(day), truth.adjusted(-8, -8, 8, 8)));
+        EdgeDescriptor reference{};
+        QVERIFY(dayMap.describe(truth, reference));
+
+        const QRect predicted = truth.translated(6, -4);
+        EdgeSearchResult result;
+        QBENCHMARK {
+            result = searchEdgeDescriptor(grayView(night), predicted, reference, 24, 8.0, 0.6f);
+        }
+        QVERIFY(result.found);
+        reportMetric(QStringLiteral("handoff.errorPx"), centerDistance(result.box, truth), QStringLiteral("px"));
+        reportMetric(QStringLiteral("handoff.evaluated"), result.evaluated, QStringLiteral("boxes"));
+    }
+
+    // Replays handoffs with random transfer errors and reports how many land
+    // on the target
+    void handoffReplay()
+    {
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> error(-12, 12);
+        const QRect truth(400, 300, 120, 80);
+        const QImage day = targetFrame(truth).convertToFormat(QImage::Format_Grayscale8);
+        EdgeOrientationMap dayMap;
+        QVERIFY(dayMap.build(grayView(day), truth.adjusted(-8, -8, 8, 8)));
+        EdgeDescriptor reference{};
+        QVERIFY(dayMap.describe(truth, reference));
+
+        constexpr int TRIALS = 40;
+        int hits = 0;
+        std::vector<double> times;
+        for (int i = 0; i < TRIALS; ++i) {
+            const QImage night = nightFrame(truth, 100 + i);
+            const QRect predicted = truth.translated(error(rng), error(rng));
+            const EdgeSearchResult result = searchEdgeDescriptor(grayView(night), predicted, reference, 24, 8.0, 0.6f);
+            times.push_back(result.elapsedMs);
+            if (result.found && centerDistance(result.box, truth) <= 4.0)
+                ++hits;
+        }
+        reportMetric(QStringLiteral("handoff.successRate"), double(hits) / TRIALS, QStringLiteral("ratio"));
+        reportMetric(QStringLiteral("handoff.p50"), percentile(times, 50.0), QStringLiteral("ms"));
+        reportMetric(QStringLiteral("handoff.p99"), percentile(times, 99.0), QStringLiteral("ms"));
+    }
+
+    // One re-acquisition search on a frame where the target is back near the
+    // predicted position
+    void reacquisitionSearch()
+    {
+        ReacquisitionEngine engine;
+        engine.setConfirmFrames(1);
+        QRect box(300, 300, 96, 64);
+        double t = 0.0;
+        for (int i = 0; i < 30; ++i, t += FRAME_PERIOD) {
+            box.translate(3, 0);
+            const QImage frame = targetFrame(box);
+            engine.updateModel(imageView(frame), box, t);
+        }
+        const QRect returned = box.translated(3 * 6 + 5, 4);
+        const QImage frame = targetFrame(returned);
+        const RgbaImageView view = imageView(frame);
+
+        ReacquisitionResult result;
+        QBENCHMARK {
+            engine.begin(t);
+            result = engine.search(view, t + 6 * FRAME_PERIOD);
+        }
+        QVERIFY(result.found);
+        reportMetric(QStringLiteral("reacquisition.errorPx"), centerDistance(result.box, returned), QStringLiteral("px"));
+    }
+
+    // Loss / return replay: the target moves, disappears for a while and comes
+    // back near its extrapolated track (or never comes back)
+    void reacquisitionReplay()
+    {
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> speed(-4, 4);
+        std::uniform_int_distribution<int> gap(3, 30);
+        std::uniform_int_distribution<int> offset(-10, 10);
+
+        constexpr int TRIALS = 20;
+        constexpr int NEVER_RETURNS = 5; // the last trials test false matches
+        int hits = 0;
+        int falseMatches = 0;
+        std::vector<double> searchMs;
+
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            ReacquisitionEngine engine;
+            const int vx = speed(rng), vy = speed(rng) / 2;
+            QRect box(380, 300, 80, 56);
+            double t = 0.0;
+            for (int i = 0; i < 20; ++i, t += FRAME_PERIOD) {
+                box.translate(vx, vy);
+                engine.updateModel(imageView(targetFrame(box)), box, t);
+            }
+            QVERIFY(engine.begin(t));
+
+            const int hidden = gap(rng);
+            const bool returns = trial < TRIALS - NEVER_RETURNS;
+            for (int frame = 1; engine.isActive() && frame < 120; ++frame) {
+                box.translate(vx, vy);
+                const QRect shown = box.translated(offset(rng) / 4, offset(rng) / 4);
+                const QImage image = (returns && frame > hidden) ? targetFrame(shown) : m_background;
+                const ReacquisitionResult result = engine.search(imageView(image), t + frame * FRAME_PERIOD);
+                searchMs.push_back(result.elapsedMs);
+                if (result.found) {
+                    if (returns && centerDistance(result.box, shown) <= 10.0)
+                        ++hits;
+                    else
+                        ++falseMatches;
+                }
+            }
+        }
+        reportMetric(QStringLiteral("reacquisition.successRate"), double(hits) / (TRIALS - NEVER_RETURNS), QStringLiteral("ratio"));
+        reportMetric(QStringLiteral("reacquisition.falseMatches"), falseMatches, QStringLiteral("count"));
+        reportMetric(QStringLiteral("reacquisition.p50"), percentile(searchMs, 50.0), QStringLiteral("ms"));
+        reportMetric(QStringLiteral("reacquisition.p99"), percentile(searchMs, 99.0), QStringLiteral("ms"));
+    }
+
+private:
+    QImage targetFrame(const QRect &box) const
+    {
+        QImage frame = m_background.copy();
+        paintTarget(frame, box, 2);
+        return frame;
+    }
+
+    // Thermal-like view of the same scene: inverted polarity, extra noise
+    QImage nightFrame(const QRect &box, quint32 seed) const
+    {
+        QImage gray = targetFrame(box).convertToFormat(QImage::Format_Grayscale8);
+        gray.invertPixels();
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> noise(0.0, 8.0);
+        for (int y = 0; y < gray.height(); ++y) {
+            uchar *row = gray.scanLine(y);
+            for (int x = 0; x < gray.width(); ++x)
+                row[x] = static_cast<uchar>(std::clamp(row[x] + noise(rng), 0.0, 255.0));
+        }
+        return gray;
+    }
+
+    QImage m_background;
+};
+
+EL7ARESS_BENCHMARK_SUITE(BenchVision);
+
+#include "bench_vision.moc"
@@ -0,0 +1,76 @@
+QT       = core gui widgets serialport testlib
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle
+
+TARGET = el7aress_bench
+
+# Hot-path benchmarks (QtTest QBENCHMARK), built without CUDA, VPI or
+# DeepStream so they also run on a development PC. See main.cpp for usage.
+INCLUDEPATH += ..
+INCLUDEPATH += "/usr/local/include/opencv4"
+LIBS += -L/usr/local/lib -lopencv_core -lopencv_imgproc -lopencv_dnn
+
+# models/systemstatemodel.h includes every device header, so the SDL2
+# headers must be installed; QtSerialBus and QtNetwork are linked for the
+# Modbus transports
+QT += serialbus network
+
+# Stamped into the JSON results
+BENCH_VERSION = $$cat($$PWD/../VERSION)
+BENCH_REVISION = $$system(git -C $$PWD/.. describe --always --dirty)
+DEFINES += EL7ARESS_VERSION=\\\"$$BENCH_VERSION\\\"
+DEFINES += EL7ARESS_REVISION=\\\"$$BENCH_REVISION\\\"
+
+SOURCES += \
+    main.cpp \
+    benchresults.cpp \
+    benchsupport.cpp \
+    bench_control.cpp \
+    bench_display.cpp \
+    bench_inference.cpp \
+    bench_instrumentation.cpp \
+    bench_modbus.cpp \
+    bench_serial.cpp \
+    bench_state.cpp \
+    bench_tracking.cpp \
+    bench_vision.cpp \
+    ../controllers/leadcomputer.cpp \
+    ../controllers/losstabilizer.cpp \
+    ../controllers/safetyinterlock.cpp \
+    ../devices/daycameracontroldevice.cpp \
+    ../devices/gyrodevice.cpp \
+    ../devices/lrfdevice.cpp \
+    ../devices/nightcameracontroldevice.cpp \
+    ../devices/plc42device.cpp \
+    ../devices/servodriverdevice.cpp \
+    ../devices/videodisplaywidget.cpp \
+    ../models/systemstatemodel.cpp \
+    ../utils/ballistics.cpp \
+    ../utils/cpuinference.cpp \
+    ../utils/cpuosd.cpp \
+    ../utils/detectionfusion.cpp \
+    ../utils/edgedescriptor.cpp \
+    ../utils/latencymonitor.cpp \
+    ../utils/metricsregistry.cpp \
+    ../utils/modbuslinkmonitor.cpp \
+    ../utils/modbusmetrics.cpp \
+    ../utils/modbustransport.cpp \
+    ../utils/reacquisition.cpp \
+    ../utils/roiinference.cpp \
+    ../utils/targetfeatures.cpp \
+    ../utils/trace.cpp
+
+HEADERS += \
+    benchresults.h \
+    benchsupport.h \
+    ../controllers/safetyinterlock.h \
+    ../devices/daycameracontroldevice.h \
+    ../devices/gyrodevice.h \
+    ../devices/lrfdevice.h \
+    ../devices/nightcameracontroldevice.h \
+    ../devices/plc42device.h \
+    ../devices/servodriverdevice.h \
+    ../devices/videodisplaywidget.h \
+    ../utils/modbustransport.h \
+    ../models/systemstatemodel.h
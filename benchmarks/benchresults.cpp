@@ -0,0 +1,145 @@
+#include "benchresults.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QXmlStreamReader>
+
+#ifndef EL7ARESS_VERSION
+#define EL7ARESS_VERSION "unknown"
+#endif
+#ifndef EL7ARESS_REVISION
+#define EL7ARESS_REVISION "unknown"
+#endif
+
+bool readQtTestXml(const QString &path, const QString &suite, std::vector<BenchmarkResult> &results)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Benchmark log not found:" << path;
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        if (!xml.readNextStartElement())
+            continue;
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            BenchmarkResult result;
+            result.suite = suite;
+            result.benchmark = function;
+            result.tag = attributes.value(QLatin1String("tag")).toString();
+            result.metric = attributes.value(QLatin1String("metric")).toString();
+            result.value = attributes.value(QLatin1String("value")).toDouble();
+            result.iterations = attributes.value(QLatin1String("iterations")).toInt();
+            results.push_back(result);
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Cannot parse benchmark log" << path << ":" << xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+QJsonObject resultsToJson(const std::vector<BenchmarkResult> &results,
+                          const std::vector<BenchmarkMetric> &metrics)
+{
+    QJsonArray resultArray;
+    for (const BenchmarkResult &r : results) {
+        resultArray.append(QJsonObject{
+            {QStringLiteral("suite"), r.suite},
+            {QStringLiteral("benchmark"), r.benchmark},
+            {QStringLiteral("tag"), r.tag},
+            {QStringLiteral("metric"), r.metric},
+            {QStringLiteral("value"), r.value},
+            {QStringLiteral("iterations"), r.iterations},
+        });
+    }
+
+    QJsonArray metricArray;
+    for (const BenchmarkMetric &m : metrics) {
+        metricArray.append(QJsonObject{
+            {QStringLiteral("suite"), m.suite},
+            {QStringLiteral("name"), m.name},
+            {QStringLiteral("value"), m.value},
+            {QStringLiteral("unit"), m.unit},
+        });
+    }
+
+    QJsonObject json;
+    json[QStringLiteral("generated")] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    json[QStringLiteral("version")] = QStringLiteral(EL7ARESS_VERSION);
+    json[QStringLiteral("revision")] = QStringLiteral(EL7ARESS_REVISION);
+    json[QStringLiteral("qt")] = QString::fromLatin1(qVersion());
+    json[QStringLiteral("cpu")] = QSysInfo::currentCpuArchitecture();
+    json[QStringLiteral("kernel")] = QSysInfo::kernelVersion();
+    json[QStringLiteral("host")] = QSysInfo::machineHostName();
+    json[QStringLiteral("results")] = resultArray;
+    json[QStringLiteral("metrics")] = metricArray;
+    return json;
+}
+
+bool writeResultsJson(const QString &path, const QJsonObject &json)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write benchmark results to" << path;
+        return false;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int compareWithBaseline(const std::vector<BenchmarkResult> &results, const QString &baselinePath,
+                        double thresholdPercent, QStringList &report)
+{
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot read benchmark baseline" << baselinePath;
+        return -1;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        qWarning() << "Benchmark baseline is not a results file:" << baselinePath;
+        return -1;
+    }
+
+    QHash<QString, double> baseline;
+    const QJsonArray entries = doc.object().value(QStringLiteral("results")).toArray();
+    for (const QJsonValue &entry : entries) {
+        const QJsonObject o = entry.toObject();
+        BenchmarkResult r;
+        r.suite = o.value(QStringLiteral("suite")).toString();
+        r.benchmark = o.value(QStringLiteral("benchmark")).toString();
+        r.tag = o.value(QStringLiteral("tag")).toString();
+        r.metric = o.value(QStringLiteral("metric")).toString();
+        baseline.insert(r.key(), o.value(QStringLiteral("value")).toDouble());
+    }
+
+    // All QtTest metrics (time, ticks, instructions, events) are lower-is-better
+    int regressions = 0;
+    for (const BenchmarkResult &r : results) {
+        const auto it = baseline.constFind(r.key());
+        if (it == baseline.constEnd()) {
+            report << QStringLiteral("new       %1").arg(r.key());
+            continue;
+        }
+        if (it.value() <= 0.0)
+            continue;
+        const double change = (r.value - it.value()) / it.value() * 100.0;
+        if (change > thresholdPercent) {
+            ++regressions;
+            report << QStringLiteral("REGRESSED %1: %2 -> %3 (+%4%)")
+                          .arg(r.key()).arg(it.value()).arg(r.value).arg(change, 0, 'f', 1);
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,54 @@
+#ifndef BENCHRESULTS_H
+#define BENCHRESULTS_H
+
+/**
+ * @file benchresults.h
+ * @brief Collects QtTest benchmark results into JSON and compares a run with a
+ *        stored baseline.
+ *
+ * QtTest has no JSON logger, so each suite is run with the XML logger to a
+ * temporary file and the <BenchmarkResult> elements are read back from it.
+ */
+
+#include "benchsupport.h"
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+/**
+ * @struct BenchmarkResult
+ * @brief One QBENCHMARK measurement (per iteration, in the unit of @c metric).
+ */
+struct BenchmarkResult {
+    QString suite;
+    QString benchmark; ///< Test function.
+    QString tag;       ///< Data row, empty for functions without data.
+    QString metric;    ///< QtTest metric name, e.g. "WalltimeMilliseconds".
+    double value = 0.0;
+    int iterations = 0;
+
+    QString key() const { return suite + QLatin1String("::") + benchmark + QLatin1Char(':') + tag + QLatin1Char(':') + metric; }
+};
+
+/**
+ * @brief Appends the results found in the QtTest XML log @p path.
+ * @return False if the file cannot be read or parsed.
+ */
+bool readQtTestXml(const QString &path, const QString &suite, std::vector<BenchmarkResult> &results);
+
+/** @brief Results, reported metrics and run information as a JSON document. */
+QJsonObject resultsToJson(const std::vector<BenchmarkResult> &results,
+                          const std::vector<BenchmarkMetric> &metrics);
+bool writeResultsJson(const QString &path, const QJsonObject &json);
+
+/**
+ * @brief Compares timings with the JSON written by an earlier run.
+ * @param thresholdPercent Slow-down above which a result counts as a regression.
+ * @param report Filled with one line per regression (and per missing baseline).
+ * @return Number of regressions, or -1 if the baseline cannot be read.
+ */
+int compareWithBaseline(const std::vector<BenchmarkResult> &results, const QString &baselinePath,
+                        double thresholdPercent, QStringList &report);
+
+#endif // BENCHRESULTS_H
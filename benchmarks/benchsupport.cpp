@@ -0,0 +1,111 @@
+#include "benchsupport.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+QString s_currentSuite;
+std::vector<BenchmarkMetric> s_metrics;
+
+quint8 clampByte(double v)
+{
+    return static_cast<quint8>(std::clamp(v, 0.0, 255.0));
+}
+
+} // namespace
+
+std::vector<BenchmarkSuite> &benchmarkSuites()
+{
+    static std::vector<BenchmarkSuite> suites;
+    return suites;
+}
+
+bool registerBenchmarkSuite(const char *name, BenchmarkFactory create)
+{
+    benchmarkSuites().push_back({QString::fromLatin1(name), create});
+    return true;
+}
+
+void setCurrentSuite(const QString &suite)
+{
+    s_currentSuite = suite;
+}
+
+void reportMetric(const QString &name, double value, const QString &unit)
+{
+    s_metrics.push_back({s_currentSuite, name, value, unit});
+    qInfo().noquote() << QStringLiteral("METRIC %1::%2 = %3 %4").arg(s_currentSuite, name).arg(value).arg(unit);
+}
+
+const std::vector<BenchmarkMetric> &reportedMetrics()
+{
+    return s_metrics;
+}
+
+QImage syntheticFrame(int width, int height, quint32 seed)
+{
+    QImage frame(width, height, QImage::Format_RGBA8888);
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 6.0);
+    std::uniform_real_distribution<double> phase(0.0, 6.283);
+    const double p1 = phase(rng), p2 = phase(rng), p3 = phase(rng);
+
+    for (int y = 0; y < height; ++y) {
+        quint8 *row = frame.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            // Low-frequency terrain-like clutter, slightly different per channel
+            const double base = 110.0 + 40.0 * std::sin(x * 0.013 + p1) * std::cos(y * 0.017 + p2)
+                              + 20.0 * std::sin((x + y) * 0.041 + p3);
+            const double n = noise(rng);
+            row[4 * x + 0] = clampByte(base + n);
+            row[4 * x + 1] = clampByte(base * 1.05 + n);
+            row[4 * x + 2] = clampByte(base * 0.9 + n);
+            row[4 * x + 3] = 255;
+        }
+    }
+    return frame;
+}
+
+void paintTarget(QImage &frame, const QRect &box, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> shade(0, 60);
+    const QRect clipped = box.intersected(frame.rect());
+    for (int y = clipped.top(); y <= clipped.bottom(); ++y) {
+        quint8 *row = frame.scanLine(y);
+        for (int x = clipped.left(); x <= clipped.right(); ++x) {
+            // Dark hull with a bright band and a checker texture
+            const int u = x - box.x();
+            const int v = y - box.y();
+            const bool band = v > box.height() / 3 && v < box.height() / 2;
+            const bool checker = ((u / 6) + (v / 6)) % 2 == 0;
+            const int value = band ? 220 : (checker ? 40 : 70) + shade(rng);
+            row[4 * x + 0] = static_cast<quint8>(value);
+            row[4 * x + 1] = static_cast<quint8>(value);
+            row[4 * x + 2] = static_cast<quint8>(std::min(255, value + 10));
+            row[4 * x + 3] = 255;
+        }
+    }
+}
+
+RgbaImageView imageView(const QImage &frame)
+{
+    RgbaImageView view;
+    view.data = frame.constBits();
+    view.width = frame.width();
+    view.height = frame.height();
+    view.stride = static_cast<int>(frame.bytesPerLine());
+    return view;
+}
+
+GrayImageView grayView(const QImage &gray)
+{
+    GrayImageView view;
+    view.data = gray.constBits();
+    view.width = gray.width();
+    view.height = gray.height();
+    view.stride = static_cast<int>(gray.bytesPerLine());
+    return view;
+}
@@ -0,0 +1,63 @@
+#ifndef BENCHSUPPORT_H
+#define BENCHSUPPORT_H
+
+/**
+ * @file benchsupport.h
+ * @brief Suite registry, synthetic inputs and extra metrics shared by the
+ *        benchmark suites.
+ *
+ * Every suite is a QtTest class (QBENCHMARK in its test functions) registered
+ * with EL7ARESS_BENCHMARK_SUITE; main.cpp runs them in turn. Figures that are
+ * not timings (success rates, residuals, overshoot) are reported with
+ * reportMetric() and end up in the JSON next to the timings.
+ */
+
+#include "utils/targetfeatures.h"
+#include "utils/edgedescriptor.h"
+#include <QImage>
+#include <QObject>
+#include <QRect>
+#include <QString>
+#include <vector>
+
+using BenchmarkFactory = QObject *(*)();
+
+struct BenchmarkSuite {
+    QString name;
+    BenchmarkFactory create = nullptr;
+};
+
+std::vector<BenchmarkSuite> &benchmarkSuites();
+bool registerBenchmarkSuite(const char *name, BenchmarkFactory create);
+
+#define EL7ARESS_BENCHMARK_SUITE(Class) \
+    static const bool Class##Registered = registerBenchmarkSuite(#Class, []() -> QObject * { return new Class; })
+
+/**
+ * @struct BenchmarkMetric
+ * @brief A non-timing result of a benchmark (quality of the measured code).
+ */
+struct BenchmarkMetric {
+    QString suite;
+    QString name;
+    double value = 0.0;
+    QString unit;
+};
+
+/** @brief Records @p value under the running suite; also printed with qInfo. */
+void reportMetric(const QString &name, double value, const QString &unit);
+void setCurrentSuite(const QString &suite);
+const std::vector<BenchmarkMetric> &reportedMetrics();
+
+// Synthetic inputs. All generators are deterministic for a given seed, so
+// timings and metrics are comparable between runs.
+
+/** @brief 960x720-style RGBA frame of smooth background clutter plus noise. */
+QImage syntheticFrame(int width, int height, quint32 seed);
+/** @brief Paints a textured, high-contrast target into @p box. */
+void paintTarget(QImage &frame, const QRect &box, quint32 seed);
+
+RgbaImageView imageView(const QImage &frame);
+GrayImageView grayView(const QImage &gray);
+
+#endif // BENCHSUPPORT_H
@@ -0,0 +1,119 @@
+/**
+ * @file main.cpp
+ * @brief Runs the benchmark suites and writes their results as JSON.
+ *
+ *     el7aress_bench [-suite <name>]... [-json <file>] [-baseline <file>]
+ *                    [-threshold <percent>] [-verbose] [QtTest options]
+ *
+ * Every registered suite runs through QTest::qExec; the timings of all suites
+ * and the metrics they report are written to one JSON file (default
+ * bench-results.json). With -baseline, timings slower than the baseline by
+ * more than -threshold percent (default 10) are listed and the exit code is 1.
+ * Remaining arguments go to QtTest, e.g. "-iterations 100" or "-tickcounter".
+ *
+ * Runs headless: QT_QPA_PLATFORM defaults to "offscreen" for the widget
+ * benchmarks.
+ *
+ * Built with "make benchmarks" in the El7aress build directory, or on its
+ * own with qmake benchmarks/benchmarks.pro.
+ */
+
+#include "benchresults.h"
+#include "benchsupport.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QStringList suites;
+    QString jsonPath = QStringLiteral("bench-results.json");
+    QString baselinePath;
+    double threshold = 10.0;
+    bool verbose = false;
+    QStringList qtTestArgs;
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        const bool hasValue = i + 1 < args.size();
+        if (arg == QLatin1String("-suite") && hasValue) {
+            suites << args.at(++i);
+        } else if (arg == QLatin1String("-json") && hasValue) {
+            jsonPath = args.at(++i);
+        } else if (arg == QLatin1String("-baseline") && hasValue) {
+            baselinePath = args.at(++i);
+        } else if (arg == QLatin1String("-threshold") && hasValue) {
+            threshold = args.at(++i).toDouble();
+        } else if (arg == QLatin1String("-verbose")) {
+            verbose = true;
+        } else if (arg == QLatin1String("-list")) {
+            for (const BenchmarkSuite &suite : benchmarkSuites())
+                qInfo().noquote() << suite.name;
+            return 0;
+        } else {
+            qtTestArgs << arg;
+        }
+    }
+
+    // The devices log every parsed frame; that would dominate the timings
+    if (!verbose)
+        QLoggingCategory::setFilterRules(QStringLiteral("default.debug=false"));
+
+    QTemporaryDir logDir;
+    if (!logDir.isValid()) {
+        qWarning() << "Cannot create a directory for the QtTest logs";
+        return 2;
+    }
+
+    std::vector<BenchmarkResult> results;
+    int failedSuites = 0;
+    for (const BenchmarkSuite &suite : benchmarkSuites()) {
+        if (!suites.isEmpty() && !suites.contains(suite.name))
+            continue;
+
+        const QString xmlPath = logDir.filePath(suite.name + QLatin1String(".xml"));
+        QStringList testArgs{args.first(), QStringLiteral("-o"), xmlPath + QLatin1String(",xml"),
+                             QStringLiteral("-o"), QStringLiteral("-,txt")};
+        testArgs << qtTestArgs;
+
+        setCurrentSuite(suite.name);
+        std::unique_ptr<QObject> object(suite.create());
+        if (QTest::qExec(object.get(), testArgs) != 0)
+            ++failedSuites;
+        if (!readQtTestXml(xmlPath, suite.name, results))
+            ++failedSuites;
+    }
+
+    if (!writeResultsJson(jsonPath, resultsToJson(results, reportedMetrics())))
+        return 2;
+    qInfo().noquote() << QStringLiteral("%1 results, %2 metrics written to %3")
+                             .arg(results.size()).arg(reportedMetrics().size())
+                             .arg(QDir::toNativeSeparators(jsonPath));
+
+    int exitCode = failedSuites > 0 ? 1 : 0;
+    if (!baselinePath.isEmpty()) {
+        QStringList report;
+        const int regressions = compareWithBaseline(results, baselinePath, threshold, report);
+        for (const QString &line : report)
+            qInfo().noquote() << line;
+        if (regressions != 0) {
+            qWarning().noquote() << (regressions < 0 ? QStringLiteral("Baseline comparison failed")
+                                                     : QStringLiteral("%1 benchmark(s) regressed by more than %2%")
+                                                           .arg(regressions).arg(threshold));
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
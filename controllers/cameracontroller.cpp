@@ -1,5 +1,9 @@
 #include "cameracontroller.h"
+#include "utils/edgedescriptor.h"
+#include "utils/trace.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
 
 CameraController::CameraController(DayCameraControlDevice* dayControl,
     DayCameraPipelineDevice* dayPipeline,
@@ -88,7 +92,7 @@ bool CameraController::initialize()
                 this, &CameraController::onTrackedIdsUpdated, Qt::QueuedConnection);
         connect(m_dayPipeline, &DayCameraPipelineDevice::selectedTrackLost,
                 this, &CameraController::onSelectedTrackLost);
-        connect(m_dayPipeline, &DayCameraPipelineDevice::targetPositionUpdated,
+        connect(m_dayPipeline, &BaseCameraPipelineDevice::targetPositionUpdated,
                 this, &CameraController::onTargetPositionUpdated);
  
 
@@ -105,6 +109,10 @@ bool CameraController::initialize()
                     updateCameraProcessingMode();
                     emit stateChanged();
                 });
+        connect(m_dayPipeline, &BaseCameraPipelineDevice::reacquisitionStarted,
+                this, [this]() { updateStatus("Searching for lost target on day camera"); });
+        connect(m_dayPipeline, &BaseCameraPipelineDevice::targetReacquired,
+                this, [this]() { updateStatus("Target re-acquired on day camera"); });
 
 
 
@@ -129,6 +137,12 @@ bool CameraController::initialize()
                     updateCameraProcessingMode();
                     emit stateChanged();
                 });
+        connect(m_nightPipeline, &BaseCameraPipelineDevice::reacquisitionStarted,
+                this, [this]() { updateStatus("Searching for lost target on night camera"); });
+        connect(m_nightPipeline, &BaseCameraPipelineDevice::targetReacquired,
+                this, [this]() { updateStatus("Target re-acquired on night camera"); });
+        connect(m_nightPipeline, &BaseCameraPipelineDevice::targetPositionUpdated,
+                this, &CameraController::onTargetPositionUpdated);
 
     }
 
@@ -242,6 +256,7 @@ VideoDisplayWidget* CameraController::getActiveCameraDisplay() const
 
 void CameraController::onDayCameraFrameAvailable(const QImage& frame)
 {
+    TRACE_SCOPE("display", "day.frameAvailable");
     //qDebug() << "Day camera frame received:" << frame.width() << "x" << frame.height()
      //        << (frame.isNull() ? "NULL" : "valid");
     
@@ -260,6 +275,7 @@ void CameraController::onDayCameraFrameAvailable(const QImage& frame)
 
 void CameraController::onNightCameraFrameAvailable(const QImage& frame)
 {
+    TRACE_SCOPE("display", "night.frameAvailable");
     //qDebug() << "Night camera frame received:" << frame.width() << "x" << frame.height()
      //        << (frame.isNull() ? "NULL" : "valid");
     
@@ -479,6 +495,53 @@ void CameraController::safeStopTracking(BaseCameraPipelineDevice* camera)
     }
 }
 
+namespace {
+// The handoff (prediction + local search) must finish within one frame period
+constexpr double HANDOFF_BUDGET_MS = 33.0;
+
+// Residual pointing error after the angle-space transfer (boresight and
+// calibration error, target motion during the switch), sets the search radius.
+constexpr double HANDOFF_ANGLE_UNCERTAINTY_DEG = 0.5;
+constexpr int HANDOFF_MIN_RADIUS = 8;
+constexpr int HANDOFF_MAX_RADIUS = 80;
+
+// Minimum edge-descriptor similarity to accept the destination box
+constexpr float HANDOFF_MIN_SCORE = 0.6f;
+
+GrayImageView grayView(const QImage &gray)
+{
+    GrayImageView view;
+    view.data = gray.constBits();
+    view.width = gray.width();
+    view.height = gray.height();
+    view.stride = static_cast<int>(gray.bytesPerLine());
+    return view;
+}
+}
+
+CameraModel CameraController::cameraModelFor(BaseCameraPipelineDevice* camera) const
+{
+    const SystemStateData data = m_stateModel ? m_stateModel->data() : SystemStateData();
+    if (camera == m_dayPipeline)
+        return camera->cameraModel(data.dayZoomPosition, data.dayCurrentHFOV);
+    return camera->cameraModel(data.nightZoomPosition, data.nightCurrentHFOV);
+}
+
+QRect CameraController::predictHandoffBox(const QRect &sourceBox, const CameraModel &from, const CameraModel &to)
+{
+    // Transfer the box corners through bore-relative angles: this applies both
+    // boresight offsets and scales the box by the FOV ratio of the two cameras.
+    double az1, el1, az2, el2;
+    from.pixelToAngle(sourceBox.left(), sourceBox.top(), az1, el1);
+    from.pixelToAngle(sourceBox.left() + sourceBox.width(), sourceBox.top() + sourceBox.height(), az2, el2);
+
+    double x1, y1, x2, y2;
+    to.angleToPixel(az1, el1, x1, y1);
+    to.angleToPixel(az2, el2, x2, y2);
+    return QRect(QPoint(qRound(std::min(x1, x2)), qRound(std::min(y1, y2))),
+                 QPoint(qRound(std::max(x1, x2)) - 1, qRound(std::max(y1, y2)) - 1));
+}
+
 bool CameraController::performTargetHandoff(BaseCameraPipelineDevice* fromCamera, BaseCameraPipelineDevice* toCamera)
 {
     if (!fromCamera || !toCamera || !fromCamera->isTracking()) {
@@ -487,52 +550,57 @@ bool CameraController::performTargetHandoff(BaseCameraPipelineDevice* fromCamera
     }
 
     try {
-        // Get current target state from source camera
-        const TargetState& sourceState = fromCamera->getTargetState();
-
-        // Transform target position to world coordinates
-        // This would use the camera parameters to convert from image to world coordinates
-        const BaseCameraPipelineDevice::CameraParameters& fromParams = fromCamera->getCameraParameters();
-        const BaseCameraPipelineDevice::CameraParameters& toParams = toCamera->getCameraParameters();
-
-        // Get the 3D position from the source camera
-        QVector3D worldPos = sourceState.position;
-
-        // Transform to target camera coordinates
-        // This is a simplified transformation - in a real system, you would use proper 3D transformations
-        QVector3D relativePos = worldPos - toParams.position;
-
-        // Project the 3D point onto the target camera's image plane
-        // This is a simplified projection - in a real system, you would use proper camera projection
-        double focalLength = toParams.focalLength;
-        QPoint principalPoint = toParams.principalPoint;
-
-        // Simple pinhole camera model projection
-        int targetX = static_cast<int>(principalPoint.x() + (relativePos.x() / relativePos.z()) * focalLength);
-        int targetY = static_cast<int>(principalPoint.y() + (relativePos.y() / relativePos.z()) * focalLength);
+        QElapsedTimer timer;
+        timer.start();
+
+        const QRect sourceBox = fromCamera->getTargetState().bbox;
+        const CameraModel fromModel = cameraModelFor(fromCamera);
+        const CameraModel toModel = cameraModelFor(toCamera);
+        if (!fromModel.isValid() || !toModel.isValid()) {
+            qWarning() << "Cannot perform handoff: camera calibration unavailable";
+            return false;
+        }
 
-        // Use the same size as the source bounding box
-        int width = sourceState.bbox.width();
-        int height = sourceState.bbox.height();
+        // 1) Geometric prediction in angle space
+        const QRect predicted = predictHandoffBox(sourceBox, fromModel, toModel);
 
-        // Create the target bounding box
-        QRect targetBBox(targetX - width/2, targetY - height/2, width, height);
+        // 2) Edge descriptor of the target in the source camera
+        const QImage fromGray = fromCamera->getCurrentFrame().convertToFormat(QImage::Format_Grayscale8);
+        const QImage toGray = toCamera->getCurrentFrame().convertToFormat(QImage::Format_Grayscale8);
+        if (fromGray.isNull() || toGray.isNull()) {
+            qWarning() << "Cannot perform handoff: no frame available";
+            return false;
+        }
 
-        // Initialize tracking in target camera with transformed position
-        bool initSuccess = toCamera->initializeTracking(targetBBox);
-        if (!initSuccess) {
-            qWarning() << "Failed to initialize tracking in target camera";
+        EdgeOrientationMap sourceMap;
+        EdgeDescriptor reference;
+        if (!sourceMap.build(grayView(fromGray), sourceBox) || !sourceMap.describe(sourceBox, reference)) {
+            qWarning() << "Cannot perform handoff: no usable edges in source box" << sourceBox;
             return false;
         }
 
-        // Validate the handoff
-        const TargetState& targetState = toCamera->getTargetState();
-        bool isValid = validateTargetHandoff(sourceState, targetState);
+        // 3) Local search around the prediction in the destination camera
+        const int radius = qBound(HANDOFF_MIN_RADIUS,
+                                  static_cast<int>(HANDOFF_ANGLE_UNCERTAINTY_DEG * toModel.pixelsPerDegree()),
+                                  HANDOFF_MAX_RADIUS);
+        const double budgetMs = HANDOFF_BUDGET_MS - timer.nsecsElapsed() / 1.0e6;
+        const EdgeSearchResult match = searchEdgeDescriptor(grayView(toGray), predicted, reference,
+                                                            radius, budgetMs, HANDOFF_MIN_SCORE);
+
+        qDebug() << "Handoff: predicted" << predicted << "matched" << match.box
+                 << "score" << match.score << "candidates" << match.evaluated
+                 << "search" << match.elapsedMs << "ms, total" << timer.nsecsElapsed() / 1.0e6 << "ms"
+                 << (match.budgetExhausted ? "(budget exhausted)" : "");
+
+        if (!match.found) {
+            qWarning() << "Target handoff: no match above" << HANDOFF_MIN_SCORE << "near" << predicted;
+            return false;
+        }
 
-        if (!isValid) {
-            // If validation fails, stop tracking in target camera
-            safeStopTracking(toCamera);
-            qWarning() << "Target handoff validation failed";
+        // Initialize tracking in the destination camera on the matched box
+        const QRect targetBBox = match.box.intersected(toGray.rect());
+        if (!toCamera->initializeTracking(targetBBox)) {
+            qWarning() << "Failed to initialize tracking in target camera";
             return false;
         }
 
@@ -546,41 +614,6 @@ bool CameraController::performTargetHandoff(BaseCameraPipelineDevice* fromCamera
     }
 }
 
-bool CameraController::validateTargetHandoff(const TargetState& oldState, const TargetState& newState)
-{
-    // Compare visual features
-    float similarity = computeFeatureSimilarity(oldState.visualFeatures, newState.visualFeatures);
-
-    // Threshold for accepting the handoff
-    const float SIMILARITY_THRESHOLD = 0.7f;
-
-    return similarity >= SIMILARITY_THRESHOLD;
-}
-
-float CameraController::computeFeatureSimilarity(const std::vector<float>& features1, const std::vector<float>& features2)
-{
-    // Simple cosine similarity between feature vectors
-    if (features1.empty() || features2.empty() || features1.size() != features2.size()) {
-        return 0.0f;
-    }
-
-    float dotProduct = 0.0f;
-    float norm1 = 0.0f;
-    float norm2 = 0.0f;
-
-    for (size_t i = 0; i < features1.size(); ++i) {
-        dotProduct += features1[i] * features2[i];
-        norm1 += features1[i] * features1[i];
-        norm2 += features2[i] * features2[i];
-    }
-
-    if (norm1 <= 0.0f || norm2 <= 0.0f) {
-        return 0.0f;
-    }
-
-    return dotProduct / (std::sqrt(norm1) * std::sqrt(norm2));
-}
-
 void CameraController::zoomIn()
 {
     if (m_isDayCameraActive) {
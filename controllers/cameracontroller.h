@@ -145,8 +145,8 @@ signals:
 
     /**
      * @brief Emitted whenever target position is updated.
-     * @param x The X position.
-     * @param y The Y position.
+     * @param x Target azimuth relative to the gun bore (deg, positive right).
+     * @param y Target elevation relative to the gun bore (deg, positive up).
      */
     void targetPositionUpdated(double x, double y);
     void stateChanged();
@@ -251,9 +251,9 @@ private:
       void safeStopTracking(BaseCameraPipelineDevice camera);
 
       void safeStopTracking(BaseCameraPipelineDevice *camera);
-      float computeFeatureSimilarity(const std::vector<float> &features1, const std::vector<float> &features2);
-      bool validateTargetHandoff(const TargetState &oldState, const TargetState &newState);
       bool performTargetHandoff(BaseCameraPipelineDevice *fromCamera, BaseCameraPipelineDevice *toCamera);
+      CameraModel cameraModelFor(BaseCameraPipelineDevice *camera) const;
+      static QRect predictHandoffBox(const QRect &sourceBox, const CameraModel &from, const CameraModel &to);
 };
 
 #endif // CAMERA_CONTROLLER_H
@@ -1,6 +1,13 @@
 #include "gimbalcontroller.h"
+#include "safetyinterlock.h"
 #include "motion_modes/manualmotionmode.h"
 #include "motion_modes/trackingmotionmode.h"
+#include "motion_modes/positionmotionmode.h"
+#include "devices/gyrodevice.h"
+#include "devices/servoalarmservice.h"
+#include "utils/trace.h"
+#include "utils/metricsregistry.h"
+#include <cstdlib>
 #include <QDebug>
 
 GimbalController::GimbalController(ServoDriverDevice* azServo,
@@ -31,10 +38,21 @@ GimbalController::GimbalController(ServoDriverDevice* azServo,
     //connect(m_elServo, &ServoDriverDevice::alarmHistoryRead, this, &GimbalController::alarmHistoryRead);
     //connect(m_elServo, &ServoDriverDevice::alarmHistoryCleared, this, &GimbalController::alarmHistoryCleared);
 
+    // E-stop edges from the PLC fast poll stop the axes directly
+    m_safetyInterlock = new SafetyInterlock(m_plc42, m_azServo, m_elServo, this);
+
+    // Alarms reach onAz/ElAlarmDetected within ServoAlarmService::MAX_AGE_MS
+    m_alarmService = new ServoAlarmService(this);
+    m_alarmService->addServo(QStringLiteral("az"), m_azServo);
+    m_alarmService->addServo(QStringLiteral("el"), m_elServo);
+
     // Initialize and start the update timer
+    m_loopJitter = MetricsRegistry::instance().histogram(
+        QStringLiteral("el7aress_control_loop_jitter_seconds"),
+        QStringLiteral("Deviation of the gimbal control loop period from its nominal value"));
     m_updateTimer = new QTimer(this);
     connect(m_updateTimer, &QTimer::timeout, this, &GimbalController::update);
-    m_updateTimer->start(50);
+    m_updateTimer->start(UPDATE_PERIOD_MS);
 }
 
 GimbalController::~GimbalController()
@@ -54,20 +72,67 @@ void GimbalController::shutdown()
 
 void GimbalController::onSystemStateChanged(const SystemStateData &newData)
 {
-    if (m_oldState.motionMode != newData.motionMode) {
+    // Take the new state before acting: a handler below may change the model
+    const SystemStateData oldState = m_oldState;
+    m_oldState = newData;
+
+    if (oldState.motionMode != newData.motionMode) {
         setMotionMode(newData.motionMode);
     }
 
-    m_oldState = newData;
+    // Panel home switch: slew home on the rising edge. The slew changes the
+    // motion mode in the model, so it runs after this dataChanged fan-out.
+    if (newData.homeSw && !oldState.homeSw) {
+        QMetaObject::invokeMethod(this, &GimbalController::slewHome, Qt::QueuedConnection);
+    }
 }
 
 void GimbalController::update()
 {
+    TRACE_SCOPE("control", "gimbal.update");
+    const qint64 nowUs = LatencyMonitor::nowUs();
+    if (m_lastUpdateUs > 0)
+        m_loopJitter->record(std::llabs(nowUs - m_lastUpdateUs - UPDATE_PERIOD_MS * 1000LL));
+    m_lastUpdateUs = nowUs;
+
+    m_safetyInterlock->drain();
+    drainGyroSamples();
+
     if (m_currentMode) {
+        // Inject base-motion compensation while the panel stabilization switch is on
+        double azRate = 0.0;
+        double elRate = 0.0;
+        if (m_stateModel) {
+            SystemStateData data = m_stateModel->data();
+            if (data.stabilizationSwitch)
+                m_stabilizer.compensation(data.gimbalAz, data.gimbalEl,
+                                          GyroDevice::monotonicNs() / 1e9, azRate, elRate);
+        }
+        m_currentMode->setStabilizationRates(azRate, elRate);
+
         m_currentMode->update(this);
     }
 }
 
+void GimbalController::drainGyroSamples()
+{
+    if (!m_gyro) return;
+
+    GyroSample sample;
+    while (m_gyro->popSample(sample)) {
+        const double t = sample.timestampNs / 1e9;
+        if (sample.hasRates) {
+            BodyRates rates;
+            rates.rollRate = sample.rollRate;
+            rates.pitchRate = sample.pitchRate;
+            rates.yawRate = sample.yawRate;
+            m_stabilizer.addBodyRateSample(rates, t);
+        } else {
+            m_stabilizer.addAttitudeSample(sample.roll, sample.pitch, sample.yaw, t);
+        }
+    }
+}
+
 void GimbalController::setMotionMode(MotionMode newMode)
 {
     if (newMode == m_currentMotionModeType)
@@ -83,10 +148,26 @@ void GimbalController::setMotionMode(MotionMode newMode)
     case MotionMode::Manual:
         m_currentMode = std::make_unique<ManualMotionMode>();
         break;
+    case MotionMode::Pattern:
+        m_currentMode = std::make_unique<PatternMotionMode>(m_scanPattern);
+        break;
     case MotionMode::AutoTrack:
     case MotionMode::ManualTrack:
         m_currentMode = std::make_unique<TrackingMotionMode>();
         break;
+    case MotionMode::Slew: {
+        m_modeBeforeSlew = m_currentMotionModeType;
+        auto positionMode = std::make_unique<PositionMotionMode>(m_slewAz, m_slewEl);
+        connect(positionMode.get(), &PositionMotionMode::slewCompleted,
+                this, &GimbalController::slewCompleted);
+        // Both are emitted from the mode's update(): switch after it returns
+        connect(positionMode.get(), &PositionMotionMode::slewCompleted,
+                this, &GimbalController::onSlewFinished, Qt::QueuedConnection);
+        connect(positionMode.get(), &PositionMotionMode::slewAborted,
+                this, &GimbalController::onSlewFinished, Qt::QueuedConnection);
+        m_currentMode = std::move(positionMode);
+        break;
+    }
     default:
         qWarning() << "Unknown motion mode:" << int(newMode);
         m_currentMode = nullptr;
@@ -102,16 +183,97 @@ void GimbalController::setMotionMode(MotionMode newMode)
     qDebug() << "[GimbalController] Mode set to" << int(m_currentMotionModeType);
 }
 
-void GimbalController::readAlarms()
+void GimbalController::slewTo(double az, double el)
 {
-    if (m_azServo) {
-        m_azServo->readAlarmStatus();
+    m_slewAz = az;
+    m_slewEl = el;
+
+    if (m_currentMotionModeType == MotionMode::Slew && m_currentMode) {
+        static_cast<PositionMotionMode*>(m_currentMode.get())->setTarget(az, el);
+        return;
     }
-    if (m_elServo) {
-        m_elServo->readAlarmStatus();
+
+    // Go through the state model so the rest of the system sees the mode change
+    if (m_stateModel) {
+        m_stateModel->setMotionMode(MotionMode::Slew);
+    } else {
+        setMotionMode(MotionMode::Slew);
+    }
+}
+
+void GimbalController::onSlewFinished()
+{
+    if (m_currentMotionModeType != MotionMode::Slew)
+        return;
+
+    // A retarget after the signal was queued keeps the slew going
+    auto positionMode = static_cast<PositionMotionMode*>(m_currentMode.get());
+    if (positionMode && !positionMode->hasArrived() && !positionMode->isAborted())
+        return;
+
+    const MotionMode mode = m_modeBeforeSlew != MotionMode::Slew ? m_modeBeforeSlew : MotionMode::Manual;
+    qDebug() << "[GimbalController] Slew finished, back to mode" << int(mode);
+    if (m_stateModel) {
+        m_stateModel->setMotionMode(mode);
+    } else {
+        setMotionMode(mode);
     }
 }
 
+void GimbalController::slewHome()
+{
+    qDebug() << "[GimbalController] Slew home";
+    slewTo(m_homeAz, m_homeEl);
+}
+
+bool GimbalController::storePreset(int index)
+{
+    if (index < 0 || index >= PRESET_COUNT || !m_stateModel)
+        return false;
+
+    SystemStateData data = m_stateModel->data();
+    m_presets[index] = {data.gimbalAz, data.gimbalEl, true};
+    qDebug() << "[GimbalController] Preset" << index << "stored at" << data.gimbalAz << data.gimbalEl;
+    return true;
+}
+
+bool GimbalController::slewToPreset(int index)
+{
+    if (index < 0 || index >= PRESET_COUNT || !m_presets[index].valid)
+        return false;
+
+    slewTo(m_presets[index].az, m_presets[index].el);
+    return true;
+}
+
+void GimbalController::onExternalCue(double az, double el)
+{
+    slewTo(az, el);
+}
+
+void GimbalController::onTargetPositionUpdated(double azOffset, double elOffset)
+{
+    if ((m_currentMotionModeType != MotionMode::AutoTrack &&
+         m_currentMotionModeType != MotionMode::ManualTrack) || !m_currentMode || !m_stateModel)
+        return;
+
+    // The offsets are bore-relative; the mode tracks absolute angles so its
+    // error stays correct while the gimbal moves between tracker frames
+    const SystemStateData data = m_stateModel->data();
+    static_cast<TrackingMotionMode*>(m_currentMode.get())
+        ->onTargetPositionUpdated(data.gimbalAz + azOffset, data.gimbalEl + elOffset);
+}
+
+void GimbalController::readAlarms()
+{
+    // Answered from the cache; the service refreshes it in the background
+    if (const uint16_t code = m_alarmService->currentAlarm(QStringLiteral("az")))
+        emit azAlarmDetected(code, m_azServo->getAlarmDescription(code));
+    if (const uint16_t code = m_alarmService->currentAlarm(QStringLiteral("el")))
+        emit elAlarmDetected(code, m_elServo->getAlarmDescription(code));
+    m_alarmService->refreshNow();
+}
+
 void GimbalController::clearAlarms()
 {
     if (m_azServo) {
@@ -8,12 +8,20 @@
 
 #include <QObject>
 #include <QTimer>
+#include <array>
 #include <memory>
 #include "motion_modes/gimbalmotionmodebase.h"
 #include "models/systemstatemodel.h"
+#include "losstabilizer.h"
+#include "motion_modes/patternmotionmode.h"
+
+class MetricHistogram;
 
 class ServoDriverDevice;
 class Plc42Device;
+class GyroDevice;
+class SafetyInterlock;
+class ServoAlarmService;
 
 /**
  * @class GimbalController
@@ -83,9 +91,90 @@ public:
      */
     SystemStateModel* systemStateModel() const { return m_stateModel; }
     
+    /**
+     * @brief Reports the cached alarms of both axes at once and asks the
+     *        alarm service for a fresh read at the next idle bus slot.
+     */
     void readAlarms();
     void clearAlarms();
 
+    /**
+     * @brief Accessor for the background alarm cache of both axes.
+     */
+    ServoAlarmService* alarmService() const { return m_alarmService; }
+
+    /**
+     * @brief Accessor for the line-of-sight stabilizer (tuning / diagnostics).
+     */
+    LosStabilizer& stabilizer() { return m_stabilizer; }
+
+    /**
+     * @brief Accessor for the E-stop / limit sensor fast path.
+     */
+    SafetyInterlock* safetyInterlock() const { return m_safetyInterlock; }
+
+    /**
+     * @brief Sets the IMU whose sample queue is drained every control-loop update.
+     * @param gyro Gyro device, or nullptr to disable stabilization input.
+     */
+    void setGyroDevice(GyroDevice* gyro) { m_gyro = gyro; }
+
+    /**
+     * @brief Sets the scan used the next time MotionMode::Pattern is entered.
+     * @param pattern Sector, raster or waypoint scan description.
+     */
+    void setScanPattern(const ScanPattern& pattern) { m_scanPattern = pattern; }
+
+    /**
+     * @brief Returns the configured scan pattern.
+     */
+    const ScanPattern& scanPattern() const { return m_scanPattern; }
+
+    /**
+     * @brief Slews the turret to an absolute az/el (MotionMode::Slew).
+     * Retargets the move if a slew is already in progress. When the slew
+     * completes or is aborted, the mode active before it is restored.
+     */
+    void slewTo(double az, double el);
+
+    /**
+     * @brief Slews to the home position.
+     */
+    void slewHome();
+
+    /**
+     * @brief Sets the home position used by slewHome() and the panel home switch.
+     */
+    void setHomePosition(double az, double el) { m_homeAz = az; m_homeEl = el; }
+
+    /**
+     * @brief Stores the current gimbal position as preset @p index.
+     * @return False if the index is out of range.
+     */
+    bool storePreset(int index);
+
+    /**
+     * @brief Slews to preset @p index.
+     * @return False if the index is out of range or the preset is empty.
+     */
+    bool slewToPreset(int index);
+
+    static constexpr int PRESET_COUNT = 8;
+    static constexpr int UPDATE_PERIOD_MS = 50; ///< Control loop period.
+
+public slots:
+    /**
+     * @brief Slew-to-cue from an external sensor or an LRF-designated point.
+     */
+    void onExternalCue(double az, double el);
+
+    /**
+     * @brief Tracker output, forwarded to the active tracking mode.
+     * @param azOffset Target azimuth relative to the gun bore (deg, positive right).
+     * @param elOffset Target elevation relative to the gun bore (deg, positive up).
+     */
+    void onTargetPositionUpdated(double azOffset, double elOffset);
+
 signals:
 
     void azAlarmDetected(uint16_t alarmCode, const QString &description);
@@ -93,6 +182,11 @@ signals:
     void elAlarmDetected(uint16_t alarmCode, const QString &description);
     void elAlarmCleared();
 
+    /**
+     * @brief Emitted when a slew reaches its target.
+     */
+    void slewCompleted(double az, double el);
+
 
 private slots:
     /**
@@ -105,6 +199,11 @@ private slots:
     void onElAlarmDetected(uint16_t alarmCode, const QString &description);
     void onElAlarmCleared();
 
+    /**
+     * @brief Leaves MotionMode::Slew for the mode it was entered from.
+     */
+    void onSlewFinished();
+
 
 private:
     /**
@@ -123,6 +222,31 @@ private:
     MotionMode m_currentMotionModeType = MotionMode::Manual; ///< Current motion mode type.
 
     QTimer* m_updateTimer = nullptr; ///< Timer for periodic updates.
+    MetricHistogram* m_loopJitter = nullptr; ///< |actual - nominal| update period.
+    qint64 m_lastUpdateUs = 0; ///< Start of the previous update (monotonic).
+
+    /**
+     * @brief Feeds all queued IMU samples into the stabilizer.
+     */
+    void drainGyroSamples();
+
+    struct PositionPreset {
+        double az = 0.0;
+        double el = 0.0;
+        bool valid = false;
+    };
+
+    ScanPattern   m_scanPattern;     ///< Scan executed in MotionMode::Pattern.
+    double        m_slewAz = 0.0;    ///< Target of MotionMode::Slew.
+    double        m_slewEl = 0.0;
+    MotionMode    m_modeBeforeSlew = MotionMode::Manual; ///< Restored when a slew ends.
+    double        m_homeAz = 0.0;    ///< Home position.
+    double        m_homeEl = 0.0;
+    std::array<PositionPreset, PRESET_COUNT> m_presets;
+    GyroDevice*   m_gyro = nullptr;  ///< IMU sample source (optional).
+    SafetyInterlock* m_safetyInterlock = nullptr; ///< Stops the axes on E-stop edges.
+    ServoAlarmService* m_alarmService = nullptr;  ///< Alarm status/history refresh in idle bus slots.
+    LosStabilizer m_stabilizer;      ///< Base-motion compensation from the IMU.
 };
 
 #endif // GIMBALCONTROLLER_H
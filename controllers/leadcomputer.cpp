@@ -0,0 +1,144 @@
+#include "leadcomputer.h"
+#include "utils/ballistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Gimbal samples further apart than this restart the rate estimate.
+constexpr double MAX_GIMBAL_GAP = 0.5;
+
+// Gimbal extrapolation horizon (s); beyond it the last rate is not trusted.
+constexpr double MAX_EXTRAPOLATION = 0.2;
+
+// Low-pass weight of the differentiated gimbal rate.
+constexpr double GIMBAL_RATE_ALPHA = 0.5;
+
+// Observations further apart than this restart the track.
+constexpr double MAX_OBSERVATION_GAP = 0.5;
+}
+
+void LeadComputer::reset()
+{
+    m_az = AxisFilter();
+    m_el = AxisFilter();
+    m_observations = 0;
+    m_gateMisses = 0;
+    m_lastObservationTime = 0.0;
+}
+
+void LeadComputer::setFilterGain(double alpha)
+{
+    m_alpha = std::clamp(alpha, 0.01, 1.0);
+    m_beta = m_alpha * m_alpha / (2.0 - m_alpha);
+}
+
+void LeadComputer::addGimbalSample(double azDeg, double elDeg, double timestampSec)
+{
+    if (!std::isfinite(azDeg) || !std::isfinite(elDeg))
+        return;
+
+    const double dt = timestampSec - m_gimbalTime;
+    if (m_hasGimbal && dt > 0.0 && dt <= MAX_GIMBAL_GAP) {
+        m_gimbalAzRate += GIMBAL_RATE_ALPHA * ((azDeg - m_gimbalAz) / dt - m_gimbalAzRate);
+        m_gimbalElRate += GIMBAL_RATE_ALPHA * ((elDeg - m_gimbalEl) / dt - m_gimbalElRate);
+    } else if (!m_hasGimbal || dt > MAX_GIMBAL_GAP) {
+        m_gimbalAzRate = 0.0;
+        m_gimbalElRate = 0.0;
+    } else {
+        return; // Out-of-order or duplicate sample
+    }
+
+    m_gimbalAz = azDeg;
+    m_gimbalEl = elDeg;
+    m_gimbalTime = timestampSec;
+    m_hasGimbal = true;
+}
+
+void LeadComputer::gimbalAt(double timestampSec, double &az, double &el) const
+{
+    const double dt = std::clamp(timestampSec - m_gimbalTime, -MAX_EXTRAPOLATION, MAX_EXTRAPOLATION);
+    az = m_gimbalAz + m_gimbalAzRate * dt;
+    el = m_gimbalEl + m_gimbalElRate * dt;
+}
+
+void LeadComputer::addObservation(double offsetAzDeg, double offsetElDeg, double timestampSec)
+{
+    if (!std::isfinite(offsetAzDeg) || !std::isfinite(offsetElDeg))
+        return;
+
+    // Target direction in the gimbal base frame
+    double gimbalAz = 0.0;
+    double gimbalEl = 0.0;
+    if (m_hasGimbal)
+        gimbalAt(timestampSec, gimbalAz, gimbalEl);
+    const double measAz = gimbalAz + offsetAzDeg;
+    const double measEl = gimbalEl + offsetElDeg;
+
+    const double dt = timestampSec - m_lastObservationTime;
+    if (m_observations == 0 || dt > MAX_OBSERVATION_GAP) {
+        // (Re)start the track at the measured direction, rate unknown
+        m_az = {measAz, 0.0};
+        m_el = {measEl, 0.0};
+        m_observations = 1;
+        m_gateMisses = 0;
+        m_lastObservationTime = timestampSec;
+        return;
+    }
+    if (dt <= 0.0)
+        return;
+
+    // Predict
+    const double predAz = m_az.angle + m_az.rate * dt;
+    const double predEl = m_el.angle + m_el.rate * dt;
+    const double resAz = measAz - predAz;
+    const double resEl = measEl - predEl;
+
+    m_lastObservationTime = timestampSec;
+
+    // Gate tracker jumps: coast on the prediction, restart if they persist
+    if (std::fabs(resAz) > m_gateDeg || std::fabs(resEl) > m_gateDeg) {
+        if (++m_gateMisses > m_maxGateMisses) {
+            m_observations = 0;
+            addObservation(offsetAzDeg, offsetElDeg, timestampSec);
+            return;
+        }
+        m_az.angle = predAz;
+        m_el.angle = predEl;
+        return;
+    }
+    m_gateMisses = 0;
+
+    // Correct
+    m_az.angle = predAz + m_alpha * resAz;
+    m_el.angle = predEl + m_alpha * resEl;
+    m_az.rate = std::clamp(m_az.rate + m_beta * resAz / dt, -m_maxRate, m_maxRate);
+    m_el.rate = std::clamp(m_el.rate + m_beta * resEl / dt, -m_maxRate, m_maxRate);
+    ++m_observations;
+}
+
+LeadSolution LeadComputer::solve(double rangeMeters, const BallisticTable *table,
+                                 double pixelsPerDegree, double nowSec) const
+{
+    LeadSolution lead;
+    lead.range = rangeMeters;
+    lead.targetAzRate = m_az.rate;
+    lead.targetElRate = m_el.rate;
+
+    if (!table || rangeMeters <= 0.0 || m_observations < m_minObservations)
+        return lead;
+    if (nowSec - m_lastObservationTime > m_staleTimeout)
+        return lead;
+
+    const BallisticSolution ballistic = table->solve(rangeMeters);
+    if (!ballistic.valid)
+        return lead;
+
+    // The target keeps its LOS rate during the time of flight
+    lead.timeOfFlight = ballistic.timeOfFlight;
+    lead.azDeg = std::clamp(m_az.rate * ballistic.timeOfFlight, -m_maxLeadDeg, m_maxLeadDeg);
+    lead.elDeg = std::clamp(m_el.rate * ballistic.timeOfFlight, -m_maxLeadDeg, m_maxLeadDeg);
+    lead.azPixels = lead.azDeg * pixelsPerDegree;
+    lead.elPixels = -lead.elDeg * pixelsPerDegree;
+    lead.valid = true;
+    return lead;
+}
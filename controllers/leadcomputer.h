@@ -0,0 +1,144 @@
+#ifndef LEADCOMPUTER_H
+#define LEADCOMPUTER_H
+
+/**
+ * @file leadcomputer.h
+ * @brief Automatic lead: aim-point offset for a moving target from its tracked
+ *        angular velocity and the ballistic time of flight.
+ */
+
+class BallisticTable;
+
+/**
+ * @struct LeadSolution
+ * @brief Aim-point offset relative to the target, in angle and OSD pixels.
+ */
+struct LeadSolution {
+    bool   valid        = false;
+    double azDeg        = 0.0; ///< Lead in azimuth, positive right (deg).
+    double elDeg        = 0.0; ///< Lead in elevation, positive up (deg).
+    double azPixels     = 0.0; ///< Horizontal OSD offset, positive right (px).
+    double elPixels     = 0.0; ///< Vertical OSD offset, positive down (px).
+    double range        = 0.0; ///< Range used for the solution (m).
+    double timeOfFlight = 0.0; ///< Projectile time of flight at that range (s).
+    double targetAzRate = 0.0; ///< Estimated target LOS rate in azimuth (deg/s).
+    double targetElRate = 0.0; ///< Estimated target LOS rate in elevation (deg/s).
+};
+
+/**
+ * @class LeadComputer
+ * @brief Estimates the target's line-of-sight angular velocity and converts it
+ *        into a lead angle using the time of flight from the firing table.
+ *
+ * The target direction is the gimbal angle plus the tracker's offset from the
+ * boresight. Gimbal angles arrive at the servo poll rate, so they are
+ * extrapolated with the gimbal rate to the tracker observation time. Each axis
+ * runs an alpha-beta filter with an innovation gate, which keeps the lead
+ * steady under box jitter and single-frame tracker jumps.
+ *
+ * The class is plain C++ (no Qt types) so recorded tracks can be replayed offline.
+ * Angle convention matches SystemStateData: azimuth positive clockwise,
+ * elevation positive up.
+ */
+class LeadComputer
+{
+public:
+    LeadComputer() = default;
+
+    /**
+     * @brief Feeds a gimbal position sample (deg).
+     * @param timestampSec Monotonic sample time (s).
+     */
+    void addGimbalSample(double azDeg, double elDeg, double timestampSec);
+
+    /**
+     * @brief Feeds a tracker observation: target offset from the boresight (deg).
+     * @param timestampSec Monotonic time of the video frame (s).
+     */
+    void addObservation(double offsetAzDeg, double offsetElDeg, double timestampSec);
+
+    /**
+     * @brief Computes the lead for the current rate estimate.
+     * @param rangeMeters Target range (m), typically the last LRF reading.
+     * @param table Firing table supplying the time of flight; may be null.
+     * @param pixelsPerDegree Angular scale of the active camera, for the OSD offset.
+     * @param nowSec Current monotonic time (s), used to reject a stale track.
+     * @return An invalid solution until the filter has converged, when the track
+     *         is stale, or when the range is outside the table.
+     */
+    LeadSolution solve(double rangeMeters, const BallisticTable *table,
+                       double pixelsPerDegree, double nowSec) const;
+
+    /**
+     * @brief Drops the track. The next observation restarts the filter.
+     */
+    void reset();
+
+    /**
+     * @brief Position gain of the alpha-beta filter (0..1). The rate gain is
+     *        derived for critical damping: beta = alpha^2 / (2 - alpha).
+     */
+    void setFilterGain(double alpha);
+
+    /**
+     * @brief Innovation gate (deg). Observations further from the prediction are ignored.
+     */
+    void setGate(double gateDeg) { m_gateDeg = gateDeg; }
+
+    /**
+     * @brief Number of consecutive gated observations after which the track restarts.
+     */
+    void setMaxGateMisses(int misses) { m_maxGateMisses = misses; }
+
+    /**
+     * @brief Observations required before a solution is reported.
+     */
+    void setMinObservations(int count) { m_minObservations = count; }
+
+    /**
+     * @brief Time after the last observation beyond which the track is stale (s).
+     */
+    void setStaleTimeout(double timeout) { m_staleTimeout = timeout; }
+
+    /**
+     * @brief Maximum lead angle per axis (deg).
+     */
+    void setMaxLead(double maxLeadDeg) { m_maxLeadDeg = maxLeadDeg; }
+
+    double targetAzRate() const { return m_az.rate; }
+    double targetElRate() const { return m_el.rate; }
+    int observationCount() const { return m_observations; }
+
+private:
+    struct AxisFilter {
+        double angle = 0.0; ///< Filtered target direction (deg).
+        double rate  = 0.0; ///< Filtered target LOS rate (deg/s).
+    };
+
+    void gimbalAt(double timestampSec, double &az, double &el) const;
+
+    AxisFilter m_az;
+    AxisFilter m_el;
+    int    m_observations = 0;
+    int    m_gateMisses = 0;
+    double m_lastObservationTime = 0.0;
+
+    // Gimbal position and rate from the servo feedback
+    bool   m_hasGimbal = false;
+    double m_gimbalAz = 0.0;
+    double m_gimbalEl = 0.0;
+    double m_gimbalAzRate = 0.0;
+    double m_gimbalElRate = 0.0;
+    double m_gimbalTime = 0.0;
+
+    double m_alpha           = 0.2;
+    double m_beta            = 0.2 * 0.2 / (2.0 - 0.2);
+    double m_gateDeg         = 1.0;
+    int    m_maxGateMisses   = 5;
+    int    m_minObservations = 10;
+    double m_staleTimeout    = 0.3;
+    double m_maxLeadDeg      = 5.0;
+    double m_maxRate         = 30.0;
+};
+
+#endif // LEADCOMPUTER_H
@@ -0,0 +1,130 @@
+#include "losstabilizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+// Shortest signed difference between two angles (deg), handles ±180 wrap.
+double wrapDelta(double a, double b)
+{
+    double d = std::fmod(a - b, 360.0);
+    if (d > 180.0) d -= 360.0;
+    if (d < -180.0) d += 360.0;
+    return d;
+}
+
+// Elevation close to ±90 makes the azimuth term singular; cap tan(el).
+constexpr double MAX_TAN_ELEVATION = 5.0;
+
+// Samples further apart than this restart the differentiator.
+constexpr double MAX_SAMPLE_GAP = 0.5;
+}
+
+void LosStabilizer::reset()
+{
+    m_rates = BodyRates();
+    m_hasRates = false;
+    m_hasAttitude = false;
+    m_lastSampleTime = 0.0;
+    m_prevAttitudeTime = 0.0;
+}
+
+void LosStabilizer::addAttitudeSample(double rollDeg, double pitchDeg, double yawDeg, double timestampSec)
+{
+    if (!std::isfinite(rollDeg) || !std::isfinite(pitchDeg) || !std::isfinite(yawDeg))
+        return;
+
+    const double dt = timestampSec - m_prevAttitudeTime;
+    if (!m_hasAttitude || dt <= 0.0 || dt > MAX_SAMPLE_GAP) {
+        // Prime (or re-prime after a gap); rates unknown until the next sample
+        m_prevRoll = rollDeg;
+        m_prevPitch = pitchDeg;
+        m_prevYaw = yawDeg;
+        m_prevAttitudeTime = timestampSec;
+        m_hasAttitude = true;
+        if (dt > MAX_SAMPLE_GAP)
+            m_hasRates = false;
+        return;
+    }
+
+    // Euler angle rates
+    const double phiDot   = wrapDelta(rollDeg, m_prevRoll) / dt;
+    const double thetaDot = (pitchDeg - m_prevPitch) / dt;
+    const double psiDot   = wrapDelta(yawDeg, m_prevYaw) / dt;
+
+    // Euler (ZYX) rates -> body rates
+    const double phi   = rollDeg * DEG_TO_RAD;
+    const double theta = pitchDeg * DEG_TO_RAD;
+    BodyRates raw;
+    raw.rollRate  = phiDot - std::sin(theta) * psiDot;
+    raw.pitchRate = std::cos(phi) * thetaDot + std::sin(phi) * std::cos(theta) * psiDot;
+    raw.yawRate   = -std::sin(phi) * thetaDot + std::cos(phi) * std::cos(theta) * psiDot;
+
+    m_prevRoll = rollDeg;
+    m_prevPitch = pitchDeg;
+    m_prevYaw = yawDeg;
+    m_prevAttitudeTime = timestampSec;
+
+    filterRates(raw, dt);
+    m_lastSampleTime = timestampSec;
+}
+
+void LosStabilizer::addBodyRateSample(const BodyRates &rates, double timestampSec)
+{
+    if (!std::isfinite(rates.rollRate) || !std::isfinite(rates.pitchRate) || !std::isfinite(rates.yawRate))
+        return;
+
+    const double dt = timestampSec - m_lastSampleTime;
+    if (!m_hasRates || dt <= 0.0 || dt > MAX_SAMPLE_GAP) {
+        m_rates = rates;
+        m_hasRates = true;
+    } else {
+        filterRates(rates, dt);
+    }
+    m_lastSampleTime = timestampSec;
+}
+
+void LosStabilizer::filterRates(const BodyRates &raw, double dt)
+{
+    if (!m_hasRates || m_filterTau <= 0.0) {
+        m_rates = raw;
+        m_hasRates = true;
+        return;
+    }
+
+    const double alpha = dt / (m_filterTau + dt);
+    m_rates.rollRate  += alpha * (raw.rollRate  - m_rates.rollRate);
+    m_rates.pitchRate += alpha * (raw.pitchRate - m_rates.pitchRate);
+    m_rates.yawRate   += alpha * (raw.yawRate   - m_rates.yawRate);
+}
+
+bool LosStabilizer::compensation(double gimbalAzDeg, double gimbalElDeg, double nowSec,
+                                 double &azRate, double &elRate) const
+{
+    azRate = 0.0;
+    elRate = 0.0;
+
+    if (!m_hasRates || nowSec - m_lastSampleTime > m_staleTimeout)
+        return false;
+
+    // IMU body (x fwd, y right, z down) -> gimbal base frame (x fwd, y left, z up)
+    const double p = m_rates.rollRate;
+    const double q = -m_rates.pitchRate;
+    const double r = -m_rates.yawRate;
+
+    // Gimbal azimuth is clockwise-positive; the derivation below uses CCW.
+    const double psi = -gimbalAzDeg * DEG_TO_RAD;
+    const double theta = gimbalElDeg * DEG_TO_RAD;
+    const double tanEl = std::clamp(std::tan(theta), -MAX_TAN_ELEVATION, MAX_TAN_ELEVATION);
+
+    // Inertial LOS rate = 0 gives:
+    //   psiDot   = -r + tan(el) * (p cos(psi) + q sin(psi))
+    //   thetaDot =  q cos(psi) - p sin(psi)
+    const double psiDot = -r + tanEl * (p * std::cos(psi) + q * std::sin(psi));
+    const double thetaDot = q * std::cos(psi) - p * std::sin(psi);
+
+    azRate = std::clamp(-psiDot * m_gain, -m_maxRate, m_maxRate);
+    elRate = std::clamp(thetaDot * m_gain, -m_maxRate, m_maxRate);
+    return true;
+}
@@ -0,0 +1,112 @@
+#ifndef LOSSTABILIZER_H
+#define LOSSTABILIZER_H
+
+/**
+ * @file losstabilizer.h
+ * @brief Line-of-sight stabilization: turns IMU base motion into compensating gimbal rates.
+ */
+
+/**
+ * @struct BodyRates
+ * @brief Vehicle angular rates in the IMU body frame (deg/s).
+ *
+ * IMU convention: x forward, y right, z down; roll positive right-wing-down,
+ * pitch positive nose-up, yaw positive clockwise seen from above.
+ */
+struct BodyRates {
+    double rollRate  = 0.0;
+    double pitchRate = 0.0;
+    double yawRate   = 0.0;
+};
+
+/**
+ * @class LosStabilizer
+ * @brief Estimates base-motion rates from IMU samples and computes the az/el rates
+ *        that hold the gimbal line of sight fixed in inertial space.
+ *
+ * Samples are fed at the IMU's native rate; compensation() is queried at the
+ * control-loop rate by GimbalController and injected into the active motion mode.
+ * The class is plain C++ (no Qt types) so it can be exercised offline.
+ *
+ * Gimbal convention matches SystemStateData: azimuth positive clockwise,
+ * elevation positive up.
+ */
+class LosStabilizer
+{
+public:
+    LosStabilizer() = default;
+
+    /**
+     * @brief Feeds an attitude sample (Euler angles, deg). Rates are obtained by
+     *        differentiating successive samples and converted to body rates.
+     * @param timestampSec Monotonic sample time (s).
+     */
+    void addAttitudeSample(double rollDeg, double pitchDeg, double yawDeg, double timestampSec);
+
+    /**
+     * @brief Feeds a body-rate sample (deg/s) from an IMU that outputs rates directly.
+     * @param timestampSec Monotonic sample time (s).
+     */
+    void addBodyRateSample(const BodyRates &rates, double timestampSec);
+
+    /**
+     * @brief Computes the compensating gimbal rates for the current LOS.
+     * @param gimbalAzDeg Current azimuth relative to the vehicle (deg).
+     * @param gimbalElDeg Current elevation relative to the vehicle (deg).
+     * @param nowSec Current monotonic time (s), used to reject stale IMU data.
+     * @param azRate Output azimuth rate (deg/s).
+     * @param elRate Output elevation rate (deg/s).
+     * @return False (and zero rates) if no fresh IMU data is available.
+     */
+    bool compensation(double gimbalAzDeg, double gimbalElDeg, double nowSec,
+                      double &azRate, double &elRate) const;
+
+    /**
+     * @brief Drops all history. The next sample only primes the estimator.
+     */
+    void reset();
+
+    /**
+     * @brief Low-pass time constant applied to the rate estimate (s). 0 disables filtering.
+     */
+    void setFilterTau(double tau) { m_filterTau = tau; }
+
+    /**
+     * @brief Fraction of the estimated base motion that is compensated (0..1).
+     */
+    void setGain(double gain) { m_gain = gain; }
+
+    /**
+     * @brief Maximum compensation rate per axis (deg/s).
+     */
+    void setMaxRate(double maxRate) { m_maxRate = maxRate; }
+
+    /**
+     * @brief Time after the last sample beyond which the estimate is considered stale (s).
+     */
+    void setStaleTimeout(double timeout) { m_staleTimeout = timeout; }
+
+    const BodyRates &bodyRates() const { return m_rates; }
+    bool hasRates() const { return m_hasRates; }
+
+private:
+    void filterRates(const BodyRates &raw, double dt);
+
+    BodyRates m_rates;
+    bool   m_hasRates = false;
+    double m_lastSampleTime = 0.0;
+
+    // Previous attitude sample (for differentiation)
+    bool   m_hasAttitude = false;
+    double m_prevRoll = 0.0;
+    double m_prevPitch = 0.0;
+    double m_prevYaw = 0.0;
+    double m_prevAttitudeTime = 0.0;
+
+    double m_filterTau    = 0.02;
+    double m_gain         = 1.0;
+    double m_maxRate      = 30.0;
+    double m_staleTimeout = 0.25;
+};
+
+#endif // LOSSTABILIZER_H
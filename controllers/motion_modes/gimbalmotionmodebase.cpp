@@ -0,0 +1,36 @@
+#include "gimbalmotionmodebase.h"
+#include "devices/servodriverdevice.h"
+#include <algorithm>
+#include <cmath>
+
+void GimbalMotionModeBase::sendAxisRate(ServoDriverDevice *servo, double degPerSec, double degreesPerStep)
+{
+    if (!servo) return;
+
+    // 1) deg/s -> signed steps/s
+    double stepsPerSecond = 0.0;
+    if (degreesPerStep != 0.0 && std::isfinite(degPerSec)) {
+        stepsPerSecond = degPerSec / degreesPerStep;
+    }
+
+    // 2) clamp speed
+    quint32 speed = static_cast<quint32>(std::lround(std::min(std::fabs(stepsPerSecond),
+                                                              static_cast<double>(MAX_SERVO_SPEED))));
+
+    // 3) split into two 16-bit regs
+    QVector<quint16> speedData;
+    speedData.append(static_cast<quint16>((speed >> 16) & 0xFFFF));
+    speedData.append(static_cast<quint16>(speed & 0xFFFF));
+    servo->writeData(0x0480, speedData);
+
+    // 4) direction
+    QVector<quint16> direction;
+    if (speed == 0) {
+        direction.append(0x0000); // stop
+    } else if (stepsPerSecond > 0) {
+        direction.append(0x4000); // forward
+    } else {
+        direction.append(0x8000); // reverse
+    }
+    servo->writeData(0x007D, direction);
+}
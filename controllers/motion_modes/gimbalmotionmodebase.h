@@ -2,6 +2,7 @@
 #define GIMBALMOTIONMODEBASE_H
 
 #include <QObject>
+#include "devices/servodriverdevice.h" // AZ_/EL_DEGREES_PER_STEP
 
 // Forward declare GimbalController
 class GimbalController;
@@ -21,6 +22,38 @@ public:
 
     // Called periodically (e.g. from GimbalController::update())
     virtual void update(GimbalController* controller) {}
+
+    // Base-motion compensation (deg/s) set by GimbalController before each update()
+    // while stabilization is on; modes add it to their own rate commands.
+    void setStabilizationRates(double azRate, double elRate)
+    {
+        m_stabAzRate = azRate;
+        m_stabElRate = elRate;
+    }
+
+protected:
+    // Servo step scaling: AZ_/EL_DEGREES_PER_STEP (servodriverdevice.h), the
+    // same constants SystemStateModel converts the drive positions with.
+
+    // Speed register limit used by every mode (steps/s)
+    static constexpr quint32 MAX_SERVO_SPEED = 30000;
+
+    // Elevation travel limits shared by all modes (deg)
+    static constexpr double MIN_ELEVATION_ANGLE = -10.0;
+    static constexpr double MAX_ELEVATION_ANGLE = 50.0;
+
+    static double clampElevationAngle(double el)
+    {
+        return el < MIN_ELEVATION_ANGLE ? MIN_ELEVATION_ANGLE
+             : el > MAX_ELEVATION_ANGLE ? MAX_ELEVATION_ANGLE : el;
+    }
+
+    // Sends an axis rate command in deg/s as speed (0x0480) + direction (0x007D).
+    // A zero rate stops the axis.
+    static void sendAxisRate(ServoDriverDevice* servo, double degPerSec, double degreesPerStep);
+
+    double m_stabAzRate = 0.0;
+    double m_stabElRate = 0.0;
 };
 
 
@@ -70,16 +70,13 @@ void ManualMotionMode::update(GimbalController *controller)
     float elInput = data.joystickElValue;
 
     // 8) Evaluate if we should clamp or stop elevation movement
-    const double minElevationAngle = -10.0;
-    const double maxElevationAngle = 50.0;
-
     // If we are pushing up (elInput < 0) but angle >= max or upper sensor is triggered => no upward
-    if ((elevationAngle >= maxElevationAngle || upperLimit) && (elInput < 0)) {
+    if ((elevationAngle >= MAX_ELEVATION_ANGLE || upperLimit) && (elInput < 0)) {
         angularVelocity = 0.0f;
         qDebug() << "[ManualMotionMode] Upper limit reached. Stop upward movement.";
     }
     // If we are pushing down (elInput > 0) but angle <= min or lower sensor => no downward
-    if ((elevationAngle <= minElevationAngle || lowerLimit) && (elInput > 0)) {
+    if ((elevationAngle <= MIN_ELEVATION_ANGLE || lowerLimit) && (elInput > 0)) {
         angularVelocity = 0.0f;
         qDebug() << "[ManualMotionMode] Lower limit reached. Stop downward movement.";
     }
@@ -89,11 +86,30 @@ void ManualMotionMode::update(GimbalController *controller)
     bool useServoDriver = 1;
 
     if (useServoDriver){
-        if (auto azServo = controller->azimuthServo()) {
-            handleServoControl(azServo, azInput, static_cast<quint16>(angularVelocity));
-        }
-        if (auto elServo = controller->elevationServo()) {
-            handleServoControl(elServo, elInput, static_cast<quint16>(angularVelocity));
+        if (m_stabAzRate == 0.0 && m_stabElRate == 0.0) {
+            if (auto azServo = controller->azimuthServo()) {
+                handleServoControl(azServo, azInput, static_cast<quint16>(angularVelocity));
+            }
+            if (auto elServo = controller->elevationServo()) {
+                handleServoControl(elServo, elInput, static_cast<quint16>(angularVelocity));
+            }
+        } else {
+            // Stabilized: operator rate (steps/s -> deg/s) plus base-motion compensation.
+            // Positive elInput drives the axis forward, i.e. down (EL_DEGREES_PER_STEP < 0).
+            double azRate = (azInput > 0 ? 1.0 : azInput < 0 ? -1.0 : 0.0) * angularVelocity * AZ_DEGREES_PER_STEP;
+            double elRate = (elInput > 0 ? 1.0 : elInput < 0 ? -1.0 : 0.0) * angularVelocity * EL_DEGREES_PER_STEP;
+            azRate += m_stabAzRate;
+            elRate += m_stabElRate;
+
+            if ((elevationAngle >= MAX_ELEVATION_ANGLE || upperLimit) && elRate > 0) {
+                elRate = 0.0;
+            }
+            if ((elevationAngle <= MIN_ELEVATION_ANGLE || lowerLimit) && elRate < 0) {
+                elRate = 0.0;
+            }
+
+            sendAxisRate(controller->azimuthServo(), azRate, AZ_DEGREES_PER_STEP);
+            sendAxisRate(controller->elevationServo(), elRate, EL_DEGREES_PER_STEP);
         }
     } else {
         auto plc42 = controller->plc42();
@@ -0,0 +1,188 @@
+#include "patternmotionmode.h"
+#include "../gimbalcontroller.h"
+#include "models/systemstatemodel.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+PatternMotionMode::PatternMotionMode(const ScanPattern &pattern, QObject* parent)
+    : GimbalMotionModeBase(parent)
+    , m_pattern(pattern)
+{
+    // Position correction around the trajectory rate feed-forward
+    PidGains gains;
+    gains.Kp = 2.0;
+    gains.Ki = 0.2;
+    gains.Kv = 1.0;
+    m_azPid.setGains(gains);
+    m_elPid.setGains(gains);
+
+    PidLimits limits;
+    limits.outputMax     = m_pattern.limits.maxVelocity * 1.5;
+    limits.integralMax   = 2.0;
+    limits.slewRate      = m_pattern.limits.maxAcceleration * 2.0;
+    limits.derivativeTau = 0.0;
+    m_azPid.setLimits(limits);
+    m_elPid.setLimits(limits);
+}
+
+void PatternMotionMode::enterMode(GimbalController* controller)
+{
+    qDebug() << "[PatternMotionMode] Enter";
+
+    double startAz = 0.0;
+    double startEl = 0.0;
+    if (controller && controller->systemStateModel()) {
+        SystemStateData data = controller->systemStateModel()->data();
+        startAz = data.gimbalAz;
+        startEl = data.gimbalEl;
+    }
+
+    planTrajectories(startAz, startEl);
+    m_onCycle = false;
+    m_trajectoryTime = 0.0;
+
+    m_azPid.reset();
+    m_elPid.reset();
+    m_updateTimer.start();
+
+    qDebug() << "[PatternMotionMode] Approach" << m_approach.duration() << "s, cycle"
+             << m_cycle.duration() << "s," << m_cycle.segmentCount() << "segments";
+}
+
+void PatternMotionMode::exitMode(GimbalController* controller)
+{
+    qDebug() << "[PatternMotionMode] Exit";
+    stopServos(controller);
+}
+
+void PatternMotionMode::planTrajectories(double startAz, double startEl)
+{
+    const double azOffset = m_pattern.relativeToStart ? startAz : 0.0;
+    const double elOffset = m_pattern.relativeToStart ? startEl : 0.0;
+
+    // 1) Pattern points
+    std::vector<ScanWaypoint> points;
+    switch (m_pattern.type) {
+    case ScanPattern::Type::Sector: {
+        const double el = clampElevationAngle(m_pattern.elMin + elOffset);
+        points.push_back({m_pattern.azMin + azOffset, el, m_pattern.edgeDwell});
+        points.push_back({m_pattern.azMax + azOffset, el, m_pattern.edgeDwell});
+        break;
+    }
+    case ScanPattern::Type::Raster: {
+        const double step = std::max(0.1, std::fabs(m_pattern.rowStep));
+        const double elLow = std::min(m_pattern.elMin, m_pattern.elMax);
+        const double elHigh = std::max(m_pattern.elMin, m_pattern.elMax);
+        bool leftToRight = true;
+        for (double el = elLow; el <= elHigh + 1e-9; el += step) {
+            const double e = clampElevationAngle(el + elOffset);
+            const double a0 = (leftToRight ? m_pattern.azMin : m_pattern.azMax) + azOffset;
+            const double a1 = (leftToRight ? m_pattern.azMax : m_pattern.azMin) + azOffset;
+            points.push_back({a0, e, 0.0});
+            points.push_back({a1, e, m_pattern.edgeDwell});
+            leftToRight = !leftToRight;
+        }
+        break;
+    }
+    case ScanPattern::Type::Waypoints:
+        for (const ScanWaypoint &wp : m_pattern.waypoints) {
+            points.push_back({wp.az + azOffset, clampElevationAngle(wp.el + elOffset), wp.dwell});
+        }
+        break;
+    }
+
+    if (points.empty()) {
+        qWarning() << "[PatternMotionMode] Empty scan pattern";
+        points.push_back({startAz, clampElevationAngle(startEl), 0.0});
+    }
+
+    // 2) Approach: entry position -> first pattern point
+    m_approach.setLimits(m_pattern.limits);
+    m_approach.setStart(startAz, startEl);
+    m_approach.addWaypoint(points.front().az, points.front().el, points.front().dwell);
+
+    // 3) Cycle: first point -> ... -> back to the first point, so it can repeat seamlessly
+    m_cycle.setLimits(m_pattern.limits);
+    m_cycle.setStart(points.front().az, points.front().el);
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        m_cycle.addWaypoint(points[i].az, points[i].el, points[i].dwell);
+    }
+    if (m_pattern.loop) {
+        m_cycle.addWaypoint(points.front().az, points.front().el, points.front().dwell);
+    }
+}
+
+void PatternMotionMode::update(GimbalController* controller)
+{
+    if (!controller || !controller->systemStateModel())
+        return;
+
+    // Measured control period (nominal 50 ms from GimbalController)
+    double dt = m_updateTimer.isValid() ? m_updateTimer.restart() / 1000.0 : 0.05;
+    if (dt <= 0.0 || dt > 0.5)
+        dt = 0.05;
+
+    SystemStateData data = controller->systemStateModel()->data();
+
+    // Safety checks: station enabled and emergency stop must be false
+    if (!data.stationEnabled || data.emergencyStopActive) {
+        stopServos(controller);
+        return;
+    }
+
+    // 1) Reference from the active trajectory
+    const ScanTrajectory &trajectory = m_onCycle ? m_cycle : m_approach;
+    TrajectoryPoint ref = trajectory.sample(m_trajectoryTime);
+
+    // 2) Position feedback correction around the rate feed-forward
+    const double errAz = ref.az - data.gimbalAz;
+    const double errEl = ref.el - data.gimbalEl;
+    double azVelocity = m_azPid.compute(errAz, dt, ref.azRate);
+    double elVelocity = m_elPid.compute(errEl, dt, ref.elRate);
+
+    // 3) Advance time only while the gimbal keeps up, so a stalled axis
+    //    resumes the pattern where it left off instead of jumping ahead
+    if (std::fabs(errAz) < MAX_FOLLOW_ERROR && std::fabs(errEl) < MAX_FOLLOW_ERROR) {
+        m_trajectoryTime += dt;
+    }
+
+    if (m_trajectoryTime >= trajectory.duration()) {
+        if (!m_onCycle) {
+            m_onCycle = true;
+            m_trajectoryTime = 0.0;
+        } else if (m_pattern.loop && m_cycle.duration() > 0.0) {
+            m_trajectoryTime = std::fmod(m_trajectoryTime, m_cycle.duration());
+        } else {
+            m_trajectoryTime = m_cycle.duration(); // hold the final point
+        }
+    }
+
+    // Base-motion compensation from the stabilization layer (0 when off)
+    azVelocity += m_stabAzRate;
+    elVelocity += m_stabElRate;
+
+    // Enforce limits from sensors and defined boundaries
+    if ((data.gimbalEl >= MAX_ELEVATION_ANGLE || data.upperLimitSensorActive) && elVelocity > 0) {
+        elVelocity = 0;
+    }
+    if ((data.gimbalEl <= MIN_ELEVATION_ANGLE || data.lowerLimitSensorActive) && elVelocity < 0) {
+        elVelocity = 0;
+    }
+
+    // Send computed velocity commands to the servo drives
+    sendAxisRate(controller->azimuthServo(), azVelocity, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), elVelocity, EL_DEGREES_PER_STEP);
+}
+
+void PatternMotionMode::stopServos(GimbalController *controller)
+{
+    if (!controller) return;
+
+    m_azPid.reset();
+    m_elPid.reset();
+
+    sendAxisRate(controller->azimuthServo(), 0.0, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), 0.0, EL_DEGREES_PER_STEP);
+}
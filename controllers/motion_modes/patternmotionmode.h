@@ -0,0 +1,92 @@
+#ifndef PATTERNMOTIONMODE_H
+#define PATTERNMOTIONMODE_H
+
+#include "gimbalmotionmodebase.h"
+#include "devices/servodriverdevice.h"
+#include "utils/pidcontroller.h"
+#include "utils/scantrajectory.h"
+
+#include <QElapsedTimer>
+#include <vector>
+
+// Forward declarations
+class GimbalController;
+
+/**
+ * @struct ScanWaypoint
+ * @brief One stop of a waypoint tour.
+ */
+struct ScanWaypoint {
+    double az = 0.0;     ///< deg
+    double el = 0.0;     ///< deg
+    double dwell = 0.0;  ///< s
+};
+
+/**
+ * @struct ScanPattern
+ * @brief Description of the scan executed by PatternMotionMode.
+ */
+struct ScanPattern {
+    enum class Type {
+        Sector,   // az back and forth between azMin/azMax at elMin
+        Raster,   // rows from elMin to elMax, rowStep apart, alternating direction
+        Waypoints // tour through the waypoint list
+    };
+
+    Type type = Type::Sector;
+    bool relativeToStart = true; ///< Angles are offsets from the position at mode entry
+    bool loop = true;            ///< Repeat the pattern until the mode is left
+
+    double azMin = -30.0;
+    double azMax = 30.0;
+    double elMin = 0.0;
+    double elMax = 0.0;
+    double rowStep = 2.0;        ///< Raster row spacing (deg)
+    double edgeDwell = 0.0;      ///< Dwell at sector/raster row ends (s)
+
+    std::vector<ScanWaypoint> waypoints;
+    TrajectoryLimits limits;
+};
+
+/**
+ * @class PatternMotionMode
+ * @brief Executes sector scans, raster scans and waypoint tours.
+ *
+ * The pattern is planned once on entry as a jerk-limited trajectory. Each
+ * update samples the reference and sends its rate as a feed-forward velocity
+ * command, corrected by a position loop on the servo feedback.
+ */
+class PatternMotionMode : public GimbalMotionModeBase
+{
+    Q_OBJECT
+public:
+    explicit PatternMotionMode(const ScanPattern &pattern, QObject* parent = nullptr);
+    ~PatternMotionMode() override = default;
+
+    // Overridden mode functions
+    void enterMode(GimbalController* controller) override;
+    void exitMode(GimbalController* controller) override;
+    void update(GimbalController* controller) override;
+
+private:
+    // Helper functions
+    void stopServos(GimbalController* controller);
+    void planTrajectories(double startAz, double startEl);
+
+    ScanPattern m_pattern;
+
+    ScanTrajectory m_approach; ///< From the entry position to the pattern start
+    ScanTrajectory m_cycle;    ///< One closed pass of the pattern
+    bool m_onCycle = false;
+    double m_trajectoryTime = 0.0;
+
+    PidController m_azPid;
+    PidController m_elPid;
+
+    // Trajectory time is held while the gimbal lags the reference by more than this
+    static constexpr double MAX_FOLLOW_ERROR = 3.0; // deg
+
+    QElapsedTimer m_updateTimer;
+};
+
+#endif // PATTERNMOTIONMODE_H
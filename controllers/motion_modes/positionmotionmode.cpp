@@ -0,0 +1,227 @@
+#include "positionmotionmode.h"
+#include "../gimbalcontroller.h"
+#include "models/systemstatemodel.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+PositionMotionMode::PositionMotionMode(double targetAz, double targetEl, QObject* parent)
+    : GimbalMotionModeBase(parent)
+    , m_targetAz(targetAz)
+    , m_targetEl(clampElevationAngle(targetEl))
+{
+    // Position correction around the profile rate feed-forward (streamed moves)
+    PidGains gains;
+    gains.Kp = 2.0;
+    gains.Ki = 0.3;
+    gains.Kv = 1.0;
+    m_azPid.setGains(gains);
+    m_elPid.setGains(gains);
+
+    PidLimits limits;
+    limits.outputMax   = MAX_VELOCITY;
+    limits.integralMax = 2.0;
+    limits.slewRate    = MAX_ACCELERATION * 2.0;
+    m_azPid.setLimits(limits);
+    m_elPid.setLimits(limits);
+}
+
+void PositionMotionMode::enterMode(GimbalController* controller)
+{
+    qDebug() << "[PositionMotionMode] Enter, target" << m_targetAz << m_targetEl;
+    m_planned = false;
+    m_driveExecuting = false;
+    m_arrived = false;
+    m_aborted = false;
+    m_azPid.reset();
+    m_elPid.reset();
+    m_updateTimer.start();
+
+    if (controller && controller->systemStateModel()) {
+        planMove(controller, controller->systemStateModel()->data());
+    }
+}
+
+void PositionMotionMode::exitMode(GimbalController* controller)
+{
+    qDebug() << "[PositionMotionMode] Exit";
+    stopServos(controller);
+}
+
+void PositionMotionMode::setTarget(double az, double el)
+{
+    m_targetAz = az;
+    m_targetEl = clampElevationAngle(el);
+    m_planned = false;   // replanned from the current position on the next update
+    m_arrived = false;
+    m_aborted = false;
+    qDebug() << "[PositionMotionMode] New target" << m_targetAz << m_targetEl;
+}
+
+void PositionMotionMode::planMove(GimbalController* controller, const SystemStateData& data)
+{
+    m_startAz = data.gimbalAz;
+    m_startEl = data.gimbalEl;
+    m_moveTime = 0.0;
+
+    // 1) Time-optimal profile per axis, then synchronise arrival
+    m_azProfile.plan(m_targetAz - m_startAz, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+    m_elProfile.plan(m_targetEl - m_startEl, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+    const double duration = std::max(m_azProfile.duration(), m_elProfile.duration());
+    m_azProfile.stretchTo(duration);
+    m_elProfile.stretchTo(duration);
+    m_planned = true;
+
+    // 2) Prefer the drives' internal position mode: one write per axis, no
+    //    per-cycle command round trips while the move runs
+    ServoDriverDevice* az = controller->azimuthServo();
+    ServoDriverDevice* el = controller->elevationServo();
+    m_driveExecuting = false;
+    if (az && el && az->directPositioningSupported() && el->directPositioningSupported()) {
+        auto toSteps = [](double deg, double degPerStep) {
+            return static_cast<qint32>(std::lround(deg / degPerStep));
+        };
+        auto rateToSteps = [](double degPerSec, double degPerStep) {
+            // speed in steps/s, rates in 0.001 kHz/s == steps/s^2
+            return static_cast<quint32>(std::lround(std::fabs(degPerSec / degPerStep)));
+        };
+
+        const quint32 azSpeed = std::min(rateToSteps(m_azProfile.peakVelocity(), AZ_DEGREES_PER_STEP), MAX_SERVO_SPEED);
+        const quint32 elSpeed = std::min(rateToSteps(m_elProfile.peakVelocity(), EL_DEGREES_PER_STEP), MAX_SERVO_SPEED);
+        const quint32 azAccel = rateToSteps(m_azProfile.peakAcceleration(), AZ_DEGREES_PER_STEP);
+        const quint32 elAccel = rateToSteps(m_elProfile.peakAcceleration(), EL_DEGREES_PER_STEP);
+
+        const bool azOk = az->moveToPosition(toSteps(m_targetAz, AZ_DEGREES_PER_STEP),
+                                             std::max<quint32>(azSpeed, 1), std::max<quint32>(azAccel, 1),
+                                             std::max<quint32>(azAccel, 1));
+        const bool elOk = el->moveToPosition(toSteps(m_targetEl, EL_DEGREES_PER_STEP),
+                                             std::max<quint32>(elSpeed, 1), std::max<quint32>(elAccel, 1),
+                                             std::max<quint32>(elAccel, 1));
+        m_driveExecuting = azOk && elOk;
+        if (!m_driveExecuting && (azOk || elOk)) {
+            // Never leave one axis running its own move while the other is streamed
+            az->stopMotion();
+            el->stopMotion();
+        }
+    }
+
+    qDebug() << "[PositionMotionMode] Move" << m_startAz << m_startEl << "->" << m_targetAz << m_targetEl
+             << "in" << duration << "s" << (m_driveExecuting ? "(drive positioning)" : "(streamed)");
+}
+
+void PositionMotionMode::update(GimbalController* controller)
+{
+    if (!controller || !controller->systemStateModel())
+        return;
+
+    // Measured control period (nominal 50 ms from GimbalController)
+    double dt = m_updateTimer.isValid() ? m_updateTimer.restart() / 1000.0 : 0.05;
+    if (dt <= 0.0 || dt > 0.5)
+        dt = 0.05;
+
+    SystemStateData data = controller->systemStateModel()->data();
+
+    // An aborted move stays stopped until a new target is commanded
+    if (m_aborted)
+        return;
+
+    // Safety checks: station enabled and emergency stop must be false
+    if (!data.stationEnabled || data.emergencyStopActive) {
+        qWarning() << "[PositionMotionMode] Station disabled or emergency stop, move aborted";
+        abortMove(controller);
+        return;
+    }
+
+    const double errAz = m_targetAz - data.gimbalAz;
+    const double errEl = m_targetEl - data.gimbalEl;
+
+    // Limit sensors override any move that pushes further into them
+    if ((data.upperLimitSensorActive && errEl > 0.0) || (data.lowerLimitSensorActive && errEl < 0.0)) {
+        qWarning() << "[PositionMotionMode] Elevation limit sensor active, move aborted";
+        abortMove(controller);
+        return;
+    }
+
+    if (!m_planned) {
+        planMove(controller, data);
+    }
+
+    m_moveTime += dt;
+
+    if (!m_arrived && std::fabs(errAz) < ARRIVAL_TOLERANCE && std::fabs(errEl) < ARRIVAL_TOLERANCE) {
+        m_arrived = true;
+        qDebug() << "[PositionMotionMode] Target reached in" << m_moveTime << "s";
+        emit slewCompleted(m_targetAz, m_targetEl);
+    }
+
+    if (m_driveExecuting) {
+        // The drives run the profile and hold the target; only supervise
+        const double duration = std::max(m_azProfile.duration(), m_elProfile.duration());
+        if (!m_arrived && m_moveTime > duration + DRIVE_TIMEOUT_MARGIN) {
+            qWarning() << "[PositionMotionMode] Drive positioning did not converge, streaming the move";
+            controller->azimuthServo()->stopMotion();
+            controller->elevationServo()->stopMotion();
+            m_driveExecuting = false;
+            m_startAz = data.gimbalAz;
+            m_startEl = data.gimbalEl;
+            m_azProfile.plan(m_targetAz - m_startAz, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+            m_elProfile.plan(m_targetEl - m_startEl, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+            const double d = std::max(m_azProfile.duration(), m_elProfile.duration());
+            m_azProfile.stretchTo(d);
+            m_elProfile.stretchTo(d);
+            m_moveTime = 0.0;
+        }
+        return;
+    }
+
+    // Streamed move: profile reference + position correction, then hold at target
+    const ProfileState az = m_azProfile.sample(m_moveTime);
+    const ProfileState el = m_elProfile.sample(m_moveTime);
+    const double refAz = m_startAz + az.position;
+    const double refEl = m_startEl + el.position;
+
+    double azVelocity = m_azPid.compute(refAz - data.gimbalAz, dt, az.velocity);
+    double elVelocity = m_elPid.compute(refEl - data.gimbalEl, dt, el.velocity);
+
+    // Base-motion compensation from the stabilization layer (0 when off)
+    azVelocity += m_stabAzRate;
+    elVelocity += m_stabElRate;
+
+    if (data.gimbalEl >= MAX_ELEVATION_ANGLE && elVelocity > 0) {
+        elVelocity = 0;
+    }
+    if (data.gimbalEl <= MIN_ELEVATION_ANGLE && elVelocity < 0) {
+        elVelocity = 0;
+    }
+
+    sendAxisRate(controller->azimuthServo(), azVelocity, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), elVelocity, EL_DEGREES_PER_STEP);
+}
+
+void PositionMotionMode::abortMove(GimbalController* controller)
+{
+    stopServos(controller);
+    m_planned = false;   // a new target is replanned from wherever the turret stopped
+    m_aborted = true;
+    emit slewAborted();
+}
+
+void PositionMotionMode::stopServos(GimbalController *controller)
+{
+    if (!controller) return;
+
+    m_azPid.reset();
+    m_elPid.reset();
+
+    if (m_driveExecuting) {
+        if (auto azServo = controller->azimuthServo())
+            azServo->stopMotion();
+        if (auto elServo = controller->elevationServo())
+            elServo->stopMotion();
+        m_driveExecuting = false;
+        return;
+    }
+
+    sendAxisRate(controller->azimuthServo(), 0.0, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), 0.0, EL_DEGREES_PER_STEP);
+}
@@ -0,0 +1,91 @@
+#ifndef POSITIONMOTIONMODE_H
+#define POSITIONMOTIONMODE_H
+
+#include "gimbalmotionmodebase.h"
+#include "devices/servodriverdevice.h"
+#include "utils/motionprofile.h"
+#include "utils/pidcontroller.h"
+
+#include <QElapsedTimer>
+
+// Forward declarations
+class GimbalController;
+struct SystemStateData;
+
+/**
+ * @class PositionMotionMode
+ * @brief Slews the turret to a commanded az/el (home, preset, external cue).
+ *
+ * Each axis gets a time-optimal S-curve profile and the faster axis is
+ * stretched so both arrive together. The target elevation is clamped to the
+ * travel limits. When both drives support direct positioning the move is
+ * handed to the drives (one Modbus write per axis) and the mode only
+ * supervises it; otherwise the profile is streamed as velocity commands with
+ * position feedback correction, as in PatternMotionMode.
+ *
+ * An E-stop, a disabled station or a limit sensor in the direction of travel
+ * aborts the move for good: the mode holds and emits slewAborted(), and only
+ * setTarget() starts a new move.
+ */
+class PositionMotionMode : public GimbalMotionModeBase
+{
+    Q_OBJECT
+public:
+    explicit PositionMotionMode(double targetAz, double targetEl, QObject* parent = nullptr);
+    ~PositionMotionMode() override = default;
+
+    // Overridden mode functions
+    void enterMode(GimbalController* controller) override;
+    void exitMode(GimbalController* controller) override;
+    void update(GimbalController* controller) override;
+
+    /**
+     * @brief Retargets the slew; the move is replanned from the current position.
+     * Also the only way to restart an aborted slew.
+     */
+    void setTarget(double az, double el);
+
+    double targetAz() const { return m_targetAz; }
+    double targetEl() const { return m_targetEl; }
+    bool hasArrived() const { return m_arrived; }
+    bool isAborted() const { return m_aborted; }
+
+signals:
+    void slewCompleted(double az, double el);
+    void slewAborted();
+
+private:
+    // Helper functions
+    void planMove(GimbalController* controller, const SystemStateData& data);
+    void stopServos(GimbalController* controller);
+    void abortMove(GimbalController* controller);
+
+    double m_targetAz = 0.0;
+    double m_targetEl = 0.0;
+
+    double m_startAz = 0.0;
+    double m_startEl = 0.0;
+    SCurveProfile m_azProfile;
+    SCurveProfile m_elProfile;
+    double m_moveTime = 0.0;
+
+    bool m_planned = false;         ///< Profiles valid for the current target
+    bool m_driveExecuting = false;  ///< Move delegated to the drives' position mode
+    bool m_arrived = false;
+    bool m_aborted = false;         ///< Stopped by E-stop/limit; cleared by setTarget() only
+
+    PidController m_azPid;
+    PidController m_elPid;
+
+    QElapsedTimer m_updateTimer;
+
+    // Slew limits
+    static constexpr double MAX_VELOCITY = 30.0;       // deg/s
+    static constexpr double MAX_ACCELERATION = 60.0;   // deg/s^2
+    static constexpr double MAX_JERK = 300.0;          // deg/s^3
+    static constexpr double ARRIVAL_TOLERANCE = 0.1;   // deg
+    // Extra time granted to a drive-executed move before falling back to streaming
+    static constexpr double DRIVE_TIMEOUT_MARGIN = 2.0; // s
+};
+
+#endif // POSITIONMOTIONMODE_H
@@ -1,15 +1,16 @@
 #include "trackingmotionmode.h"
 #include "../gimbalcontroller.h"
 #include "models/systemstatemodel.h" // m_stateModel if needed
+#include "utils/latencymonitor.h"
 #include <QDebug>
 #include <QtGlobal> // for qBound
 
 TrackingMotionMode::TrackingMotionMode(QObject* parent)
     : GimbalMotionModeBase(parent)
+    , m_gainSchedule(defaultGainSchedule())
 {
-    // Initialize PID gains as needed
-    m_azPid.Kp = 0.5;
-    m_elPid.Kp = 0.5;
+    m_azPid.setLimits(defaultLimits());
+    m_elPid.setLimits(defaultLimits());
 }
 
 void TrackingMotionMode::enterMode(GimbalController* controller)
@@ -19,12 +20,16 @@ void TrackingMotionMode::enterMode(GimbalController* controller)
     m_targetEl = 0.0;
     m_targetValid = false;
     m_lostCounter = 0;
+    m_targetAzRate = 0.0;
+    m_targetElRate = 0.0;
+    m_targetTimer.invalidate();
 
-    if (controller) {
-        // Example: Connect to the camera's tracking signal if available
-        // connect(controller->cameraSystem(), &CameraSystem::targetPositionUpdated,
-        //         this, &TrackingMotionMode::onTargetPositionUpdated);
-    }
+    m_azPid.reset();
+    m_elPid.reset();
+    m_updateTimer.start();
+
+    // Target updates arrive through GimbalController::onTargetPositionUpdated
+    Q_UNUSED(controller);
 }
 
 void TrackingMotionMode::exitMode(GimbalController* controller)
@@ -38,6 +43,11 @@ void TrackingMotionMode::update(GimbalController* controller)
     if (!controller || !controller->systemStateModel())
         return;
 
+    // Measured control period (nominal 50 ms from GimbalController)
+    double dt = m_updateTimer.isValid() ? m_updateTimer.restart() / 1000.0 : 0.05;
+    if (dt <= 0.0 || dt > 0.5)
+        dt = 0.05;
+
     SystemStateData data = controller->systemStateModel()->data();
 
     // Safety checks: station enabled and emergency stop must be false
@@ -46,50 +56,85 @@ void TrackingMotionMode::update(GimbalController* controller)
         return;
     }
 
+    // A track that stopped reporting is no longer followed
+    if (m_targetValid && m_targetTimer.elapsed() > TARGET_TIMEOUT_MS) {
+        qDebug() << "[TrackingMotionMode] Target update timeout, holding position";
+        m_targetValid = false;
+        ++m_lostCounter;
+    }
+
     // If the target is not valid, stop movement
     if (!m_targetValid) {
         stopServos(controller);
         return;
     }
 
-    // Calculate errors between current state and target position
+    // Schedule gains on the active camera field of view
+    const double hfov = data.activeCameraIsDay ? data.dayCurrentHFOV : data.nightCurrentHFOV;
+    const PidGains gains = m_gainSchedule.gainsFor(hfov);
+    m_azPid.setGains(gains);
+    m_elPid.setGains(gains);
+
+    // Calculate errors between current state and target position (absolute
+    // angles, see GimbalController::onTargetPositionUpdated). With a valid
+    // lead solution the gimbal aims ahead of the target (offset aim).
     double currentAz = data.gimbalAz;
     double currentEl = data.gimbalEl;
-    double errAz = m_targetAz - currentAz;
-    double errEl = m_targetEl - currentEl;
-
-    // Compute control signals using a simple PID (P-only here)
-    double azVelocity = pidCompute(m_azPid, errAz, 0.05); // dt assumed 0.05 s
-    double elVelocity = pidCompute(m_elPid, errEl, 0.05);
+    double aimAz = m_targetAz;
+    double aimEl = m_targetEl;
+    if (data.leadAngleValid) {
+        aimAz += data.leadAzDeg;
+        aimEl += data.leadElDeg;
+    }
+    double errAz = aimAz - currentAz;
+    double errEl = aimEl - currentEl;
 
-    // Clamp the velocities to safe limits (e.g., ±30 deg/s)
-    azVelocity = qBound(-30.0, azVelocity, 30.0);
-    elVelocity = qBound(-30.0, elVelocity, 30.0);
+    // PID + target-rate feed-forward; output clamped to ±30 deg/s and slew limited
+    double azVelocity = m_azPid.compute(errAz, dt, m_targetAzRate);
+    double elVelocity = m_elPid.compute(errEl, dt, m_targetElRate);
 
-    const double minElevationAngle = -10.0;
-    const double maxElevationAngle = 50.0;
+    // Base-motion compensation from the stabilization layer (0 when off)
+    azVelocity += m_stabAzRate;
+    elVelocity += m_stabElRate;
 
     // Enforce limits from sensors and defined boundaries
-    if ((currentEl >= maxElevationAngle && elVelocity > 0) ||
+    if ((currentEl >= MAX_ELEVATION_ANGLE && elVelocity > 0) ||
         data.upperLimitSensorActive)
     {
         elVelocity = 0;
+        m_elPid.reset();
     }
-    if ((currentEl <= minElevationAngle && elVelocity < 0) ||
+    if ((currentEl <= MIN_ELEVATION_ANGLE && elVelocity < 0) ||
         data.lowerLimitSensorActive)
     {
         elVelocity = 0;
+        m_elPid.reset();
     }
 
     // Send computed velocity commands to the servo drives
-    //if (controller->azimuthServo())
-       // controller->azimuthServo()->setVelocity(azVelocity);
-    //if (controller->elevationServo())
-        //controller->elevationServo()->setVelocity(elVelocity);
+    sendAxisRate(controller->azimuthServo(), azVelocity, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), elVelocity, EL_DEGREES_PER_STEP);
+
+    // Age of the newest tracked frame when its correction reaches the drives
+    LatencyMonitor::instance().markServoCommand();
 }
 
 void TrackingMotionMode::onTargetPositionUpdated(double az, double el)
 {
+    // Estimate target angular rate from successive updates (low-pass filtered)
+    if (m_targetValid && m_targetTimer.isValid()) {
+        const double dt = m_targetTimer.restart() / 1000.0;
+        if (dt > 0.0 && dt < 0.5) {
+            const double alpha = 0.3;
+            m_targetAzRate += alpha * ((az - m_targetAz) / dt - m_targetAzRate);
+            m_targetElRate += alpha * ((el - m_targetEl) / dt - m_targetElRate);
+        }
+    } else {
+        m_targetTimer.start();
+        m_targetAzRate = 0.0;
+        m_targetElRate = 0.0;
+    }
+
     m_targetAz = az;
     m_targetEl = el;
     m_targetValid = true;
@@ -101,67 +146,9 @@ void TrackingMotionMode::stopServos(GimbalController *controller)
 {
     if (!controller) return;
 
-    if (auto azServo = controller->azimuthServo()) {
-        handleServoControl(azServo, 0, 0);
-    }
-    if (auto elServo = controller->elevationServo()) {
-        handleServoControl(elServo, 0, 0);
-    }
-}
-
-double TrackingMotionMode::pidCompute(PID &pid, double error, double dt)
-{
-    // A simple proportional controller is implemented here.
-    // You may expand this function to include integral and derivative terms.
-    double output = pid.Kp * error;
-    return output;
-}
+    m_azPid.reset();
+    m_elPid.reset();
 
-void TrackingMotionMode::handleServoControl(ServoDriverDevice *driverInterface, int joystickInput, quint16 angularVelocity)
-{
-    if (!driverInterface) return;
-
-    // 1) set acceleration
-    setAcceleration(driverInterface, 100000);
-
-    // 2) clamp speed
-    quint32 maxSpeed = 30000;
-    quint32 clampedVelocity = std::min(static_cast<quint32>(angularVelocity), maxSpeed);
-
-    // 3) split into two 16‐bit regs
-    quint16 upperBits = static_cast<quint16>((clampedVelocity >> 16) & 0xFFFF);
-    quint16 lowerBits = static_cast<quint16>(clampedVelocity & 0xFFFF);
-
-    QVector<quint16> speedData;
-    speedData.append(upperBits);
-    speedData.append(lowerBits);
-    driverInterface->writeData(0x0480, speedData);
-
-    // 4) direction
-    QVector<quint16> data;
-    if (joystickInput > 0) {
-        data.append(0x4000); // forward
-    } else if (joystickInput < 0) {
-        data.append(0x8000); // reverse
-    } else {
-        data.append(0x0000); // stop
-    }
-    driverInterface->writeData(0x007D, data);
-}
-
-void TrackingMotionMode::setAcceleration(ServoDriverDevice *driverInterface, quint32 acceleration)
-{
-    if (!driverInterface) return;
-    quint32 maxAccel = 1000000000;
-    quint32 clamped = std::min(acceleration, maxAccel);
-
-    quint16 upper = static_cast<quint16>((clamped >> 16) & 0xFFFF);
-    quint16 lower = static_cast<quint16>(clamped & 0xFFFF);
-
-    QVector<quint16> accelData;
-    accelData.append(upper);
-    accelData.append(lower);
-    // driverInterface->writeData(0x0676, accelData);
-    // driverInterface->writeData(0x0677, accelData);
-    // etc. based on your servo map
+    sendAxisRate(controller->azimuthServo(), 0.0, AZ_DEGREES_PER_STEP);
+    sendAxisRate(controller->elevationServo(), 0.0, EL_DEGREES_PER_STEP);
 }
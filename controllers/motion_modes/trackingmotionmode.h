@@ -4,6 +4,9 @@
 #include "gimbalmotionmodebase.h"
 #include "devices/servodriverdevice.h"
 #include "devices/plc42device.h"
+#include "utils/pidcontroller.h"
+
+#include <QElapsedTimer>
 
 // Forward declarations
 class GimbalController;
@@ -21,35 +24,62 @@ public:
     void exitMode(GimbalController* controller) override;
     void update(GimbalController* controller) override;
 
+    /**
+     * @brief Gains of both axes by camera HFOV (also held to step-response
+     *        limits in bench_control).
+     */
+    static GainSchedule<4> defaultGainSchedule()
+    {
+        // Narrow FOV means small pixel errors are small angles, so the loop can
+        // run stiffer without amplifying tracker noise.
+        GainSchedule<4> schedule;
+        //                   Kp    Ki    Kd    Kv    Ka
+        schedule.addPoint( 2.0, {1.20, 0.30, 0.04, 1.0, 0.0});
+        schedule.addPoint(10.0, {0.90, 0.20, 0.03, 1.0, 0.0});
+        schedule.addPoint(30.0, {0.70, 0.10, 0.02, 0.9, 0.0});
+        schedule.addPoint(60.0, {0.50, 0.05, 0.00, 0.8, 0.0});
+        return schedule;
+    }
+
+    static PidLimits defaultLimits()
+    {
+        PidLimits limits;
+        limits.outputMax     = 30.0;  // deg/s, previous hard clamp
+        limits.integralMax   = 5.0;   // deg/s
+        limits.slewRate      = 120.0; // deg/s^2
+        limits.derivativeTau = 0.1;   // s
+        return limits;
+    }
+
 public slots:
+    /**
+     * @brief New target observation as absolute gimbal angles (deg).
+     * The target is dropped if no update arrives within TARGET_TIMEOUT_MS.
+     */
     void onTargetPositionUpdated(double az, double el);
 
 private:
     // Helper functions
     void stopServos(GimbalController* controller);
-    ///double pidCompute(struct PID &pid, double error, double dt);
-
-    // Simple PID structure for azimuth and elevation
-    struct PID {
-        double Kp = 0.0;
-        double Ki = 0.0;
-        double Kd = 0.0;
-        double integral = 0.0;
-        double previousError = 0.0;
-    };
 
-    PID m_azPid;
-    PID m_elPid;
+    // Per-axis PID + feed-forward, gains scheduled by the active camera HFOV
+    PidController m_azPid;
+    PidController m_elPid;
+    GainSchedule<4> m_gainSchedule;
 
     double m_targetAz = 0.0;
     double m_targetEl = 0.0;
     bool m_targetValid = false;
     int m_lostCounter = 0;
+    static constexpr qint64 TARGET_TIMEOUT_MS = 250; ///< Max age of the last target update.
 
-    double pidCompute(struct PID &pid, double error, double dt);
+    // Target angular rate estimate (deg/s), used as velocity feed-forward
+    double m_targetAzRate = 0.0;
+    double m_targetElRate = 0.0;
+    QElapsedTimer m_targetTimer;
 
-    void setAcceleration(ServoDriverDevice *driverInterface, quint32 acceleration);
-    void handleServoControl(ServoDriverDevice *driverInterface, int joystickInput, quint16 angularVelocity);
+    // Control period measurement
+    QElapsedTimer m_updateTimer;
 };
 
 #endif // TRACKINGMOTIONMODE_H
@@ -0,0 +1,65 @@
+#include "safetyinterlock.h"
+#include "devices/plc42device.h"
+#include "devices/servodriverdevice.h"
+#include "utils/metricsregistry.h"
+#include "utils/trace.h"
+#include <QDebug>
+
+SafetyInterlock::SafetyInterlock(Plc42Device *plc42, ServoDriverDevice *azServo, ServoDriverDevice *elServo,
+                                 QObject *parent)
+    : QObject(parent)
+    , m_plc42(plc42)
+    , m_azServo(azServo)
+    , m_elServo(elServo)
+{
+    m_stopLatency = MetricsRegistry::instance().histogram(
+        QStringLiteral("el7aress_estop_stop_latency_seconds"),
+        QStringLiteral("E-stop edge seen on the PLC until both servo drives acknowledged STOP"));
+
+    if (m_plc42)
+        connect(m_plc42, &Plc42Device::safetyEventsAvailable, this, &SafetyInterlock::drain);
+    for (ServoDriverDevice *servo : {m_azServo, m_elServo}) {
+        if (servo)
+            connect(servo, &ServoDriverDevice::stopAcknowledged, this, &SafetyInterlock::onStopAcknowledged);
+    }
+}
+
+void SafetyInterlock::drain()
+{
+    if (!m_plc42)
+        return;
+
+    SafetyInputEvent event;
+    while (m_plc42->popSafetyEvent(event)) {
+        if (event.input != SafetyInput::EmergencyStop) {
+            // Both limit sensors are on the elevation axis
+            if (event.active && !m_emergencyStop && m_elServo) {
+                qWarning() << "SafetyInterlock: elevation limit sensor, stopping elevation axis";
+                m_elServo->stopMotion();
+            }
+            continue;
+        }
+        if (event.active == m_emergencyStop)
+            continue;
+
+        m_emergencyStop = event.active;
+        if (m_emergencyStop) {
+            TRACE_INSTANT("control", "estop");
+            qWarning() << "SafetyInterlock: emergency stop, stopping both axes";
+            m_stopDetectedUs = event.timestampUs;
+            m_stopAcksPending = 0;
+            for (ServoDriverDevice *servo : {m_azServo, m_elServo}) {
+                if (servo && servo->stopMotion())
+                    ++m_stopAcksPending;
+            }
+        }
+    }
+}
+
+void SafetyInterlock::onStopAcknowledged()
+{
+    if (m_stopAcksPending <= 0)
+        return;
+    if (--m_stopAcksPending == 0)
+        m_stopLatency->record(LatencyMonitor::nowUs() - m_stopDetectedUs);
+}
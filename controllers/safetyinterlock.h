@@ -0,0 +1,55 @@
+#ifndef SAFETYINTERLOCK_H
+#define SAFETYINTERLOCK_H
+
+/**
+ * @file safetyinterlock.h
+ * @brief Reaction of the control loop to the PLC42 safety inputs.
+ */
+
+#include <QObject>
+#include "utils/safetyinputs.h"
+
+class Plc42Device;
+class ServoDriverDevice;
+class MetricHistogram;
+
+/**
+ * @class SafetyInterlock
+ * @brief Drains the safety edge queue of Plc42Device and stops both servo
+ *        drives on an E-stop edge, and the elevation drive on a limit sensor
+ *        edge, without waiting for the state model.
+ *
+ * The motion modes still see emergencyStopActive and the limit sensors
+ * through SystemStateModel and hold the axes while they are active; the
+ * interlock only cuts the time to the first STOP command.
+ *
+ * Metric: el7aress_estop_stop_latency_seconds, from the PLC reply that
+ * showed the E-stop edge until both drives acknowledged STOP.
+ */
+class SafetyInterlock : public QObject
+{
+    Q_OBJECT
+public:
+    SafetyInterlock(Plc42Device *plc42, ServoDriverDevice *azServo, ServoDriverDevice *elServo,
+                    QObject *parent = nullptr);
+
+    bool emergencyStopActive() const { return m_emergencyStop; }
+
+public slots:
+    /** @brief Handles all queued edges; also called from the control loop. */
+    void drain();
+
+private:
+    void onStopAcknowledged();
+
+    Plc42Device *m_plc42 = nullptr;
+    ServoDriverDevice *m_azServo = nullptr;
+    ServoDriverDevice *m_elServo = nullptr;
+
+    bool m_emergencyStop = false;
+    qint64 m_stopDetectedUs = 0; ///< Edge timestamp of the stop in progress.
+    int m_stopAcksPending = 0;   ///< Drives that have not acknowledged STOP yet.
+    MetricHistogram *m_stopLatency = nullptr;
+};
+
+#endif // SAFETYINTERLOCK_H
@@ -4,6 +4,7 @@
 #include "devices/plc42device.h"
 #include "weaponcontroller.h"
 #include <QDebug>
+#include <QTimer>
 
 WeaponController::WeaponController(SystemStateModel* m_stateModel,
                                    ServoActuatorDevice* servoActuator,
@@ -19,6 +20,75 @@ WeaponController::WeaponController(SystemStateModel* m_stateModel,
                 this, &WeaponController::onSystemStateChanged);
     }
 
+    m_leadClock.start();
+
+    // The lead is published from its own timer, never from inside the
+    // dataChanged fan-out it would otherwise re-enter
+    m_leadTimer = new QTimer(this);
+    connect(m_leadTimer, &QTimer::timeout, this, &WeaponController::refreshLead);
+    m_leadTimer->start(LEAD_UPDATE_MS);
+
+    qRegisterMetaType<BallisticTablePtr>("BallisticTablePtr");
+    setAmmunitionProfile(AmmunitionProfile::m33Ball());
+}
+
+void WeaponController::onTargetObservation(double offsetAzDeg, double offsetElDeg)
+{
+    m_leadComputer.addObservation(offsetAzDeg, offsetElDeg, m_leadClock.elapsed() / 1000.0);
+}
+
+void WeaponController::refreshLead()
+{
+    if (!m_stateModel)
+        return;
+
+    // Refresh the lead while tracking; expire a published one otherwise
+    const SystemStateData data = m_stateModel->data();
+    if (data.trackingActive)
+        updateLead(data);
+    else if (data.leadAngleValid)
+        m_stateModel->setLeadSolution(false, 0.0, 0.0, 0.0);
+}
+
+void WeaponController::setCameraCalibrations(CameraCalibrationPtr day, CameraCalibrationPtr night)
+{
+    m_dayCalibration = std::move(day);
+    m_nightCalibration = std::move(night);
+}
+
+void WeaponController::updateLead(const SystemStateData &data)
+{
+    // Range from the LRF; without a reading, lead is computed for the battle-sight range
+    const double DEFAULT_RANGE = 500.0;
+    const double range = data.lrfDistance > 0.0 ? data.lrfDistance : DEFAULT_RANGE;
+
+    // OSD scale of the active camera, from its calibration
+    const CameraCalibrationPtr &cal = data.activeCameraIsDay ? m_dayCalibration : m_nightCalibration;
+    const double zoom = data.activeCameraIsDay ? data.dayZoomPosition : data.nightZoomPosition;
+    const double hfov = data.activeCameraIsDay ? data.dayCurrentHFOV : data.nightCurrentHFOV;
+    const CameraModel model = cal ? cal->modelAt(zoom, hfov) : CameraModel::fromHfov(hfov, 960, 720);
+    const double pixelsPerDegree = model.pixelsPerDegree();
+
+    m_leadSolution = m_leadComputer.solve(range, m_ballisticTable.get(), pixelsPerDegree,
+                                          m_leadClock.elapsed() / 1000.0);
+    m_stateModel->setLeadSolution(m_leadSolution.valid, m_leadSolution.azDeg,
+                                  m_leadSolution.elDeg, m_leadSolution.timeOfFlight);
+}
+
+bool WeaponController::setAmmunitionProfile(const AmmunitionProfile &profile)
+{
+    BallisticTablePtr table = BallisticTable::build(profile);
+    if (!table) {
+        qWarning() << "Invalid ammunition profile" << QString::fromStdString(profile.name);
+        return false;
+    }
+
+    m_ammoProfile = profile;
+    m_ballisticTable = table;
+    qDebug() << "Ballistic table for" << QString::fromStdString(profile.name)
+             << "built in" << table->buildTimeMs() << "ms, up to" << table->maxRange() << "m";
+    emit ballisticTableChanged(m_ballisticTable);
+    return true;
 }
 
 void WeaponController::onSystemStateChanged(const SystemStateData &newData)
@@ -61,6 +131,14 @@ void WeaponController::onSystemStateChanged(const SystemStateData &newData)
         }
     }
 
+    // Lead: gimbal feedback for the target rate estimate; drop the track with the tracker
+    if (!qFuzzyCompare(m_oldState.gimbalAz + 1.0, newData.gimbalAz + 1.0) ||
+        !qFuzzyCompare(m_oldState.gimbalEl + 1.0, newData.gimbalEl + 1.0)) {
+        m_leadComputer.addGimbalSample(newData.gimbalAz, newData.gimbalEl, m_leadClock.elapsed() / 1000.0);
+    }
+    if (m_oldState.trackingActive && !newData.trackingActive)
+        m_leadComputer.reset();
+
     // Verify that all conditions are met for arming the system.
     if (newData.opMode == OperationalMode::Engagement &&
         newData.gunArmed &&
@@ -2,13 +2,18 @@
 #define WEAPONCONTROLLER_H
 
 #include <QObject>
+#include <QElapsedTimer>
 
 
+class QTimer;
 class Plc42Device;
 class ServoActuatorDevice;
 class SystemStateModel;
 
 #include "models/systemstatemodel.h"
+#include "utils/ballistics.h"
+#include "controllers/leadcomputer.h"
+#include "utils/cameracalibration.h"
 
 enum class AmmoState {
     Idle,
@@ -40,15 +45,30 @@ public:
     void stopFiring();
     void unloadAmmo();
 
+    // Ballistics: the firing table is rebuilt whenever the profile changes
+    bool setAmmunitionProfile(const AmmunitionProfile &profile);
+    const AmmunitionProfile &ammunitionProfile() const { return m_ammoProfile; }
+    BallisticTablePtr ballisticTable() const { return m_ballisticTable; }
+
+    // Automatic lead from the tracked target's angular velocity
+    const LeadSolution &leadSolution() const { return m_leadSolution; }
+    void setCameraCalibrations(CameraCalibrationPtr day, CameraCalibrationPtr night);
+
+public slots:
+    // Tracker observation: target offset from the boresight (deg, el positive up)
+    void onTargetObservation(double offsetAzDeg, double offsetElDeg);
+
 signals:
     void weaponArmed(bool armed);
     void weaponFired();
+    void ballisticTableChanged(BallisticTablePtr table);
 
 private slots:
     //void onPlc21DataChanged(const Plc21PanelData &data);
 
     void onSystemStateChanged(const SystemStateData &newData);
     void onActuatorPositionReached();
+    void refreshLead();
 
 private:
     SystemStateModel*  m_stateModel = nullptr;
@@ -63,7 +83,22 @@ private:
     int m_ammoFlag = 0;
 AmmoState m_ammoState { AmmoState::Idle };
 
+    AmmunitionProfile m_ammoProfile;
+    BallisticTablePtr m_ballisticTable;
+
+    void updateLead(const SystemStateData &data);
+
+    LeadComputer m_leadComputer;
+    LeadSolution m_leadSolution;
+    QElapsedTimer m_leadClock;
+    QTimer* m_leadTimer = nullptr;
+    static constexpr int LEAD_UPDATE_MS = 50; ///< Lead publication period (control loop rate).
+    CameraCalibrationPtr m_dayCalibration;
+    CameraCalibrationPtr m_nightCalibration;
+
 };
 
 
+Q_DECLARE_METATYPE(BallisticTablePtr)
+
 #endif // WEAPONCONTROLLER_H
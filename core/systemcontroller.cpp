@@ -3,6 +3,7 @@
 /* INclude Devices */
 #include "devices/daycameracontroldevice.h"
 #include "devices/daycamerapipelinedevice.h"
+#include "devices/gimbalpollgroup.h"
 #include "devices/gyrodevice.h"
 #include "devices/joystickdevice.h"
 #include "devices/lensdevice.h"
@@ -12,6 +13,7 @@
 #include "devices/plc21device.h"
 #include "devices/plc42device.h"
 #include "devices/servoactuatordevice.h"
+#include "devices/servoalarmservice.h"
 #include "devices/servodriverdevice.h"
 
 /* INclude Models */
@@ -35,6 +37,43 @@
 
 #include "ui/mainwindow.h"
 
+#include "utils/cameracalibration.h"
+#include "utils/metricsregistry.h"
+#include "utils/pipelinecatalog.h"
+#include "utils/trace.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+
+namespace {
+// Set from the signal handler, consumed on the GUI thread
+std::atomic<bool> s_traceDumpRequested{false};
+
+void onTraceSignal(int)
+{
+    s_traceDumpRequested.store(true, std::memory_order_relaxed);
+}
+
+// Frame detector of the CPU pipelines from the catalog's "inference" section
+void applyInference(BaseCameraPipelineDevice *device, PipelineInference inference)
+{
+    if (!inference.config.modelPath.empty()) {
+        const QString model = QString::fromStdString(inference.config.modelPath);
+        inference.config.modelPath = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath(model).toStdString();
+    }
+    device->setInferenceConfig(inference.config);
+    if (inference.roiWindow.isValid())
+        device->roiPlanner().setWindowSize(inference.roiWindow);
+    if (inference.roiFullFrameInterval >= 0)
+        device->roiPlanner().setFullFrameInterval(inference.roiFullFrameInterval);
+}
+} // namespace
+
 SystemController::SystemController(QObject *parent)
     : QObject(parent)
 {
@@ -47,6 +86,9 @@ SystemController::~SystemController()
 
 void SystemController::initializeSystem()
 {
+    installTraceSignal();
+    installMetrics();
+
     // 1) Create devices
     m_dayCamControl = new DayCameraControlDevice(this);
     m_dayCamPipeline = new DayCameraPipelineDevice("/dev/video0", nullptr);
@@ -61,6 +103,27 @@ void SystemController::initializeSystem()
     m_servoActuatorDevice = new ServoActuatorDevice(this);
     m_servoAzDevice = new ServoDriverDevice("az", "/dev/serial/by-id/usb-WCH.CN_USB_Quad_Serial_BC046FABCD-if04", 230400, 2, this);
     m_servoElDevice = new ServoDriverDevice("el", "/dev/serial/by-id/usb-WCH.CN_USB_Quad_Serial_BC046FABCD-if06", 230400, 1, this);
+    // AZ-series drives: absolute moves can run in the drive (direct data operation)
+    m_servoAzDevice->setDirectPositioningSupported(true);
+    m_servoElDevice->setDirectPositioningSupported(true);
+    // Both axes are read in the same tick (replaces the per-driver poll timers)
+    m_gimbalPollGroup = new GimbalPollGroup(m_servoAzDevice, m_servoElDevice, this);
+
+    // Camera pipeline descriptions, validated once here (gst_init has run in
+    // the day pipeline constructor) and used when CameraController starts the
+    // pipelines. Without the file the built-in graphs are used.
+    auto pipelineCatalog = std::make_shared<PipelineCatalog>();
+    const QString pipelineCatalogPath = QCoreApplication::applicationDirPath() + "/config/pipelines.json";
+    if (!QFile::exists(pipelineCatalogPath)) {
+        qCritical() << "Pipeline catalog" << pipelineCatalogPath
+                    << "not found (config/ not deployed?), using the built-in camera pipelines";
+    } else if (pipelineCatalog->loadFromFile(pipelineCatalogPath)) {
+        pipelineCatalog->validate(PipelineCapabilities::probe());
+        m_dayCamPipeline->setPipelineCatalog(pipelineCatalog);
+        m_nightCamPipeline->setPipelineCatalog(pipelineCatalog);
+        applyInference(m_dayCamPipeline, pipelineCatalog->inference(QStringLiteral("day")));
+        applyInference(m_nightCamPipeline, pipelineCatalog->inference(QStringLiteral("night")));
+    }
     //m_dayCamPipeline = std::make_unique<DayCameraPipelineDevice>("/dev/video1", nullptr);
     //m_nightCamPipeline = std::make_unique<NightCameraPipelineDevice>("/dev/video1", nullptr);
 
@@ -152,10 +215,14 @@ void SystemController::initializeSystem()
     connect(m_servoActuatorModel,   &ServoActuatorDataModel::dataChanged,
             m_systemStateModel, &SystemStateModel::onServoActuatorDataChanged);
 
-    connect(m_servoAzModel, &ServoDriverDataModel::dataChanged,
+    // Gimbal az/el reach the state model as one time-aligned pair per poll
+    // tick instead of through the per-axis models; an axis whose partner did
+    // not answer is published alone so it never goes stale with it
+    connect(m_gimbalPollGroup, &GimbalPollGroup::gimbalSampleReady,
+            m_systemStateModel, &SystemStateModel::onGimbalSampleChanged);
+    connect(m_gimbalPollGroup, &GimbalPollGroup::azSampleReady,
             m_systemStateModel, &SystemStateModel::onServoAzDataChanged);
-
-    connect(m_servoElModel, &ServoDriverDataModel::dataChanged,
+    connect(m_gimbalPollGroup, &GimbalPollGroup::elSampleReady,
             m_systemStateModel, &SystemStateModel::onServoElDataChanged);
 
 
@@ -171,6 +238,20 @@ void SystemController::initializeSystem()
                                               m_lensDevice,
                                               m_systemStateModel);
 
+    // Servo alarm timeline next to the other logs
+    m_gimbalController->alarmService()->setTimelinePath(QCoreApplication::applicationDirPath() +
+                                                        "/logs/servo-alarms.jsonl");
+
+    // IMU samples reach the stabilizer through the gyro's lock-free sample queue
+    m_gimbalController->setGyroDevice(m_gyroDevice);
+
+    // Tracker offsets drive the tracking motion modes and feed the automatic
+    // lead computation
+    connect(m_cameraController, &CameraController::targetPositionUpdated,
+            m_gimbalController, &GimbalController::onTargetPositionUpdated);
+    connect(m_cameraController, &CameraController::targetPositionUpdated,
+            m_weaponController, &WeaponController::onTargetObservation);
+
     m_stateMachine = new SystemStateMachine(m_systemStateModel, m_gimbalController, m_weaponController, m_cameraController, this);
 
     m_joystickController = new JoystickController(m_joystickModel,
@@ -190,17 +271,40 @@ void SystemController::initializeSystem()
     connect(m_systemStateModel, &SystemStateModel::dataChanged,
             m_nightCamPipeline,   &NightCameraPipelineDevice::onSystemStateChanged);
 
+    // Camera calibration tables (fitted offline by tools/cameracalibration).
+    // A missing file leaves the table empty and the reported HFOV is used.
+    const QString calibrationDir = QCoreApplication::applicationDirPath() + "/calibration/";
+    auto dayCalibration = std::make_shared<CameraCalibration>();
+    dayCalibration->setName("day");
+    dayCalibration->loadFromFile(calibrationDir + "day_camera.json");
+    auto nightCalibration = std::make_shared<CameraCalibration>();
+    nightCalibration->setName("night");
+    nightCalibration->loadFromFile(calibrationDir + "night_camera.json");
+    m_dayCamPipeline->setCalibration(dayCalibration);
+    m_nightCamPipeline->setCalibration(nightCalibration);
+    m_weaponController->setCameraCalibrations(dayCalibration, nightCalibration);
+
+    // Firing table for the Circle reticle, rebuilt on ammunition changes
+    m_dayCamPipeline->setBallisticTable(m_weaponController->ballisticTable());
+    m_nightCamPipeline->setBallisticTable(m_weaponController->ballisticTable());
+    connect(m_weaponController, &WeaponController::ballisticTableChanged,
+            m_dayCamPipeline,   &DayCameraPipelineDevice::setBallisticTable);
+    connect(m_weaponController, &WeaponController::ballisticTableChanged,
+            m_nightCamPipeline,   &NightCameraPipelineDevice::setBallisticTable);
+
     // 8) Start up devices if needed
     m_dayCamControl->openSerialPort("/dev/serial/by-id/usb-WCH.CN_USB_Quad_Serial_BCD9DCABCD-if00");  //   /dev/serial/by-id/usb-WCH.CN_USB_Quad_Serial_BCD9DCABCD-if00
-    //m_gyroDevice->openSerialPort("/dev/ttyUSB1");
+    //m_gyroDevice->openSerialPort("/dev/ttyUSB1", GyroDevice::Protocol::Binary);
     //m_lensDevice->openSerialPort("/dev/ttyUSB1");
     //m_lrfDevice->openSerialPort("/dev/ttyUSB1");
     m_nightCamControl->openSerialPort("/dev/serial/by-id/usb-1a86_USB_Single_Serial_56D1123075-if00"); //  /dev/serial/by-id/usb-WCH.CN_USB_Quad_Serial_BCD9DCABCD-if02
     m_plc21Device->connectDevice();
-    m_plc42Device->connectDevice();
+    if (!m_plc42Device->connectDevice())
+        qCritical() << "PLC42 not connected: the safety watchdog raises an emergency stop";
     //m_servoActuatorDevice->openSerialPort("/dev/ttyUSB1");
     m_servoAzDevice->connectDevice();
     m_servoElDevice->connectDevice();
+    m_gimbalPollGroup->start();
 
 
     //
@@ -211,6 +315,55 @@ void SystemController::initializeSystem()
 
 }
 
+void SystemController::installTraceSignal()
+{
+    // `kill -USR1 <pid>` dumps the trace without touching the UI. Only an
+    // atomic flag is set in the handler; a timer does the file I/O.
+    std::signal(SIGUSR1, onTraceSignal);
+    m_traceSignalTimer = new QTimer(this);
+    connect(m_traceSignalTimer, &QTimer::timeout, this, [this]() {
+        if (s_traceDumpRequested.exchange(false, std::memory_order_relaxed))
+            dumpTrace();
+    });
+    m_traceSignalTimer->start(250);
+}
+
+void SystemController::dumpTrace()
+{
+    Tracer::instance().writeChromeJson(QCoreApplication::applicationDirPath() + "/logs/trace-" +
+                                       QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json");
+}
+
+void SystemController::installMetrics()
+{
+    // A probe timer that fires late measures how long the GUI thread was busy
+    // (or blocked) when it should have been dispatching events
+    constexpr int STALL_PROBE_MS = 100;
+    constexpr int METRICS_EXPORT_MS = 10000;
+
+    m_eventLoopStall = MetricsRegistry::instance().histogram(
+        QStringLiteral("el7aress_event_loop_stall_seconds"),
+        QStringLiteral("Lateness of a 100 ms timer on the GUI event loop"));
+    m_stallProbeTimer = new QTimer(this);
+    m_stallProbeTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_stallProbeTimer, &QTimer::timeout, this, [this]() {
+        const qint64 nowUs = LatencyMonitor::nowUs();
+        if (m_lastStallProbeUs > 0)
+            m_eventLoopStall->record(qMax<qint64>(0, nowUs - m_lastStallProbeUs - STALL_PROBE_MS * 1000LL));
+        m_lastStallProbeUs = nowUs;
+    });
+    m_stallProbeTimer->start(STALL_PROBE_MS);
+
+    m_metricsExportTimer = new QTimer(this);
+    connect(m_metricsExportTimer, &QTimer::timeout, this, &SystemController::dumpMetrics);
+    m_metricsExportTimer->start(METRICS_EXPORT_MS);
+}
+
+void SystemController::dumpMetrics()
+{
+    MetricsRegistry::instance().writePrometheus(QCoreApplication::applicationDirPath() + "/logs/metrics.prom");
+}
+
 void SystemController::showMainWindow()
 {
     // Optionally create + show main UI
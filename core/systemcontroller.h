@@ -18,6 +18,7 @@ class Plc21Device;
 class Plc42Device;
 class ServoActuatorDevice;
 class ServoDriverDevice;
+class GimbalPollGroup;
 
 class DayCameraDataModel;
 class GyroDataModel;
@@ -41,6 +42,8 @@ class JoystickController;
 class SystemStateMachine;
 
 class MainWindow;          // If you have a main UI class
+class QTimer;
+class MetricHistogram;
 class DayCameraPipelineDevice; // Your camera pipeline class
 
 class SystemController : public QObject
@@ -53,7 +56,16 @@ public:
     void initializeSystem();  // Setup devices, models, m_stateModel
     void showMainWindow();    // UI creation
 
+public slots:
+    // Writes the trace rings to logs/trace-<time>.json (also on SIGUSR1)
+    void dumpTrace();
+    // Writes the metrics registry to logs/metrics.prom (also every 10 s)
+    void dumpMetrics();
+
 private:
+    void installTraceSignal();
+    void installMetrics();
+
     // Devices
     DayCameraControlDevice* m_dayCamControl = nullptr;
     DayCameraPipelineDevice* m_dayCamPipeline = nullptr;
@@ -68,6 +80,7 @@ private:
     ServoActuatorDevice* m_servoActuatorDevice = nullptr;
     ServoDriverDevice* m_servoAzDevice = nullptr;
     ServoDriverDevice* m_servoElDevice = nullptr;
+    GimbalPollGroup* m_gimbalPollGroup = nullptr;
 
     // Data models
     DayCameraDataModel* m_dayCamControlModel = nullptr;
@@ -96,6 +109,14 @@ private:
 
     // UI
     MainWindow* m_mainWindow = nullptr;
+
+    QTimer* m_traceSignalTimer = nullptr;
+
+    // Metrics: event-loop stall probe and periodic Prometheus export
+    QTimer* m_stallProbeTimer = nullptr;
+    QTimer* m_metricsExportTimer = nullptr;
+    MetricHistogram* m_eventLoopStall = nullptr;
+    qint64 m_lastStallProbeUs = 0;
 };
 
 #endif // SYSTEMCONTROLLER_H
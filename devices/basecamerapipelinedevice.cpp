@@ -1,5 +1,6 @@
 #include "basecamerapipelinedevice.h"
 #include <QDebug>
+#include "utils/trace.h"
 
 BaseCameraPipelineDevice::BaseCameraPipelineDevice(const std::string& path, QWidget *parent)
     : QWidget(parent),
@@ -10,6 +11,11 @@ BaseCameraPipelineDevice::BaseCameraPipelineDevice(const std::string& path, QWid
 {
     // Set default bounding box in the center (100x100)
     defaultBBox = QRect(0, 0, 100, 100);
+    m_trackClock.start();
+    m_pendingDetections.reserve(64);
+    m_fusionDetections.reserve(64);
+    m_frameDetections.reserve(64);
+    m_latestDetections.reserve(64);
 }
 
 BaseCameraPipelineDevice::~BaseCameraPipelineDevice()
@@ -98,10 +104,19 @@ bool BaseCameraPipelineDevice::initializeTracking(const QRect& bbox)
         // Update tracking state
         trackedBBox = bbox;
         
-        // Extract visual features for the target
         currentTarget.bbox = bbox;
-        extractTargetFeatures(currentFrame, bbox);
         updateTargetPosition(currentTarget);
+
+        // New target (or re-acquired one): restart the appearance/motion model
+        m_reacquisition.cancel();
+        m_reacquisition.clearModel();
+        m_reacquisition.updateModel(imageView(currentFrame), bbox, m_trackClock.elapsed() / 1000.0);
+
+        m_fusion.reset();
+        {
+            QMutexLocker locker(&m_detectionMutex);
+            m_detectionsFresh = false;
+        }
         
         trackingEnabled = true;
         qDebug() << "Tracking initialized successfully for camera:" << devicePath.c_str();
@@ -116,14 +131,34 @@ void BaseCameraPipelineDevice::stopTracking()
 {
     trackingEnabled = false;
     
-    // Clear any visual features to prevent memory leaks
-    currentTarget.visualFeatures.clear();
-    currentTarget.targetPatch = QImage(); // Clear the image
+    m_reacquisition.cancel();
+    m_reacquisition.clearModel();
     
     emit trackingStatusChanged(false);
     qDebug() << "Tracking stopped on camera" << devicePath.c_str();
 }
 
+CameraModel BaseCameraPipelineDevice::cameraModel(double zoomPosition, double hfovDeg) const
+{
+    CameraCalibrationPtr cal = calibration();
+    if (cal)
+        return cal->modelAt(zoomPosition, hfovDeg);
+    return CameraModel::fromHfov(hfovDeg, 960, 720);
+}
+
+void BaseCameraPipelineDevice::updateCameraParameters(double zoomPosition, double hfovDeg)
+{
+    m_zoomPosition = zoomPosition;
+    m_hfovDeg = hfovDeg;
+
+    const CameraModel model = cameraModel(zoomPosition, hfovDeg);
+    if (!model.isValid())
+        return;
+
+    cameraParams.focalLength = model.intrinsics().fx;
+    cameraParams.principalPoint = QPoint(qRound(model.intrinsics().cx), qRound(model.intrinsics().cy));
+}
+
 QImage BaseCameraPipelineDevice::getCurrentFrame() const
 {
     return currentFrame;
@@ -146,7 +181,9 @@ GstFlowReturn BaseCameraPipelineDevice::onNewSampleCallback(GstAppSink *sink, gp
 
 GstFlowReturn BaseCameraPipelineDevice::onNewSample(GstAppSink *sink)
 {
+    TRACE_SCOPE("frame", "appsink.sample");
     try {
+        recordPipelineFrame();
         GstSample *sample = gst_app_sink_pull_sample(sink);
         if (!sample) {
             qDebug() << "Failed to pull sample from appsink for" << devicePath.c_str();
@@ -196,6 +233,7 @@ GstFlowReturn BaseCameraPipelineDevice::onNewSample(GstAppSink *sink)
             gst_sample_unref(sample);
             return GST_FLOW_ERROR;
         }
+        countDroppedFrames(structure, buffer);
 
         GstMapInfo map;
         if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
@@ -218,6 +256,10 @@ GstFlowReturn BaseCameraPipelineDevice::onNewSample(GstAppSink *sink)
                 << "width:" << width << "height:" << height 
                 << "expected size:" << (width * height * 4);*/
 
+        // Stamp capture (buffer PTS) and arrival before any processing
+        const qint64 appsinkUs = LatencyMonitor::nowUs();
+        m_frameId = LatencyMonitor::instance().beginFrame(latencySource(), captureTimeUs(buffer, appsinkUs), appsinkUs);
+
         // Process the frame data
         processFrame(map.data, width, height);
 
@@ -233,6 +275,7 @@ GstFlowReturn BaseCameraPipelineDevice::onNewSample(GstAppSink *sink)
 
 void BaseCameraPipelineDevice::processFrame(const guint8 *data, int width, int height)
 {
+    TRACE_SCOPE("frame", "processFrame");
     if (!data) {
         qWarning() << "Received null data pointer in processFrame for" << devicePath.c_str();
         return;
@@ -258,17 +301,23 @@ void BaseCameraPipelineDevice::processFrame(const guint8 *data, int width, int h
     // Store a copy of the frame
 
     QImage frameCopy = newFrame.copy();
+    if (m_frameId)
+        frameCopy.setText(LatencyMonitor::FRAME_ID_KEY, QString::number(m_frameId));
     
     // Store the frame copy
     {
         QMutexLocker locker(&frameMutex);  // Assuming you have a mutex to protect the frame
         currentFrame = frameCopy;
     }
+
+    runFrameDetector();
  
     
     // If tracking is enabled, update the tracker with the new frame
     if (trackingEnabled && dcfTracker) {
         //qDebug() << "Updating tracking for" << devicePath.c_str() << "with new frame";
+        TRACE_SCOPE("tracker", "dcf.update");
+        MetricTimer trackerTimer(m_trackerUpdate);
         try {
             // Update the tracker with the new frame
             QRect newBBox = trackedBBox;
@@ -281,12 +330,14 @@ void BaseCameraPipelineDevice::processFrame(const guint8 *data, int width, int h
             
             // Check if tracking was successful
             if (success && newBBox.width() > 0 && newBBox.height() > 0) {
+                applyDetectionFusion(newBBox);
                 trackedBBox = newBBox;
                 
                 // Update target state
                 currentTarget.bbox = newBBox;
-                extractTargetFeatures(currentFrame, newBBox);
                 updateTargetPosition(currentTarget);
+                publishTargetAngles(newBBox);
+                m_reacquisition.updateModel(imageView(currentFrame), newBBox, m_trackClock.elapsed() / 1000.0);
                 
                 //qDebug() << "Tracking updated for" << devicePath.c_str() << "- new bbox:" << newBBox;
             } else {
@@ -297,92 +348,361 @@ void BaseCameraPipelineDevice::processFrame(const guint8 *data, int width, int h
             qCritical() << "Error updating tracking:" << e.what() << "for" << devicePath.c_str();
             handleTrackingFailure();
         }
+    } else if (m_reacquisition.isActive() && dcfTracker) {
+        runReacquisition();
+    }
+    LatencyMonitor::instance().markProcessed(m_frameId, trackingEnabled && !trackedBBox.isEmpty());
+
+    // Emit the new frame with the image data. Without nvdsosd the overlay is
+    // drawn here, on a copy so the tracker keeps reading clean frames.
+    if (m_pipelineVariant == PipelineVariant::Cpu) {
+        QImage displayFrame = currentFrame.copy();
+        m_osdContent.reticle = cameraParams.principalPoint;
+        m_osdContent.trackedBox = trackingEnabled ? trackedBBox : QRect();
+        {
+            QMutexLocker locker(&m_detectionMutex);
+            m_osdContent.detections.assign(m_latestDetections.begin(), m_latestDetections.end());
+        }
+        {
+            QMutexLocker locker(&m_osdMutex);
+            m_osdContent.statusLines = m_osdStatus;
+        }
+        {
+            TRACE_SCOPE("osd", "cpuOsd.render");
+            m_cpuOsd.render(displayFrame, m_osdContent);
+        }
+        LatencyMonitor::instance().markPublished(m_frameId);
+        emit newFrameAvailable(displayFrame);
+    } else {
+        LatencyMonitor::instance().markPublished(m_frameId);
+        emit newFrameAvailable(currentFrame);
     }
-    // Emit the new frame with the image data
-    emit newFrameAvailable(currentFrame);
     
     // Notify that a new frame is available
     emit frameUpdated();
 }
 
-void BaseCameraPipelineDevice::extractTargetFeatures(const QImage& frame, const QRect& bbox)
+void BaseCameraPipelineDevice::submitDetections(const std::vector<FusionDetection>& detections)
 {
-    // Skip if the bounding box is invalid
-    if (bbox.width() <= 0 || bbox.height() <= 0 || 
-        bbox.right() >= frame.width() || bbox.bottom() >= frame.height()) {
-        qWarning() << "Invalid bounding box for feature extraction";
+    QMutexLocker locker(&m_detectionMutex);
+    m_pendingDetections.assign(detections.begin(), detections.end());
+    m_detectionsFresh = true;
+}
+
+std::vector<FusionDetection> BaseCameraPipelineDevice::latestDetections() const
+{
+    QMutexLocker locker(&m_detectionMutex);
+    return m_latestDetections;
+}
+
+void BaseCameraPipelineDevice::publishDetections(const std::vector<FusionDetection>& detections)
+{
+    {
+        QMutexLocker locker(&m_detectionMutex);
+        m_latestDetections.assign(detections.begin(), detections.end());
+    }
+    emit detectionsUpdated();
+}
+
+void BaseCameraPipelineDevice::runFrameDetector()
+{
+    if (!m_detector || m_detector->runsInPipeline() || !m_detector->isLoaded() || !m_detector->frameDue())
         return;
+
+    // Window around the target (tracked, or predicted while re-acquiring) or
+    // the reticle, with a periodic full frame
+    QRect target;
+    if (trackingEnabled)
+        target = trackedBBox;
+    else if (m_reacquisition.isActive())
+        target = m_reacquisition.predictedBox(m_trackClock.elapsed() / 1000.0);
+    const InferenceRegion region = m_roiPlanner.next(currentFrame.size(), cameraParams.principalPoint, target);
+
+    TRACE_SCOPE("detector", "detect");
+    const RgbaImageView view = imageView(currentFrame);
+    if (!m_detector->detect(&view, region.fullFrame ? nullptr : &region.region, 1, &m_frameDetections))
+        return;
+
+    m_objectTracker.update(m_frameDetections);
+    publishDetections(m_frameDetections);
+    if (trackingEnabled)
+        submitDetections(m_frameDetections);
+}
+
+void BaseCameraPipelineDevice::applyDetectionFusion(QRect& bbox)
+{
+    TRACE_SCOPE("tracker", "fusion");
+    {
+        QMutexLocker locker(&m_detectionMutex);
+        if (!m_detectionsFresh)
+            return;
+        m_fusionDetections.swap(m_pendingDetections);
+        m_detectionsFresh = false;
     }
 
-    // Extract a patch of the target - use a downsampled version for efficiency
-    QRect scaledBox = bbox;
-    int maxDimension = 64; // Limit size for performance
-    
-    if (bbox.width() > maxDimension || bbox.height() > maxDimension) {
-        double scale = std::min(
-            static_cast<double>(maxDimension) / bbox.width(),
-            static_cast<double>(maxDimension) / bbox.height()
-        );
-        scaledBox.setWidth(bbox.width() * scale);
-        scaledBox.setHeight(bbox.height() * scale);
+    const FusionCorrection correction = m_fusion.update(bbox, m_fusionDetections);
+    if (!correction.matched || !correction.reseed)
+        return;
+
+    // Re-seed the DCF on the corrected box to remove drift and fix its scale
+    const QRect box = correction.box.intersected(QRect(0, 0, currentFrame.width(), currentFrame.height()));
+    if (box.width() <= 0 || box.height() <= 0)
+        return;
+    dcfTracker->initialize(currentFrame.constBits(), currentFrame.width(), currentFrame.height(), box);
+    bbox = box;
+}
+
+void BaseCameraPipelineDevice::setOsdStatus(const QStringList& lines)
+{
+    QMutexLocker locker(&m_osdMutex);
+    m_osdStatus = lines;
+}
+
+void BaseCameraPipelineDevice::setOsdStatus(const SystemStateData& state)
+{
+    QString mode;
+    switch (state.opMode) {
+    case OperationalMode::Idle:         mode = "Mode: IDLE"; break;
+    case OperationalMode::Surveillance: mode = "Mode: SURVEILLANCE"; break;
+    case OperationalMode::Tracking:     mode = "Mode: TRACKING"; break;
+    case OperationalMode::Engagement:   mode = "Mode: ENGAGEMENT"; break;
     }
-    
-    QImage patch = frame.copy(bbox).scaled(
-        scaledBox.size(), 
-        Qt::KeepAspectRatio, 
-        Qt::FastTransformation
-    );
-    
-    currentTarget.targetPatch = patch;
-    
-    // Use a smaller feature vector for efficiency
-    const int featureSize = 8; // 2x2 grid with RGB+intensity
-    currentTarget.visualFeatures.resize(featureSize, 0.0f);
-    
-    // Simple feature: average color in a 2x2 grid
-    int patchWidth = patch.width();
-    int patchHeight = patch.height();
-    
-    for (int i = 0; i < 2; i++) {
-        for (int j = 0; j < 2; j++) {
-            int x = (i * patchWidth) / 2;
-            int y = (j * patchHeight) / 2;
-            int w = patchWidth / 2;
-            int h = patchHeight / 2;
-            
-            // Use accumulators for each channel
-            int totalRed = 0;
-            int totalGreen = 0;
-            int totalBlue = 0;
-            int count = 0;
-            
-            // Sample fewer pixels for performance
-            const int sampleStep = 2;
-            
-            // Calculate average color in this region
-            for (int px = x; px < x + w && px < patchWidth; px += sampleStep) {
-                for (int py = y; py < y + h && py < patchHeight; py += sampleStep) {
-                    QColor pixelColor = patch.pixelColor(px, py);
-                    totalRed += pixelColor.red();
-                    totalGreen += pixelColor.green();
-                    totalBlue += pixelColor.blue();
-                    count++;
-                }
-            }
-            
-            // Calculate average safely
-            float avgRed = count > 0 ? totalRed / static_cast<float>(count) : 0;
-            float avgGreen = count > 0 ? totalGreen / static_cast<float>(count) : 0;
-            float avgBlue = count > 0 ? totalBlue / static_cast<float>(count) : 0;
-            
-            // Store RGB features (normalized)
-            int idx = i * 4 + j * 2;
-            currentTarget.visualFeatures[idx] = (avgRed + avgGreen + avgBlue) / (3.0f * 255.0f);
-            
-            // Store intensity feature
-            currentTarget.visualFeatures[idx + 1] = (0.299f * avgRed + 0.587f * avgGreen + 0.114f * avgBlue) / 255.0f;
+
+    QString motion;
+    switch (state.motionMode) {
+    case MotionMode::Manual:      motion = "Motion: MANUAL"; break;
+    case MotionMode::Pattern:     motion = "Motion: PATTERN"; break;
+    case MotionMode::AutoTrack:   motion = "Motion: AUTO TRACK"; break;
+    case MotionMode::ManualTrack: motion = "Motion: MAN TRACK"; break;
+    case MotionMode::Slew:        motion = "Motion: SLEW"; break;
+    default:                      motion = "Motion: IDLE"; break;
+    }
+
+    setOsdStatus(QStringList{mode, motion, QStringLiteral("CPU PIPELINE")});
+}
+
+bool BaseCameraPipelineDevice::buildCpuPipeline(const CpuPipelineSettings& settings)
+{
+    beginPipelineTiming(PipelineVariant::Cpu);
+
+    const QString description = cpuPipelineDescription(settings);
+    qDebug() << "Building CPU pipeline for" << devicePath.c_str() << ":" << description;
+    if (!launchPipeline(description, settings.appSinkName))
+        return false;
+
+    createFrameDetector();
+    return startPipeline();
+}
+
+bool BaseCameraPipelineDevice::parseCatalogPipeline(const QString& camera, PipelineDescription& used)
+{
+    const PipelineCatalogPtr catalog = pipelineCatalog();
+    if (!catalog)
+        return false;
+    const PipelineDescription *description = catalog->select(camera);
+    if (!description) {
+        qWarning() << "No valid catalog pipeline for" << camera << "- using the built-in graph";
+        return false;
+    }
+    used = *description;
+
+    beginPipelineTiming(used.variant);
+    qDebug() << "Building catalog pipeline" << used.name << "for" << devicePath.c_str() << ":" << used.resolved;
+    if (!launchPipeline(used.resolved, used.taps.appSink))
+        return false;
+
+    if (used.variant == PipelineVariant::Cpu)
+        createFrameDetector();
+    return true;
+}
+
+GstPad* BaseCameraPipelineDevice::tapPad(const QString& tap) const
+{
+    QString elementName, padName;
+    if (!pipeline || !PipelineCatalog::splitPadTap(tap, elementName, padName))
+        return nullptr;
+    GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), elementName.toUtf8().constData());
+    if (!element)
+        return nullptr;
+    GstPad *pad = gst_element_get_static_pad(element, padName.toUtf8().constData());
+    gst_object_unref(element);
+    return pad;
+}
+
+bool BaseCameraPipelineDevice::launchPipeline(const QString& description, const QString& appSinkName)
+{
+    GError *error = nullptr;
+    pipeline = gst_parse_launch(description.toUtf8().constData(), &error);
+    if (error) {
+        qCritical() << "Pipeline could not be built:" << error->message;
+        g_error_free(error);
+        if (pipeline) {
+            gst_object_unref(pipeline);
+            pipeline = nullptr;
         }
+        return false;
     }
+
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), appSinkName.toUtf8().constData());
+    if (!sink) {
+        qCritical() << "Pipeline has no appsink named" << appSinkName;
+        gst_object_unref(pipeline);
+        pipeline = nullptr;
+        return false;
+    }
+    g_signal_connect(sink, "new-sample", G_CALLBACK(onNewSampleCallback), this);
+    appSink = GST_APP_SINK(sink);
+    gst_object_unref(sink); // the pipeline keeps its reference
+    return true;
+}
+
+bool BaseCameraPipelineDevice::startPipeline()
+{
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        qCritical() << pipelineVariantName(m_pipelineVariant) << "pipeline failed to start for" << devicePath.c_str();
+        gst_object_unref(pipeline);
+        pipeline = nullptr;
+        appSink = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void BaseCameraPipelineDevice::createFrameDetector()
+{
+    // Detector on the frames, if a CPU model is configured ("inference" in
+    // config/pipelines.json)
+    if (m_inferenceConfig.modelPath.empty()) {
+        qWarning() << "No CPU detection model configured for" << devicePath.c_str() << "- detection off";
+    } else {
+        InferenceBackendPtr cpuDetector = createInferenceBackend(InferenceBackendType::OpenCvDnn);
+        if (cpuDetector->load(m_inferenceConfig))
+            setDetector(std::move(cpuDetector));
+    }
+    m_objectTracker.reset();
+}
+
+int BaseCameraPipelineDevice::latencySource()
+{
+    int source = m_latencySource.load(std::memory_order_relaxed);
+    if (source < 0) {
+        // Registration is idempotent per name, so concurrent first calls agree
+        source = LatencyMonitor::instance().registerSource(getDeviceName());
+        m_latencySource.store(source, std::memory_order_relaxed);
+    }
+    return source;
+}
+
+qint64 BaseCameraPipelineDevice::captureTimeUs(GstBuffer *buffer, qint64 appsinkUs) const
+{
+    // With do-timestamp the PTS is the running time at capture. The age of the
+    // frame on the pipeline clock is mapped onto the monotonic clock of the
+    // other stamps; without a PTS the arrival time is used.
+    if (!pipeline || !GST_BUFFER_PTS_IS_VALID(buffer))
+        return appsinkUs;
+    GstClock *clock = gst_element_get_clock(pipeline);
+    if (!clock)
+        return appsinkUs;
+    const GstClockTime captured = gst_element_get_base_time(pipeline) + GST_BUFFER_PTS(buffer);
+    const GstClockTime now = gst_clock_get_time(clock);
+    gst_object_unref(clock);
+    if (now <= captured)
+        return appsinkUs;
+    return appsinkUs - static_cast<qint64>(GST_TIME_AS_USECONDS(now - captured));
+}
+
+void BaseCameraPipelineDevice::beginPipelineTiming(PipelineVariant variant)
+{
+    m_pipelineVariant = variant;
+    m_startupMs = -1;
+    m_measuredFps = 0.0;
+    m_fpsFrames = 0;
+    m_fpsWindowStart = 0;
+    m_lastPts = GST_CLOCK_TIME_NONE;
+    m_pipelineClock.start();
+
+    if (!m_fpsGauge) {
+        MetricsRegistry &registry = MetricsRegistry::instance();
+        const MetricLabels labels = {{QStringLiteral("camera"), getDeviceName()}};
+        m_fpsGauge = registry.gauge(QStringLiteral("el7aress_pipeline_fps"),
+                                    QStringLiteral("Frames delivered to the appsink per second (5 s window)"), labels);
+        m_droppedFrames = registry.counter(QStringLiteral("el7aress_appsink_dropped_frames_total"),
+                                           QStringLiteral("Frames missing between consecutive appsink samples"), labels);
+        m_trackerUpdate = registry.histogram(QStringLiteral("el7aress_tracker_update_seconds"),
+                                             QStringLiteral("DCF tracker update time per frame"), labels);
+    }
+    m_fpsGauge->set(0.0);
+}
+
+void BaseCameraPipelineDevice::recordPipelineFrame()
+{
+    // Frame rate over 5 s windows, logged once per window
+    constexpr qint64 FPS_WINDOW_MS = 5000;
+
+    const qint64 now = m_pipelineClock.elapsed();
+    if (m_startupMs.load() < 0) {
+        m_startupMs = now;
+        m_fpsWindowStart = now;
+        qDebug() << pipelineVariantName(m_pipelineVariant) << "pipeline for" << devicePath.c_str()
+                 << "delivered its first frame after" << now << "ms";
+        return;
+    }
+
+    ++m_fpsFrames;
+    const qint64 elapsed = now - m_fpsWindowStart;
+    if (elapsed >= FPS_WINDOW_MS) {
+        m_measuredFps = m_fpsFrames * 1000.0 / elapsed;
+        if (m_fpsGauge)
+            m_fpsGauge->set(m_measuredFps.load());
+        qDebug() << pipelineVariantName(m_pipelineVariant) << "pipeline for" << devicePath.c_str()
+                 << "running at" << QString::number(m_measuredFps.load(), 'f', 1) << "fps";
+        m_fpsFrames = 0;
+        m_fpsWindowStart = now;
+    }
+}
+
+void BaseCameraPipelineDevice::countDroppedFrames(GstStructure *structure, GstBuffer *buffer)
+{
+    // The appsink (max-buffers=1 drop=true) and leaky queues discard frames
+    // silently; a PTS gap of more than 1.5 frame periods means some went missing
+    if (!m_droppedFrames || !GST_BUFFER_PTS_IS_VALID(buffer))
+        return;
+    const GstClockTime pts = GST_BUFFER_PTS(buffer);
+    const GstClockTime last = m_lastPts;
+    m_lastPts = pts;
+
+    gint num = 0;
+    gint den = 0;
+    if (!GST_CLOCK_TIME_IS_VALID(last) || pts <= last
+        || !gst_structure_get_fraction(structure, "framerate", &num, &den) || num <= 0 || den <= 0)
+        return;
+    const GstClockTime period = gst_util_uint64_scale_int(GST_SECOND, den, num);
+    const GstClockTime gap = pts - last;
+    if (period > 0 && gap > period + period / 2)
+        m_droppedFrames->increment((gap + period / 2) / period - 1);
+}
+
+RgbaImageView BaseCameraPipelineDevice::imageView(const QImage& frame)
+{
+    RgbaImageView view;
+    view.data = frame.constBits();
+    view.width = frame.width();
+    view.height = frame.height();
+    view.stride = static_cast<int>(frame.bytesPerLine());
+    return view;
+}
+
+void BaseCameraPipelineDevice::publishTargetAngles(const QRect& bbox)
+{
+    const CameraModel model = cameraModel(m_zoomPosition.load(), m_hfovDeg.load());
+    if (!model.isValid())
+        return;
+
+    double targetAzimuth = 0.0;
+    double targetElevation = 0.0;
+    model.pixelToAngle(bbox.x() + bbox.width() / 2.0, bbox.y() + bbox.height() / 2.0,
+                       targetAzimuth, targetElevation);
+    emit targetPositionUpdated(targetAzimuth, targetElevation);
 }
 
 void BaseCameraPipelineDevice::updateTargetPosition(TargetState& state)
@@ -429,8 +749,47 @@ void BaseCameraPipelineDevice::updateTargetPosition(TargetState& state)
 void BaseCameraPipelineDevice::handleTrackingFailure()
 {
     trackingEnabled = false;
+
+    // Search for the last good appearance before giving the target up
+    if (m_reacquisition.begin(m_trackClock.elapsed() / 1000.0)) {
+        qDebug() << "Tracking lost on camera" << devicePath.c_str()
+                 << "- searching for" << m_reacquisition.window() << "s";
+        emit reacquisitionStarted();
+        return;
+    }
+
     emit trackingLost();
     emit trackingStatusChanged(false);
     qDebug() << "Tracking lost on camera" << devicePath.c_str();
 }
 
+void BaseCameraPipelineDevice::runReacquisition()
+{
+    TRACE_SCOPE("tracker", "reacquisition");
+    const ReacquisitionResult result = m_reacquisition.search(imageView(currentFrame),
+                                                              m_trackClock.elapsed() / 1000.0);
+    const ReacquisitionStats &stats = m_reacquisition.stats();
+
+    if (result.expired) {
+        qDebug() << "Re-acquisition window expired on camera" << devicePath.c_str()
+                 << "- success rate" << stats.successes << "/" << stats.attempts;
+        emit trackingLost();
+        emit trackingStatusChanged(false);
+        return;
+    }
+
+    if (!result.found)
+        return;
+
+    const QRect box = result.box.intersected(QRect(0, 0, currentFrame.width(), currentFrame.height()));
+    if (!initializeTracking(box)) {
+        emit trackingLost();
+        emit trackingStatusChanged(false);
+        return;
+    }
+
+    qDebug() << "Target re-acquired on camera" << devicePath.c_str() << "at" << box
+             << "score" << result.score << "- success rate" << stats.successes << "/" << stats.attempts;
+    emit targetReacquired(box);
+}
+
@@ -14,6 +14,20 @@
 #include <QMatrix4x4>
 #include "utils/dcftrackervpi.h"
 #include "utils/targetstate.h"
+#include "utils/ballistics.h"
+#include "utils/cameracalibration.h"
+#include "utils/reacquisition.h"
+#include "utils/detectionfusion.h"
+#include "utils/inferencebackend.h"
+#include "utils/roiinference.h"
+#include "utils/pipelinebuilder.h"
+#include "utils/pipelinecatalog.h"
+#include "utils/cpuosd.h"
+#include "utils/latencymonitor.h"
+#include "utils/metricsregistry.h"
+#include "models/systemstatedata.h"
+#include <atomic>
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QMutexLocker>
 
@@ -46,8 +60,8 @@ public:
         QVector3D position;      // Camera position
         
         CameraParameters() : 
-            focalLength(1000.0),  // Default focal length
-            principalPoint(640, 360) {  // Default for 1280x720
+            focalLength(1000.0),  // Replaced from the calibration on the first state update
+            principalPoint(480, 360) {  // Default for the 960x720 output
             rotation.setToIdentity();
             position = QVector3D(0, 0, 0);
         }
@@ -62,6 +76,50 @@ public:
     // Initialize tracking with specific bounding box (for handoff)
     bool initializeTracking(const QRect& bbox);
 
+    // Detector output for a frame on which inference ran. Called from the
+    // streaming thread; fused with the DCF box on the next tracked frame.
+    void submitDetections(const std::vector<FusionDetection>& detections);
+
+    // Object detector. In-pipeline backends (nvinfer) are created by
+    // buildPipeline(); a frame backend set here runs on the appsink frames.
+    // The CPU pipelines load one from the config set here (before initialize(),
+    // from the "inference" section of config/pipelines.json).
+    void setInferenceConfig(const InferenceConfig& config) { m_inferenceConfig = config; }
+    const InferenceConfig& inferenceConfig() const { return m_inferenceConfig; }
+    void setDetector(InferenceBackendPtr detector) { m_detector = std::move(detector); }
+    InferenceBackend* detector() const { return m_detector.get(); }
+    // Region-of-interest inference around the reticle or target (frame backends)
+    RoiInferencePlanner& roiPlanner() { return m_roiPlanner; }
+    // Detections of the last inferred frame, frame coordinates
+    std::vector<FusionDetection> latestDetections() const;
+
+    // Pixel <-> angle calibration, shared by tracking, OSD and handoff. Without
+    // a calibration the HFOV reported by the camera is used.
+    void setCalibration(CameraCalibrationPtr calibration) { std::atomic_store(&m_calibration, std::move(calibration)); }
+    CameraCalibrationPtr calibration() const { return std::atomic_load(&m_calibration); }
+    CameraModel cameraModel(double zoomPosition, double hfovDeg) const;
+
+    // Firing table for the Circle reticle. Swapped atomically so the OSD probe
+    // (streaming thread) always sees a complete table.
+    void setBallisticTable(BallisticTablePtr table) { std::atomic_store(&m_ballisticTable, std::move(table)); }
+    BallisticTablePtr ballisticTable() const { return std::atomic_load(&m_ballisticTable); }
+
+    // Pipeline descriptions from config/pipelines.json. Set before
+    // initialize(); without a catalog (or a valid entry) buildPipeline() uses
+    // its built-in graph.
+    void setPipelineCatalog(PipelineCatalogPtr catalog) { std::atomic_store(&m_pipelineCatalog, std::move(catalog)); }
+    PipelineCatalogPtr pipelineCatalog() const { return std::atomic_load(&m_pipelineCatalog); }
+
+    // Pipeline variant in use, time from build to first frame and frame rate
+    // over the last measurement window
+    PipelineVariant pipelineVariant() const { return m_pipelineVariant; }
+    qint64 startupTimeMs() const { return m_startupMs.load(); }
+    double measuredFps() const { return m_measuredFps.load(); }
+
+    // Status text drawn by the CPU OSD (the DeepStream OSD draws its own)
+    void setOsdStatus(const QStringList& lines);
+    void setOsdStatus(const SystemStateData& state);
+
     // Static callback for GStreamer
     static GstFlowReturn onNewSampleCallback(GstAppSink *sink, gpointer user_data);
     
@@ -72,7 +130,16 @@ signals:
     void newFrameAvailable(const QImage& frame);
     void frameUpdated();
     void trackingStatusChanged(bool isTracking);
+    // Emitted when the tracker fails but a re-acquisition search is started;
+    // trackingLost follows only if the search window expires.
+    void reacquisitionStarted();
+    void targetReacquired(const QRect& bbox);
+    // A new set of detections is available through latestDetections()
+    void detectionsUpdated();
     void trackingLost();
+    // Selected target angles relative to the gun bore (deg, az right, el up),
+    // from the DCF track or the selected nvtracker object
+    void targetPositionUpdated(double targetAzimuth, double targetElevation);
 
 protected:
     // Camera properties
@@ -88,6 +155,39 @@ protected:
     // Target state
     TargetState currentTarget;
 
+    // Re-acquisition of lost tracks
+    ReacquisitionEngine m_reacquisition;
+    QElapsedTimer m_trackClock;
+    void runReacquisition();
+    static RgbaImageView imageView(const QImage& frame);
+
+    // Detector-tracker fusion
+    DetectionFusion m_fusion;
+    std::vector<FusionDetection> m_pendingDetections; // written by submitDetections
+    std::vector<FusionDetection> m_fusionDetections;  // swapped in by the tracking thread
+    bool m_detectionsFresh = false;
+    mutable QMutex m_detectionMutex;
+    void applyDetectionFusion(QRect& bbox);
+
+    // Object detection
+    InferenceConfig m_inferenceConfig;
+    InferenceBackendPtr m_detector;
+    RoiInferencePlanner m_roiPlanner;
+    std::vector<FusionDetection> m_frameDetections;  // frame backend output
+    std::vector<FusionDetection> m_latestDetections; // guarded by m_detectionMutex
+    void publishDetections(const std::vector<FusionDetection>& detections);
+    void runFrameDetector();
+
+    // Calibration
+    CameraCalibrationPtr m_calibration;
+    void updateCameraParameters(double zoomPosition, double hfovDeg);
+    std::atomic<double> m_zoomPosition{0.0}; // last state update, read by the tracker
+    std::atomic<double> m_hfovDeg{0.0};
+    void publishTargetAngles(const QRect& bbox);
+
+    // Ballistics
+    BallisticTablePtr m_ballisticTable;
+
     // GStreamer elements
     GstAppSink *appSink;
 
@@ -98,13 +198,56 @@ protected:
     virtual GstFlowReturn onNewSample(GstAppSink *sink);
     virtual void processFrame(const guint8 *data, int width, int height);
     
-    // Target feature extraction and position estimation
-    void extractTargetFeatures(const QImage& frame, const QRect& bbox);
+    // Target position estimation
     void updateTargetPosition(TargetState& state);
     void handleTrackingFailure();
 
     // Pipeline setup
     virtual void buildPipeline() = 0;
+    // Standard-element pipeline for machines without DeepStream: detection
+    // (when a CPU model is configured), tracking and OSD run on the frames
+    bool buildCpuPipeline(const CpuPipelineSettings& settings);
+    // Catalog pipeline for @p camera, parsed and wired to its appsink but not
+    // started, so the caller can attach its probes. Copies the entry used.
+    bool parseCatalogPipeline(const QString& camera, PipelineDescription& used);
+    // Pad named by an "element.pad" tap (new reference), nullptr if absent
+    GstPad* tapPad(const QString& tap) const;
+    // Shared by the catalog and CPU paths
+    bool launchPipeline(const QString& description, const QString& appSinkName);
+    bool startPipeline();
+    void createFrameDetector();
+    PipelineCatalogPtr m_pipelineCatalog;
+
+    // Per-frame latency stamps (LatencyMonitor); the frame id is attached to
+    // the emitted QImage so the display can stamp the present time
+    int latencySource();
+    qint64 captureTimeUs(GstBuffer *buffer, qint64 appsinkUs) const;
+    std::atomic<int> m_latencySource{-1};
+    quint64 m_frameId = 0;
+
+    // Startup and frame-rate measurement
+    void beginPipelineTiming(PipelineVariant variant);
+    void recordPipelineFrame();
+    PipelineVariant m_pipelineVariant = PipelineVariant::DeepStream;
+    QElapsedTimer m_pipelineClock;
+    std::atomic<qint64> m_startupMs{-1};
+    std::atomic<double> m_measuredFps{0.0};
+    qint64 m_fpsWindowStart = 0;
+    int m_fpsFrames = 0;
+
+    // Registry metrics (camera="<device name>"), registered in beginPipelineTiming
+    void countDroppedFrames(GstStructure *structure, GstBuffer *buffer);
+    MetricGauge *m_fpsGauge = nullptr;
+    MetricCounter *m_droppedFrames = nullptr;
+    MetricHistogram *m_trackerUpdate = nullptr;
+    GstClockTime m_lastPts = GST_CLOCK_TIME_NONE;
+
+    // CPU pipeline overlay and multi-object ids (nvdsosd / nvtracker roles)
+    CpuOsd m_cpuOsd;
+    CpuOsdContent m_osdContent;
+    QStringList m_osdStatus;
+    QMutex m_osdMutex;
+    DetectionTracker m_objectTracker;
     QMutex frameMutex; // Mutex to protect the frame data
 };
 
@@ -1,5 +1,7 @@
 #include "daycameracontroldevice.h"
 #include <QDebug>
+#include "utils/trace.h"
+#include "utils/metricsregistry.h"
 #include <QTimer>
 
 static QByteArray buildPelcoD(quint8 address, quint8 cmd1, quint8 cmd2,
@@ -22,7 +24,8 @@ static QByteArray buildPelcoD(quint8 address, quint8 cmd1, quint8 cmd2,
 
 DayCameraControlDevice::DayCameraControlDevice(QObject *parent)
     : QObject(parent),
-    cameraSerial(new QSerialPort(this))
+    cameraSerial(new QSerialPort(this)),
+    m_checksumErrors(serialChecksumErrorCounter(QStringLiteral("day_camera")))
 {
     // Initialize any default states
     m_currentData.isConnected = false;
@@ -127,9 +130,15 @@ void DayCameraControlDevice::sendCommand(const QByteArray &command) {
 }
 
 void DayCameraControlDevice::processIncomingData()
+{
+    TRACE_SCOPE("serial", "dayCamera.parse");
+    processData(cameraSerial->readAll());
+}
+
+void DayCameraControlDevice::processData(const QByteArray &data)
 {
     // Append all newly received bytes to our persistent buffer.
-    incomingBuffer.append(cameraSerial->readAll());
+    incomingBuffer.append(data);
 
     // Process complete frames (each frame is 7 bytes long).
     while (incomingBuffer.size() >= 7) {
@@ -158,6 +167,7 @@ void DayCameraControlDevice::processIncomingData()
         // 4. Compute checksum per documentation: CKSM = (ADDR + RESP1 + RESP2 + DATA1 + DATA2) & 0xFF.
         quint8 calcCksum = (addr + resp1 + resp2 + data1 + data2) & 0xFF;
         if (recvCksum != calcCksum) {
+            m_checksumErrors->increment();
             qDebug() << "Checksum mismatch in received frame:"
                      << "ADDR:" << QString::number(addr, 16)
                      << "RESP1:" << QString::number(resp1, 16)
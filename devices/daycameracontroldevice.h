@@ -5,6 +5,8 @@
 #include <QSerialPort>
 #include <QtGlobal>
 
+class MetricCounter;
+
 struct DayCameraData
 {
     bool isConnected = false;
@@ -59,6 +61,9 @@ public:
     // Inquiry commands
     void getCameraStatus();
 
+    // Frames and handles received bytes (port reads, capture replay, benchmarks)
+    void processData(const QByteArray &data);
+
 signals:
     // We keep errorOccurred for serious hardware or protocol errors
     void errorOccurred(const QString &error);
@@ -74,6 +79,7 @@ private:
     QSerialPort *cameraSerial;
     QByteArray incomingBuffer;
     DayCameraData m_currentData;
+    MetricCounter *m_checksumErrors;
 
     void sendCommand(const QByteArray &command);
     void updateDayCameraData(const DayCameraData &newData);
@@ -7,17 +7,43 @@
 #include <QCoreApplication>
 #include <gst/gl/gstglmemory.h>
 #include <gst/gstdebugutils.h>
+#include "utils/deepstreaminference.h"
+#include "utils/trace.h"
+
+namespace {
+// nvinfer runs on one batch in FUSED_PGIE_INTERVAL + 1 while AutoTrack fuses
+// detections into the DCF; the DCF carries the target on the skipped frames
+constexpr guint FUSED_PGIE_INTERVAL = 4;
+}
 
 DayCameraPipelineDevice::DayCameraPipelineDevice(const std::string& devicePath, QWidget *parent)
     : BaseCameraPipelineDevice(devicePath, parent)
 {
     gst_init(nullptr, nullptr);
     // Set camera parameters for day camera
-    cameraParams.focalLength = 1000.0;  // Example focal length
-    cameraParams.principalPoint = QPoint(640, 360);  // For 1280x720 resolution
+    // Focal length and principal point follow the calibration (updateCameraParameters)
+    cameraParams.principalPoint = QPoint(480, 360);  // For the 960x720 output
     cameraParams.rotation.setToIdentity();
     cameraParams.position = QVector3D(0.0, 0.0, 0.0);  // Origin position
 
+    m_probeDetections.reserve(64);
+
+    // Track list from the CPU detector and tracker; with DeepStream the OSD
+    // probe reports the nvtracker ids instead
+    connect(this, &BaseCameraPipelineDevice::detectionsUpdated, this, [this]() {
+        if (pipelineVariant() != PipelineVariant::Cpu)
+            return;
+        QSet<int> trackIds;
+        for (const FusionDetection &det : latestDetections()) {
+            if (det.trackId >= 0)
+                trackIds.insert(det.trackId);
+        }
+        if (trackIds != previousTrackIds) {
+            previousTrackIds = trackIds;
+            emit trackedTargetsUpdated(trackIds);
+        }
+    });
+
     qDebug() << "CameraSystem instance created:" << this;
 
  }
@@ -76,9 +102,14 @@ void DayCameraPipelineDevice::stop()
 bool DayCameraPipelineDevice::initialize()
 {
     try {
-        // Create VPI DCF Tracker
-        dcfTracker = std::make_unique<DcfTrackerVPI>(VPI_BACKEND_CUDA);
-        qDebug() << "VPI DCF Tracker created for DayCamera" << devicePath.c_str();
+        // Create VPI DCF Tracker. Without CUDA/VPI the camera still runs,
+        // with tracking unavailable.
+        try {
+            dcfTracker = std::make_unique<DcfTrackerVPI>(VPI_BACKEND_CUDA);
+            qDebug() << "VPI DCF Tracker created for DayCamera" << devicePath.c_str();
+        } catch (const std::exception& e) {
+            qWarning() << "DCF tracker unavailable for DayCamera, tracking disabled:" << e.what();
+        }
 
         // Setup GStreamer pipeline
         buildPipeline();
@@ -106,6 +137,22 @@ void DayCameraPipelineDevice::start()
 void DayCameraPipelineDevice::onSystemStateChanged(const SystemStateData &state)
 {
     m_systemState = state; 
+    updateCameraParameters(state.dayZoomPosition, state.dayCurrentHFOV);
+
+    // A frame detector only looks around the aim point while tracking/engaging
+    m_roiPlanner.setEnabled(state.opMode == OperationalMode::Tracking ||
+                            state.opMode == OperationalMode::Engagement);
+    if (pipelineVariant() == PipelineVariant::Cpu)
+        setOsdStatus(state);
+
+    // Infer less often while the DCF is corrected from detections
+    const bool fuse = isTracking() && state.motionMode == MotionMode::AutoTrack;
+    if (fuse != m_fusionActive && pgie) {
+        if (fuse)
+            g_object_get(G_OBJECT(pgie), "interval", &m_defaultPgieInterval, NULL);
+        setPGIEInterval(fuse ? FUSED_PGIE_INTERVAL : m_defaultPgieInterval);
+        m_fusionActive = fuse;
+    }
 }
 
 void DayCameraPipelineDevice::buildPipeline()
@@ -113,6 +160,53 @@ void DayCameraPipelineDevice::buildPipeline()
     // Create a GStreamer pipeline with a single appsink for display and processing
     GstBus *bus = NULL;
 
+    // Pipeline described in config/pipelines.json, when one is valid
+    PipelineDescription described;
+    if (parseCatalogPipeline(QStringLiteral("day"), described)) {
+        if (!described.taps.inference.isEmpty()) {
+            pgie = gst_bin_get_by_name(GST_BIN(this->pipeline), described.taps.inference.toUtf8().constData());
+            if (pgie) {
+                gst_object_unref(pgie); // the pipeline keeps its reference
+                // Keep the nvinfer config file named in the description
+                InferenceConfig config = m_inferenceConfig;
+                gchar *configPath = nullptr;
+                g_object_get(G_OBJECT(pgie), "config-file-path", &configPath, NULL);
+                if (configPath && *configPath)
+                    config.deepstreamConfigPath = configPath;
+                g_free(configPath);
+                auto inference = std::make_unique<DeepStreamInferenceBackend>();
+                inference->attachElement(pgie);
+                inference->load(config);
+                setDetector(std::move(inference));
+            }
+        }
+        if (!described.taps.osdProbe.isEmpty()) {
+            GstPad *osd_sink_pad = tapPad(described.taps.osdProbe);
+            if (osd_sink_pad) {
+                osd_probe_id = gst_pad_add_probe(osd_sink_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                                                 osd_sink_pad_buffer_probe, this, NULL);
+                gst_object_unref(osd_sink_pad);
+            }
+        }
+        if (startPipeline())
+            return;
+        pgie = nullptr;
+        setDetector(nullptr);
+        qWarning() << "Catalog pipeline" << described.name << "failed, using the built-in graph";
+    }
+
+    // Fall back to standard elements when DeepStream is not installed
+    const PipelineCapabilities &capabilities = PipelineCapabilities::probe();
+    if (!capabilities.hasDeepStream()) {
+        qWarning() << "DeepStream elements missing:" << capabilities.missing.join(", ")
+                   << "- building the CPU pipeline for" << devicePath.c_str();
+        CpuPipelineSettings settings;
+        settings.devicePath = QString::fromStdString(devicePath);
+        buildCpuPipeline(settings);
+        return;
+    }
+    beginPipelineTiming(PipelineVariant::DeepStream);
+
     // Create pipeline
     this->pipeline = gst_pipeline_new("deepstream-camera-app");
     if (!this->pipeline) {
@@ -126,7 +220,8 @@ void DayCameraPipelineDevice::buildPipeline()
     GstElement *nvvidconv1 = gst_element_factory_make("nvvideoconvert", "day_nvvideo-converter1");
     GstElement *capsfilter2 = gst_element_factory_make("capsfilter", "day_src-cap-filter2");
     GstElement *streammux = gst_element_factory_make("nvstreammux", "day_stream-muxer");
-    GstElement *pgie = gst_element_factory_make("nvinfer", "primary-inference-engine");
+    auto inference = std::make_unique<DeepStreamInferenceBackend>();
+    pgie = inference->createElement("primary-inference-engine");
     GstElement *tracker = gst_element_factory_make("nvtracker", "tracker");
     GstElement *nvvidconv2 = gst_element_factory_make("nvvideoconvert", "day_nvvideo-converter2");
     GstElement *nvosd = gst_element_factory_make("nvdsosd", "day_nv-onscreendisplay");
@@ -180,9 +275,8 @@ void DayCameraPipelineDevice::buildPipeline()
     g_object_set(G_OBJECT(streammux), "live-source", TRUE, NULL);
 
     // Set properties for primary inference engine
-    g_object_set(G_OBJECT(pgie),
-                "config-file-path", "/home/rapit/DeepStream-Yolo/config_infer_primary_yoloV8.txt",
-                NULL);
+    inference->load(m_inferenceConfig);
+    setDetector(std::move(inference));
 
     // Set properties for tracker
     g_object_set(G_OBJECT(tracker),
@@ -337,7 +431,8 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
 {
 
     auto self = static_cast<DayCameraPipelineDevice*>(user_data);
-    auto start = std::chrono::high_resolution_clock::now();
+    const qint64 start = LatencyMonitor::nowUs();
+    TRACE_SCOPE("osd", "day.osdProbe");
     // Increment framesSinceLastSeen for all active tracks
     for (auto &entry : self->activeTracks)
     {
@@ -389,6 +484,7 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
     case MotionMode::Pattern:    subModeText = g_strdup("Motion: PATTERN"); break;
     case MotionMode::AutoTrack:  subModeText = g_strdup("Motion: AUTO TRACK"); break;
     case MotionMode::ManualTrack:subModeText = g_strdup("Motion: MAN TRACK"); break;
+    case MotionMode::Slew:       subModeText = g_strdup("Motion: SLEW"); break;
     }
 
     char *fireModeText = nullptr;
@@ -463,6 +559,16 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
     for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame; l_frame = l_frame->next) {
         NvDsFrameMeta *frame_meta = (NvDsFrameMeta*)(l_frame->data);
 
+        // Publish fresh detections, and hand them to the DCF before the tracking
+        // modes clear them. On frames skipped by nvinfer the objects are only
+        // nvtracker predictions.
+        if (frame_meta->bInferDone) {
+            DeepStreamInferenceBackend::collectObjects(frame_meta, self->m_probeDetections);
+            self->publishDetections(self->m_probeDetections);
+            if (isTracking && state.motionMode == MotionMode::AutoTrack)
+                self->submitDetections(self->m_probeDetections);
+        }
+
         NvDsDisplayMeta *display_meta = nvds_acquire_display_meta_from_pool(batch_meta);
         display_meta->num_labels = 0;
 
@@ -917,101 +1023,96 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
 
         }
         else if (self->m_reticle_type==3){
-            const double FOV_DEGREES = 10.4;  // Wide Field of View (horizontal, in degrees) Field of View: 10.4°H x 8.3°V
-            const int RESOLUTION_HEIGHT = 720; // Vertical resolution of the frame
-            const int RESOLUTION_WIDTH = 960; // Horizontal resolution of the frame
-            double pixels_per_degree = 92.3;  //Wide: 1280 px/63.7°≈20.09pixels/degree
-                       QVector<QPair<double, double>> dropData = {
-            {100, 0.05},   // Example: Range 100m, Drop 0.2m
-                {200, 0.37},   // Example: Range 200m, Drop 0.8m
-                {300, 0.9},    // Example: Range 300m, Drop 1.8m
-                {400, 1.5},   // Example: Range 100m, Drop 0.2m
-                {500, 2.28},   // Example: Range 200m, Drop 0.8m
-                {600, 3.21}    // Example: Range 300m, Drop 1.8m
-        };
-
-        for (const auto &data : dropData) {
-            double rangeMeters = data.first; // Range (e.g., 100m, 200m)
-            double dropMeters = data.second; // Drop (in meters)
-            double dropAngleRadians = atan(dropMeters / rangeMeters); // Drop angle in radians
-            double dropAngleDegrees = dropAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-            // Convert to pixels using FOV and vertical resolution
-            int pixelOffset = static_cast<int>((dropAngleDegrees / FOV_DEGREES) * RESOLUTION_HEIGHT);
-            int reticleY = centerY + pixelOffset;
-            self->addLineToDisplayMeta(display_meta6,
-                                       centerX -3 , reticleY, centerX +3 , reticleY,
-                                       4, self->shadowLineColor );
-            self->addLineToDisplayMeta(display_meta6,
-                                       centerX -3 , reticleY, centerX +3 , reticleY,
-                                       2, self->lineColor );
-
-            // Add range label
-            //painter.drawText(centerX + 15, reticleY + 5, QString::number(static_cast<int>(rangeMeters)) + "m");
-
-
-            char* displayrangeMetersText =   g_strdup_printf(" %.0f", rangeMeters);
-            self->addTextToDisplayMeta(display_meta3, centerX + 15, reticleY + 5, displayrangeMetersText);
-            g_free(displayrangeMetersText);
-        }
-
-
-
-
-        //int centerX = RESOLUTION_WIDTH / 2; // Center of the screen (X-axis)
-        //int centerY = RESOLUTION_HEIGHT / 2; // Center of the screen (Y-axis)
-
-        // Calculate drift in meters
-        double windSpeed = 20;
-        double  rangeMeters = 500;
-        double driftMeters = (windSpeed * rangeMeters) / 800.0; // Adjust for bullet speed
-        double driftAngleRadians = atan(driftMeters / rangeMeters); // Drift angle in radians
-        double driftAngleDegrees = driftAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-        // Convert to pixels using horizontal FoV and resolution
-        int driftPixels = static_cast<int>((driftAngleDegrees / FOV_DEGREES) * RESOLUTION_WIDTH);
-
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX - driftPixels ,  centerY - 10, centerX - driftPixels , centerY + 10,
-                                   2, self->lineColor );
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX + driftPixels ,  centerY - 10, centerX + driftPixels , centerY + 10,
-                                   2, self->lineColor );
-
-        // Draw markers
-
-        // Label markers
-        char* displayldriftText =   g_strdup_printf("L");
-        self->addTextToDisplayMeta(display_meta3, centerX - driftPixels, centerY - 15, displayldriftText);
-        g_free(displayldriftText);
-
-        char* displayrdriftText =   g_strdup_printf("R");
-        self->addTextToDisplayMeta(display_meta3, centerX + driftPixels - 30, centerY - 15, displayrdriftText);
-        g_free(displayrdriftText);
-
-
-        double targetSpeed = 5;
-        // Calculate lead in meters
-        double leadMeters = (targetSpeed * rangeMeters) / 800.0; // Adjust for bullet speed
-        driftAngleRadians = atan(leadMeters / rangeMeters); // Drift angle in radians
-        driftAngleDegrees = driftAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-        // Convert to pixels using horizontal FoV and resolution
-        int leadPixels = static_cast<int>((driftAngleDegrees / FOV_DEGREES) * RESOLUTION_WIDTH);
-        // Convert to pixels
+            // Angular scale at the current zoom, from the camera calibration
+            const double pixelsPerDegree = self->cameraModel(state.dayZoomPosition, state.dayCurrentHFOV).pixelsPerDegree();
+            const double REFERENCE_CROSSWIND = 10.0; // m/s, full value, for the wind bracket
+
+            BallisticTablePtr table = self->ballisticTable();
+            if (table) {
+                // Holdover marks: interpolated table lookups, no trigonometry per frame
+                static const double markRanges[] = {100, 200, 300, 400, 500, 600, 800, 1000};
+                for (double rangeMeters : markRanges) {
+                    BallisticSolution mark = table->solve(rangeMeters);
+                    if (!mark.valid)
+                        continue;
+
+                    int reticleY = centerY + static_cast<int>(mark.holdoverDeg * pixelsPerDegree);
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX -3 , reticleY, centerX +3 , reticleY,
+                                               4, self->shadowLineColor );
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX -3 , reticleY, centerX +3 , reticleY,
+                                               2, self->lineColor );
+
+                    // Add range label
+                    char* displayrangeMetersText =   g_strdup_printf(" %.0f", rangeMeters);
+                    self->addTextToDisplayMeta(display_meta3, centerX + 15, reticleY + 5, displayrangeMetersText);
+                    g_free(displayrangeMetersText);
+                }
 
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX - leadPixels ,  centerY - 10, centerX - leadPixels , centerY + 10,
-                                   2, self->lineColor );
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX + leadPixels ,  centerY - 10, centerX + leadPixels , centerY + 10,
-                                   2, self->lineColor );
-        // Draw markers
+                // Wind and lead brackets at the LRF range (500 m without a range)
+                double rangeMeters = state.lrfDistance > 0.0 ? state.lrfDistance : 500.0;
+                BallisticSolution aim = table->solve(rangeMeters);
+                if (aim.valid) {
+                    int aimY = centerY + static_cast<int>(aim.holdoverDeg * pixelsPerDegree);
+                    if (state.lrfDistance > 0.0) {
+                        // Aim point for the measured range
+                        self->addLineToDisplayMeta(display_meta6,
+                                                   centerX - 8, aimY, centerX + 8, aimY,
+                                                   4, self->shadowLineColor );
+                        self->addLineToDisplayMeta(display_meta6,
+                                                   centerX - 8, aimY, centerX + 8, aimY,
+                                                   2, self->lineColor );
+                    }
 
-        // Label markers
-        //painter.drawText(centerX - leadPixels - 30, centerY - 15, "Lead Left");
-        //painter.drawText(centerX + leadPixels + 10, centerY - 15, "Lead Right");
+                    int driftPixels = static_cast<int>(aim.windageDeg(REFERENCE_CROSSWIND) * pixelsPerDegree);
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX - driftPixels ,  aimY - 10, centerX - driftPixels , aimY + 10,
+                                               2, self->lineColor );
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX + driftPixels ,  aimY - 10, centerX + driftPixels , aimY + 10,
+                                               2, self->lineColor );
+
+                    // Label markers
+                    char* displayldriftText =   g_strdup_printf("L");
+                    self->addTextToDisplayMeta(display_meta3, centerX - driftPixels, aimY - 15, displayldriftText);
+                    g_free(displayldriftText);
+
+                    char* displayrdriftText =   g_strdup_printf("R");
+                    self->addTextToDisplayMeta(display_meta3, centerX + driftPixels - 30, aimY - 15, displayrdriftText);
+                    g_free(displayrdriftText);
+
+                    // Automatic lead from the tracked target's angular velocity. In the
+                    // tracking modes the gimbal already aims ahead (offset aim), so the
+                    // reticle centre is the aim point and only the label is shown.
+                    if (state.leadAngleValid) {
+                        const bool offsetAim = state.motionMode == MotionMode::AutoTrack ||
+                                               state.motionMode == MotionMode::ManualTrack;
+                        int leadX = centerX;
+                        int leadY = aimY;
+                        if (!offsetAim) {
+                            leadX += static_cast<int>(state.leadAzDeg * pixelsPerDegree);
+                            leadY -= static_cast<int>(state.leadElDeg * pixelsPerDegree);
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX - 6, leadY, leadX + 6, leadY,
+                                                       4, self->shadowLineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX, leadY - 6, leadX, leadY + 6,
+                                                       4, self->shadowLineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX - 6, leadY, leadX + 6, leadY,
+                                                       2, self->lineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX, leadY - 6, leadX, leadY + 6,
+                                                       2, self->lineColor );
+                        }
 
+                        char* displayLeadText =   g_strdup_printf("LEAD %.1f", state.leadAzDeg);
+                        self->addTextToDisplayMeta(display_meta3, leadX + 10, leadY + 10, displayLeadText);
+                        g_free(displayLeadText);
+                    }
+                }
+            }
         }
 
 
@@ -1164,48 +1265,21 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
 
                     nvds_add_display_meta_to_frame(frame_meta, display_meta);
 
-                    // **Calculate Target Angles Adjusted for Cropping**
-
-                    // Image dimensions after cropping
-                    double croppedImageWidth = frame_meta->source_frame_width; // Should be 960
-                    double croppedImageHeight = frame_meta->source_frame_height; // Should be 720
-
-                    // Image center
-                    double imageCenterX = croppedImageWidth / 2.0;
-                    double imageCenterY = croppedImageHeight / 2.0;
-
-                    // Target center coordinates
+                    // Target angles relative to the gun bore, from the camera calibration
                     double targetX = obj_meta->rect_params.left + obj_meta->rect_params.width / 2.0;
                     double targetY = obj_meta->rect_params.top + obj_meta->rect_params.height / 2.0;
 
-                    // Offsets from center
-                    double deltaX = targetX - imageCenterX;
-                    double deltaY = imageCenterY - targetY;
-
-                    // Effective FOV calculations
-                    double cameraHorizontalFOV =  90.0; // Replace with   camera's actual HFOV
-                    double originalImageWidth = 1280.0;
-                    double originalImageHeight = originalImageWidth * 9/16;
-                    double effectiveHorizontalFOV = cameraHorizontalFOV * (croppedImageWidth / originalImageWidth);
-                    double anglePerPixelX = effectiveHorizontalFOV / croppedImageWidth;
+                    double targetAzimuth = 0.0;
+                    double targetElevation = 0.0;
+                    self->cameraModel(state.dayZoomPosition, state.dayCurrentHFOV)
+                        .pixelToAngle(targetX, targetY, targetAzimuth, targetElevation);
 
-                    double cameraVerticalFOV = cameraHorizontalFOV * (originalImageHeight / originalImageWidth);
-                    double anglePerPixelY = cameraVerticalFOV / croppedImageHeight;
-
-                    // Calculate target angles
-                    double targetAzimuthOffset = deltaX * anglePerPixelX;
-                    double targetElevationOffset = deltaY * anglePerPixelY;
-
-                    double currentAzimuth = 0; //self->m_dataModel->get;
-                    double currentElevation = 0; //self->m_dataModel->getElevationPosition();
-
-                    double targetAzimuth = currentAzimuth + targetAzimuthOffset;
-                    double targetElevation = currentElevation + targetElevationOffset;
-
-                    // Emit signal to update target position
+                    // Emit signal to update target position; while the DCF tracker
+                    // runs it publishes the target itself (one source per frame)
                     //qDebug() << "Emitting targetPositionUpdated from CameraSystem instance:" << self;
 
-                    emit self->targetPositionUpdated(targetAzimuth, targetElevation);
+                    if (!self->trackingEnabled)
+                        emit self->targetPositionUpdated(targetAzimuth, targetElevation);
 
                 }
                 std::vector<int> tracksToRemove;
@@ -1355,18 +1429,16 @@ GstPadProbeReturn DayCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad
     } // End of frame loop
 
 
-    auto end = std::chrono::high_resolution_clock::now();
-
-    // Calculate the elapsed time in microseconds
-    auto elapsedTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    if (elapsedTimeUs > 2000)
-        std::cout << "Processing time: " << elapsedTimeUs << " microseconds (" <<   std::endl;
+    // Probe processing time, in the latency histograms of this camera
+    LatencyMonitor::instance().record(self->latencySource(), LatencyStage::OsdProbe,
+                                      LatencyMonitor::nowUs() - start);
 
     return GST_PAD_PROBE_OK;
 }
 
 void DayCameraPipelineDevice::setPGIEInterval(guint interval)
-{    if (!pipeline)
+{
+    if (!pgie)
         return;
     g_object_set(G_OBJECT(pgie), "interval", interval, NULL);
 }
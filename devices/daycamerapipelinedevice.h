@@ -107,7 +107,6 @@ signals:
     void trackedTargetsUpdated(const QSet<int> &trackIds);
     void trackingResult(QRect updatedBoundingBox);
     void selectedTrackLost(int trackId);
-    void targetPositionUpdated(double targetAzimuth, double targetElevation);
     void pipelineShutdownComplete();
     void errorOccurred(const QString &errorMessage);
     void endOfStream();
@@ -156,7 +155,7 @@ private:
     GstElement *capsfilter3;
     GstElement *nvvidconvsrc1;
     GstElement *nvvidconvsrc2;
-    GstElement *pgie;
+    GstElement *pgie = nullptr;
     GstElement *tracker;
     GstElement *nvvidconvsrc3;
     GstElement *jpegparse;
@@ -225,6 +224,12 @@ private:
     NvOSD_ColorParams shadowLineColor;
     NvOSD_FontParams textFontParam, textFontParam_;
 
+    // Detections collected from nvinfer by the OSD probe, and the
+    // inference interval used while the DCF carries the target in between
+    std::vector<FusionDetection> m_probeDetections;
+    guint m_defaultPgieInterval = 0;
+    bool m_fusionActive = false;
+
     int m_reticle_type;
     SystemStateModel* m_stateModel;
     SystemStateData m_systemState; // local copy for OSD usage
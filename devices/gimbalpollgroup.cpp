@@ -0,0 +1,120 @@
+#include "gimbalpollgroup.h"
+#include "utils/metricsregistry.h"
+#include "utils/trace.h"
+#include <QTimer>
+
+GimbalPollGroup::GimbalPollGroup(ServoDriverDevice *azServo, ServoDriverDevice *elServo, QObject *parent)
+    : QObject(parent),
+    m_azServo(azServo),
+    m_elServo(elServo),
+    m_timer(new QTimer(this))
+{
+    m_skew = MetricsRegistry::instance().histogram(
+        QStringLiteral("el7aress_gimbal_axis_skew_seconds"),
+        QStringLiteral("Time between the az and el servo samples of one gimbal sample"));
+    m_dropped = MetricsRegistry::instance().counter(
+        QStringLiteral("el7aress_gimbal_samples_dropped_total"),
+        QStringLiteral("Gimbal poll ticks whose az/el pair was not complete by the next tick"));
+
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &GimbalPollGroup::poll);
+
+    m_azServo->setExternalPolling(true);
+    m_elServo->setExternalPolling(true);
+    connect(m_azServo, &ServoDriverDevice::statusSampled, this, &GimbalPollGroup::onAzSampled);
+    connect(m_elServo, &ServoDriverDevice::statusSampled, this, &GimbalPollGroup::onElSampled);
+}
+
+GimbalPollGroup::~GimbalPollGroup()
+{
+    stop();
+}
+
+void GimbalPollGroup::start(int periodMs)
+{
+    m_timer->start(periodMs);
+}
+
+void GimbalPollGroup::stop()
+{
+    m_timer->stop();
+}
+
+void GimbalPollGroup::poll()
+{
+    TRACE_SCOPE("modbus", "gimbal.poll");
+
+    // The previous tick's pair is incomplete: publish the axis that answered
+    if (m_publishedSequence != m_sequence) {
+        if (m_az.sequence == m_sequence)
+            publishSingleAxis(m_az, true);
+        if (m_el.sequence == m_sequence)
+            publishSingleAxis(m_el, false);
+    }
+
+    // Ticks in which no axis was asked (disconnected) are not counted
+    const bool asked = m_az.pendingSequence == m_sequence || m_el.pendingSequence == m_sequence;
+    if (m_sequence > 0 && asked && m_publishedSequence != m_sequence)
+        m_dropped->increment();
+
+    ++m_sequence;
+    // Back to back, so the two requests leave within microseconds of each other
+    if (m_azServo->pollStatus())
+        m_az.pendingSequence = m_sequence;
+    if (m_elServo->pollStatus())
+        m_el.pendingSequence = m_sequence;
+}
+
+void GimbalPollGroup::onAzSampled(const ServoData &data, qint64 timestampUs)
+{
+    m_az.sequence = m_az.pendingSequence;
+    m_az.data = data;
+    m_az.timestampUs = timestampUs;
+    publishIfComplete();
+}
+
+void GimbalPollGroup::onElSampled(const ServoData &data, qint64 timestampUs)
+{
+    m_el.sequence = m_el.pendingSequence;
+    m_el.data = data;
+    m_el.timestampUs = timestampUs;
+    publishIfComplete();
+}
+
+void GimbalPollGroup::publishIfComplete()
+{
+    if (m_az.sequence != m_el.sequence) {
+        // A partner with no read in flight for the same tick will not complete the pair
+        if (m_az.sequence > m_el.sequence && m_el.pendingSequence != m_az.sequence)
+            publishSingleAxis(m_az, true);
+        if (m_el.sequence > m_az.sequence && m_az.pendingSequence != m_el.sequence)
+            publishSingleAxis(m_el, false);
+        return;
+    }
+    if (m_az.sequence == 0 || m_az.sequence == m_publishedSequence)
+        return;
+
+    GimbalSample sample;
+    sample.az = m_az.data;
+    sample.el = m_el.data;
+    sample.azTimestampUs = m_az.timestampUs;
+    sample.elTimestampUs = m_el.timestampUs;
+    sample.timestampUs = m_az.timestampUs + (m_el.timestampUs - m_az.timestampUs) / 2;
+    sample.sequence = m_az.sequence;
+
+    m_publishedSequence = sample.sequence;
+    m_lastSample = sample;
+    m_skew->record(sample.skewUs());
+    emit gimbalSampleReady(sample);
+}
+
+void GimbalPollGroup::publishSingleAxis(AxisSlot &slot, bool azimuth)
+{
+    if (slot.sequence == 0 || slot.singleSequence == slot.sequence)
+        return;
+    slot.singleSequence = slot.sequence;
+    if (azimuth)
+        emit azSampleReady(slot.data);
+    else
+        emit elSampleReady(slot.data);
+}
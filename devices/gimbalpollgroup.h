@@ -0,0 +1,108 @@
+#ifndef GIMBALPOLLGROUP_H
+#define GIMBALPOLLGROUP_H
+
+/**
+ * @file gimbalpollgroup.h
+ * @brief Synchronized status polling of the azimuth and elevation servo drivers.
+ *
+ * Each driver used to poll on its own 50 ms timer, so an az and an el
+ * position taken up to one period apart were combined in the control math.
+ * The group issues both status reads in the same tick and publishes the pair
+ * only when both replies of that tick arrived. An axis whose partner did not
+ * answer is still published on its own, so one failing drive does not freeze
+ * the position of the other.
+ */
+
+#include <QObject>
+#include <QtGlobal>
+#include "servodriverdevice.h"
+
+class QTimer;
+class MetricCounter;
+class MetricHistogram;
+
+/**
+ * @struct GimbalSample
+ * @brief Time-aligned az/el servo status (position, rpm, torque, ...).
+ */
+struct GimbalSample {
+    ServoData az;
+    ServoData el;
+    qint64 azTimestampUs = 0; ///< Estimated sampling time of az (LatencyMonitor::nowUs() clock).
+    qint64 elTimestampUs = 0; ///< Estimated sampling time of el.
+    qint64 timestampUs = 0;   ///< Midpoint of the two.
+    quint64 sequence = 0;     ///< Poll tick that produced the pair.
+
+    qint64 skewUs() const { return qAbs(azTimestampUs - elTimestampUs); }
+};
+
+/**
+ * @class GimbalPollGroup
+ * @brief Polls both servo drivers in one tick and emits GimbalSample.
+ *
+ * The drivers are switched to external polling; servoDataChanged keeps
+ * working for the per-axis models. A tick whose pair is incomplete (timeout,
+ * or one axis still busy with the previous read) is dropped, never mixed
+ * with a neighbouring tick. A pair completing after the next tick began is
+ * still published but counted as dropped.
+ *
+ * The axis that did answer an incomplete tick is emitted alone through
+ * azSampleReady() / elSampleReady(): at once if the other axis was not asked
+ * (disconnected or busy), at the next tick if its read timed out.
+ *
+ * Metrics: el7aress_gimbal_axis_skew_seconds (|t_az - t_el| per pair) and
+ * el7aress_gimbal_samples_dropped_total.
+ */
+class GimbalPollGroup : public QObject
+{
+    Q_OBJECT
+public:
+    GimbalPollGroup(ServoDriverDevice *azServo, ServoDriverDevice *elServo, QObject *parent = nullptr);
+    ~GimbalPollGroup();
+
+    /** @brief Starts polling every @p periodMs. */
+    void start(int periodMs = 50);
+    void stop();
+
+    /** @brief Last published pair (sequence 0 until the first one). */
+    const GimbalSample &lastSample() const { return m_lastSample; }
+
+signals:
+    void gimbalSampleReady(const GimbalSample &sample);
+    /** @brief Az answered a tick whose el reply is missing. */
+    void azSampleReady(const ServoData &data);
+    /** @brief El answered a tick whose az reply is missing. */
+    void elSampleReady(const ServoData &data);
+
+private slots:
+    void poll();
+    void onAzSampled(const ServoData &data, qint64 timestampUs);
+    void onElSampled(const ServoData &data, qint64 timestampUs);
+
+private:
+    struct AxisSlot {
+        quint64 pendingSequence = 0; ///< Tick of the read in flight.
+        quint64 sequence = 0;        ///< Tick of data/timestampUs.
+        quint64 singleSequence = 0;  ///< Tick last published without its partner.
+        ServoData data;
+        qint64 timestampUs = 0;
+    };
+
+    void publishIfComplete();
+    void publishSingleAxis(AxisSlot &slot, bool azimuth);
+
+    ServoDriverDevice *m_azServo = nullptr;
+    ServoDriverDevice *m_elServo = nullptr;
+    QTimer *m_timer = nullptr;
+
+    quint64 m_sequence = 0;          ///< Current tick.
+    quint64 m_publishedSequence = 0; ///< Tick of m_lastSample.
+    AxisSlot m_az;
+    AxisSlot m_el;
+    GimbalSample m_lastSample;
+
+    MetricHistogram *m_skew = nullptr;
+    MetricCounter *m_dropped = nullptr;
+};
+
+#endif // GIMBALPOLLGROUP_H
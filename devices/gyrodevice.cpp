@@ -1,9 +1,13 @@
 #include "gyrodevice.h"
 #include <QTimer>
 #include <QDebug>
+#include "utils/trace.h"
+#include "utils/metricsregistry.h"
+#include <chrono>
 
 GyroDevice::GyroDevice(QObject *parent)
-    : QObject(parent), gyroSerial(new QSerialPort(this)), m_isConnected(false)
+    : QObject(parent), gyroSerial(new QSerialPort(this)), m_isConnected(false),
+      m_checksumErrors(serialChecksumErrorCounter(QStringLiteral("gyro")))
 {
 }
 
@@ -12,21 +16,34 @@ GyroDevice::~GyroDevice()
     shutdown();
 }
 
-bool GyroDevice::openSerialPort(const QString &portName) {
+bool GyroDevice::openSerialPort(const QString &portName, Protocol protocol, qint32 baudRate) {
     if (gyroSerial->isOpen()) {
         gyroSerial->close();
     }
 
+    m_protocol = protocol;
+    if (baudRate > 0) {
+        m_baudRate = baudRate;
+    } else {
+        m_baudRate = (protocol == Protocol::Binary) ? 921600 : QSerialPort::Baud9600;
+    }
+    m_textBuffer.clear();
+    m_binaryParser.reset();
+    m_binaryParser.setSamplePeriodNs(0);
+    m_samplePeriodNs = 0;
+    m_lastDecodeNs = 0;
+    m_reportedChecksumErrors = 0;
+
     gyroSerial->setPortName(portName);
-    gyroSerial->setBaudRate(QSerialPort::Baud9600);
+    gyroSerial->setBaudRate(m_baudRate);
     gyroSerial->setDataBits(QSerialPort::Data8);
     gyroSerial->setParity(QSerialPort::NoParity);
     gyroSerial->setStopBits(QSerialPort::OneStop);
     gyroSerial->setFlowControl(QSerialPort::NoFlowControl);
 
     if (gyroSerial->open(QIODevice::ReadWrite)) {
-        connect(gyroSerial, &QSerialPort::readyRead, this, &GyroDevice::processGyroData);
-        connect(gyroSerial, &QSerialPort::errorOccurred, this, &GyroDevice::handleSerialError);
+        connect(gyroSerial, &QSerialPort::readyRead, this, &GyroDevice::processGyroData, Qt::UniqueConnection);
+        connect(gyroSerial, &QSerialPort::errorOccurred, this, &GyroDevice::handleSerialError, Qt::UniqueConnection);
         qDebug() << "Opened gyro serial port:" << portName;
         m_isConnected = true;
         emit statusChanged(m_isConnected);
@@ -54,21 +71,72 @@ void GyroDevice::shutdown() {
     // Additional cleanup if necessary
 }
 
+qint64 GyroDevice::monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void GyroDevice::processGyroData() {
+    TRACE_SCOPE("serial", "gyro.parse");
+    // Timestamp at the readyRead boundary, before any parsing
+    const qint64 timestampNs = monotonicNs();
+
     // Read data from the serial port
-    QByteArray data = gyroSerial->readAll();
-    // Process the data to extract Roll, Pitch, Yaw
-    // For demonstration, let's assume the data is in a specific format
+    processData(gyroSerial->readAll(), timestampNs);
+}
+
+void GyroDevice::processData(const QByteArray &data, qint64 timestampNs)
+{
+    if (m_protocol == Protocol::Binary) {
+        processBinaryData(data, timestampNs);
+    } else {
+        processTextData(data, timestampNs);
+    }
+}
+
+void GyroDevice::processBinaryData(const QByteArray &data, qint64 timestampNs)
+{
+    std::size_t decoded = 0;
+    m_binaryParser.feed(data.constData(), static_cast<std::size_t>(data.size()), timestampNs,
+                        [this, &decoded](const GyroSample &sample) {
+                            ++decoded;
+                            publishSample(sample);
+                        });
+
+    // Estimate the IMU sample period from the chunk stamps so the parser can
+    // space several samples decoded from one read instead of stamping them alike
+    if (decoded > 0) {
+        if (m_lastDecodeNs > 0) {
+            const qint64 periodNs = (timestampNs - m_lastDecodeNs) / static_cast<qint64>(decoded);
+            if (periodNs >= MIN_SAMPLE_PERIOD_NS && periodNs <= MAX_SAMPLE_PERIOD_NS) {
+                m_samplePeriodNs = (m_samplePeriodNs == 0)
+                    ? periodNs
+                    : m_samplePeriodNs + (periodNs - m_samplePeriodNs) / 8;
+                m_binaryParser.setSamplePeriodNs(m_samplePeriodNs);
+            }
+        }
+        m_lastDecodeNs = timestampNs;
+    }
+
+    const std::uint64_t errors = m_binaryParser.checksumErrors();
+    if (errors > m_reportedChecksumErrors) {
+        m_checksumErrors->increment(errors - m_reportedChecksumErrors);
+        m_reportedChecksumErrors = errors;
+    }
+}
+
+void GyroDevice::processTextData(const QByteArray &data, qint64 timestampNs)
+{
     // Example: "R:1.0,P:2.0,Y:3.0\n"
 
     // Accumulate data until we have a full line
-    static QByteArray buffer;
-    buffer.append(data);
+    m_textBuffer.append(data);
 
-    while (buffer.contains('\n')) {
-        int endIndex = buffer.indexOf('\n');
-        QByteArray lineData = buffer.left(endIndex).trimmed();
-        buffer.remove(0, endIndex + 1);
+    while (m_textBuffer.contains('\n')) {
+        int endIndex = m_textBuffer.indexOf('\n');
+        QByteArray lineData = m_textBuffer.left(endIndex).trimmed();
+        m_textBuffer.remove(0, endIndex + 1);
 
         QString line = QString::fromUtf8(lineData);
         // Parse the line to extract gyro data
@@ -81,10 +149,39 @@ void GyroDevice::processGyroData() {
             double yaw = parts[2].section(':', 1).toDouble(&ok3);
 
             if (ok1 && ok2 && ok3) {
-                emit gyroDataReceived(roll, pitch, yaw);
+                GyroSample sample;
+                sample.timestampNs = timestampNs;
+                sample.roll = roll;
+                sample.pitch = pitch;
+                sample.yaw = yaw;
+                publishSample(sample);
             }
         }
     }
+
+    // Guard against a stream without line breaks (e.g. wrong protocol selected)
+    if (m_textBuffer.size() > 1024) {
+        m_textBuffer.clear();
+    }
+}
+
+void GyroDevice::publishSample(const GyroSample &sample)
+{
+    // 1) control loop path, full rate
+    m_sampleQueue.tryPush(sample);
+
+    emit gyroDataReceived(sample.roll, sample.pitch, sample.yaw);
+
+    // 2) model path, decimated to display rate
+    if (sample.timestampNs - m_lastPublishNs >= MODEL_PUBLISH_INTERVAL_NS) {
+        m_lastPublishNs = sample.timestampNs;
+
+        GyroData newData = m_currentData;
+        newData.roll = sample.roll;
+        newData.pitch = sample.pitch;
+        newData.yaw = sample.yaw;
+        updateGyroData(newData);
+    }
 }
 
 void GyroDevice::updateGyroData(const GyroData &newData)
@@ -107,7 +204,7 @@ void GyroDevice::handleSerialError(QSerialPort::SerialPortError error) {
 
 void GyroDevice::attemptReconnection() {
     if (!gyroSerial->isOpen()) {
-        if (openSerialPort(gyroSerial->portName())) {
+        if (openSerialPort(gyroSerial->portName(), m_protocol, m_baudRate)) {
             qDebug() << "Gyro serial port reconnected.";
             // Reinitialize if necessary
         } else {
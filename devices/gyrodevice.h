@@ -8,6 +8,11 @@
 #include <QByteArray>
 #include <QThread>
 
+#include "utils/gyrobinaryparser.h"
+#include "utils/spscqueue.h"
+
+class MetricCounter;
+
 // Structure to hold actuator data.
 struct GyroData {
     double     roll  = 0;
@@ -25,16 +30,41 @@ struct GyroData {
 };
 
 
+// Samples handed from the serial reader to the gimbal control loop
+using GyroSampleQueue = SpscQueue<GyroSample, 1024>;
+
 class GyroDevice : public QObject {
         Q_OBJECT
 public:
+    // Wire protocol of the IMU output
+    enum class Protocol {
+        Text,   // "R:1.0,P:2.0,Y:3.0\n" at 9600 baud (fallback)
+        Binary  // fixed 28-byte frames at high baud, see gyrobinaryparser.h
+    };
+
     explicit GyroDevice(QObject *parent = nullptr);
     ~GyroDevice();
 
-    bool openSerialPort(const QString &portName);
+    bool openSerialPort(const QString &portName, Protocol protocol = Protocol::Text,
+                        qint32 baudRate = 0);
     void closeSerialPort();
     void shutdown();
 
+    Protocol protocol() const { return m_protocol; }
+    // Protocol of the bytes given to processData(); openSerialPort() sets it too
+    void setProtocol(Protocol protocol) { m_protocol = protocol; }
+
+    // Parses received bytes stamped at timestampNs (port reads, capture replay, benchmarks)
+    void processData(const QByteArray &data, qint64 timestampNs);
+
+    // Consumer side of the sample queue (control loop only)
+    bool popSample(GyroSample &sample) { return m_sampleQueue.tryPop(sample); }
+    std::size_t droppedSampleCount() const { return m_sampleQueue.droppedCount(); }
+    const GyroBinaryParser &binaryParser() const { return m_binaryParser; }
+
+    // Monotonic clock shared by sample timestamps and their consumers (ns)
+    static qint64 monotonicNs();
+
 signals:
     void gyroDataReceived(double Roll, double Pitch, double Yaw);
     void errorOccurred(const QString &error);
@@ -50,11 +80,33 @@ private slots:
     void updateGyroData(const GyroData &newData);
 private:
 
+    void processTextData(const QByteArray &data, qint64 timestampNs);
+    void processBinaryData(const QByteArray &data, qint64 timestampNs);
+    void publishSample(const GyroSample &sample);
+
     QSerialPort *gyroSerial;
     bool m_isConnected;
+    Protocol m_protocol = Protocol::Text;
+    qint32 m_baudRate = QSerialPort::Baud9600;
 
     GyroData m_currentData;
 
+    QByteArray m_textBuffer;
+    GyroBinaryParser m_binaryParser;
+    MetricCounter *m_checksumErrors;
+    std::uint64_t m_reportedChecksumErrors = 0; // parser errors already counted
+    GyroSampleQueue m_sampleQueue;
+
+    // Running estimate of the IMU sample period, handed to m_binaryParser
+    static constexpr qint64 MIN_SAMPLE_PERIOD_NS = 1000000;   // 1 kHz
+    static constexpr qint64 MAX_SAMPLE_PERIOD_NS = 100000000; // 10 Hz
+    qint64 m_samplePeriodNs = 0;
+    qint64 m_lastDecodeNs = 0;
+
+    // The aggregated model only needs display-rate updates
+    static constexpr qint64 MODEL_PUBLISH_INTERVAL_NS = 50000000;
+    qint64 m_lastPublishNs = 0;
+
 };
 
 #endif // GYROINTERFACE_H
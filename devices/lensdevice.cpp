@@ -1,5 +1,6 @@
 #include "lensdevice.h"
 #include <QDebug>
+#include "utils/trace.h"
 #include <QTimer>
 
 /*
@@ -146,6 +147,7 @@ QString LensDevice::sendCommand(const QString &command)
 
 void LensDevice::parseLensResponse(const QString &rawResponse)
 {
+    TRACE_SCOPE("serial", "lens.parse");
     LensData newData = m_currentData;
 
     // EXAMPLE: pretend the device returns something like "FOCUS=215 TEMP=38.2"
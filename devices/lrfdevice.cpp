@@ -1,11 +1,14 @@
 #include "lrfdevice.h"
 #include <QDebug>
+#include "utils/trace.h"
+#include "utils/metricsregistry.h"
 #include <QSerialPortInfo>
 #include <QTimer>
 
 LRFDevice::LRFDevice(QObject *parent)
     : QObject(parent),
-    m_serialPort(new QSerialPort(this))
+    m_serialPort(new QSerialPort(this)),
+    m_checksumErrors(serialChecksumErrorCounter(QStringLiteral("lrf")))
 {
     // Initialize and connect signals for the serial port
     connect(m_serialPort, &QSerialPort::readyRead,
@@ -70,10 +73,16 @@ void LRFDevice::shutdown()
 
 void LRFDevice::processIncomingData()
 {
+    TRACE_SCOPE("serial", "lrf.parse");
     if (!m_serialPort || !m_serialPort->isOpen())
         return;
 
-    m_readBuffer.append(m_serialPort->readAll());
+    processData(m_serialPort->readAll());
+}
+
+void LRFDevice::processData(const QByteArray &data)
+{
+    m_readBuffer.append(data);
 
     // Attempt to parse multiple packets if present
     while (m_readBuffer.size() >= 3) {
@@ -97,6 +106,7 @@ void LRFDevice::processIncomingData()
 
         // Verify checksum
         if (!verifyChecksum(packet)) {
+            m_checksumErrors->increment();
             emit errorOccurred("Checksum mismatch in incoming packet.");
             continue;
         }
@@ -10,6 +10,8 @@
 
 #include <QtGlobal>
 
+class MetricCounter;
+
 // This struct holds key LRF states
 struct LrfData {
     bool isConnected = false;
@@ -71,6 +73,9 @@ public:
     void querySettingValue();
     void queryAccumulatedLaserCount();
 
+    // Frames and handles received bytes (port reads, capture replay, benchmarks)
+    void processData(const QByteArray &data);
+
 signals:
     // Emitted when a serious hardware or protocol error occurs
     void errorOccurred(const QString &error);
@@ -133,6 +138,7 @@ private:
 
     QByteArray m_readBuffer;
     LrfData m_currentData;
+    MetricCounter *m_checksumErrors;
 
     QTimer *m_statusTimer;
 };
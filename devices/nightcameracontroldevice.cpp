@@ -1,11 +1,14 @@
 #include "nightcameracontroldevice.h"
 #include <QDebug>
+#include "utils/trace.h"
+#include "utils/metricsregistry.h"
 #include <QTimer>
 
 
 
 NightCameraControlDevice::NightCameraControlDevice(QObject *parent)
-    : QObject(parent), cameraSerial(new QSerialPort(this)), m_isConnected(false)
+    : QObject(parent), cameraSerial(new QSerialPort(this)), m_isConnected(false),
+      m_checksumErrors(serialChecksumErrorCounter(QStringLiteral("night_camera")))
 {
     m_currentData.isConnected = false;
 }
@@ -195,9 +198,14 @@ quint16 NightCameraControlDevice::calculateCRC(const QByteArray &data, int lengt
 }
 
 void NightCameraControlDevice::processIncomingData() {
+    TRACE_SCOPE("serial", "nightCamera.parse");
     if (!cameraSerial) return;
 
-    incomingBuffer += cameraSerial->readAll();
+    processData(cameraSerial->readAll());
+}
+
+void NightCameraControlDevice::processData(const QByteArray &data) {
+    incomingBuffer += data;
 
     // Tau2 packets have a minimum length of 10 bytes: 6-byte header + CRC1 + data + CRC2
     while (incomingBuffer.size() >= 10) {
@@ -228,6 +236,7 @@ void NightCameraControlDevice::processIncomingData() {
 
         // Verify CRCs
         if (!verifyCRC(packet)) {
+            m_checksumErrors->increment();
             emit errorOccurred("CRC mismatch in incoming packet.");
             continue;
         }
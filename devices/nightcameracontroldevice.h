@@ -5,6 +5,8 @@
 #include <QSerialPort>
 #include <QtGlobal>
 
+class MetricCounter;
+
 struct NightCameraData
 {
     bool isConnected = false;
@@ -50,6 +52,12 @@ public:
     void performFFC();
     void getCameraStatus();
 
+    // Frames and handles received bytes (port reads, capture replay, benchmarks)
+    void processData(const QByteArray &data);
+
+    // CRC-16/CCITT (poly 0x1021, init 0) over the first length bytes, as used by Tau2
+    static quint16 calculateCRC(const QByteArray &data, int length);
+
 signals:
     // Original signals
     void responseReceived(const QByteArray &response);
@@ -69,7 +77,6 @@ private slots:
 private:
     void sendCommand(const QByteArray &command);
     QByteArray buildCommand(quint8 function, const QByteArray &data);
-    quint16 calculateCRC(const QByteArray &data, int length);
     bool verifyCRC(const QByteArray &packet);
 
     // specialized response handlers
@@ -84,6 +91,7 @@ private:
     QSerialPort *cameraSerial;
     bool m_isConnected;
     QByteArray incomingBuffer;
+    MetricCounter *m_checksumErrors;
 
     // Our "bulk" data struct
     NightCameraData m_currentData;
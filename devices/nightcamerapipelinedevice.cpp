@@ -7,6 +7,7 @@
 #include <QCoreApplication>
 #include <gst/gl/gstglmemory.h>
 #include <gst/gstdebugutils.h>
+#include "utils/trace.h"
 
 
 NightCameraPipelineDevice::NightCameraPipelineDevice(const std::string &devicePath, QWidget *parent)
@@ -14,8 +15,8 @@ NightCameraPipelineDevice::NightCameraPipelineDevice(const std::string &devicePa
 {
     gst_init(nullptr, nullptr);
     // Set camera parameters for night camera
-    cameraParams.focalLength = 1000.0;  // Example focal length
-    cameraParams.principalPoint = QPoint(640, 360);  // For 1280x720 resolution
+    // Focal length and principal point follow the calibration (updateCameraParameters)
+    cameraParams.principalPoint = QPoint(480, 360);  // For the 960x720 output
     cameraParams.rotation.setToIdentity();
     cameraParams.position = QVector3D(0.0, 0.0, 0.0);  // Origin position
 
@@ -32,9 +33,14 @@ NightCameraPipelineDevice::~NightCameraPipelineDevice()
 bool NightCameraPipelineDevice::initialize()
 {
     try {
-        // Create VPI DCF Tracker
-        dcfTracker = std::make_unique<DcfTrackerVPI>(VPI_BACKEND_CUDA);
-        qDebug() << "VPI DCF Tracker created for nightCamera" << devicePath.c_str();
+        // Create VPI DCF Tracker. Without CUDA/VPI the camera still runs,
+        // with tracking unavailable.
+        try {
+            dcfTracker = std::make_unique<DcfTrackerVPI>(VPI_BACKEND_CUDA);
+            qDebug() << "VPI DCF Tracker created for nightCamera" << devicePath.c_str();
+        } catch (const std::exception& e) {
+            qWarning() << "DCF tracker unavailable for nightCamera, tracking disabled:" << e.what();
+        }
 
         // Setup GStreamer pipeline
         buildPipeline();
@@ -110,6 +116,13 @@ void NightCameraPipelineDevice::onSystemStateChanged(const SystemStateData &stat
 {
     //QMutexLocker locker(&m_pipelineMutex);
     m_systemState = state;
+    updateCameraParameters(state.nightZoomPosition, state.nightCurrentHFOV);
+
+    // A frame detector only looks around the aim point while tracking/engaging
+    m_roiPlanner.setEnabled(state.opMode == OperationalMode::Tracking ||
+                            state.opMode == OperationalMode::Engagement);
+    if (pipelineVariant() == PipelineVariant::Cpu)
+        setOsdStatus(state);
 
     // We do not immediately draw; we just store. The OSD pad probe will read m_systemState.
 }
@@ -119,6 +132,34 @@ void NightCameraPipelineDevice::buildPipeline(){
      // Create a GStreamer pipeline with a single appsink for display and processing
      GstBus *bus = NULL;
 
+     // Pipeline described in config/pipelines.json, when one is valid
+     PipelineDescription described;
+     if (parseCatalogPipeline(QStringLiteral("night"), described)) {
+         if (!described.taps.osdProbe.isEmpty()) {
+             GstPad *osd_sink_pad = tapPad(described.taps.osdProbe);
+             if (osd_sink_pad) {
+                 osd_probe_id = gst_pad_add_probe(osd_sink_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                                                  osd_sink_pad_buffer_probe, this, NULL);
+                 gst_object_unref(osd_sink_pad);
+             }
+         }
+         if (startPipeline())
+             return;
+         qWarning() << "Catalog pipeline" << described.name << "failed, using the built-in graph";
+     }
+
+     // Fall back to standard elements when DeepStream is not installed
+     const PipelineCapabilities &capabilities = PipelineCapabilities::probe();
+     if (!capabilities.hasDeepStream()) {
+         qWarning() << "DeepStream elements missing:" << capabilities.missing.join(", ")
+                    << "- building the CPU pipeline for" << devicePath.c_str();
+         CpuPipelineSettings settings;
+         settings.devicePath = QString::fromStdString(devicePath);
+         buildCpuPipeline(settings);
+         return;
+     }
+     beginPipelineTiming(PipelineVariant::DeepStream);
+
      // Create pipeline
      this->pipeline = gst_pipeline_new("deepstream-camera-app");
      if (!this->pipeline) {
@@ -544,7 +585,8 @@ GstFlowReturn NightCameraPipelineDevice::on_new_sample(GstAppSink *sink, gpointe
 GstPadProbeReturn NightCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
 {
     auto self = static_cast<NightCameraPipelineDevice*>(user_data);
-    auto start = std::chrono::high_resolution_clock::now();
+    const qint64 start = LatencyMonitor::nowUs();
+    TRACE_SCOPE("osd", "night.osdProbe");
 
     NvDsBatchMeta *batch_meta = gst_buffer_get_nvds_batch_meta((GstBuffer*)info->data);
     if (!batch_meta) {
@@ -577,6 +619,7 @@ GstPadProbeReturn NightCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *p
     case MotionMode::Pattern:    subModeText = g_strdup("Motion: PATTERN"); break;
     case MotionMode::AutoTrack:  subModeText = g_strdup("Motion: AUTO TRACK"); break;
     case MotionMode::ManualTrack:subModeText = g_strdup("Motion: MAN TRACK"); break;
+    case MotionMode::Slew:       subModeText = g_strdup("Motion: SLEW"); break;
     }
 
     char *fireModeText = nullptr;
@@ -1105,101 +1148,96 @@ GstPadProbeReturn NightCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *p
 
         }
         else if (self->m_reticle_type==3){
-            const double FOV_DEGREES = 10.4;  // Wide Field of View (horizontal, in degrees) Field of View: 10.4°H x 8.3°V
-            const int RESOLUTION_HEIGHT = 720; // Vertical resolution of the frame
-            const int RESOLUTION_WIDTH = 960; // Horizontal resolution of the frame
-            double pixels_per_degree = 92.3;  //Wide: 1280 px/63.7°≈20.09pixels/degree
-                                  QVector<QPair<double, double>> dropData = {
-            {100, 0.05},   // Example: Range 100m, Drop 0.2m
-                {200, 0.37},   // Example: Range 200m, Drop 0.8m
-                {300, 0.9},    // Example: Range 300m, Drop 1.8m
-                {400, 1.5},   // Example: Range 100m, Drop 0.2m
-                {500, 2.28},   // Example: Range 200m, Drop 0.8m
-                {600, 3.21}    // Example: Range 300m, Drop 1.8m
-        };
-
-        for (const auto &data : dropData) {
-            double rangeMeters = data.first; // Range (e.g., 100m, 200m)
-            double dropMeters = data.second; // Drop (in meters)
-            double dropAngleRadians = atan(dropMeters / rangeMeters); // Drop angle in radians
-            double dropAngleDegrees = dropAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-            // Convert to pixels using FOV and vertical resolution
-            int pixelOffset = static_cast<int>((dropAngleDegrees / FOV_DEGREES) * RESOLUTION_HEIGHT);
-            int reticleY = centerY + pixelOffset;
-            self->addLineToDisplayMeta(display_meta6,
-                                       centerX -3 , reticleY, centerX +3 , reticleY,
-                                       4, self->shadowLineColor );
-            self->addLineToDisplayMeta(display_meta6,
-                                       centerX -3 , reticleY, centerX +3 , reticleY,
-                                       2, self->lineColor );
-
-            // Add range label
-            //painter.drawText(centerX + 15, reticleY + 5, QString::number(static_cast<int>(rangeMeters)) + "m");
-
-
-            /*char* displayrangeMetersText =   g_strdup_printf(" %.0f", rangeMeters);
-            self->addTextToDisplayMeta(display_meta3, centerX + 15, reticleY + 5, displayrangeMetersText);
-            g_free(displayrangeMetersText);*/
-        }
-
-
-
-
-        //int centerX = RESOLUTION_WIDTH / 2; // Center of the screen (X-axis)
-        //int centerY = RESOLUTION_HEIGHT / 2; // Center of the screen (Y-axis)
-
-        // Calculate drift in meters
-        double windSpeed = 20;
-        double  rangeMeters = 500;
-        double driftMeters = (windSpeed * rangeMeters) / 800.0; // Adjust for bullet speed
-        double driftAngleRadians = atan(driftMeters / rangeMeters); // Drift angle in radians
-        double driftAngleDegrees = driftAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-        // Convert to pixels using horizontal FoV and resolution
-        int driftPixels = static_cast<int>((driftAngleDegrees / FOV_DEGREES) * RESOLUTION_WIDTH);
-
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX - driftPixels ,  centerY - 10, centerX - driftPixels , centerY + 10,
-                                   2, self->lineColor );
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX + driftPixels ,  centerY - 10, centerX + driftPixels , centerY + 10,
-                                   2, self->lineColor );
-
-        // Draw markers
-
-        // Label markers
-        /*char* displayldriftText =   g_strdup_printf("L");
-        self->addTextToDisplayMeta(display_meta3, centerX - driftPixels, centerY - 15, displayldriftText);
-        g_free(displayldriftText);
-
-        char* displayrdriftText =   g_strdup_printf("R");
-        self->addTextToDisplayMeta(display_meta3, centerX + driftPixels - 30, centerY - 15, displayrdriftText);
-        g_free(displayrdriftText);*/
-
-
-        double targetSpeed = 5;
-        // Calculate lead in meters
-        double leadMeters = (targetSpeed * rangeMeters) / 800.0; // Adjust for bullet speed
-        driftAngleRadians = atan(leadMeters / rangeMeters); // Drift angle in radians
-        driftAngleDegrees = driftAngleRadians * (180.0 / M_PI); // Convert to degrees
-
-        // Convert to pixels using horizontal FoV and resolution
-        int leadPixels = static_cast<int>((driftAngleDegrees / FOV_DEGREES) * RESOLUTION_WIDTH);
-        // Convert to pixels
-
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX - leadPixels ,  centerY - 10, centerX - leadPixels , centerY + 10,
-                                   2, self->lineColor );
-        self->addLineToDisplayMeta(display_meta6,
-                                   centerX + leadPixels ,  centerY - 10, centerX + leadPixels , centerY + 10,
-                                   2, self->lineColor );
-        // Draw markers
-
-        // Label markers
-        //painter.drawText(centerX - leadPixels - 30, centerY - 15, "Lead Left");
-        //painter.drawText(centerX + leadPixels + 10, centerY - 15, "Lead Right");
+            // Angular scale at the current zoom, from the camera calibration
+            const double pixelsPerDegree = self->cameraModel(state.nightZoomPosition, state.nightCurrentHFOV).pixelsPerDegree();
+            const double REFERENCE_CROSSWIND = 10.0; // m/s, full value, for the wind bracket
+
+            BallisticTablePtr table = self->ballisticTable();
+            if (table) {
+                // Holdover marks: interpolated table lookups, no trigonometry per frame
+                static const double markRanges[] = {100, 200, 300, 400, 500, 600, 800, 1000};
+                for (double rangeMeters : markRanges) {
+                    BallisticSolution mark = table->solve(rangeMeters);
+                    if (!mark.valid)
+                        continue;
+
+                    int reticleY = centerY + static_cast<int>(mark.holdoverDeg * pixelsPerDegree);
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX -3 , reticleY, centerX +3 , reticleY,
+                                               4, self->shadowLineColor );
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX -3 , reticleY, centerX +3 , reticleY,
+                                               2, self->lineColor );
+
+                    // Add range label
+                    /*char* displayrangeMetersText =   g_strdup_printf(" %.0f", rangeMeters);
+                    self->addTextToDisplayMeta(display_meta3, centerX + 15, reticleY + 5, displayrangeMetersText);
+                    g_free(displayrangeMetersText);*/
+                }
 
+                // Wind and lead brackets at the LRF range (500 m without a range)
+                double rangeMeters = state.lrfDistance > 0.0 ? state.lrfDistance : 500.0;
+                BallisticSolution aim = table->solve(rangeMeters);
+                if (aim.valid) {
+                    int aimY = centerY + static_cast<int>(aim.holdoverDeg * pixelsPerDegree);
+                    if (state.lrfDistance > 0.0) {
+                        // Aim point for the measured range
+                        self->addLineToDisplayMeta(display_meta6,
+                                                   centerX - 8, aimY, centerX + 8, aimY,
+                                                   4, self->shadowLineColor );
+                        self->addLineToDisplayMeta(display_meta6,
+                                                   centerX - 8, aimY, centerX + 8, aimY,
+                                                   2, self->lineColor );
+                    }
+
+                    int driftPixels = static_cast<int>(aim.windageDeg(REFERENCE_CROSSWIND) * pixelsPerDegree);
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX - driftPixels ,  aimY - 10, centerX - driftPixels , aimY + 10,
+                                               2, self->lineColor );
+                    self->addLineToDisplayMeta(display_meta6,
+                                               centerX + driftPixels ,  aimY - 10, centerX + driftPixels , aimY + 10,
+                                               2, self->lineColor );
+
+                    // Label markers
+                    /*char* displayldriftText =   g_strdup_printf("L");
+                    self->addTextToDisplayMeta(display_meta3, centerX - driftPixels, aimY - 15, displayldriftText);
+                    g_free(displayldriftText);
+
+                    char* displayrdriftText =   g_strdup_printf("R");
+                    self->addTextToDisplayMeta(display_meta3, centerX + driftPixels - 30, aimY - 15, displayrdriftText);
+                    g_free(displayrdriftText);*/
+
+                    // Automatic lead from the tracked target's angular velocity. In the
+                    // tracking modes the gimbal already aims ahead (offset aim), so the
+                    // reticle centre is the aim point and only the label is shown.
+                    if (state.leadAngleValid) {
+                        const bool offsetAim = state.motionMode == MotionMode::AutoTrack ||
+                                               state.motionMode == MotionMode::ManualTrack;
+                        int leadX = centerX;
+                        int leadY = aimY;
+                        if (!offsetAim) {
+                            leadX += static_cast<int>(state.leadAzDeg * pixelsPerDegree);
+                            leadY -= static_cast<int>(state.leadElDeg * pixelsPerDegree);
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX - 6, leadY, leadX + 6, leadY,
+                                                       4, self->shadowLineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX, leadY - 6, leadX, leadY + 6,
+                                                       4, self->shadowLineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX - 6, leadY, leadX + 6, leadY,
+                                                       2, self->lineColor );
+                            self->addLineToDisplayMeta(display_meta6,
+                                                       leadX, leadY - 6, leadX, leadY + 6,
+                                                       2, self->lineColor );
+                        }
+
+                        char* displayLeadText =   g_strdup_printf("LEAD %.1f", state.leadAzDeg);
+                        self->addTextToDisplayMeta(display_meta3, leadX + 10, leadY + 10, displayLeadText);
+                        g_free(displayLeadText);
+                    }
+                }
+            }
     }
 
 
@@ -1213,12 +1251,9 @@ GstPadProbeReturn NightCameraPipelineDevice::osd_sink_pad_buffer_probe(GstPad *p
     nvds_add_display_meta_to_frame(frame_meta, display_meta6);
 
 } // End of frame loop
-auto end = std::chrono::high_resolution_clock::now();
-
-// Calculate the elapsed time in microseconds
-auto elapsedTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-if (elapsedTimeUs > 2000)
-    std::cout << "Processing time: " << elapsedTimeUs << " microseconds (" <<   std::endl;
+// Probe processing time, in the latency histograms of this camera
+LatencyMonitor::instance().record(self->latencySource(), LatencyStage::OsdProbe,
+                                  LatencyMonitor::nowUs() - start);
 
 return GST_PAD_PROBE_OK;
 }
@@ -110,7 +110,6 @@ signals:
     void trackedTargetsUpdated(const QSet<int> &trackIds);
     void trackingResult(QRect updatedBoundingBox);
     void selectedTrackLost(int trackId);
-    void targetPositionUpdated(double targetAzimuth, double targetElevation);
     void pipelineShutdownComplete();
     void errorOccurred(const QString &errorMessage);
     void endOfStream();
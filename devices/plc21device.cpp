@@ -4,6 +4,7 @@
 #include <QDebug>
 #include <QMutexLocker>
 #include <QtMath>
+#include "utils/trace.h"
 
 Plc21Device::Plc21Device(const QString &device,
                          int baudRate,
@@ -13,24 +14,20 @@ Plc21Device::Plc21Device(const QString &device,
     m_device(device),
     m_baudRate(baudRate),
     m_slaveId(slaveId),
-    m_modbusDevice(new QModbusRtuSerialClient(this)),
+    m_modbusDevice(ModbusTransport::create(
+        ModbusEndpoint::resolve(QStringLiteral("plc21"), device, baudRate, QSerialPort::EvenParity), this)),
     m_readTimer(new QTimer(this)),
     m_timeoutTimer(new QTimer(this)),
     m_reconnectAttempts(0),
     MAX_RECONNECT_ATTEMPTS(5)
 {
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialPortNameParameter, m_device);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, m_baudRate);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialParityParameter, QSerialPort::EvenParity);
+    // Timeout and retries are set per request by m_link
+    m_modbusDevice->setTimeout(m_link.timeoutMs());
+    m_modbusDevice->setNumberOfRetries(ModbusLinkMonitor::retriesFor(ModbusRequestClass::Command));
 
-    m_modbusDevice->setTimeout(500);
-    m_modbusDevice->setNumberOfRetries(3);
-
-    connect(m_modbusDevice, &QModbusClient::stateChanged,
+    connect(m_modbusDevice, &ModbusTransport::stateChanged,
             this, &Plc21Device::onStateChanged);
-    connect(m_modbusDevice, &QModbusClient::errorOccurred,
+    connect(m_modbusDevice, &ModbusTransport::errorOccurred,
             this, &Plc21Device::onErrorOccurred);
 
     connect(m_readTimer, &QTimer::timeout,
@@ -103,17 +100,22 @@ void Plc21Device::readData() {
     if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
         return;
 
-    {
+    // A read still queued is already stale; do not queue another behind it
+    if (!m_link.isPending(QStringLiteral("digital_inputs"))) {
         QMutexLocker locker(&m_mutex);
         QModbusDataUnit readUnit(QModbusDataUnit::DiscreteInputs,
                                  DIGITAL_INPUTS_START_ADDRESS,
                                  DIGITAL_INPUTS_COUNT);
 
+        m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
         if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+            m_link.track(m_modbusDevice, reply, QStringLiteral("digital_inputs"));
             if (!reply->isFinished()) {
+                TRACE_ASYNC_BEGIN("modbus", "plc21.digitalInputs", reply);
                 connect(reply, &QModbusReply::finished, this, &Plc21Device::onDigitalInputsReadReady);
                 if (!m_timeoutTimer->isActive())
-                    m_timeoutTimer->start(1000);
+                    m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
             } else {
                 reply->deleteLater();
             }
@@ -123,17 +125,21 @@ void Plc21Device::readData() {
         }
     }
 
-    {
+    if (!m_link.isPending(QStringLiteral("analog_inputs"))) {
         QMutexLocker locker(&m_mutex);
         QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters,
                                  ANALOG_INPUTS_START_ADDRESS,
                                  ANALOG_INPUTS_COUNT);
 
+        m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
         if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+            m_link.track(m_modbusDevice, reply, QStringLiteral("analog_inputs"));
             if (!reply->isFinished()) {
+                TRACE_ASYNC_BEGIN("modbus", "plc21.analogInputs", reply);
                 connect(reply, &QModbusReply::finished, this, &Plc21Device::onAnalogInputsReadReady);
                 if (!m_timeoutTimer->isActive())
-                    m_timeoutTimer->start(1000);
+                    m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
             } else {
                 reply->deleteLater();
             }
@@ -148,6 +154,8 @@ void Plc21Device::onDigitalInputsReadReady() {
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "plc21.digitalInputs", reply);
+    TRACE_SCOPE("modbus", "plc21.digitalInputs.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -209,6 +217,8 @@ void Plc21Device::onAnalogInputsReadReady() {
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "plc21.analogInputs", reply);
+    TRACE_SCOPE("modbus", "plc21.analogInputs.reply");
 
     QMutexLocker locker(&m_mutex);
     if (reply->error() == QModbusDevice::NoError) {
@@ -259,8 +269,12 @@ void Plc21Device::writeData() {
         writeUnit.setValue(i, coilValues.at(i));
     }
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
+
     if (auto *reply = m_modbusDevice->sendWriteRequest(writeUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("command"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "plc21.write", reply);
             connect(reply, &QModbusReply::finished, this, &Plc21Device::onWriteReady);
         } else {
             reply->deleteLater();
@@ -275,6 +289,8 @@ void Plc21Device::onWriteReady() {
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "plc21.write", reply);
+    TRACE_SCOPE("modbus", "plc21.write.reply");
 
     if (reply->error() != QModbusDevice::NoError) {
         logError(QString("Write response error: %1").arg(reply->errorString()));
@@ -4,10 +4,11 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
-#include <QModbusRtuSerialClient>
 #include <QModbusDataUnit>
 #include <QModbusReply>
 #include <QVector>
+#include "utils/modbuslinkmonitor.h"
+#include "utils/modbustransport.h"
 
 // Constants for Modbus
 constexpr int DIGITAL_INPUTS_START_ADDRESS  = 0;
@@ -104,7 +105,8 @@ private:
     // Helper to unify all data changes
     void updatePanelData(const Plc21PanelData &newData);
 
-    QModbusRtuSerialClient *m_modbusDevice = nullptr;
+    ModbusTransport *m_modbusDevice = nullptr;
+    ModbusLinkMonitor m_link{QStringLiteral("plc21")};
     QTimer *m_readTimer       = nullptr;
     QTimer *m_timeoutTimer    = nullptr;
     mutable QMutex m_mutex;
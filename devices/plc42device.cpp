@@ -5,6 +5,9 @@
 #include <QSerialPort>
 #include <QMutexLocker>
 #include <QtMath>
+#include <QDebug>
+#include "utils/latencymonitor.h"
+#include "utils/trace.h"
 
 #define NUM_HOLDING_REGS 9
 
@@ -16,23 +19,25 @@ Plc42Device::Plc42Device(const QString &device,
     m_device(device),
     m_baudRate(baudRate),
     m_slaveId(slaveId),
-    m_modbusDevice(new QModbusRtuSerialClient(this)),
+    m_modbusDevice(ModbusTransport::create(
+        ModbusEndpoint::resolve(QStringLiteral("plc42"), device, baudRate, QSerialPort::EvenParity), this)),
     m_pollTimer(new QTimer(this)),
-    m_timeoutTimer(new QTimer(this))
+    m_timeoutTimer(new QTimer(this)),
+    m_safetyTimer(new QTimer(this))
 {
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialPortNameParameter, m_device);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, m_baudRate);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialParityParameter, QSerialPort::EvenParity);
-
-    m_modbusDevice->setTimeout(500);
-    m_modbusDevice->setNumberOfRetries(3);
+    // Timeout and retries are set per request by m_link
+    m_modbusDevice->setTimeout(m_link.timeoutMs());
+    m_modbusDevice->setNumberOfRetries(ModbusLinkMonitor::retriesFor(ModbusRequestClass::Command));
 
     connect(m_pollTimer, &QTimer::timeout, this, &Plc42Device::readData);
-    connect(m_modbusDevice, &QModbusRtuSerialClient::stateChanged,
+    m_safetyTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_safetyTimer, &QTimer::timeout, this, &Plc42Device::readSafetyInputs);
+    // Runs before and regardless of connectDevice(): a PLC that never
+    // connects trips the missed-poll watchdog like one that stops answering
+    m_safetyTimer->start(SAFETY_POLL_MS);
+    connect(m_modbusDevice, &ModbusTransport::stateChanged,
             this, &Plc42Device::onStateChanged);
-    connect(m_modbusDevice, &QModbusRtuSerialClient::errorOccurred,
+    connect(m_modbusDevice, &ModbusTransport::errorOccurred,
             this, &Plc42Device::onErrorOccurred);
 
     connect(m_timeoutTimer, &QTimer::timeout, this, &Plc42Device::handleTimeout);
@@ -62,7 +67,10 @@ bool Plc42Device::connectDevice()
     newData.isConnected = true;
     updatePlc42Data(newData);
 
-    m_pollTimer->start(200);
+    m_missedSafetyPolls = 0;
+    m_pollTimer->start(POLL_INTERVAL_MS);
+    if (!m_safetyTimer->isActive())
+        m_safetyTimer->start(SAFETY_POLL_MS);
     return true;
 }
 
@@ -71,6 +79,7 @@ void Plc42Device::disconnectDevice()
     if (m_modbusDevice) {
         m_modbusDevice->disconnectDevice();
         m_pollTimer->stop();
+        m_safetyTimer->stop();
         m_timeoutTimer->stop();
 
         Plc42Data newData = m_currentData;
@@ -89,18 +98,25 @@ void Plc42Device::readDigitalInputs()
 {
     if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
         return;
+    // A read still queued is already stale; do not queue another behind it
+    if (m_link.isPending(QStringLiteral("digital_inputs")))
+        return;
 
     QMutexLocker locker(&m_mutex);
     QModbusDataUnit readUnit(QModbusDataUnit::DiscreteInputs,
                              DIGITAL_INPUTS_START_ADDRESS,
                              DIGITAL_INPUTS_COUNT);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
     if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("digital_inputs"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "plc42.digitalInputs", reply);
             connect(reply, &QModbusReply::finished,
                     this, &Plc42Device::onDigitalInputsReadReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
         } else {
             reply->deleteLater();
         }
@@ -115,6 +131,8 @@ void Plc42Device::onDigitalInputsReadReady()
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "plc42.digitalInputs", reply);
+    TRACE_SCOPE("modbus", "plc42.digitalInputs.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -124,9 +142,7 @@ void Plc42Device::onDigitalInputsReadReady()
         Plc42Data newData = m_currentData;
 
         if (unit.valueCount() >= 7) {
-            newData.stationUpperSensor  = (unit.value(0) != 0);
-            newData.stationLowerSensor  = (unit.value(1) != 0);
-            newData.emergencyStopActive = (unit.value(2) != 0);
+            // Inputs 0-2 are owned by the safety poll (debounced)
             newData.ammunitionLevel     = (unit.value(3) != 0); // same bit or a different one?
             newData.stationInput1       = (unit.value(4) != 0);
             newData.stationInput2       = (unit.value(5) != 0);
@@ -148,22 +164,123 @@ void Plc42Device::onDigitalInputsReadReady()
     reply->deleteLater();
 }
 
+void Plc42Device::readSafetyInputs()
+{
+    // Watchdog: a dead link must not leave the last (released) E-stop state
+    // in place. Counts ticks while disconnected, busy or after error replies.
+    if (++m_missedSafetyPolls > SAFETY_MAX_MISSED_POLLS)
+        raiseSafetyLinkLoss();
+
+    if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
+        return;
+    if (m_link.isPending(QStringLiteral("safety_inputs")))
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    QModbusDataUnit readUnit(QModbusDataUnit::DiscreteInputs,
+                             DIGITAL_INPUTS_START_ADDRESS,
+                             SAFETY_INPUT_COUNT);
+
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
+    // No reply timer here: a lost reply is covered by m_missedSafetyPolls, and
+    // the replies would keep stopping the watchdog of the slow poll
+    if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("safety_inputs"));
+        if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "plc42.safetyInputs", reply);
+            connect(reply, &QModbusReply::finished,
+                    this, &Plc42Device::onSafetyInputsReadReady);
+        } else {
+            reply->deleteLater();
+        }
+    }
+}
+
+void Plc42Device::onSafetyInputsReadReady()
+{
+    auto *reply = qobject_cast<QModbusReply *>(sender());
+    if (!reply)
+        return;
+    TRACE_ASYNC_END("modbus", "plc42.safetyInputs", reply);
+    TRACE_SCOPE("modbus", "plc42.safetyInputs.reply");
+
+    // Errors are counted by m_link and, through m_missedSafetyPolls, by the
+    // watchdog in readSafetyInputs()
+    const QModbusDataUnit unit = reply->result();
+    if (reply->error() == QModbusDevice::NoError && unit.valueCount() >= SAFETY_INPUT_COUNT) {
+        m_missedSafetyPolls = 0;
+        if (m_safetyLinkLost) {
+            // The forced E-stop is released by the debouncer like a real one
+            qWarning() << "PLC42: safety input replies resumed";
+            m_safetyLinkLost = false;
+        }
+
+        const qint64 nowUs = LatencyMonitor::nowUs();
+        bool edges = false;
+        for (int i = 0; i < SAFETY_INPUT_COUNT; ++i) {
+            if (m_safetyDebouncers[i].update(unit.value(i) != 0)) {
+                m_safetyQueue.tryPush({static_cast<SafetyInput>(i), m_safetyDebouncers[i].active(), nowUs});
+                edges = true;
+            }
+        }
+
+        if (edges) {
+            // The control loop first, then the models
+            emit safetyEventsAvailable();
+
+            Plc42Data newData = m_currentData;
+            newData.stationUpperSensor  = m_safetyDebouncers[int(SafetyInput::UpperLimit)].active();
+            newData.stationLowerSensor  = m_safetyDebouncers[int(SafetyInput::LowerLimit)].active();
+            newData.emergencyStopActive = m_safetyDebouncers[int(SafetyInput::EmergencyStop)].active();
+            updatePlc42Data(newData);
+        }
+    }
+    reply->deleteLater();
+}
+
+void Plc42Device::raiseSafetyLinkLoss()
+{
+    if (m_safetyLinkLost)
+        return;
+    m_safetyLinkLost = true;
+    qCritical() << "PLC42: no safety input reply for" << m_missedSafetyPolls * SAFETY_POLL_MS
+                << "ms, raising emergency stop";
+
+    // Same path as a pressed E-stop: interlock first, then the models
+    if (!m_safetyDebouncers[int(SafetyInput::EmergencyStop)].forceActive())
+        return;
+    m_safetyQueue.tryPush({SafetyInput::EmergencyStop, true, LatencyMonitor::nowUs()});
+    emit safetyEventsAvailable();
+
+    Plc42Data newData = m_currentData;
+    newData.emergencyStopActive = true;
+    updatePlc42Data(newData);
+}
+
 void Plc42Device::readHoldingData()
 {
     if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
         return;
+    // A read still queued is already stale; do not queue another behind it
+    if (m_link.isPending(QStringLiteral("holding_registers")))
+        return;
 
     QMutexLocker locker(&m_mutex);
     QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters,
                              HOLDING_REGISTERS_START_ADDRESS,
                              HOLDING_REGISTERS_COUNT);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
     if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("holding_registers"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "plc42.holdingRegisters", reply);
             connect(reply, &QModbusReply::finished,
                     this, &Plc42Device::onHoldingDataReadReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
         } else {
             reply->deleteLater();
         }
@@ -178,6 +295,8 @@ void Plc42Device::onHoldingDataReadReady()
     auto *reply = qobject_cast<QModbusReply*>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "plc42.holdingRegisters", reply);
+    TRACE_SCOPE("modbus", "plc42.holdingRegisters.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -244,8 +363,12 @@ void Plc42Device::writeRegisterData()
     writeUnit.setValue(7, m_currentData.elevationDirection);
     writeUnit.setValue(8, m_currentData.solenoidState);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
+
     if (auto *reply = m_modbusDevice->sendWriteRequest(writeUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("command"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "plc42.write", reply);
             connect(reply, &QModbusReply::finished, this, &Plc42Device::onWriteReady);
         } else {
             reply->deleteLater();
@@ -316,6 +439,7 @@ void Plc42Device::onWriteReady()
 {
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (reply) {
+        TRACE_ASYNC_END("modbus", "plc42.write", reply);
         if (reply->error() != QModbusDevice::NoError) {
             logError("Write response error: " + reply->errorString());
             emit errorOccurred(reply->errorString());
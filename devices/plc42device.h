@@ -4,10 +4,13 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
-#include <QModbusRtuSerialClient>
 #include <QModbusDataUnit>
 #include <QModbusReply>
 #include <QVector>
+#include <array>
+#include "utils/modbuslinkmonitor.h"
+#include "utils/modbustransport.h"
+#include "utils/safetyinputs.h"
 
 // Combined structure representing all PLC42 device data (digital + holding)
 struct Plc42Data {
@@ -73,6 +76,9 @@ public:
     // Poll method
     void readData();
 
+    // Consumer side of the safety edge queue (control loop only)
+    bool popSafetyEvent(SafetyInputEvent &event) { return m_safetyQueue.tryPop(event); }
+
     // Holding register setters
     void setSolenoidMode(uint16_t mode);
     void setGimbalMotionMode(uint16_t mode);
@@ -87,6 +93,8 @@ signals:
     void errorOccurred(const QString &error);
     // Single unified data-change signal
     void plc42DataChanged(const Plc42Data &data);
+    // New edges are waiting in the safety queue (emitted once per poll reply)
+    void safetyEventsAvailable();
 
 private slots:
     void onWriteReady();
@@ -100,6 +108,11 @@ private slots:
     // Holding registers
     void onHoldingDataReadReady();
 
+    // Safety inputs (fast poll)
+    void readSafetyInputs();
+    void onSafetyInputsReadReady();
+    void raiseSafetyLinkLoss();
+
 private:
     void readDigitalInputs();
     void readHoldingData();
@@ -108,9 +121,11 @@ private:
     void updatePlc42Data(const Plc42Data &newData);
     void logError(const QString &message);
 
-    QModbusRtuSerialClient *m_modbusDevice = nullptr;
+    ModbusTransport *m_modbusDevice = nullptr;
+    ModbusLinkMonitor m_link{QStringLiteral("plc42")};
     QTimer *m_pollTimer       = nullptr; // replaced m_timer/m_readTimer if desired
     QTimer *m_timeoutTimer    = nullptr;
+    QTimer *m_safetyTimer     = nullptr; // E-stop and limit sensors, SAFETY_POLL_MS
     QMutex m_mutex;
 
     QString m_device;
@@ -119,11 +134,22 @@ private:
 
     Plc42Data m_currentData;
 
+    std::array<SafetyDebouncer, SAFETY_INPUT_COUNT> m_safetyDebouncers;
+    SafetyInputQueue m_safetyQueue;
+    int m_missedSafetyPolls = 0;  ///< Safety polls since the last good reply.
+    bool m_safetyLinkLost = false;
+
     static constexpr int DIGITAL_INPUTS_START_ADDRESS  = 0;
     static constexpr int DIGITAL_INPUTS_COUNT          = 13;
     static constexpr int HOLDING_REGISTERS_START       = 0;
     static constexpr int HOLDING_REGISTERS_COUNT       = 7;
     static constexpr int HOLDING_REGISTERS_START_ADDRESS = 9;
+    // Inputs 0-2 (SafetyInput) are read 10x as often as the rest; the RTU
+    // line is shared with the 200 ms poll and the writes
+    static constexpr int POLL_INTERVAL_MS              = 200;
+    static constexpr int SAFETY_POLL_MS                = 20;
+    // Safety polls without a good reply before a synthetic E-stop (100 ms)
+    static constexpr int SAFETY_MAX_MISSED_POLLS       = 5;
 };
 
 #endif // PLC42DEVICE_H
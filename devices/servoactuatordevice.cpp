@@ -1,5 +1,6 @@
 #include "servoactuatordevice.h"
 #include <QDebug>
+#include "utils/trace.h"
 #include <QTimer>
 
 ServoActuatorDevice::ServoActuatorDevice(QObject *parent)
@@ -120,6 +121,7 @@ void ServoActuatorDevice::checkAlarms()
 
 void ServoActuatorDevice::processIncomingData()
 {
+    TRACE_SCOPE("serial", "servoActuator.parse");
     if (!servoSerial)
         return;
 
@@ -0,0 +1,187 @@
+#include "servoalarmservice.h"
+#include "servodriverdevice.h"
+#include "utils/latencymonitor.h"
+#include "utils/metricsregistry.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+namespace {
+
+constexpr int DEADLINE_CHECK_MS = 100;
+
+QString hexCode(uint16_t code)
+{
+    return QStringLiteral("0x%1").arg(QString::number(code, 16).toUpper());
+}
+
+} // namespace
+
+ServoAlarmService::ServoAlarmService(QObject *parent)
+    : QObject(parent),
+    m_deadlineTimer(new QTimer(this))
+{
+    // Catches drives whose bus never went idle (and drives without status polls)
+    connect(m_deadlineTimer, &QTimer::timeout, this, [this]() {
+        for (const auto &axis : m_axes)
+            service(*axis);
+    });
+    m_deadlineTimer->start(DEADLINE_CHECK_MS);
+}
+
+ServoAlarmService::~ServoAlarmService() = default;
+
+void ServoAlarmService::addServo(const QString &axis, ServoDriverDevice *servo)
+{
+    if (!servo)
+        return;
+
+    auto entry = std::make_unique<Axis>();
+    entry->name = axis;
+    entry->servo = servo;
+    entry->readInterval = MetricsRegistry::instance().histogram(
+        QStringLiteral("el7aress_servo_alarm_read_interval_seconds"),
+        QStringLiteral("Time between successful alarm status reads of a servo drive"),
+        {{QStringLiteral("axis"), axis}});
+    Axis *a = entry.get();
+    m_axes.push_back(std::move(entry));
+
+    // The gap after a status reply is the idle slot
+    connect(servo, &ServoDriverDevice::statusSampled, this, [this, a]() { service(*a); });
+    connect(servo, &ServoDriverDevice::alarmStatusRead, this, [this, a]() { onStatusRead(*a); });
+    connect(servo, &ServoDriverDevice::alarmDetected, this, [this, a](uint16_t code) { onAlarmDetected(*a, code); });
+    connect(servo, &ServoDriverDevice::alarmCleared, this, [this, a]() { onAlarmCleared(*a); });
+    connect(servo, &ServoDriverDevice::alarmHistoryRead, this,
+            [this, a](const QList<uint16_t> &history) { onHistoryRead(*a, history); });
+    connect(servo, &ServoDriverDevice::alarmHistoryCleared, this, [a]() { a->historyDue = true; });
+}
+
+void ServoAlarmService::service(Axis &axis)
+{
+    const qint64 nowUs = LatencyMonitor::nowUs();
+    const bool idle = axis.servo->isBusIdle();
+
+    // One diagnostic read per slot; the history only in idle slots
+    if (axis.historyDue && idle) {
+        axis.historyDue = false;
+        axis.servo->readAlarmHistory();
+        return;
+    }
+
+    const qint64 ageUs = nowUs - axis.lastRequestUs;
+    if (ageUs < REFRESH_MS * 1000LL)
+        return;
+    if (!idle && ageUs < MAX_AGE_MS * 1000LL)
+        return;
+
+    axis.lastRequestUs = nowUs;
+    axis.servo->readAlarmStatus();
+}
+
+void ServoAlarmService::onStatusRead(Axis &axis)
+{
+    const qint64 nowUs = LatencyMonitor::nowUs();
+    if (axis.lastStatusReadUs > 0)
+        axis.readInterval->record(nowUs - axis.lastStatusReadUs);
+    axis.lastStatusReadUs = nowUs;
+}
+
+void ServoAlarmService::onAlarmDetected(Axis &axis, uint16_t alarmCode)
+{
+    // A direct change from one alarm to another closes the previous one first
+    onAlarmCleared(axis);
+
+    axis.alarmCode = alarmCode;
+    axis.alarmSinceUs = LatencyMonitor::nowUs();
+    axis.historyDue = true;
+    appendTimeline(axis, QStringLiteral("raised"),
+                   {{QStringLiteral("code"), hexCode(alarmCode)},
+                    {QStringLiteral("name"), axis.servo->alarmName(alarmCode)}});
+}
+
+void ServoAlarmService::onAlarmCleared(Axis &axis)
+{
+    if (axis.alarmCode == 0)
+        return;
+    const qint64 durationMs = (LatencyMonitor::nowUs() - axis.alarmSinceUs) / 1000;
+    appendTimeline(axis, QStringLiteral("cleared"),
+                   {{QStringLiteral("code"), hexCode(axis.alarmCode)},
+                    {QStringLiteral("durationMs"), durationMs}});
+    axis.alarmCode = 0;
+    axis.historyDue = true;
+}
+
+void ServoAlarmService::onHistoryRead(Axis &axis, const QList<uint16_t> &history)
+{
+    if (history == axis.history)
+        return;
+    axis.history = history;
+
+    QVariantList codes;
+    for (uint16_t code : history)
+        codes << hexCode(code);
+    appendTimeline(axis, QStringLiteral("history"), {{QStringLiteral("codes"), codes}});
+    emit alarmHistoryChanged(axis.name, history);
+}
+
+void ServoAlarmService::appendTimeline(const Axis &axis, const QString &event, const QVariantMap &fields)
+{
+    if (m_timelinePath.isEmpty())
+        return;
+
+    QJsonObject line = QJsonObject::fromVariantMap(fields);
+    line.insert(QStringLiteral("time"), QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    line.insert(QStringLiteral("axis"), axis.name);
+    line.insert(QStringLiteral("event"), event);
+
+    QDir().mkpath(QFileInfo(m_timelinePath).absolutePath());
+    QFile file(m_timelinePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "ServoAlarmService: cannot write" << m_timelinePath << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(line).toJson(QJsonDocument::Compact));
+    file.write("\n");
+}
+
+void ServoAlarmService::refreshNow()
+{
+    for (const auto &axis : m_axes) {
+        axis->historyDue = true;
+        axis->lastRequestUs = 0;
+    }
+}
+
+const ServoAlarmService::Axis *ServoAlarmService::find(const QString &axis) const
+{
+    for (const auto &a : m_axes) {
+        if (a->name == axis)
+            return a.get();
+    }
+    return nullptr;
+}
+
+uint16_t ServoAlarmService::currentAlarm(const QString &axis) const
+{
+    const Axis *a = find(axis);
+    return a ? a->alarmCode : 0;
+}
+
+QList<uint16_t> ServoAlarmService::alarmHistory(const QString &axis) const
+{
+    const Axis *a = find(axis);
+    return a ? a->history : QList<uint16_t>();
+}
+
+qint64 ServoAlarmService::alarmStatusAgeMs(const QString &axis) const
+{
+    const Axis *a = find(axis);
+    if (!a || a->lastStatusReadUs == 0)
+        return -1;
+    return (LatencyMonitor::nowUs() - a->lastStatusReadUs) / 1000;
+}
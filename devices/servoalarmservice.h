@@ -0,0 +1,97 @@
+#ifndef SERVOALARMSERVICE_H
+#define SERVOALARMSERVICE_H
+
+/**
+ * @file servoalarmservice.h
+ * @brief Background alarm status / history refresh of the servo drivers.
+ *
+ * Alarm reads used to go out only when the operator pressed Read, each as
+ * its own transaction in the middle of the motion traffic. The service reads
+ * the present alarm of every drive in the gap after a status poll reply
+ * when the driver has nothing else queued, so status and command requests
+ * are never delayed by it. A drive that never goes idle is still read after
+ * MAX_AGE_MS, which bounds the time until GimbalController sees a new alarm.
+ *
+ * The history (last 10 alarms) is read once after connecting and after
+ * every alarm change, and kept in a cache. Raised/cleared/history events are
+ * appended to a JSON-lines timeline (logs/servo-alarms.jsonl).
+ */
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <memory>
+#include <vector>
+
+class QTimer;
+class MetricHistogram;
+class ServoDriverDevice;
+
+/**
+ * @class ServoAlarmService
+ * @brief Alarm cache of the servo drives, refreshed in idle bus slots.
+ *
+ * Metric: el7aress_servo_alarm_read_interval_seconds{axis}, the time between
+ * successful alarm status reads (the alarm reporting latency bound).
+ */
+class ServoAlarmService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ServoAlarmService(QObject *parent = nullptr);
+    ~ServoAlarmService();
+
+    /** @brief Adds a drive; @p axis names it in the cache, log and metrics ("az", "el"). */
+    void addServo(const QString &axis, ServoDriverDevice *servo);
+
+    /** @brief Appends the alarm timeline to @p path (empty = not persisted). */
+    void setTimelinePath(const QString &path) { m_timelinePath = path; }
+
+    /** @brief Present alarm from the cache (0 = none). */
+    uint16_t currentAlarm(const QString &axis) const;
+
+    /** @brief Alarm history from the cache, newest first as read from the drive. */
+    QList<uint16_t> alarmHistory(const QString &axis) const;
+
+    /** @brief Time since the last successful alarm status read (ms, -1 = never). */
+    qint64 alarmStatusAgeMs(const QString &axis) const;
+
+    /** @brief Reads status and history of every drive at the next idle slot. */
+    void refreshNow();
+
+    static constexpr int REFRESH_MS = 250; ///< Alarm status period when the bus is idle.
+    static constexpr int MAX_AGE_MS = 500; ///< Read even if the bus is busy after this.
+
+signals:
+    void alarmHistoryChanged(const QString &axis, const QList<uint16_t> &history);
+
+private:
+    struct Axis {
+        QString name;
+        ServoDriverDevice *servo = nullptr;
+        uint16_t alarmCode = 0;
+        qint64 alarmSinceUs = 0;
+        QList<uint16_t> history;
+        bool historyDue = true;
+        qint64 lastRequestUs = 0;    ///< Last alarm status request.
+        qint64 lastStatusReadUs = 0; ///< Last successful alarm status reply.
+        MetricHistogram *readInterval = nullptr;
+    };
+
+    /** @brief Issues the due diagnostic read of @p axis if the slot allows it. */
+    void service(Axis &axis);
+    void onStatusRead(Axis &axis);
+    void onAlarmDetected(Axis &axis, uint16_t alarmCode);
+    void onAlarmCleared(Axis &axis);
+    void onHistoryRead(Axis &axis, const QList<uint16_t> &history);
+    void appendTimeline(const Axis &axis, const QString &event, const QVariantMap &fields);
+
+    const Axis *find(const QString &axis) const;
+
+    std::vector<std::unique_ptr<Axis>> m_axes; // stable addresses for the signal handlers
+    QTimer *m_deadlineTimer = nullptr;
+    QString m_timelinePath;
+};
+
+#endif // SERVOALARMSERVICE_H
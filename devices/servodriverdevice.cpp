@@ -3,6 +3,8 @@
 #include <QSerialPort>
 #include <QVariant>
 #include <QDebug>
+#include "utils/latencymonitor.h"
+#include "utils/trace.h"
 
 ServoDriverDevice::ServoDriverDevice(const QString &identifier,
                                      const QString &device,
@@ -14,20 +16,20 @@ ServoDriverDevice::ServoDriverDevice(const QString &identifier,
     m_device(device),
     m_baudRate(baudRate),
     m_slaveId(slaveId),
+    m_link(QStringLiteral("servo_") + identifier),
     m_readTimer(new QTimer(this)),
     m_timeoutTimer(new QTimer(this))
 {
-    m_modbusDevice = new QModbusRtuSerialClient(this);
+    initializeAlarmMap();
 
-    // Configure connection parameters.
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialPortNameParameter, m_device);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, m_baudRate);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
-    m_modbusDevice->setConnectionParameter(QModbusDevice::SerialParityParameter, QSerialPort::NoParity);
+    // Serial port name or tcp:// / rtu+tcp:// endpoint (simulators, gateways)
+    m_modbusDevice = ModbusTransport::create(
+        ModbusEndpoint::resolve(QStringLiteral("servo_") + m_identifier, m_device, m_baudRate, QSerialPort::NoParity),
+        this);
 
-    m_modbusDevice->setTimeout(500);      // 500 ms timeout
-    m_modbusDevice->setNumberOfRetries(3);
+    // Timeout and retries are set per request by m_link
+    m_modbusDevice->setTimeout(m_link.timeoutMs());
+    m_modbusDevice->setNumberOfRetries(ModbusLinkMonitor::retriesFor(ModbusRequestClass::Command));
 
     connect(m_readTimer, &QTimer::timeout, this, &ServoDriverDevice::readData);
     m_readTimer->setInterval(50); // Adjust as needed.
@@ -35,9 +37,9 @@ ServoDriverDevice::ServoDriverDevice(const QString &identifier,
     connect(m_timeoutTimer, &QTimer::timeout, this, &ServoDriverDevice::handleTimeout);
     m_timeoutTimer->setSingleShot(true);
 
-    connect(m_modbusDevice, &QModbusClient::stateChanged,
+    connect(m_modbusDevice, &ModbusTransport::stateChanged,
             this, &ServoDriverDevice::onStateChanged);
-    connect(m_modbusDevice, &QModbusClient::errorOccurred,
+    connect(m_modbusDevice, &ModbusTransport::errorOccurred,
             this, &ServoDriverDevice::onErrorOccurred);
 }
 
@@ -93,7 +95,8 @@ void ServoDriverDevice::onStateChanged(QModbusDevice::State state)
         emit logMessage(QString("[%1] Connected.").arg(m_identifier));
         sd.isConnected = true;
         updateServoData(sd);
-        m_readTimer->start();
+        if (!m_externalPolling)
+            m_readTimer->start();
     } else if (state == QModbusDevice::UnconnectedState) {
         qDebug() << "Servo Modbus disconnected:" << m_identifier;
         emit logMessage(QString("[%1] Disconnected.").arg(m_identifier));
@@ -115,9 +118,27 @@ void ServoDriverDevice::onErrorOccurred(QModbusDevice::Error error)
 }
 
 void ServoDriverDevice::readData()
+{
+    pollStatus();
+}
+
+void ServoDriverDevice::setExternalPolling(bool external)
+{
+    m_externalPolling = external;
+    if (external)
+        m_readTimer->stop();
+    else if (m_modbusDevice && m_modbusDevice->state() == QModbusDevice::ConnectedState)
+        m_readTimer->start();
+}
+
+bool ServoDriverDevice::pollStatus()
 {
     if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
-        return;
+        return false;
+
+    // A status read still queued is already stale; do not queue another behind it
+    if (m_link.isPending(QStringLiteral("status")))
+        return false;
 
     QMutexLocker locker(&m_mutex);
 
@@ -126,20 +147,27 @@ void ServoDriverDevice::readData()
 
     QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, startAddress, numberOfEntries);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+
+    m_statusSentUs = LatencyMonitor::nowUs();
     if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("status"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "servo.read", reply);
             connect(reply, &QModbusReply::finished, this, &ServoDriverDevice::onReadReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
         } else {
             reply->deleteLater();
         }
-    } else {
-        logError(QString("Read error: %1").arg(m_modbusDevice->errorString()));
-        ServoData sd = m_currentData;
-        sd.isConnected = false;
-        updateServoData(sd);
+        return true;
     }
+
+    logError(QString("Read error: %1").arg(m_modbusDevice->errorString()));
+    ServoData sd = m_currentData;
+    sd.isConnected = false;
+    updateServoData(sd);
+    return false;
 }
 
 void ServoDriverDevice::onReadReady()
@@ -147,6 +175,8 @@ void ServoDriverDevice::onReadReady()
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "servo.read", reply);
+    TRACE_SCOPE("modbus", "servo.read.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -170,6 +200,11 @@ void ServoDriverDevice::onReadReady()
             newData.driverTemp = static_cast<float>((static_cast<int32_t>(data[48]) << 16) | data[49]);
 
             updateServoData(newData);
+
+            // The drive sampled its registers somewhere between request and
+            // response; the midpoint is the best estimate
+            const qint64 receivedUs = LatencyMonitor::nowUs();
+            emit statusSampled(newData, m_statusSentUs + (receivedUs - m_statusSentUs) / 2);
         } else {
             qWarning() << "Insufficient register data:" << data.size();
         }
@@ -184,27 +219,88 @@ void ServoDriverDevice::onReadReady()
 }
 
 void ServoDriverDevice::writeData(int startAddress, const QVector<quint16> &values)
+{
+    sendWrite(startAddress, values);
+}
+
+QModbusReply *ServoDriverDevice::sendWrite(int startAddress, const QVector<quint16> &values)
 {
     if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
-        return;
+        return nullptr;
 
     QMutexLocker locker(&m_mutex);
     QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, startAddress, values);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
+
     if (auto *reply = m_modbusDevice->sendWriteRequest(writeUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("command"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "servo.write", reply);
             connect(reply, &QModbusReply::finished, this, &ServoDriverDevice::onWriteReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Command));
         } else {
             reply->deleteLater();
         }
-    } else {
-        logError(QString("Write error: %1").arg(m_modbusDevice->errorString()));
-        ServoData sd = m_currentData;
-        sd.isConnected = false;
-        updateServoData(sd);
+        return reply;
     }
+
+    logError(QString("Write error: %1").arg(m_modbusDevice->errorString()));
+    ServoData sd = m_currentData;
+    sd.isConnected = false;
+    updateServoData(sd);
+    return nullptr;
+}
+
+bool ServoDriverDevice::moveToPosition(qint32 positionSteps, quint32 speed, quint32 acceleration, quint32 deceleration)
+{
+    if (!m_directPositioningSupported)
+        return false;
+    if (!m_modbusDevice || m_modbusDevice->state() != QModbusDevice::ConnectedState)
+        return false;
+
+    auto appendU32 = [](QVector<quint16> &regs, quint32 value) {
+        regs.append(static_cast<quint16>((value >> 16) & 0xFFFF));
+        regs.append(static_cast<quint16>(value & 0xFFFF));
+    };
+
+    // Release FW/RV continuous operation before the positioning move
+    writeData(0x007D, {0x0000});
+
+    // Direct data operation block, written in one request:
+    // data No., operation type, position, speed, rate, deceleration, current, trigger
+    QVector<quint16> regs;
+    appendU32(regs, 0);                                 // 0x0058 operation data No.
+    appendU32(regs, 1);                                 // 0x005A type: absolute positioning
+    appendU32(regs, static_cast<quint32>(positionSteps)); // 0x005C position
+    appendU32(regs, speed);                             // 0x005E operating speed
+    appendU32(regs, acceleration);                      // 0x0060 starting/changing rate
+    appendU32(regs, deceleration);                      // 0x0062 stopping deceleration
+    appendU32(regs, 1000);                              // 0x0064 operating current (100%)
+    appendU32(regs, 1);                                 // 0x0066 trigger: start
+    writeData(0x0058, regs);
+    return true;
+}
+
+bool ServoDriverDevice::stopMotion()
+{
+    // STOP input is edge triggered: assert then release
+    QModbusReply *reply = sendWrite(0x007D, {0x0020});
+    if (!reply)
+        return false;
+
+    auto acknowledge = [this](QModbusReply *r) {
+        if (r->error() == QModbusDevice::NoError)
+            emit stopAcknowledged();
+    };
+    if (reply->isFinished())
+        acknowledge(reply);
+    else
+        connect(reply, &QModbusReply::finished, this, [reply, acknowledge]() { acknowledge(reply); });
+
+    writeData(0x007D, {0x0000});
+    return true;
 }
 
 void ServoDriverDevice::onWriteReady()
@@ -212,6 +308,8 @@ void ServoDriverDevice::onWriteReady()
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "servo.write", reply);
+    TRACE_SCOPE("modbus", "servo.write.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -268,11 +366,15 @@ void ServoDriverDevice::readAlarmStatus()
     
     QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, alarmRegister, 2);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Diagnostic);
+
     if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("alarm_status"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "servo.alarmStatus", reply);
             connect(reply, &QModbusReply::finished, this, &ServoDriverDevice::onAlarmReadReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Diagnostic));
         } else {
             reply->deleteLater();
         }
@@ -286,6 +388,8 @@ void ServoDriverDevice::onAlarmReadReady()
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "servo.alarmStatus", reply);
+    TRACE_SCOPE("modbus", "servo.alarmStatus.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -293,12 +397,18 @@ void ServoDriverDevice::onAlarmReadReady()
     if (reply->error() == QModbusDevice::NoError) {
         QModbusDataUnit unit = reply->result();
         if (unit.valueCount() >= 2) {
-            // Combine upper and lower registers to get full alarm code
-            int m_currentAlarmCode = (unit.value(0) << 16) | unit.value(1);
-            
-            if (m_currentAlarmCode != 0) {
-                QString alarmDescription = getAlarmDescription(m_currentAlarmCode);
-                emit alarmDetected(m_currentAlarmCode, alarmDescription);
+            // The code is in the lower register; the upper one is always 0
+            // for the 16-bit alarm codes of the drive
+            const uint16_t alarmCode = unit.value(1);
+            emit alarmStatusRead(alarmCode);
+
+            // Alarm status is polled in the background: report changes only
+            if (alarmCode != m_currentAlarmCode) {
+                m_currentAlarmCode = alarmCode;
+                if (alarmCode != 0)
+                    emit alarmDetected(alarmCode, getAlarmDescription(alarmCode));
+                else
+                    emit alarmCleared();
             }
         }
     } else {
@@ -322,9 +432,11 @@ bool ServoDriverDevice::clearAlarm() {
     writeUnit.setValue(0, 0); // Upper register = 0
     writeUnit.setValue(1, 1); // Lower register = 1 to execute the command
     
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
     auto *reply = m_modbusDevice->sendWriteRequest(writeUnit, m_slaveId);
     if (!reply)
         return logError(QString("Alarm reset error: %1").arg(m_modbusDevice->errorString())), false;
+    m_link.track(m_modbusDevice, reply, QStringLiteral("alarm_reset"));
     
     if (reply->isFinished()) {
         reply->deleteLater();
@@ -339,7 +451,9 @@ bool ServoDriverDevice::clearAlarm() {
             resetUnit.setValue(0, 0); // Upper register = 0
             resetUnit.setValue(1, 0); // Lower register = 0 to prepare for next execution
             
+            m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
             if (auto *resetReply = m_modbusDevice->sendWriteRequest(resetUnit, m_slaveId)) {
+                m_link.track(m_modbusDevice, resetReply, QStringLiteral("alarm_reset"));
                 connect(resetReply, &QModbusReply::finished, resetReply, &QModbusReply::deleteLater);
             }
             
@@ -367,11 +481,15 @@ void ServoDriverDevice::readAlarmHistory()
     
     QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, startRegister, numRegisters);
 
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Diagnostic);
+
     if (auto *reply = m_modbusDevice->sendReadRequest(readUnit, m_slaveId)) {
+        m_link.track(m_modbusDevice, reply, QStringLiteral("alarm_history"));
         if (!reply->isFinished()) {
+            TRACE_ASYNC_BEGIN("modbus", "servo.alarmHistory", reply);
             connect(reply, &QModbusReply::finished, this, &ServoDriverDevice::onAlarmHistoryReady);
             if (!m_timeoutTimer->isActive())
-                m_timeoutTimer->start(1000);
+                m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Diagnostic));
         } else {
             reply->deleteLater();
         }
@@ -385,6 +503,8 @@ void ServoDriverDevice::onAlarmHistoryReady()
     auto *reply = qobject_cast<QModbusReply *>(sender());
     if (!reply)
         return;
+    TRACE_ASYNC_END("modbus", "servo.alarmHistory", reply);
+    TRACE_SCOPE("modbus", "servo.alarmHistory.reply");
 
     if (m_timeoutTimer->isActive())
         m_timeoutTimer->stop();
@@ -396,7 +516,8 @@ void ServoDriverDevice::onAlarmHistoryReady()
         // Process alarm history entries
         for (int i = 0; i < unit.valueCount(); i += 2) {
             if (i + 1 < unit.valueCount()) {
-                uint16_t alarmCode = (unit.value(i) << 16) | unit.value(i + 1);
+                // Lower register of each entry, as for the current alarm
+                uint16_t alarmCode = unit.value(i + 1);
                 alarmHistory.append(alarmCode);
             }
         }
@@ -423,9 +544,11 @@ bool ServoDriverDevice::clearAlarmHistory() {
     writeUnit.setValue(0, 0); // Upper register = 0
     writeUnit.setValue(1, 1); // Lower register = 1 to execute the command
     
+    m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
     auto *reply = m_modbusDevice->sendWriteRequest(writeUnit, m_slaveId);
     if (!reply)
         return logError(QString("Clear alarm history error: %1").arg(m_modbusDevice->errorString())), false;
+    m_link.track(m_modbusDevice, reply, QStringLiteral("alarm_history_clear"));
     
     if (reply->isFinished()) {
         reply->deleteLater();
@@ -440,7 +563,9 @@ bool ServoDriverDevice::clearAlarmHistory() {
             resetUnit.setValue(0, 0); // Upper register = 0
             resetUnit.setValue(1, 0); // Lower register = 0 to prepare for next execution
             
+            m_link.prepare(m_modbusDevice, ModbusRequestClass::Command);
             if (auto *resetReply = m_modbusDevice->sendWriteRequest(resetUnit, m_slaveId)) {
+                m_link.track(m_modbusDevice, resetReply, QStringLiteral("alarm_history_clear"));
                 connect(resetReply, &QModbusReply::finished, resetReply, &QModbusReply::deleteLater);
             }
             
@@ -454,6 +579,18 @@ bool ServoDriverDevice::clearAlarmHistory() {
     return true;
 }
 
+QString ServoDriverDevice::alarmName(uint16_t alarmCode) const
+{
+    const auto it = m_alarmMap.constFind(alarmCode);
+    return it != m_alarmMap.constEnd() ? it->alarmName : QString();
+}
+
+bool ServoDriverDevice::isBusIdle() const
+{
+    return m_modbusDevice && m_modbusDevice->state() == QModbusDevice::ConnectedState &&
+           m_link.pendingCount() == 0;
+}
+
 QString ServoDriverDevice::getAlarmDescription(uint16_t alarmCode)
 {
     if (m_alarmMap.contains(alarmCode)) {
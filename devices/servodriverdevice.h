@@ -9,10 +9,11 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
-#include <QModbusRtuSerialClient>
 #include <QModbusDataUnit>
 #include <QModbusReply>
 #include <QtGlobal>
+#include "utils/modbuslinkmonitor.h"
+#include "utils/modbustransport.h"
 
 /**
  * @struct ServoData
@@ -43,6 +44,11 @@ struct ServoData {
     }
 };
 
+// Gimbal step scaling (deg per motor step) for ServoData::position and the
+// rate commands. Signed: the elevation drive counts against positive elevation.
+static constexpr double AZ_DEGREES_PER_STEP = 0.0016179775280;
+static constexpr double EL_DEGREES_PER_STEP = -0.0018;
+
 /**
  * @class ServoDriverDevice
  * @brief Handles Modbus communication with a servo driver over a serial interface.
@@ -96,11 +102,57 @@ public:
      * @param values A vector of 16-bit values to write.
      */
     void writeData(int startAddress, const QVector<quint16> &values);
+
+    /**
+     * @brief Declares whether the drive implements direct data operation (0x0058..0x0067).
+     * Absolute moves are only sent to drives flagged here.
+     */
+    void setDirectPositioningSupported(bool supported) { m_directPositioningSupported = supported; }
+    bool directPositioningSupported() const { return m_directPositioningSupported; }
+
+    /**
+     * @brief Starts an absolute positioning move executed by the drive's own profile generator.
+     * @param positionSteps Target position (steps, same scale as ServoData::position).
+     * @param speed Operating speed (steps/s).
+     * @param acceleration Starting/changing rate (0.001 kHz/s, as setAcceleration in the modes).
+     * @param deceleration Stopping deceleration (0.001 kHz/s).
+     * @return False if direct positioning is not supported or the device is not connected.
+     */
+    bool moveToPosition(qint32 positionSteps, quint32 speed, quint32 acceleration, quint32 deceleration);
+
+    /**
+     * @brief Decelerates the current operation to a stop (STOP input edge).
+     * @return False if the command could not be sent; otherwise
+     *         stopAcknowledged() follows once the drive accepted it.
+     */
+    bool stopMotion();
+
+    /**
+     * @brief Stops the device's own 50 ms status poll; the caller then
+     *        polls with pollStatus() (see GimbalPollGroup).
+     */
+    void setExternalPolling(bool external);
+
+    /**
+     * @brief Sends one status read.
+     * @return False if not connected, the previous status read is still
+     *         pending, or the request could not be sent.
+     */
+    bool pollStatus();
+
     void readAlarmHistory();
     bool clearAlarmHistory();
     void readAlarmStatus();
     bool clearAlarm();
     QString getAlarmDescription(uint16_t alarmCode);
+    /** @brief Short alarm name from the alarm map (empty if unknown). */
+    QString alarmName(uint16_t alarmCode) const;
+
+    /**
+     * @brief True if connected and no request of this driver is queued or in
+     *        flight, i.e. a diagnostic read now delays no motion traffic.
+     */
+    bool isBusIdle() const;
 
 signals:
     /**
@@ -117,6 +169,13 @@ signals:
 
     void servoDataChanged(const ServoData &data);
 
+    /**
+     * @brief Emitted for every successful status read, changed or not.
+     * @param timestampUs Estimated sampling time (LatencyMonitor::nowUs() clock):
+     *        midpoint between request and response.
+     */
+    void statusSampled(const ServoData &data, qint64 timestampUs);
+
     /**
      * @brief Emitted when an error occurs.
      * @param message The error message.
@@ -124,8 +183,23 @@ signals:
     void errorOccurred(const QString &message);
 
 
+    /**
+     * @brief Emitted when the drive acknowledged the STOP edge of stopMotion().
+     */
+    void stopAcknowledged();
+
+    /**
+     * @brief Emitted when the present alarm changes to a non-zero code.
+     */
     void alarmDetected(uint16_t alarmCode, const QString &description);
+    /**
+     * @brief Emitted when the alarm was reset or the drive reports none any more.
+     */
     void alarmCleared();
+    /**
+     * @brief Emitted for every successful alarm status read (0 = no alarm).
+     */
+    void alarmStatusRead(uint16_t alarmCode);
     void alarmHistoryRead(const QList<uint16_t> &alarmHistory);
     void alarmHistoryCleared();
 private slots:
@@ -174,6 +248,11 @@ private:
      */
     void updateServoData(const ServoData &newData);
 
+    /**
+     * @brief Queues a register write; nullptr if it could not be sent.
+     */
+    QModbusReply *sendWrite(int startAddress, const QVector<quint16> &values);
+
     void onAlarmHistoryReady();
     void onAlarmStatusReady();
     void onAlarmReadReady();
@@ -182,8 +261,9 @@ private:
     QString m_device;      ///< Serial port name.
     int m_baudRate;        ///< Baud rate.
     int m_slaveId;         ///< Modbus slave ID.
+    ModbusLinkMonitor m_link; ///< Adaptive timeout, retry policy and metrics, slave="servo_<identifier>".
 
-    QModbusRtuSerialClient *m_modbusDevice = nullptr; ///< Modbus device client.
+    ModbusTransport *m_modbusDevice = nullptr; ///< RTU serial, Modbus TCP or RTU over TCP.
     QMutex m_mutex;                                   ///< Thread-safety mutex.
 
     QTimer *m_readTimer     = nullptr; ///< Timer for periodic data reads.
@@ -193,6 +273,10 @@ private:
 
     QMap<uint16_t, AlarmData> m_alarmMap; // Map of alarm codes to their details
     uint16_t m_currentAlarmCode = 0;
+
+    bool m_directPositioningSupported = false; ///< Drive accepts direct data operation.
+    bool m_externalPolling = false;   ///< Status reads are issued by pollStatus() callers only.
+    qint64 m_statusSentUs = 0;        ///< Send time of the last status read.
     
     // Initialize the alarm map
     void initializeAlarmMap();
@@ -1,4 +1,6 @@
 #include "videodisplaywidget.h"
+#include "utils/latencymonitor.h"
+#include "utils/trace.h"
 
 
 VideoDisplayWidget::VideoDisplayWidget(QWidget *parent) : QWidget(parent) {
@@ -31,6 +33,7 @@ void VideoDisplayWidget::updateFrame(const QImage& frame) {
 }
 
 void VideoDisplayWidget::paintEvent(QPaintEvent *) {
+    TRACE_SCOPE("display", "paint");
     // Debug paint event start
     //qDebug() << "Paint event started on" << objectName();
     
@@ -67,6 +70,13 @@ void VideoDisplayWidget::paintEvent(QPaintEvent *) {
                       (height() - scaledImage.height()) / 2);
     
     painter.drawImage(centerPoint, scaledImage);
+
+    // Display present time of the frame (glass-to-glass latency)
+    const quint64 frameId = frameToDraw.text(LatencyMonitor::FRAME_ID_KEY).toULongLong();
+    if (frameId && frameId != m_lastPresentedFrame) {
+        m_lastPresentedFrame = frameId;
+        LatencyMonitor::instance().markPresented(frameId);
+    }
     
     // Draw a border with widget name for debugging
     //painter.setPen(QPen(Qt::red, 2));
@@ -18,6 +18,7 @@ protected:
 private:
     QImage currentFrame;
     QMutex frameMutex;
+    quint64 m_lastPresentedFrame = 0; // latency stamp once per frame, not per repaint
 };
 
 #endif // VIDEODISPLAYWIDGET_H
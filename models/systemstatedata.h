@@ -11,7 +11,8 @@ enum class MotionMode {
     AutoTrack,     // AI auto track
     ManualTrack,    // user selects ROI track
     RadarTracking,
-    Idle// etc.
+    Idle,// etc.
+    Slew           // turret slewing to a commanded position (home, preset, cue)
 };
 
 struct SystemStateData {
@@ -124,6 +125,12 @@ struct SystemStateData {
     double  targetEl = 0;
     bool trackingActive = false;
 
+    // Automatic lead (aim-point offset from the target, deg; el positive up)
+    bool leadAngleValid = false;
+    double leadAzDeg = 0.0;
+    double leadElDeg = 0.0;
+    double leadTimeOfFlight = 0.0;
+
 
     // ================= Helper Functions =================
     // Example: Determine if everything is “Ready”
@@ -210,7 +217,11 @@ struct SystemStateData {
             requesTrackingRestart == other.requesTrackingRestart &&
             targetAz == other.targetAz &&
             targetEl == other.targetEl &&
-            trackingActive == other.trackingActive
+            trackingActive == other.trackingActive &&
+            leadAngleValid == other.leadAngleValid &&
+            qFuzzyCompare(leadAzDeg + 1.0, other.leadAzDeg + 1.0) &&
+            qFuzzyCompare(leadElDeg + 1.0, other.leadElDeg + 1.0) &&
+            qFuzzyCompare(leadTimeOfFlight + 1.0, other.leadTimeOfFlight + 1.0)
             );
     }
     bool operator!=(const SystemStateData &other) const {
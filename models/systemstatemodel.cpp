@@ -19,7 +19,9 @@ void SystemStateModel::onDayCameraDataChanged(const DayCameraData &dayData)
 void SystemStateModel::onGyroDataChanged(const GyroData &gyroData)
 {
     SystemStateData newData = m_data;
-    newData.lrfDistance = gyroData.roll; // or convert to float
+    newData.roll = gyroData.roll;
+    newData.pitch = gyroData.pitch;
+    newData.yaw = gyroData.yaw;
     updateData(newData);
 }
 
@@ -146,17 +148,26 @@ void SystemStateModel::onServoActuatorDataChanged(const ServoActuatorData &actua
     updateData(newData);
 }
 
+// Servo steps to gimbal degrees
 void SystemStateModel::onServoAzDataChanged(const ServoData &azData)
 {
     SystemStateData newData = m_data;
-    newData.gimbalAz = azData.position * 0.0016179775280;
+    newData.gimbalAz = azData.position * AZ_DEGREES_PER_STEP;
     updateData(newData);
 }
 
 void SystemStateModel::onServoElDataChanged(const ServoData &elData)
 {
     SystemStateData newData = m_data;
-    newData.gimbalEl = elData.position * (-0.0018);;
+    newData.gimbalEl = elData.position * EL_DEGREES_PER_STEP;
+    updateData(newData);
+}
+
+void SystemStateModel::onGimbalSampleChanged(const GimbalSample &sample)
+{
+    SystemStateData newData = m_data;
+    newData.gimbalAz = sample.az.position * AZ_DEGREES_PER_STEP;
+    newData.gimbalEl = sample.el.position * EL_DEGREES_PER_STEP;
     updateData(newData);
 }
 
@@ -193,6 +204,16 @@ void SystemStateModel::setTrackingStarted(bool start)
     updateData(newData);
 }
 
+void SystemStateModel::setLeadSolution(bool valid, double azDeg, double elDeg, double timeOfFlight)
+{
+    SystemStateData newData = m_data;
+    newData.leadAngleValid = valid;
+    newData.leadAzDeg = valid ? azDeg : 0.0;
+    newData.leadElDeg = valid ? elDeg : 0.0;
+    newData.leadTimeOfFlight = valid ? timeOfFlight : 0.0;
+    updateData(newData);
+}
+
 void SystemStateModel::setColorStyle(const QString &style)
 {
     // 1) set m_stateModel field
@@ -15,6 +15,7 @@
 #include "plc42datamodel.h"
 #include "servoactuatordatamodel.h"
 #include "servodriverdatamodel.h"
+#include "../devices/gimbalpollgroup.h"
 // etc.
 
 class SystemStateModel : public QObject
@@ -46,6 +47,8 @@ public slots:
     void onPlc42DataChanged(const Plc42Data &pData);
     void onServoAzDataChanged(const ServoData &azData);
     void onServoElDataChanged(const ServoData &elData);
+    /** @brief Both gimbal axes from one poll tick, applied in a single update. */
+    void onGimbalSampleChanged(const GimbalSample &sample);
     void onServoActuatorDataChanged(const ServoActuatorData &actuatorData);
     void onLrfDataChanged(const LrfData &lrfData);
 
@@ -53,6 +56,7 @@ public slots:
     void setOpMode(OperationalMode newOpMode);
     void setTrackingRestartRequested(bool restart);
     void setTrackingStarted(bool start);
+    void setLeadSolution(bool valid, double azDeg, double elDeg, double timeOfFlight);
 
     void onDayCameraDataChanged(const DayCameraData &dayData);
     void onGyroDataChanged(const GyroData &gyroData);
@@ -0,0 +1,18 @@
+QT       = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = cameracalibration
+
+# Offline tool: fits the per-zoom calibration tables loaded by SystemController
+INCLUDEPATH += ../..
+INCLUDEPATH += "/usr/local/include/opencv4"
+LIBS += -L/usr/local/lib -lopencv_core -lopencv_imgproc -lopencv_imgcodecs -lopencv_videoio -lopencv_calib3d
+
+SOURCES += \
+    main.cpp \
+    ../../utils/cameracalibration.cpp
+
+HEADERS += \
+    ../../utils/cameracalibration.h
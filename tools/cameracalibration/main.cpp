@@ -0,0 +1,231 @@
+/**
+ * @file main.cpp
+ * @brief Offline camera calibration: fits the per-zoom intrinsics table used by
+ *        CameraCalibration from recorded chessboard frames.
+ *
+ * Input layout: one entry per zoom position inside the recording directory,
+ * named "zoom_<position>", either a directory of frames or a video file:
+ *
+ *     recordings/zoom_0/        *.png / *.jpg
+ *     recordings/zoom_4096.mp4
+ *
+ * Frames must be recorded at the pipeline output size (960x720 by default).
+ * The boresight is measured by recording the gun's aim point: pass its pixel
+ * position and the zoom it was measured at.
+ */
+
+#include "utils/cameracalibration.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct FitResult {
+    bool ok = false;
+    CameraIntrinsics intrinsics;
+    double rms = 0.0;
+    int frames = 0;
+};
+
+bool detectBoard(const cv::Mat &frame, const cv::Size &board, std::vector<cv::Point2f> &corners)
+{
+    cv::Mat gray;
+    if (frame.channels() == 1)
+        gray = frame;
+    else
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+    const int flags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
+    if (!cv::findChessboardCorners(gray, board, corners, flags))
+        return false;
+
+    cv::cornerSubPix(gray, corners, cv::Size(11, 11), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.01));
+    return true;
+}
+
+std::vector<cv::Mat> loadFrames(const QFileInfo &source, int videoStride)
+{
+    std::vector<cv::Mat> frames;
+    if (source.isDir()) {
+        const QStringList images = QDir(source.filePath())
+                .entryList({"*.png", "*.jpg", "*.jpeg", "*.bmp"}, QDir::Files, QDir::Name);
+        for (const QString &name : images) {
+            cv::Mat img = cv::imread(QDir(source.filePath()).filePath(name).toStdString());
+            if (!img.empty())
+                frames.push_back(img);
+        }
+        return frames;
+    }
+
+    cv::VideoCapture capture(source.filePath().toStdString());
+    cv::Mat img;
+    for (int index = 0; capture.read(img); ++index) {
+        if (index % videoStride == 0)
+            frames.push_back(img.clone());
+    }
+    return frames;
+}
+
+FitResult fitZoom(const std::vector<cv::Mat> &frames, const cv::Size &board, double squareSize,
+                  const cv::Size &imageSize)
+{
+    FitResult result;
+
+    std::vector<cv::Point3f> objectCorners;
+    for (int r = 0; r < board.height; ++r)
+        for (int c = 0; c < board.width; ++c)
+            objectCorners.emplace_back(c * squareSize, r * squareSize, 0.0f);
+
+    std::vector<std::vector<cv::Point3f>> objectPoints;
+    std::vector<std::vector<cv::Point2f>> imagePoints;
+    for (const cv::Mat &frame : frames) {
+        if (frame.size() != imageSize) {
+            qWarning() << "  skipping frame of size" << frame.cols << "x" << frame.rows;
+            continue;
+        }
+        std::vector<cv::Point2f> corners;
+        if (detectBoard(frame, board, corners)) {
+            imagePoints.push_back(corners);
+            objectPoints.push_back(objectCorners);
+        }
+    }
+
+    result.frames = static_cast<int>(imagePoints.size());
+    if (result.frames < 3)
+        return result;
+
+    // Same model as CameraModel: k1, k2 only, no tangential term
+    cv::Mat cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
+    cv::Mat distCoeffs = cv::Mat::zeros(5, 1, CV_64F);
+    std::vector<cv::Mat> rvecs, tvecs;
+    const int flags = cv::CALIB_ZERO_TANGENT_DIST | cv::CALIB_FIX_K3;
+    result.rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize,
+                                     cameraMatrix, distCoeffs, rvecs, tvecs, flags);
+
+    result.intrinsics.fx = cameraMatrix.at<double>(0, 0);
+    result.intrinsics.fy = cameraMatrix.at<double>(1, 1);
+    result.intrinsics.cx = cameraMatrix.at<double>(0, 2);
+    result.intrinsics.cy = cameraMatrix.at<double>(1, 2);
+    result.intrinsics.k1 = distCoeffs.at<double>(0);
+    result.intrinsics.k2 = distCoeffs.at<double>(1);
+    result.ok = true;
+    return result;
+}
+
+bool parsePair(const QString &text, double &a, double &b)
+{
+    const QStringList parts = text.split(',');
+    if (parts.size() != 2)
+        return false;
+    bool okA = false, okB = false;
+    a = parts[0].toDouble(&okA);
+    b = parts[1].toDouble(&okB);
+    return okA && okB;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cameracalibration");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fits per-zoom camera intrinsics from recorded chessboard frames.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("recordings", "Directory containing zoom_<position> entries.");
+    parser.addPositionalArgument("output", "Calibration JSON to write.");
+
+    QCommandLineOption nameOption("name", "Camera name stored in the table.", "name", "day");
+    QCommandLineOption boardOption("board", "Inner corners of the chessboard (cols,rows).", "cols,rows", "9,6");
+    QCommandLineOption squareOption("square", "Chessboard square size (any unit).", "size", "1.0");
+    QCommandLineOption sizeOption("size", "Frame size (width,height).", "w,h", "960,720");
+    QCommandLineOption strideOption("stride", "Use every Nth frame of video recordings.", "n", "15");
+    QCommandLineOption boresightOption("boresight", "Gun aim point in the image (x,y).", "x,y");
+    QCommandLineOption boresightZoomOption("boresight-zoom", "Zoom position the aim point was measured at.", "zoom", "0");
+    parser.addOptions({nameOption, boardOption, squareOption, sizeOption, strideOption,
+                       boresightOption, boresightZoomOption});
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(1);
+
+    double boardCols = 0, boardRows = 0, width = 0, height = 0;
+    if (!parsePair(parser.value(boardOption), boardCols, boardRows) ||
+        !parsePair(parser.value(sizeOption), width, height)) {
+        qCritical() << "Invalid --board or --size";
+        return 1;
+    }
+    const cv::Size board(static_cast<int>(boardCols), static_cast<int>(boardRows));
+    const cv::Size imageSize(static_cast<int>(width), static_cast<int>(height));
+    const double squareSize = parser.value(squareOption).toDouble();
+    const int stride = std::max(1, parser.value(strideOption).toInt());
+
+    CameraCalibration calibration(imageSize.width, imageSize.height);
+    calibration.setName(parser.value(nameOption));
+
+    const QRegularExpression zoomPattern("^zoom_(-?[0-9]+(?:\\.[0-9]+)?)");
+    const QFileInfoList entries = QDir(args[0]).entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot,
+                                                              QDir::Name);
+    for (const QFileInfo &entry : entries) {
+        const QRegularExpressionMatch match = zoomPattern.match(entry.fileName());
+        if (!match.hasMatch())
+            continue;
+
+        const double zoom = match.captured(1).toDouble();
+        const std::vector<cv::Mat> frames = loadFrames(entry, stride);
+        const FitResult fit = fitZoom(frames, board, squareSize, imageSize);
+        if (!fit.ok) {
+            qWarning() << "zoom" << zoom << ": not enough chessboard views (" << fit.frames << ")";
+            continue;
+        }
+
+        const double hfov = 2.0 * std::atan(imageSize.width / 2.0 / fit.intrinsics.fx) * 180.0 / M_PI;
+        qInfo().noquote() << QString("zoom %1: %2 views, rms %3 px, fx %4 fy %5 cx %6 cy %7 k1 %8 k2 %9, HFOV %10 deg")
+                             .arg(zoom).arg(fit.frames).arg(fit.rms, 0, 'f', 3)
+                             .arg(fit.intrinsics.fx, 0, 'f', 1).arg(fit.intrinsics.fy, 0, 'f', 1)
+                             .arg(fit.intrinsics.cx, 0, 'f', 1).arg(fit.intrinsics.cy, 0, 'f', 1)
+                             .arg(fit.intrinsics.k1, 0, 'f', 4).arg(fit.intrinsics.k2, 0, 'f', 4)
+                             .arg(hfov, 0, 'f', 2);
+        calibration.addEntry(zoom, fit.intrinsics);
+    }
+
+    if (calibration.isEmpty()) {
+        qCritical() << "No zoom position could be calibrated";
+        return 1;
+    }
+
+    // Boresight: angle of the gun aim point as seen by the camera
+    if (parser.isSet(boresightOption)) {
+        double x = 0, y = 0;
+        if (!parsePair(parser.value(boresightOption), x, y)) {
+            qCritical() << "Invalid --boresight";
+            return 1;
+        }
+        double az = 0, el = 0;
+        calibration.modelAt(parser.value(boresightZoomOption).toDouble(), 0.0).pixelToAngle(x, y, az, el);
+        calibration.setBoresight(az, el);
+        qInfo() << "boresight az" << az << "el" << el << "deg";
+    }
+
+    if (!calibration.saveToFile(args[1]))
+        return 1;
+
+    qInfo() << "Wrote" << calibration.entries().size() << "entries to" << args[1];
+    return 0;
+}
@@ -106,6 +106,14 @@ void CustomMenuWidget::setColorStyleChanged(const QString &style)
     }
 }
 
+void CustomMenuWidget::setOptions(const QStringList &options)
+{
+    const int row = m_listWidget->currentRow();
+    m_listWidget->clear();
+    m_listWidget->addItems(options);
+    m_listWidget->setCurrentRow(qBound(0, row, options.size() - 1));
+}
+
 QString CustomMenuWidget::currentItemText() const
 {
     QListWidgetItem *item = m_listWidget->currentItem();
@@ -19,6 +19,7 @@ public:
     void moveSelectionDown();
     void selectCurrentItem();
     void setColorStyleChanged(const QString &style); // manually update color
+    void setOptions(const QStringList &options);     // replace items, keep the selected row
 
 signals:
     void optionSelected(const QString &option);
@@ -8,10 +8,16 @@
 #include "core/systemstatemachine.h"
 
 #include "models/systemstatemodel.h"
+#include "utils/latencymonitor.h"
+#include "utils/metricsregistry.h"
+#include "utils/trace.h"
 #include <QDBusInterface>
 #include <QDBusReply>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 
 MainWindow::MainWindow(GimbalController *gimbal,
     WeaponController *weapon,
@@ -288,7 +294,11 @@ void MainWindow::onSystemStateChanged(const SystemStateData &newData)
 void MainWindow::onUpSwChanged()
 {
 
-        if (m_reticleMenuActive && m_reticleMenuWidget) {
+        if (m_diagnosticsActive && m_diagnosticsWidget) {
+            m_diagnosticsWidget->moveSelectionUp();
+        } else if (m_logsActive && m_logsWidget) {
+            m_logsWidget->moveSelectionUp();
+        } else if (m_reticleMenuActive && m_reticleMenuWidget) {
             m_reticleMenuWidget->moveSelectionUp();
         } else if (m_colorMenuActive && m_colorMenuWidget) {
             m_colorMenuWidget->moveSelectionUp();
@@ -308,7 +318,11 @@ void MainWindow::onUpSwChanged()
 void MainWindow::onDownSwChanged()
 {
 
-        if (m_reticleMenuActive && m_reticleMenuWidget) {
+        if (m_diagnosticsActive && m_diagnosticsWidget) {
+            m_diagnosticsWidget->moveSelectionDown();
+        } else if (m_logsActive && m_logsWidget) {
+            m_logsWidget->moveSelectionDown();
+        } else if (m_reticleMenuActive && m_reticleMenuWidget) {
             m_reticleMenuWidget->moveSelectionDown();
         } else if (m_colorMenuActive && m_colorMenuWidget) {
             m_colorMenuWidget->moveSelectionDown();
@@ -329,6 +343,10 @@ void MainWindow::onDownSwChanged()
 {
         if (m_systemStatusActive && m_systemStatusWidget) {
             m_systemStatusWidget->selectCurrentItem();
+        } else if (m_diagnosticsActive && m_diagnosticsWidget) {
+            m_diagnosticsWidget->selectCurrentItem();
+        } else if (m_logsActive && m_logsWidget) {
+            m_logsWidget->selectCurrentItem();
         } else
             if (m_reticleMenuActive && m_reticleMenuWidget) {
                 m_reticleMenuWidget->selectCurrentItem();
@@ -398,6 +416,8 @@ void MainWindow::handleMenuOptionSelected(const QString &option)
         configureSettings();
     } else if (option == "View Logs") {
         viewLogs();
+    } else if (option == "Diagnostics") {
+        runDiagnostics();
     } else if (option == "Help/About") {
         showHelpAbout();
     }
@@ -518,8 +538,37 @@ void MainWindow::configureSettings() {
 }
 
 void MainWindow::viewLogs() {
-    // Display logs
-    QMessageBox::information(this, "View Logs", "No logs available.");
+    if (m_logsActive) return;
+
+    // Newest first, with size and time, so a dump just taken is on top
+    QStringList lines = {"Return ..."};
+    const QFileInfoList files = QDir(QCoreApplication::applicationDirPath() + "/logs")
+                                    .entryInfoList(QDir::Files, QDir::Time);
+    for (const QFileInfo &file : files) {
+        lines << QString("%1 %2 KB  %3")
+                     .arg(file.fileName(), -34)
+                     .arg(QString::number((file.size() + 1023) / 1024), 6)
+                     .arg(file.lastModified().toString("yyyy-MM-dd HH:mm:ss"));
+    }
+    if (files.isEmpty())
+        lines << "No logs available";
+
+    m_logsActive = true;
+    m_logsWidget = new CustomMenuWidget(lines, m_stateModel, this);
+    m_logsWidget->setColorStyleChanged(m_stateModel->data().colorStyle);
+    m_logsWidget->resize(620, 420);
+    m_logsWidget->move(170, 100);
+
+    connect(m_logsWidget, &CustomMenuWidget::optionSelected, this, [this](const QString &option) {
+        // Listing only: any selection leaves the page
+        Q_UNUSED(option);
+        showIdleMenu();
+    });
+    connect(m_logsWidget, &CustomMenuWidget::menuClosed, this, [this]() {
+        m_logsActive = false;
+        m_logsWidget = nullptr;
+    });
+    m_logsWidget->show();
 }
 
 void MainWindow::softwareUpdates() {
@@ -527,9 +576,62 @@ void MainWindow::softwareUpdates() {
     QMessageBox::information(this, "Software Updates", "Software is up to date.");
 }
 
+QStringList MainWindow::diagnosticsLines() const
+{
+    QStringList lines = {"Return ...", "Dump Latency", "Reset Latency", "Dump Trace", "Dump Metrics"};
+    lines << LatencyMonitor::instance().summaryLines();
+    lines << "--- Metrics ---";
+    lines << MetricsRegistry::instance().summaryLines();
+    return lines;
+}
+
 void MainWindow::runDiagnostics() {
-    // Implement diagnostics
-    QMessageBox::information(this, "Diagnostics", "Diagnostics completed successfully.");
+    if (m_diagnosticsActive) return;
+
+    m_diagnosticsActive = true;
+    m_diagnosticsWidget = new CustomMenuWidget(diagnosticsLines(), m_stateModel, this);
+    m_diagnosticsWidget->setColorStyleChanged(m_stateModel->data().colorStyle);
+    m_diagnosticsWidget->resize(620, 420);
+    m_diagnosticsWidget->move(170, 100);
+
+    // Live percentiles while the page is open
+    m_diagnosticsTimer = new QTimer(m_diagnosticsWidget);
+    connect(m_diagnosticsTimer, &QTimer::timeout, this, [this]() {
+        if (m_diagnosticsWidget)
+            m_diagnosticsWidget->setOptions(diagnosticsLines());
+    });
+    m_diagnosticsTimer->start(1000);
+
+    connect(m_diagnosticsWidget, &CustomMenuWidget::optionSelected, this, [this](const QString &option) {
+        if (option == "Dump Latency") {
+            const QString path = QCoreApplication::applicationDirPath() + "/logs/latency-" +
+                                 QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+            LatencyMonitor::instance().writeJson(path);
+        } else if (option == "Reset Latency") {
+            LatencyMonitor::instance().reset();
+            MetricsRegistry::instance().resetHistograms();
+        } else if (option == "Dump Trace") {
+            Tracer::instance().writeChromeJson(QCoreApplication::applicationDirPath() + "/logs/trace-" +
+                                               QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json");
+        } else if (option == "Dump Metrics") {
+            MetricsRegistry::instance().writePrometheus(QCoreApplication::applicationDirPath() + "/logs/metrics-" +
+                                                        QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".prom");
+        }
+        // selectCurrentItem() closes the page; reopen it unless leaving
+        if (option == "Return ...")
+            showIdleMenu();
+        else
+            QTimer::singleShot(0, this, &MainWindow::runDiagnostics);
+    });
+
+    connect(m_diagnosticsWidget, &CustomMenuWidget::menuClosed, this, [this]() {
+        if (m_diagnosticsTimer)
+            m_diagnosticsTimer->stop();
+        m_diagnosticsActive = false;
+        m_diagnosticsWidget = nullptr;
+        m_diagnosticsTimer = nullptr;
+    });
+    m_diagnosticsWidget->show();
 }
 
 void MainWindow::showHelpAbout() {
@@ -146,6 +146,16 @@ private:
 
     CustomMenuWidget *m_aboutWidget = nullptr;
     bool m_aboutActive = false;
+
+    // Diagnostics page (latency histograms and metrics), refreshed while open
+    CustomMenuWidget *m_diagnosticsWidget = nullptr;
+    bool m_diagnosticsActive = false;
+    QTimer *m_diagnosticsTimer = nullptr;
+    QStringList diagnosticsLines() const;
+
+    // Log page: files written to logs/ (latency, trace and metrics dumps)
+    CustomMenuWidget *m_logsWidget = nullptr;
+    bool m_logsActive = false;
     bool m_isDayCameraActive = true;
 
     void closeAppAndHardware();
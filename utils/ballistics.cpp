@@ -0,0 +1,234 @@
+#include "ballistics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr double GRAVITY = 9.80665;
+constexpr double RAD_TO_DEG = 180.0 / M_PI;
+constexpr double LB_PER_IN2_TO_KG_PER_M2 = 703.06958;
+constexpr double INTEGRATION_STEP = 0.0005; // s
+
+struct DragPoint { double mach; double cd; };
+
+// Abridged standard drag tables (Mach, Cd)
+const DragPoint G1_TABLE[] = {
+    {0.00, 0.2629}, {0.50, 0.2032}, {0.60, 0.2034}, {0.70, 0.2165}, {0.80, 0.2546},
+    {0.90, 0.3341}, {0.95, 0.3897}, {1.00, 0.4805}, {1.05, 0.5385}, {1.10, 0.5934},
+    {1.20, 0.6440}, {1.30, 0.6589}, {1.40, 0.6625}, {1.50, 0.6573}, {1.75, 0.6246},
+    {2.00, 0.5934}, {2.50, 0.5397}, {3.00, 0.5133}, {4.00, 0.4731}, {5.00, 0.4610}
+};
+
+const DragPoint G7_TABLE[] = {
+    {0.00, 0.1198}, {0.50, 0.1197}, {0.70, 0.1196}, {0.80, 0.1242}, {0.90, 0.1464},
+    {0.95, 0.2054}, {1.00, 0.3803}, {1.05, 0.4043}, {1.10, 0.4014}, {1.20, 0.3955},
+    {1.50, 0.3657}, {2.00, 0.2980}, {2.50, 0.2697}, {3.00, 0.2424}, {4.00, 0.2046},
+    {5.00, 0.1851}
+};
+
+template <std::size_t N>
+double interpolateCd(const DragPoint (&table)[N], double mach)
+{
+    if (mach <= table[0].mach)
+        return table[0].cd;
+    for (std::size_t i = 1; i < N; ++i) {
+        if (mach <= table[i].mach) {
+            const double t = (mach - table[i - 1].mach) / (table[i].mach - table[i - 1].mach);
+            return table[i - 1].cd + t * (table[i].cd - table[i - 1].cd);
+        }
+    }
+    return table[N - 1].cd;
+}
+
+double dragCoefficient(DragModel model, double mach)
+{
+    return model == DragModel::G7 ? interpolateCd(G7_TABLE, mach) : interpolateCd(G1_TABLE, mach);
+}
+
+struct TrajectorySample {
+    double x;   // downrange (m)
+    double y;   // height relative to the bore line origin (m)
+    double t;   // s
+    double v;   // m/s
+};
+
+/**
+ * Integrates the point-mass trajectory for a launch angle and calls onSample
+ * every time x crosses a multiple of rangeStep. Returns the height at zeroRange.
+ */
+template <typename Callback>
+double integrate(const AmmunitionProfile &p, const BallisticConditions &c,
+                 double launchAngle, double maxRange, double rangeStep, Callback &&onSample)
+{
+    const double bcSi = p.ballisticCoefficient * LB_PER_IN2_TO_KG_PER_M2;
+    const double dragFactor = M_PI * c.airDensity / (8.0 * bcSi);
+
+    double x = 0.0, y = 0.0, t = 0.0;
+    double vx = p.muzzleVelocity * std::cos(launchAngle);
+    double vy = p.muzzleVelocity * std::sin(launchAngle);
+    double heightAtZero = 0.0;
+    bool zeroPassed = false;
+    double nextRange = 0.0;
+
+    onSample(TrajectorySample{0.0, 0.0, 0.0, p.muzzleVelocity});
+    nextRange += rangeStep;
+
+    const double dt = INTEGRATION_STEP;
+    while (nextRange <= maxRange + 1e-9 || !zeroPassed) {
+        auto accel = [&](double avx, double avy, double &ax, double &ay) {
+            const double v = std::hypot(avx, avy);
+            const double k = dragFactor * dragCoefficient(p.dragModel, v / c.speedOfSound) * v;
+            ax = -k * avx;
+            ay = -k * avy - GRAVITY;
+        };
+
+        // Midpoint (RK2) step
+        double ax1, ay1;
+        accel(vx, vy, ax1, ay1);
+        const double mvx = vx + 0.5 * dt * ax1;
+        const double mvy = vy + 0.5 * dt * ay1;
+        double ax2, ay2;
+        accel(mvx, mvy, ax2, ay2);
+
+        const double nx = x + dt * mvx;
+        const double ny = y + dt * mvy;
+        const double nvx = vx + dt * ax2;
+        const double nvy = vy + dt * ay2;
+        const double nt = t + dt;
+
+        // Sample crossings of the range grid (linear between integration steps)
+        while (nextRange <= maxRange + 1e-9 && nx >= nextRange) {
+            const double f = (nextRange - x) / (nx - x);
+            onSample(TrajectorySample{nextRange, y + f * (ny - y), t + f * dt,
+                                      std::hypot(vx + f * (nvx - vx), vy + f * (nvy - vy))});
+            nextRange += rangeStep;
+        }
+        if (!zeroPassed && nx >= p.zeroRange) {
+            const double f = (p.zeroRange - x) / (nx - x);
+            heightAtZero = y + f * (ny - y);
+            zeroPassed = true;
+        }
+
+        x = nx; y = ny; vx = nvx; vy = nvy; t = nt;
+
+        // Projectile stalled or falling steeply: stop
+        if (vx <= 1.0 || t > 30.0)
+            break;
+    }
+    return heightAtZero;
+}
+
+} // namespace
+
+AmmunitionProfile AmmunitionProfile::m33Ball()
+{
+    AmmunitionProfile p;
+    p.name = "12.7x99 M33 Ball";
+    p.dragModel = DragModel::G1;
+    p.ballisticCoefficient = 0.62;
+    p.muzzleVelocity = 887.0;
+    p.sightHeight = 0.10;
+    p.zeroRange = 300.0;
+    return p;
+}
+
+AmmunitionProfile AmmunitionProfile::m80Ball()
+{
+    AmmunitionProfile p;
+    p.name = "7.62x51 M80 Ball";
+    p.dragModel = DragModel::G7;
+    p.ballisticCoefficient = 0.200;
+    p.muzzleVelocity = 838.0;
+    p.sightHeight = 0.08;
+    p.zeroRange = 300.0;
+    return p;
+}
+
+std::vector<AmmunitionProfile> AmmunitionProfile::builtInProfiles()
+{
+    return { m33Ball(), m80Ball() };
+}
+
+std::shared_ptr<const BallisticTable> BallisticTable::build(const AmmunitionProfile &profile,
+                                                            const BallisticConditions &conditions,
+                                                            double maxRange, double rangeStep)
+{
+    if (profile.muzzleVelocity <= 0.0 || profile.ballisticCoefficient <= 0.0 ||
+        rangeStep <= 0.0 || maxRange < rangeStep || profile.zeroRange <= 0.0)
+        return nullptr;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto ignore = [](const TrajectorySample &) {};
+
+    // 1) Zero: find the launch angle where the trajectory meets the sight line
+    //    (height == sightHeight) at zeroRange. Height at zero grows with angle.
+    double lo = -0.01, hi = 0.05; // rad
+    for (int i = 0; i < 50; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        const double h = integrate(profile, conditions, mid, 0.0, rangeStep, ignore);
+        if (h < profile.sightHeight) lo = mid; else hi = mid;
+    }
+    const double launchAngle = 0.5 * (lo + hi);
+
+    // 2) Dense table along the zeroed trajectory
+    std::shared_ptr<BallisticTable> table(new BallisticTable());
+    table->m_profile = profile;
+    table->m_rangeStep = rangeStep;
+    table->m_invRangeStep = 1.0 / rangeStep;
+    table->m_launchAngleDeg = launchAngle * RAD_TO_DEG;
+    table->m_entries.reserve(static_cast<std::size_t>(maxRange / rangeStep) + 2);
+
+    // The sight line is the horizontal reference, sightHeight above the bore origin
+    const double mv = profile.muzzleVelocity;
+
+    integrate(profile, conditions, launchAngle, maxRange, rangeStep,
+              [&](const TrajectorySample &s) {
+        Entry e;
+        e.timeOfFlight = s.t;
+        e.velocity = s.v;
+        e.drop = profile.sightHeight - s.y;
+        if (s.x > 0.0) {
+            e.holdoverDeg = std::atan(e.drop / s.x) * RAD_TO_DEG;
+            // Didion lag rule: drift = w * (t - x / v0)
+            const double lag = std::max(0.0, s.t - s.x / mv);
+            e.driftPerMpsDeg = std::atan(lag / s.x) * RAD_TO_DEG;
+        } else {
+            e.holdoverDeg = 0.0;
+            e.driftPerMpsDeg = 0.0;
+        }
+        table->m_entries.push_back(e);
+    });
+
+    if (table->m_entries.size() < 2)
+        return nullptr;
+
+    table->m_buildTimeMs = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start).count();
+    return table;
+}
+
+BallisticSolution BallisticTable::solve(double range) const
+{
+    BallisticSolution s;
+    if (!(range >= 0.0) || m_entries.size() < 2)
+        return s;
+
+    const double pos = range * m_invRangeStep;
+    const std::size_t i = static_cast<std::size_t>(pos);
+    if (i + 1 >= m_entries.size())
+        return s;
+
+    const double f = pos - static_cast<double>(i);
+    const Entry &a = m_entries[i];
+    const Entry &b = m_entries[i + 1];
+
+    s.valid = true;
+    s.range = range;
+    s.timeOfFlight   = a.timeOfFlight   + f * (b.timeOfFlight   - a.timeOfFlight);
+    s.velocity       = a.velocity       + f * (b.velocity       - a.velocity);
+    s.drop           = a.drop           + f * (b.drop           - a.drop);
+    s.holdoverDeg    = a.holdoverDeg    + f * (b.holdoverDeg    - a.holdoverDeg);
+    s.driftPerMpsDeg = a.driftPerMpsDeg + f * (b.driftPerMpsDeg - a.driftPerMpsDeg);
+    return s;
+}
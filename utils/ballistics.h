@@ -0,0 +1,117 @@
+#ifndef BALLISTICS_H
+#define BALLISTICS_H
+
+/**
+ * @file ballistics.h
+ * @brief Point-mass ballistic solver and precomputed firing tables for the OSD reticles.
+ *
+ * The trajectory is integrated once per ammunition profile (zeroed at the
+ * profile's zero range) and sampled into a dense, uniformly spaced table.
+ * Per-frame lookups are O(1) linear interpolations with no trigonometry.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Standard reference drag functions.
+ */
+enum class DragModel {
+    G1,  // flat-base projectiles
+    G7   // boat-tail, long-range projectiles
+};
+
+/**
+ * @struct AmmunitionProfile
+ * @brief Projectile and weapon data needed to build a firing table.
+ */
+struct AmmunitionProfile {
+    std::string name = "12.7x99 M33 Ball";
+    DragModel dragModel = DragModel::G1;
+    double ballisticCoefficient = 0.62; ///< lb/in^2, for dragModel
+    double muzzleVelocity = 887.0;      ///< m/s
+    double sightHeight = 0.10;          ///< Sight axis above bore (m)
+    double zeroRange = 300.0;           ///< Range at which sight and trajectory coincide (m)
+
+    // Built-in profiles for the mounted weapons
+    static AmmunitionProfile m33Ball();   // 12.7x99 mm
+    static AmmunitionProfile m80Ball();   // 7.62x51 mm
+    static std::vector<AmmunitionProfile> builtInProfiles();
+};
+
+/**
+ * @struct BallisticConditions
+ * @brief Atmosphere used when building the table.
+ */
+struct BallisticConditions {
+    double airDensity = 1.225;    ///< kg/m^3 (ICAO sea level)
+    double speedOfSound = 340.3;  ///< m/s
+};
+
+/**
+ * @struct BallisticSolution
+ * @brief Interpolated table entry for one range. Angles are in degrees.
+ */
+struct BallisticSolution {
+    bool valid = false;
+    double range = 0.0;          ///< m
+    double timeOfFlight = 0.0;   ///< s
+    double velocity = 0.0;       ///< Remaining velocity (m/s)
+    double drop = 0.0;           ///< Below the sight line (m), negative above
+    double holdoverDeg = 0.0;    ///< Aim-up angle relative to the sight line
+    double driftPerMpsDeg = 0.0; ///< Wind drift angle per 1 m/s full-value crosswind
+
+    /// Drift angle for a given crosswind (m/s, positive from the left)
+    double windageDeg(double crosswind) const { return driftPerMpsDeg * crosswind; }
+};
+
+/**
+ * @class BallisticTable
+ * @brief Immutable dense firing table. Safe to share between threads once built.
+ */
+class BallisticTable
+{
+public:
+    /**
+     * @brief Integrates the trajectory and samples it every @p rangeStep metres.
+     * @return nullptr if the profile is invalid.
+     */
+    static std::shared_ptr<const BallisticTable> build(const AmmunitionProfile &profile,
+                                                       const BallisticConditions &conditions = BallisticConditions(),
+                                                       double maxRange = 2000.0,
+                                                       double rangeStep = 5.0);
+
+    /**
+     * @brief O(1) interpolated lookup. Ranges beyond the table are invalid.
+     */
+    BallisticSolution solve(double range) const;
+
+    const AmmunitionProfile &profile() const { return m_profile; }
+    double maxRange() const { return m_rangeStep * (static_cast<int>(m_entries.size()) - 1); }
+    double rangeStep() const { return m_rangeStep; }
+    double launchAngleDeg() const { return m_launchAngleDeg; }
+    double buildTimeMs() const { return m_buildTimeMs; }
+
+private:
+    struct Entry {
+        double timeOfFlight;
+        double velocity;
+        double drop;
+        double holdoverDeg;
+        double driftPerMpsDeg;
+    };
+
+    BallisticTable() = default;
+
+    AmmunitionProfile m_profile;
+    double m_rangeStep = 5.0;
+    double m_invRangeStep = 0.2;
+    double m_launchAngleDeg = 0.0;
+    double m_buildTimeMs = 0.0;
+    std::vector<Entry> m_entries;
+};
+
+using BallisticTablePtr = std::shared_ptr<const BallisticTable>;
+
+#endif // BALLISTICS_H
@@ -0,0 +1,244 @@
+#include "cameracalibration.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+constexpr double RAD_TO_DEG = 180.0 / M_PI;
+
+// Fixed-point undistortion converges in a few steps for the mild distortion
+// of the zoom lenses; a fixed count keeps the per-call cost bounded.
+constexpr int UNDISTORT_ITERATIONS = 5;
+
+CameraIntrinsics lerp(const CameraIntrinsics &a, const CameraIntrinsics &b, double t)
+{
+    CameraIntrinsics r;
+    r.fx = a.fx + t * (b.fx - a.fx);
+    r.fy = a.fy + t * (b.fy - a.fy);
+    r.cx = a.cx + t * (b.cx - a.cx);
+    r.cy = a.cy + t * (b.cy - a.cy);
+    r.k1 = a.k1 + t * (b.k1 - a.k1);
+    r.k2 = a.k2 + t * (b.k2 - a.k2);
+    return r;
+}
+}
+
+// ============================================================================
+// CameraModel
+// ============================================================================
+
+CameraModel::CameraModel(const CameraIntrinsics &intrinsics, double boresightAzDeg, double boresightElDeg)
+    : m_intrinsics(intrinsics),
+      m_invFx(intrinsics.fx > 0.0 ? 1.0 / intrinsics.fx : 0.0),
+      m_invFy(intrinsics.fy > 0.0 ? 1.0 / intrinsics.fy : 0.0),
+      m_boresightAz(boresightAzDeg),
+      m_boresightEl(boresightElDeg)
+{
+}
+
+CameraModel CameraModel::fromHfov(double hfovDeg, int imageWidth, int imageHeight)
+{
+    CameraIntrinsics intrinsics;
+    if (hfovDeg > 0.0 && hfovDeg < 180.0 && imageWidth > 0) {
+        intrinsics.fx = (imageWidth / 2.0) / std::tan(hfovDeg * DEG_TO_RAD / 2.0);
+        intrinsics.fy = intrinsics.fx; // square pixels
+    }
+    intrinsics.cx = imageWidth / 2.0;
+    intrinsics.cy = imageHeight / 2.0;
+    return CameraModel(intrinsics, 0.0, 0.0);
+}
+
+void CameraModel::distort(double xu, double yu, double &xd, double &yd) const
+{
+    const double r2 = xu * xu + yu * yu;
+    const double scale = 1.0 + r2 * (m_intrinsics.k1 + r2 * m_intrinsics.k2);
+    xd = xu * scale;
+    yd = yu * scale;
+}
+
+void CameraModel::undistort(double xd, double yd, double &xu, double &yu) const
+{
+    xu = xd;
+    yu = yd;
+    if (m_intrinsics.k1 == 0.0 && m_intrinsics.k2 == 0.0)
+        return;
+
+    for (int i = 0; i < UNDISTORT_ITERATIONS; ++i) {
+        const double r2 = xu * xu + yu * yu;
+        const double scale = 1.0 + r2 * (m_intrinsics.k1 + r2 * m_intrinsics.k2);
+        xu = xd / scale;
+        yu = yd / scale;
+    }
+}
+
+void CameraModel::pixelToAngle(double x, double y, double &azDeg, double &elDeg) const
+{
+    double xu, yu;
+    undistort((x - m_intrinsics.cx) * m_invFx, (y - m_intrinsics.cy) * m_invFy, xu, yu);
+
+    // Ray (xu, yu, 1) in camera coordinates, image y pointing down
+    azDeg = std::atan(xu) * RAD_TO_DEG - m_boresightAz;
+    elDeg = std::atan2(-yu, std::sqrt(1.0 + xu * xu)) * RAD_TO_DEG - m_boresightEl;
+}
+
+void CameraModel::angleToPixel(double azDeg, double elDeg, double &x, double &y) const
+{
+    const double xu = std::tan((azDeg + m_boresightAz) * DEG_TO_RAD);
+    const double yu = -std::tan((elDeg + m_boresightEl) * DEG_TO_RAD) * std::sqrt(1.0 + xu * xu);
+
+    double xd, yd;
+    distort(xu, yu, xd, yd);
+    x = m_intrinsics.cx + xd * m_intrinsics.fx;
+    y = m_intrinsics.cy + yd * m_intrinsics.fy;
+}
+
+void CameraModel::pixelsToAngles(const double *xy, double *azEl, int count) const
+{
+    for (int i = 0; i < count; ++i)
+        pixelToAngle(xy[2 * i], xy[2 * i + 1], azEl[2 * i], azEl[2 * i + 1]);
+}
+
+void CameraModel::anglesToPixels(const double *azEl, double *xy, int count) const
+{
+    for (int i = 0; i < count; ++i)
+        angleToPixel(azEl[2 * i], azEl[2 * i + 1], xy[2 * i], xy[2 * i + 1]);
+}
+
+double CameraModel::pixelsPerDegree() const
+{
+    return m_intrinsics.fx * DEG_TO_RAD;
+}
+
+double CameraModel::horizontalFov(int imageWidth) const
+{
+    if (!isValid())
+        return 0.0;
+    return 2.0 * std::atan((imageWidth / 2.0) * m_invFx) * RAD_TO_DEG;
+}
+
+// ============================================================================
+// CameraCalibration
+// ============================================================================
+
+CameraCalibration::CameraCalibration(int imageWidth, int imageHeight)
+    : m_imageWidth(imageWidth),
+      m_imageHeight(imageHeight)
+{
+}
+
+void CameraCalibration::addEntry(double zoomPosition, const CameraIntrinsics &intrinsics)
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), zoomPosition,
+                               [](const CalibrationEntry &e, double zoom) { return e.zoomPosition < zoom; });
+    if (it != m_entries.end() && it->zoomPosition == zoomPosition) {
+        it->intrinsics = intrinsics;
+        return;
+    }
+    m_entries.insert(it, {zoomPosition, intrinsics});
+}
+
+CameraModel CameraCalibration::modelAt(double zoomPosition, double fallbackHfovDeg) const
+{
+    if (m_entries.empty()) {
+        CameraModel fallback = CameraModel::fromHfov(fallbackHfovDeg, m_imageWidth, m_imageHeight);
+        return CameraModel(fallback.intrinsics(), m_boresightAz, m_boresightEl);
+    }
+
+    if (zoomPosition <= m_entries.front().zoomPosition)
+        return CameraModel(m_entries.front().intrinsics, m_boresightAz, m_boresightEl);
+    if (zoomPosition >= m_entries.back().zoomPosition)
+        return CameraModel(m_entries.back().intrinsics, m_boresightAz, m_boresightEl);
+
+    auto hi = std::lower_bound(m_entries.begin(), m_entries.end(), zoomPosition,
+                               [](const CalibrationEntry &e, double zoom) { return e.zoomPosition < zoom; });
+    auto lo = hi - 1;
+    const double span = hi->zoomPosition - lo->zoomPosition;
+    const double t = span > 0.0 ? (zoomPosition - lo->zoomPosition) / span : 0.0;
+    return CameraModel(lerp(lo->intrinsics, hi->intrinsics, t), m_boresightAz, m_boresightEl);
+}
+
+bool CameraCalibration::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "CameraCalibration: cannot open" << path;
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "CameraCalibration: invalid JSON in" << path << error.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    m_name = root.value("name").toString(m_name);
+    m_imageWidth = root.value("imageWidth").toInt(m_imageWidth);
+    m_imageHeight = root.value("imageHeight").toInt(m_imageHeight);
+
+    const QJsonObject boresight = root.value("boresight").toObject();
+    m_boresightAz = boresight.value("az").toDouble(0.0);
+    m_boresightEl = boresight.value("el").toDouble(0.0);
+
+    m_entries.clear();
+    const QJsonArray entries = root.value("entries").toArray();
+    for (const QJsonValue &value : entries) {
+        const QJsonObject e = value.toObject();
+        CameraIntrinsics intrinsics;
+        intrinsics.fx = e.value("fx").toDouble();
+        intrinsics.fy = e.value("fy").toDouble(intrinsics.fx);
+        intrinsics.cx = e.value("cx").toDouble(m_imageWidth / 2.0);
+        intrinsics.cy = e.value("cy").toDouble(m_imageHeight / 2.0);
+        intrinsics.k1 = e.value("k1").toDouble(0.0);
+        intrinsics.k2 = e.value("k2").toDouble(0.0);
+        if (intrinsics.fx <= 0.0 || intrinsics.fy <= 0.0) {
+            qWarning() << "CameraCalibration: skipping entry with invalid focal length in" << path;
+            continue;
+        }
+        addEntry(e.value("zoom").toDouble(), intrinsics);
+    }
+
+    qDebug() << "CameraCalibration:" << m_name << "loaded" << m_entries.size() << "entries from" << path;
+    return true;
+}
+
+bool CameraCalibration::saveToFile(const QString &path) const
+{
+    QJsonArray entries;
+    for (const CalibrationEntry &entry : m_entries) {
+        QJsonObject e;
+        e["zoom"] = entry.zoomPosition;
+        e["fx"] = entry.intrinsics.fx;
+        e["fy"] = entry.intrinsics.fy;
+        e["cx"] = entry.intrinsics.cx;
+        e["cy"] = entry.intrinsics.cy;
+        e["k1"] = entry.intrinsics.k1;
+        e["k2"] = entry.intrinsics.k2;
+        entries.append(e);
+    }
+
+    QJsonObject boresight;
+    boresight["az"] = m_boresightAz;
+    boresight["el"] = m_boresightEl;
+
+    QJsonObject root;
+    root["name"] = m_name;
+    root["imageWidth"] = m_imageWidth;
+    root["imageHeight"] = m_imageHeight;
+    root["boresight"] = boresight;
+    root["entries"] = entries;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "CameraCalibration: cannot write" << path;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
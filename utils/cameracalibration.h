@@ -0,0 +1,161 @@
+#ifndef CAMERACALIBRATION_H
+#define CAMERACALIBRATION_H
+
+/**
+ * @file cameracalibration.h
+ * @brief Pixel <-> angle calibration for the day and night cameras.
+ *
+ * Intrinsics (focal lengths, principal point, radial distortion) are stored per
+ * zoom position and interpolated in between. A boresight offset relates the
+ * camera axis to the gun bore, so every angle produced here is relative to the
+ * bore: azimuth positive right, elevation positive up (SystemStateData convention).
+ */
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct CameraIntrinsics
+ * @brief Pinhole intrinsics with two-term radial distortion, in output pixels.
+ */
+struct CameraIntrinsics {
+    double fx = 0.0; ///< Horizontal focal length (px).
+    double fy = 0.0; ///< Vertical focal length (px).
+    double cx = 0.0; ///< Principal point x (px).
+    double cy = 0.0; ///< Principal point y (px).
+    double k1 = 0.0; ///< Radial distortion, r^2 term.
+    double k2 = 0.0; ///< Radial distortion, r^4 term.
+};
+
+/**
+ * @class CameraModel
+ * @brief Calibration evaluated at one zoom position. Cheap to copy; all
+ *        transforms are const and allocation-free, so it can be used per frame
+ *        from the streaming thread.
+ */
+class CameraModel
+{
+public:
+    CameraModel() = default;
+    CameraModel(const CameraIntrinsics &intrinsics, double boresightAzDeg, double boresightElDeg);
+
+    /**
+     * @brief Distortion-free model with the principal point at the image centre.
+     */
+    static CameraModel fromHfov(double hfovDeg, int imageWidth, int imageHeight);
+
+    bool isValid() const { return m_intrinsics.fx > 0.0 && m_intrinsics.fy > 0.0; }
+    const CameraIntrinsics &intrinsics() const { return m_intrinsics; }
+
+    /**
+     * @brief Image point (px) to angles relative to the gun bore (deg).
+     */
+    void pixelToAngle(double x, double y, double &azDeg, double &elDeg) const;
+
+    /**
+     * @brief Angles relative to the gun bore (deg) to image point (px).
+     */
+    void angleToPixel(double azDeg, double elDeg, double &x, double &y) const;
+
+    /**
+     * @brief Batched pixelToAngle(). @p xy and @p azEl hold interleaved pairs
+     *        and may alias.
+     */
+    void pixelsToAngles(const double *xy, double *azEl, int count) const;
+
+    /**
+     * @brief Batched angleToPixel(). @p azEl and @p xy hold interleaved pairs
+     *        and may alias.
+     */
+    void anglesToPixels(const double *azEl, double *xy, int count) const;
+
+    /**
+     * @brief Angular scale at the principal point (px/deg), for small offsets
+     *        such as reticle marks.
+     */
+    double pixelsPerDegree() const;
+
+    /**
+     * @brief Where the gun bore appears in the image (px).
+     */
+    void boresightPixel(double &x, double &y) const { angleToPixel(0.0, 0.0, x, y); }
+
+    double horizontalFov(int imageWidth) const;
+
+private:
+    void undistort(double xd, double yd, double &xu, double &yu) const;
+    void distort(double xu, double yu, double &xd, double &yd) const;
+
+    CameraIntrinsics m_intrinsics;
+    double m_invFx = 0.0;
+    double m_invFy = 0.0;
+    double m_boresightAz = 0.0;
+    double m_boresightEl = 0.0;
+};
+
+/**
+ * @struct CalibrationEntry
+ * @brief Intrinsics measured at one zoom position.
+ */
+struct CalibrationEntry {
+    double zoomPosition = 0.0; ///< Raw zoom position reported by the camera.
+    CameraIntrinsics intrinsics;
+};
+
+/**
+ * @class CameraCalibration
+ * @brief Calibration table of one camera, keyed by zoom position.
+ *
+ * Tables are produced offline by tools/cameracalibration and stored as JSON.
+ * An empty table falls back to the HFOV reported by the camera control device.
+ */
+class CameraCalibration
+{
+public:
+    explicit CameraCalibration(int imageWidth = 960, int imageHeight = 720);
+
+    void setName(const QString &name) { m_name = name; }
+    const QString &name() const { return m_name; }
+
+    int imageWidth() const { return m_imageWidth; }
+    int imageHeight() const { return m_imageHeight; }
+
+    /**
+     * @brief Inserts an entry, keeping the table sorted by zoom position.
+     *        An entry at an existing zoom position replaces it.
+     */
+    void addEntry(double zoomPosition, const CameraIntrinsics &intrinsics);
+    void clear() { m_entries.clear(); }
+    bool isEmpty() const { return m_entries.empty(); }
+    const std::vector<CalibrationEntry> &entries() const { return m_entries; }
+
+    /**
+     * @brief Bore direction as seen by the camera (deg, az right, el up).
+     */
+    void setBoresight(double azDeg, double elDeg) { m_boresightAz = azDeg; m_boresightEl = elDeg; }
+    double boresightAz() const { return m_boresightAz; }
+    double boresightEl() const { return m_boresightEl; }
+
+    /**
+     * @brief Model at a zoom position, interpolated linearly between table
+     *        entries and held constant outside the table.
+     * @param fallbackHfovDeg HFOV used when the table is empty.
+     */
+    CameraModel modelAt(double zoomPosition, double fallbackHfovDeg) const;
+
+    bool loadFromFile(const QString &path);
+    bool saveToFile(const QString &path) const;
+
+private:
+    QString m_name;
+    int m_imageWidth;
+    int m_imageHeight;
+    std::vector<CalibrationEntry> m_entries;
+    double m_boresightAz = 0.0;
+    double m_boresightEl = 0.0;
+};
+
+using CameraCalibrationPtr = std::shared_ptr<const CameraCalibration>;
+
+#endif // CAMERACALIBRATION_H
@@ -0,0 +1,378 @@
+#include "cpuinference.h"
+#include "simd.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace {
+// Letterbox padding, the grey used when the YOLO models were trained
+constexpr float PAD_VALUE = 114.0f / 255.0f;
+constexpr float BYTE_SCALE = 1.0f / 255.0f;
+
+float candidateIou(const DetectionCandidate &a, const DetectionCandidate &b)
+{
+    const float w = std::min(a.x1, b.x1) - std::max(a.x0, b.x0);
+    const float h = std::min(a.y1, b.y1) - std::max(a.y0, b.y0);
+    if (w <= 0.0f || h <= 0.0f)
+        return 0.0f;
+    const float inter = w * h;
+    const float uni = (a.x1 - a.x0) * (a.y1 - a.y0) + (b.x1 - b.x0) * (b.y1 - b.y0) - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+float lerpChannel(uint32_t tl, uint32_t tr, uint32_t bl, uint32_t br, int shift, float fx, float fy)
+{
+    const float a = static_cast<float>((tl >> shift) & 0xFF);
+    const float b = static_cast<float>((tr >> shift) & 0xFF);
+    const float c = static_cast<float>((bl >> shift) & 0xFF);
+    const float d = static_cast<float>((br >> shift) & 0xFF);
+    const float top = a + (b - a) * fx;
+    const float bottom = c + (d - c) * fx;
+    return (top + (bottom - top) * fy) * BYTE_SCALE;
+}
+}
+
+void Letterbox::prepare(int sourceWidth, int sourceHeight, int width, int height)
+{
+    m_sourceWidth = sourceWidth;
+    m_sourceHeight = sourceHeight;
+    m_width = width;
+    m_height = height;
+
+    const float scale = std::min(static_cast<float>(width) / sourceWidth, static_cast<float>(height) / sourceHeight);
+    m_contentWidth = std::clamp(static_cast<int>(std::lround(sourceWidth * scale)), 1, width);
+    m_contentHeight = std::clamp(static_cast<int>(std::lround(sourceHeight * scale)), 1, height);
+    m_transform.scale = scale;
+    m_transform.padX = (width - m_contentWidth) / 2;
+    m_transform.padY = (height - m_contentHeight) / 2;
+
+    auto buildAxis = [scale](int count, int sourceCount, std::vector<int> &i0, std::vector<int> &i1, std::vector<float> &f) {
+        i0.resize(count);
+        i1.resize(count);
+        f.resize(count);
+        for (int d = 0; d < count; ++d) {
+            const float s = std::clamp((d + 0.5f) / scale - 0.5f, 0.0f, static_cast<float>(sourceCount - 1));
+            i0[d] = static_cast<int>(s);
+            i1[d] = std::min(i0[d] + 1, sourceCount - 1);
+            f[d] = s - i0[d];
+        }
+    };
+    buildAxis(m_contentWidth, sourceWidth, m_x0, m_x1, m_fx);
+    buildAxis(m_contentHeight, sourceHeight, m_y0, m_y1, m_fy);
+
+    m_topLeft.resize(m_contentWidth);
+    m_topRight.resize(m_contentWidth);
+    m_bottomLeft.resize(m_contentWidth);
+    m_bottomRight.resize(m_contentWidth);
+}
+
+bool Letterbox::run(const RgbaImageView &image, const QRect &region, int width, int height,
+                    float *planes, LetterboxTransform &transform)
+{
+    const QRect frame(0, 0, image.width, image.height);
+    const QRect source = (region.isEmpty() ? frame : region).intersected(frame);
+    if (source.isEmpty() || width <= 0 || height <= 0)
+        return false;
+
+    if (source.width() != m_sourceWidth || source.height() != m_sourceHeight || width != m_width || height != m_height)
+        prepare(source.width(), source.height(), width, height);
+
+    transform = m_transform;
+    transform.originX = source.x();
+    transform.originY = source.y();
+
+    const int planeSize = width * height;
+    float *out[3] = {planes, planes + planeSize, planes + 2 * planeSize};
+    const int padX = m_transform.padX;
+    const int padY = m_transform.padY;
+    const int contentEnd = padX + m_contentWidth;
+
+    // Padding bands above and below the content
+    for (int c = 0; c < 3; ++c) {
+        std::fill(out[c], out[c] + padY * width, PAD_VALUE);
+        std::fill(out[c] + (padY + m_contentHeight) * width, out[c] + planeSize, PAD_VALUE);
+    }
+
+    const simd::f32x4 byteScale = simd::set1(BYTE_SCALE);
+    for (int dy = 0; dy < m_contentHeight; ++dy) {
+        const uint32_t *top = reinterpret_cast<const uint32_t *>(image.data + (source.y() + m_y0[dy]) * image.stride) + source.x();
+        const uint32_t *bottom = reinterpret_cast<const uint32_t *>(image.data + (source.y() + m_y1[dy]) * image.stride) + source.x();
+        for (int dx = 0; dx < m_contentWidth; ++dx) {
+            m_topLeft[dx] = top[m_x0[dx]];
+            m_topRight[dx] = top[m_x1[dx]];
+            m_bottomLeft[dx] = bottom[m_x0[dx]];
+            m_bottomRight[dx] = bottom[m_x1[dx]];
+        }
+
+        const int row = (padY + dy) * width;
+        const float fy = m_fy[dy];
+        const simd::f32x4 wy = simd::set1(fy);
+        int dx = 0;
+        for (; dx + simd::LANES <= m_contentWidth; dx += simd::LANES) {
+            const simd::f32x4 wx = simd::load(&m_fx[dx]);
+            for (int c = 0; c < 3; ++c) {
+                const simd::f32x4 a = simd::unpackByte(&m_topLeft[dx], c);
+                const simd::f32x4 b = simd::unpackByte(&m_topRight[dx], c);
+                const simd::f32x4 d = simd::unpackByte(&m_bottomLeft[dx], c);
+                const simd::f32x4 e = simd::unpackByte(&m_bottomRight[dx], c);
+                const simd::f32x4 upper = simd::add(a, simd::mul(simd::sub(b, a), wx));
+                const simd::f32x4 lower = simd::add(d, simd::mul(simd::sub(e, d), wx));
+                const simd::f32x4 value = simd::add(upper, simd::mul(simd::sub(lower, upper), wy));
+                simd::store(out[c] + row + padX + dx, simd::mul(value, byteScale));
+            }
+        }
+        for (; dx < m_contentWidth; ++dx) {
+            for (int c = 0; c < 3; ++c)
+                out[c][row + padX + dx] = lerpChannel(m_topLeft[dx], m_topRight[dx], m_bottomLeft[dx],
+                                                      m_bottomRight[dx], c * 8, m_fx[dx], fy);
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            std::fill(out[c] + row, out[c] + row + padX, PAD_VALUE);
+            std::fill(out[c] + row + contentEnd, out[c] + row + width, PAD_VALUE);
+        }
+    }
+    return true;
+}
+
+DetectionNms::DetectionNms(int capacity)
+{
+    m_order.reserve(capacity);
+    m_suppressed.reserve(capacity);
+}
+
+void DetectionNms::run(const std::vector<DetectionCandidate> &candidates, float iouThreshold,
+                       bool classAgnostic, int maxKeep, std::vector<int> &keep)
+{
+    keep.clear();
+    const int n = static_cast<int>(candidates.size());
+    m_order.resize(n);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(), [&candidates](int a, int b) {
+        return candidates[a].score > candidates[b].score || (candidates[a].score == candidates[b].score && a < b);
+    });
+    m_suppressed.assign(n, 0);
+
+    for (int oi = 0; oi < n && static_cast<int>(keep.size()) < maxKeep; ++oi) {
+        const int i = m_order[oi];
+        if (m_suppressed[i])
+            continue;
+        keep.push_back(i);
+
+        const DetectionCandidate &best = candidates[i];
+        for (int oj = oi + 1; oj < n; ++oj) {
+            const int j = m_order[oj];
+            if (m_suppressed[j] || (!classAgnostic && candidates[j].classId != best.classId))
+                continue;
+            if (candidateIou(best, candidates[j]) > iouThreshold)
+                m_suppressed[j] = 1;
+        }
+    }
+}
+
+YoloDecoder::YoloDecoder(int maxCandidates)
+    : m_maxCandidates(maxCandidates)
+{
+}
+
+void YoloDecoder::decode(const float *data, int anchors, int channels, Layout layout,
+                         float confidenceThreshold, std::vector<DetectionCandidate> &candidates)
+{
+    candidates.clear();
+    auto push = [&](float cx, float cy, float w, float h, float score, int classId) {
+        DetectionCandidate c;
+        c.x0 = cx - w * 0.5f;
+        c.y0 = cy - h * 0.5f;
+        c.x1 = cx + w * 0.5f;
+        c.y1 = cy + h * 0.5f;
+        c.score = score;
+        c.classId = classId;
+        candidates.push_back(c);
+    };
+
+    if (layout == Layout::ChannelsFirst) {
+        const int classes = channels - 4;
+        if (classes <= 0)
+            return;
+
+        // Class-major rows are contiguous: keep a running maximum per anchor
+        m_bestScore.assign(data + 4 * anchors, data + 5 * anchors);
+        m_bestClass.assign(anchors, 0);
+        for (int c = 1; c < classes; ++c) {
+            const float *row = data + (4 + c) * anchors;
+            for (int i = 0; i < anchors; ++i) {
+                if (row[i] > m_bestScore[i]) {
+                    m_bestScore[i] = row[i];
+                    m_bestClass[i] = c;
+                }
+            }
+        }
+
+        for (int i = 0; i < anchors && static_cast<int>(candidates.size()) < m_maxCandidates; ++i) {
+            if (m_bestScore[i] < confidenceThreshold)
+                continue;
+            push(data[i], data[anchors + i], data[2 * anchors + i], data[3 * anchors + i], m_bestScore[i], m_bestClass[i]);
+        }
+        return;
+    }
+
+    const int classes = channels - 5;
+    if (classes <= 0)
+        return;
+    for (int i = 0; i < anchors && static_cast<int>(candidates.size()) < m_maxCandidates; ++i) {
+        const float *p = data + static_cast<size_t>(i) * channels;
+        const float objectness = p[4];
+        if (objectness < confidenceThreshold)
+            continue;
+        const float *scores = p + 5;
+        const int classId = static_cast<int>(std::max_element(scores, scores + classes) - scores);
+        const float score = objectness * scores[classId];
+        if (score >= confidenceThreshold)
+            push(p[0], p[1], p[2], p[3], score, classId);
+    }
+}
+
+OpenCvDnnBackend::OpenCvDnnBackend()
+{
+    m_candidates.reserve(4096);
+}
+
+bool OpenCvDnnBackend::load(const InferenceConfig &config)
+{
+    m_config = config;
+    m_config.batchSize = std::max(1, config.batchSize);
+    m_loaded = false;
+
+    try {
+        m_net = cv::dnn::readNetFromONNX(config.modelPath);
+    } catch (const cv::Exception &e) {
+        qWarning() << "OpenCvDnnBackend: cannot load" << config.modelPath.c_str() << e.what();
+        return false;
+    }
+    if (m_net.empty()) {
+        qWarning() << "OpenCvDnnBackend: empty network from" << config.modelPath.c_str();
+        return false;
+    }
+
+    m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    if (config.threads > 0)
+        cv::setNumThreads(config.threads);
+    m_outputNames = m_net.getUnconnectedOutLayersNames();
+
+    if (m_config.roiInputWidth <= 0 || m_config.roiInputHeight <= 0) {
+        m_config.roiInputWidth = config.inputWidth;
+        m_config.roiInputHeight = config.inputHeight;
+    }
+
+    const size_t imageSize = 3 * static_cast<size_t>(std::max(config.inputWidth * config.inputHeight,
+                                                              m_config.roiInputWidth * m_config.roiInputHeight));
+    m_blob.assign(imageSize * m_config.batchSize, PAD_VALUE);
+    m_transforms.assign(m_config.batchSize, LetterboxTransform());
+    m_keep.reserve(std::max(1, config.maxDetections));
+
+    // One forward pass per input size on the padding, so the layer buffers are
+    // allocated now and a batch or shape the model does not accept fails here
+    // rather than per frame
+    try {
+        const int full[] = {m_config.batchSize, 3, config.inputHeight, config.inputWidth};
+        m_net.setInput(cv::Mat(4, full, CV_32F, m_blob.data()));
+        m_net.forward(m_outputs, m_outputNames);
+        if (m_config.roiInputWidth != config.inputWidth || m_config.roiInputHeight != config.inputHeight) {
+            const int roi[] = {m_config.batchSize, 3, m_config.roiInputHeight, m_config.roiInputWidth};
+            m_net.setInput(cv::Mat(4, roi, CV_32F, m_blob.data()));
+            m_net.forward(m_outputs, m_outputNames);
+        }
+    } catch (const cv::Exception &e) {
+        qWarning() << "OpenCvDnnBackend: warm-up failed for" << config.modelPath.c_str()
+                   << "batch" << m_config.batchSize << e.what();
+        return false;
+    }
+
+    m_loaded = true;
+    qDebug() << "OpenCvDnnBackend: loaded" << config.modelPath.c_str() << config.inputWidth << "x" << config.inputHeight
+             << "batch" << m_config.batchSize;
+    return true;
+}
+
+bool OpenCvDnnBackend::detect(const RgbaImageView *frames, const QRect *regions, int count,
+                              std::vector<FusionDetection> *detections)
+{
+    if (!m_loaded)
+        return false;
+
+    const auto start = std::chrono::steady_clock::now();
+    const int batch = m_config.batchSize;
+    const int width = regions ? m_config.roiInputWidth : m_config.inputWidth;
+    const int height = regions ? m_config.roiInputHeight : m_config.inputHeight;
+    const size_t imageSize = 3 * static_cast<size_t>(width) * height;
+    const int sizes[] = {batch, 3, height, width};
+
+    for (int first = 0; first < count; first += batch) {
+        const int n = std::min(batch, count - first);
+        for (int k = 0; k < n; ++k) {
+            const QRect &region = regions ? regions[first + k] : m_config.roi;
+            if (!m_letterbox.run(frames[first + k], region, width, height, &m_blob[k * imageSize], m_transforms[k]))
+                m_transforms[k].scale = 0.0f;
+        }
+
+        try {
+            m_net.setInput(cv::Mat(4, sizes, CV_32F, m_blob.data()));
+            m_net.forward(m_outputs, m_outputNames);
+        } catch (const cv::Exception &e) {
+            qWarning() << "OpenCvDnnBackend: forward failed:" << e.what();
+            return false;
+        }
+
+        const cv::Mat &output = m_outputs.front();
+        if (output.dims != 3 || output.size[0] < n || output.type() != CV_32F) {
+            qWarning() << "OpenCvDnnBackend: unexpected output tensor, dims" << output.dims;
+            return false;
+        }
+
+        for (int k = 0; k < n; ++k) {
+            detections[first + k].clear();
+            if (m_transforms[k].scale > 0.0f)
+                postprocess(output, k, m_transforms[k], frames[first + k], detections[first + k]);
+        }
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_stats.inferences += count;
+    m_stats.totalMs += ms;
+    m_stats.lastMs = ms;
+    return true;
+}
+
+void OpenCvDnnBackend::postprocess(const cv::Mat &output, int image, const LetterboxTransform &transform,
+                                   const RgbaImageView &frame, std::vector<FusionDetection> &detections)
+{
+    // Channel count is far below the anchor count in both layouts
+    const int d1 = output.size[1];
+    const int d2 = output.size[2];
+    const bool channelsFirst = d1 < d2;
+    m_decoder.decode(output.ptr<float>(image), channelsFirst ? d2 : d1, channelsFirst ? d1 : d2,
+                     channelsFirst ? YoloDecoder::Layout::ChannelsFirst : YoloDecoder::Layout::AnchorsFirst,
+                     m_config.confidenceThreshold, m_candidates);
+    m_nms.run(m_candidates, m_config.nmsThreshold, m_config.classAgnosticNms, m_config.maxDetections, m_keep);
+
+    for (int index : m_keep) {
+        const DetectionCandidate &c = m_candidates[index];
+        const float x0 = std::clamp(transform.toFrameX(c.x0), 0.0f, static_cast<float>(frame.width));
+        const float y0 = std::clamp(transform.toFrameY(c.y0), 0.0f, static_cast<float>(frame.height));
+        const float x1 = std::clamp(transform.toFrameX(c.x1), 0.0f, static_cast<float>(frame.width));
+        const float y1 = std::clamp(transform.toFrameY(c.y1), 0.0f, static_cast<float>(frame.height));
+        const int w = static_cast<int>(std::lround(x1 - x0));
+        const int h = static_cast<int>(std::lround(y1 - y0));
+        if (w < 1 || h < 1)
+            continue;
+
+        FusionDetection det;
+        det.box = QRect(static_cast<int>(std::lround(x0)), static_cast<int>(std::lround(y0)), w, h);
+        det.classId = c.classId;
+        det.confidence = c.score;
+        detections.push_back(det);
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef CPUINFERENCE_H
+#define CPUINFERENCE_H
+
+/**
+ * @file cpuinference.h
+ * @brief CPU detector backend: YOLO-family ONNX models through OpenCV DNN, with
+ *        SIMD letterbox preprocessing and NMS on preallocated buffers.
+ *
+ * Both YOLOv8-style ([batch, 4 + classes, anchors]) and YOLOv5-style
+ * ([batch, anchors, 5 + classes]) output tensors are decoded. Models quantised
+ * to int8 (QDQ ONNX) run on OpenCV's int8 layers without further settings.
+ */
+
+#include "utils/inferencebackend.h"
+#include <opencv2/dnn.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct LetterboxTransform
+ * @brief Maps network input coordinates back to frame coordinates.
+ */
+struct LetterboxTransform {
+    float scale = 1.0f; ///< Network pixels per frame pixel.
+    int   padX = 0;     ///< Left/top padding in network pixels.
+    int   padY = 0;
+    int   originX = 0;  ///< Top-left of the source region in the frame.
+    int   originY = 0;
+
+    float toFrameX(float x) const { return (x - padX) / scale + originX; }
+    float toFrameY(float y) const { return (y - padY) / scale + originY; }
+};
+
+/**
+ * @class Letterbox
+ * @brief Resizes an RGBA frame region into a planar float RGB network input,
+ *        keeping the aspect ratio and padding with YOLO grey (114).
+ *
+ * Bilinear sampling; the four source pixels of each output column are gathered
+ * into row buffers and interpolated four columns at a time with the SIMD layer.
+ * Sampling tables are rebuilt only when the geometry changes.
+ */
+class Letterbox
+{
+public:
+    /**
+     * @param planes Output, 3 * width * height floats (R, G, B planes), 0..1.
+     * @return False if @p region does not overlap the image.
+     */
+    bool run(const RgbaImageView &image, const QRect &region, int width, int height,
+             float *planes, LetterboxTransform &transform);
+
+private:
+    void prepare(int sourceWidth, int sourceHeight, int width, int height);
+
+    // Geometry the tables were built for
+    int m_sourceWidth = 0;
+    int m_sourceHeight = 0;
+    int m_width = 0;
+    int m_height = 0;
+
+    LetterboxTransform m_transform;
+    int m_contentWidth = 0;
+    int m_contentHeight = 0;
+
+    // Per output column / row: first source index and weight of the second
+    std::vector<int> m_x0, m_x1, m_y0, m_y1;
+    std::vector<float> m_fx, m_fy;
+
+    // Gathered source pixels of one output row
+    std::vector<uint32_t> m_topLeft, m_topRight, m_bottomLeft, m_bottomRight;
+};
+
+/**
+ * @struct DetectionCandidate
+ * @brief Decoded box before NMS, network input coordinates.
+ */
+struct DetectionCandidate {
+    float x0 = 0.0f;
+    float y0 = 0.0f;
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+    float score = 0.0f;
+    int   classId = -1;
+};
+
+/**
+ * @class DetectionNms
+ * @brief Greedy non-maximum suppression, per class or class-agnostic.
+ *
+ * Work buffers are reserved for @p capacity candidates; larger inputs still
+ * work but allocate.
+ */
+class DetectionNms
+{
+public:
+    explicit DetectionNms(int capacity = 4096);
+
+    /**
+     * @brief Suppresses overlapping candidates.
+     * @param keep Cleared and filled with the indices of the kept candidates,
+     *        best score first, at most @p maxKeep.
+     */
+    void run(const std::vector<DetectionCandidate> &candidates, float iouThreshold,
+             bool classAgnostic, int maxKeep, std::vector<int> &keep);
+
+private:
+    std::vector<int> m_order;
+    std::vector<char> m_suppressed;
+};
+
+/**
+ * @class YoloDecoder
+ * @brief Turns one image of a YOLO output tensor into scored candidates.
+ */
+class YoloDecoder
+{
+public:
+    enum class Layout {
+        ChannelsFirst, ///< [4 + classes, anchors], YOLOv8 and later.
+        AnchorsFirst   ///< [anchors, 5 + classes], YOLOv5 (objectness at 4).
+    };
+
+    explicit YoloDecoder(int maxCandidates = 4096);
+
+    /**
+     * @brief Decodes @p data (one image) into @p candidates (cleared first).
+     *        Candidates beyond the capacity are dropped.
+     */
+    void decode(const float *data, int anchors, int channels, Layout layout,
+                float confidenceThreshold, std::vector<DetectionCandidate> &candidates);
+
+private:
+    int m_maxCandidates;
+    std::vector<float> m_bestScore; // per anchor, ChannelsFirst
+    std::vector<int> m_bestClass;
+};
+
+/**
+ * @class OpenCvDnnBackend
+ * @brief ONNX detector on the CPU.
+ *
+ * The network input blob, candidate list and NMS buffers are allocated at
+ * load(); detect() letterboxes up to batchSize frames into the blob and runs one
+ * forward pass per batch. Region inferences use the ROI input size when one is
+ * configured, which needs a model exported with dynamic input shapes.
+ */
+class OpenCvDnnBackend : public InferenceBackend
+{
+public:
+    OpenCvDnnBackend();
+
+    const char *name() const override { return "opencv-dnn"; }
+    bool load(const InferenceConfig &config) override;
+    bool isLoaded() const override { return m_loaded; }
+    bool detect(const RgbaImageView *frames, const QRect *regions, int count,
+                std::vector<FusionDetection> *detections) override;
+
+private:
+    void postprocess(const cv::Mat &output, int image, const LetterboxTransform &transform,
+                     const RgbaImageView &frame, std::vector<FusionDetection> &detections);
+
+    cv::dnn::Net m_net;
+    std::vector<cv::String> m_outputNames;
+    std::vector<cv::Mat> m_outputs;
+    bool m_loaded = false;
+
+    std::vector<float> m_blob; // [batch][3][height][width], sized for the larger input
+    Letterbox m_letterbox;
+    std::vector<LetterboxTransform> m_transforms;
+
+    YoloDecoder m_decoder;
+    DetectionNms m_nms;
+    std::vector<DetectionCandidate> m_candidates;
+    std::vector<int> m_keep;
+};
+
+#endif // CPUINFERENCE_H
@@ -0,0 +1,62 @@
+#include "cpuosd.h"
+#include <QFont>
+#include <QPainter>
+#include <QPen>
+
+namespace {
+// Crosshair geometry of the DeepStream OSD (reticle type 1)
+constexpr int CROSSHAIR_LENGTH = 120;
+constexpr int CROSSHAIR_GAP = 15;
+}
+
+void CpuOsd::render(QImage &frame, const CpuOsdContent &content) const
+{
+    QPainter painter(&frame);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    QFont font(QStringLiteral("Courier New"), 14);
+    font.setWeight(QFont::DemiBold);
+    painter.setFont(font);
+
+    // Each element is drawn twice: a wide dark shadow, then the colour on top
+    auto line = [&](int x1, int y1, int x2, int y2) {
+        painter.setPen(QPen(m_shadow, 4));
+        painter.drawLine(x1, y1, x2, y2);
+        painter.setPen(QPen(m_color, 2));
+        painter.drawLine(x1, y1, x2, y2);
+    };
+    auto rect = [&](const QRect &r, const QColor &color, int width) {
+        painter.setPen(QPen(m_shadow, width + 2));
+        painter.drawRect(r);
+        painter.setPen(QPen(color, width));
+        painter.drawRect(r);
+    };
+    auto text = [&](int x, int y, const QString &s) {
+        painter.setPen(m_shadow);
+        painter.drawText(x + 1, y + 1, s);
+        painter.setPen(m_color);
+        painter.drawText(x, y, s);
+    };
+
+    const int cx = content.reticle.x();
+    const int cy = content.reticle.y();
+    line(cx - CROSSHAIR_LENGTH / 2, cy, cx - CROSSHAIR_GAP, cy);
+    line(cx + CROSSHAIR_GAP, cy, cx + CROSSHAIR_LENGTH / 2, cy);
+    line(cx, cy - CROSSHAIR_LENGTH / 2, cx, cy - CROSSHAIR_GAP);
+    line(cx, cy + CROSSHAIR_GAP, cx, cy + CROSSHAIR_LENGTH / 2);
+
+    for (const FusionDetection &det : content.detections) {
+        rect(det.box, m_color, 1);
+        const QString label = det.trackId >= 0 ? QStringLiteral("%1 ID:%2").arg(det.classId).arg(det.trackId)
+                                                : QString::number(det.classId);
+        text(det.box.x(), det.box.y() - 4, label);
+    }
+
+    if (!content.trackedBox.isEmpty())
+        rect(content.trackedBox, QColor(255, 255, 0), 2);
+
+    int y = 24;
+    for (const QString &s : content.statusLines) {
+        text(10, y, s);
+        y += 22;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef CPUOSD_H
+#define CPUOSD_H
+
+/**
+ * @file cpuosd.h
+ * @brief Software overlay for the CPU camera pipeline, drawn with QPainter on
+ *        the RGBA frame in place of nvdsosd.
+ */
+
+#include "utils/detectionfusion.h"
+#include <QColor>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QStringList>
+#include <vector>
+
+/**
+ * @struct CpuOsdContent
+ * @brief Everything drawn on one frame.
+ */
+struct CpuOsdContent {
+    QPoint reticle;                         ///< Aim point, frame pixels.
+    QRect  trackedBox;                      ///< DCF target box; empty if not tracking.
+    std::vector<FusionDetection> detections;
+    QStringList statusLines;                ///< Mode/status text, top left.
+};
+
+/**
+ * @class CpuOsd
+ * @brief Draws the crosshair, tracked box, detections and status text, in the
+ *        colours and line widths of the DeepStream OSD.
+ */
+class CpuOsd
+{
+public:
+    void setColor(const QColor &color) { m_color = color; }
+    void render(QImage &frame, const CpuOsdContent &content) const;
+
+private:
+    QColor m_color = QColor::fromRgbF(0.0, 0.72, 0.3);
+    QColor m_shadow = QColor::fromRgbF(0.0, 0.0, 0.0, 0.65);
+};
+
+#endif // CPUOSD_H
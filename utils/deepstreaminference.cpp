@@ -0,0 +1,55 @@
+#include "deepstreaminference.h"
+#include <QDebug>
+
+bool DeepStreamInferenceBackend::isAvailable()
+{
+    GstElementFactory *factory = gst_element_factory_find("nvinfer");
+    if (!factory)
+        return false;
+    gst_object_unref(factory);
+    return true;
+}
+
+GstElement *DeepStreamInferenceBackend::createElement(const char *elementName)
+{
+    m_element = gst_element_factory_make("nvinfer", elementName);
+    m_loaded = false;
+    return m_element;
+}
+
+void DeepStreamInferenceBackend::attachElement(GstElement *element)
+{
+    m_element = element;
+    m_loaded = false;
+}
+
+bool DeepStreamInferenceBackend::load(const InferenceConfig &config)
+{
+    m_config = config;
+    if (!m_element) {
+        qWarning() << "DeepStreamInferenceBackend: no nvinfer element";
+        return false;
+    }
+
+    g_object_set(G_OBJECT(m_element), "config-file-path", config.deepstreamConfigPath.c_str(), NULL);
+    if (config.interval >= 0)
+        g_object_set(G_OBJECT(m_element), "interval", static_cast<guint>(config.interval), NULL);
+
+    m_loaded = true;
+    return true;
+}
+
+void DeepStreamInferenceBackend::collectObjects(const NvDsFrameMeta *frameMeta, std::vector<FusionDetection> &detections)
+{
+    detections.clear();
+    for (NvDsMetaList *l_obj = frameMeta->obj_meta_list; l_obj != NULL; l_obj = l_obj->next) {
+        const NvDsObjectMeta *obj = (NvDsObjectMeta *)(l_obj->data);
+        FusionDetection det;
+        det.box = QRect(static_cast<int>(obj->rect_params.left), static_cast<int>(obj->rect_params.top),
+                        static_cast<int>(obj->rect_params.width), static_cast<int>(obj->rect_params.height));
+        det.trackId = obj->object_id == UNTRACKED_OBJECT_ID ? -1 : static_cast<int>(obj->object_id);
+        det.classId = obj->class_id;
+        det.confidence = obj->confidence;
+        detections.push_back(det);
+    }
+}
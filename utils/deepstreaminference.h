@@ -0,0 +1,54 @@
+#ifndef DEEPSTREAMINFERENCE_H
+#define DEEPSTREAMINFERENCE_H
+
+/**
+ * @file deepstreaminference.h
+ * @brief nvinfer (TensorRT) detector backend for the DeepStream camera pipelines.
+ */
+
+#include "utils/inferencebackend.h"
+#include <gst/gst.h>
+#include "gstnvdsmeta.h"
+
+/**
+ * @class DeepStreamInferenceBackend
+ * @brief Creates and configures the nvinfer element of a pipeline.
+ *
+ * Inference runs inside the graph; the OSD probe turns the NvDsObjectMeta of
+ * each frame into FusionDetection records with collectObjects(). The ROI and
+ * NMS settings of InferenceConfig are left to the nvinfer config file, and the
+ * RoiInferencePlanner window is not applied: nvinfer runs on the full frame.
+ */
+class DeepStreamInferenceBackend : public InferenceBackend
+{
+public:
+    const char *name() const override { return "nvinfer"; }
+
+    /** @brief True when the nvinfer GStreamer element is installed. */
+    static bool isAvailable();
+
+    /**
+     * @brief Creates the nvinfer element, floating, for the caller to add to its bin.
+     * @return nullptr if nvinfer is missing.
+     */
+    GstElement *createElement(const char *elementName);
+    /** @brief Uses an nvinfer element created elsewhere (e.g. by gst_parse_launch). */
+    void attachElement(GstElement *element);
+    GstElement *element() const { return m_element; }
+
+    /** @brief Sets the nvinfer config file, and the interval when config.interval >= 0. */
+    bool load(const InferenceConfig &config) override;
+    bool isLoaded() const override { return m_loaded; }
+    bool runsInPipeline() const override { return true; }
+
+    bool detect(const RgbaImageView *, const QRect *, int, std::vector<FusionDetection> *) override { return false; }
+
+    /** @brief Converts the object metadata of @p frameMeta into @p detections (cleared first). */
+    static void collectObjects(const NvDsFrameMeta *frameMeta, std::vector<FusionDetection> &detections);
+
+private:
+    GstElement *m_element = nullptr;
+    bool m_loaded = false;
+};
+
+#endif // DEEPSTREAMINFERENCE_H
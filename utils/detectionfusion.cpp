@@ -0,0 +1,277 @@
+#include "detectionfusion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Cost of a pair below the IoU gate; never accepted
+constexpr float FORBIDDEN = 1e6f;
+}
+
+float boxIou(const QRect &a, const QRect &b)
+{
+    if (a.isEmpty() || b.isEmpty())
+        return 0.0f;
+    const QRect inter = a.intersected(b);
+    if (inter.isEmpty())
+        return 0.0f;
+    const double i = static_cast<double>(inter.width()) * inter.height();
+    const double u = static_cast<double>(a.width()) * a.height() + static_cast<double>(b.width()) * b.height() - i;
+    return static_cast<float>(i / u);
+}
+
+IouAssociator::IouAssociator(int maxTracks, int maxDetections)
+    : m_maxTracks(maxTracks),
+      m_maxDetections(maxDetections),
+      m_cost(static_cast<size_t>(maxTracks) * maxDetections),
+      m_iou(static_cast<size_t>(maxTracks) * maxDetections)
+{
+    // Square workspace: the Hungarian solver pads the smaller side
+    const int n = std::max(maxTracks, maxDetections) + 1;
+    m_u.resize(n);
+    m_v.resize(n);
+    m_minv.resize(n);
+    m_p.resize(n);
+    m_way.resize(n);
+    m_used.resize(n);
+}
+
+int IouAssociator::associate(const std::vector<QRect> &tracks,
+                             const std::vector<FusionDetection> &detections,
+                             std::vector<FusionMatch> &matches,
+                             const std::vector<int> *preferredIds)
+{
+    matches.clear();
+    const int rows = std::min(static_cast<int>(tracks.size()), m_maxTracks);
+    const int cols = std::min(static_cast<int>(detections.size()), m_maxDetections);
+    if (rows == 0 || cols == 0)
+        return 0;
+
+    for (int r = 0; r < rows; ++r) {
+        const int preferred = preferredIds && r < static_cast<int>(preferredIds->size()) ? (*preferredIds)[r] : -1;
+        float *cost = &m_cost[static_cast<size_t>(r) * m_maxDetections];
+        float *iou = &m_iou[static_cast<size_t>(r) * m_maxDetections];
+        for (int c = 0; c < cols; ++c) {
+            iou[c] = boxIou(tracks[r], detections[c].box);
+            if (iou[c] < m_minIou) {
+                cost[c] = FORBIDDEN;
+                continue;
+            }
+            cost[c] = 1.0f - iou[c];
+            if (preferred >= 0 && detections[c].trackId == preferred)
+                cost[c] -= m_identityBonus;
+        }
+    }
+
+    if (m_method == AssociationMethod::Greedy)
+        solveGreedy(rows, cols, matches);
+    else
+        solveHungarian(rows, cols, matches);
+    return static_cast<int>(matches.size());
+}
+
+void IouAssociator::solveGreedy(int rows, int cols, std::vector<FusionMatch> &matches)
+{
+    // Repeatedly take the cheapest remaining pair; m_used marks rows then columns
+    std::fill(m_used.begin(), m_used.end(), 0);
+    std::vector<char> &rowUsed = m_used;
+    for (int k = 0; k < std::min(rows, cols); ++k) {
+        float best = FORBIDDEN;
+        int bestRow = -1, bestCol = -1;
+        for (int r = 0; r < rows; ++r) {
+            if (rowUsed[r])
+                continue;
+            const float *cost = &m_cost[static_cast<size_t>(r) * m_maxDetections];
+            for (int c = 0; c < cols; ++c) {
+                if (cost[c] < best) {
+                    best = cost[c];
+                    bestRow = r;
+                    bestCol = c;
+                }
+            }
+        }
+        if (bestRow < 0)
+            break;
+
+        matches.push_back({bestRow, bestCol, m_iou[static_cast<size_t>(bestRow) * m_maxDetections + bestCol]});
+        rowUsed[bestRow] = 1;
+        for (int r = 0; r < rows; ++r)
+            m_cost[static_cast<size_t>(r) * m_maxDetections + bestCol] = FORBIDDEN;
+    }
+}
+
+void IouAssociator::solveHungarian(int rows, int cols, std::vector<FusionMatch> &matches)
+{
+    // Kuhn-Munkres with potentials, O(n^2 m) for an n x m matrix with n <= m.
+    // The matrix is padded to square with forbidden cells.
+    const int n = std::max(rows, cols);
+    auto cost = [&](int r, int c) -> double {
+        if (r >= rows || c >= cols)
+            return FORBIDDEN;
+        return m_cost[static_cast<size_t>(r) * m_maxDetections + c];
+    };
+
+    std::fill(m_u.begin(), m_u.begin() + n + 1, 0.0);
+    std::fill(m_v.begin(), m_v.begin() + n + 1, 0.0);
+    std::fill(m_p.begin(), m_p.begin() + n + 1, 0);
+    std::fill(m_way.begin(), m_way.begin() + n + 1, 0);
+
+    for (int i = 1; i <= n; ++i) {
+        m_p[0] = i;
+        int j0 = 0;
+        std::fill(m_minv.begin(), m_minv.begin() + n + 1, std::numeric_limits<double>::infinity());
+        std::fill(m_used.begin(), m_used.begin() + n + 1, 0);
+        do {
+            m_used[j0] = 1;
+            const int i0 = m_p[j0];
+            double delta = std::numeric_limits<double>::infinity();
+            int j1 = 0;
+            for (int j = 1; j <= n; ++j) {
+                if (m_used[j])
+                    continue;
+                const double cur = cost(i0 - 1, j - 1) - m_u[i0] - m_v[j];
+                if (cur < m_minv[j]) {
+                    m_minv[j] = cur;
+                    m_way[j] = j0;
+                }
+                if (m_minv[j] < delta) {
+                    delta = m_minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= n; ++j) {
+                if (m_used[j]) {
+                    m_u[m_p[j]] += delta;
+                    m_v[j] -= delta;
+                } else {
+                    m_minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (m_p[j0] != 0);
+
+        do {
+            const int j1 = m_way[j0];
+            m_p[j0] = m_p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= n; ++j) {
+        const int r = m_p[j] - 1;
+        const int c = j - 1;
+        if (r < rows && c < cols && cost(r, c) < FORBIDDEN)
+            matches.push_back({r, c, m_iou[static_cast<size_t>(r) * m_maxDetections + c]});
+    }
+    std::sort(matches.begin(), matches.end(),
+              [](const FusionMatch &a, const FusionMatch &b) { return a.track < b.track; });
+}
+
+DetectionFusion::DetectionFusion()
+    : m_associator(1, 64),
+      m_tracks(1),
+      m_preferredIds(1, -1)
+{
+    m_matches.reserve(1);
+}
+
+void DetectionFusion::reset()
+{
+    m_preferredIds[0] = -1;
+}
+
+FusionCorrection DetectionFusion::update(const QRect &dcfBox, const std::vector<FusionDetection> &detections)
+{
+    FusionCorrection result;
+    result.box = dcfBox;
+
+    m_tracks[0] = dcfBox;
+    if (m_associator.associate(m_tracks, detections, m_matches, &m_preferredIds) == 0)
+        return result;
+
+    const FusionMatch &match = m_matches.front();
+    const FusionDetection &det = detections[match.detection];
+    m_preferredIds[0] = det.trackId;
+
+    // Blend centre and size separately: the detector fixes scale better than position jitter
+    const double dcfCx = dcfBox.x() + dcfBox.width() / 2.0;
+    const double dcfCy = dcfBox.y() + dcfBox.height() / 2.0;
+    const double detCx = det.box.x() + det.box.width() / 2.0;
+    const double detCy = det.box.y() + det.box.height() / 2.0;
+    const double cx = dcfCx + m_positionGain * (detCx - dcfCx);
+    const double cy = dcfCy + m_positionGain * (detCy - dcfCy);
+    const double w = dcfBox.width() + m_sizeGain * (det.box.width() - dcfBox.width());
+    const double h = dcfBox.height() + m_sizeGain * (det.box.height() - dcfBox.height());
+
+    result.matched = true;
+    result.iou = match.iou;
+    result.trackId = det.trackId;
+    result.box = QRect(static_cast<int>(std::lround(cx - w / 2.0)), static_cast<int>(std::lround(cy - h / 2.0)),
+                       std::max(1, static_cast<int>(std::lround(w))), std::max(1, static_cast<int>(std::lround(h))));
+    result.reseed = boxIou(result.box, dcfBox) < m_reseedIou;
+
+    ++m_fusedFrames;
+    if (result.reseed)
+        ++m_reseeds;
+    return result;
+}
+
+DetectionTracker::DetectionTracker(int maxTracks)
+    : m_associator(maxTracks, 64),
+      m_maxTracks(maxTracks)
+{
+    m_associator.setMinIou(0.2f);
+    m_tracks.reserve(maxTracks);
+    m_boxes.reserve(maxTracks);
+    m_matches.reserve(maxTracks);
+    m_trackMatched.reserve(maxTracks);
+    m_detectionMatched.reserve(64);
+}
+
+void DetectionTracker::reset()
+{
+    m_tracks.clear();
+}
+
+void DetectionTracker::update(std::vector<FusionDetection> &detections)
+{
+    m_boxes.clear();
+    for (const Track &track : m_tracks)
+        m_boxes.push_back(track.box);
+    m_associator.associate(m_boxes, detections, m_matches);
+
+    m_trackMatched.assign(m_tracks.size(), 0);
+    m_detectionMatched.assign(detections.size(), 0);
+    for (const FusionMatch &match : m_matches) {
+        Track &track = m_tracks[match.track];
+        FusionDetection &det = detections[match.detection];
+        track.box = det.box;
+        track.misses = 0;
+        det.trackId = track.id;
+        m_trackMatched[match.track] = 1;
+        m_detectionMatched[match.detection] = 1;
+    }
+
+    // Age out unmatched tracks, keeping the order of the survivors
+    size_t kept = 0;
+    for (size_t i = 0; i < m_tracks.size(); ++i) {
+        if (!m_trackMatched[i] && ++m_tracks[i].misses > m_maxMisses)
+            continue;
+        m_tracks[kept++] = m_tracks[i];
+    }
+    m_tracks.resize(kept);
+
+    for (size_t d = 0; d < detections.size(); ++d) {
+        if (m_detectionMatched[d])
+            continue;
+        if (static_cast<int>(m_tracks.size()) >= m_maxTracks) {
+            detections[d].trackId = -1;
+            continue;
+        }
+        Track track;
+        track.box = detections[d].box;
+        track.id = m_nextId++;
+        m_tracks.push_back(track);
+        detections[d].trackId = track.id;
+    }
+}
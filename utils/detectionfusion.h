@@ -0,0 +1,194 @@
+#ifndef DETECTIONFUSION_H
+#define DETECTIONFUSION_H
+
+/**
+ * @file detectionfusion.h
+ * @brief Association of tracker boxes with detector (nvinfer/nvtracker) objects
+ *        and correction of the DCF box from matched detections.
+ *
+ * The DCF tracker follows appearance only and slowly drifts or keeps the wrong
+ * scale; the detector is drift-free but runs every N frames and jitters. On
+ * frames where inference ran, the DCF box is associated with the detections by
+ * IoU and pulled towards the match; in between, the DCF runs alone.
+ */
+
+#include <QRect>
+#include <vector>
+
+/**
+ * @struct FusionDetection
+ * @brief One detector object in frame coordinates.
+ */
+struct FusionDetection {
+    QRect box;
+    int   trackId = -1;      ///< nvtracker object id, -1 if untracked.
+    int   classId = -1;
+    float confidence = 0.0f;
+};
+
+/**
+ * @struct FusionMatch
+ * @brief A track/detection pair produced by IouAssociator.
+ */
+struct FusionMatch {
+    int   track = -1;     ///< Index into the track boxes.
+    int   detection = -1; ///< Index into the detections.
+    float iou = 0.0f;
+};
+
+enum class AssociationMethod {
+    Greedy,    ///< Best IoU pair first; cheap and exact for one or two tracks.
+    Hungarian  ///< Minimum total cost assignment (Kuhn-Munkres).
+};
+
+/**
+ * @brief Intersection over union of two boxes (0 when either is empty).
+ */
+float boxIou(const QRect &a, const QRect &b);
+
+/**
+ * @class IouAssociator
+ * @brief One-to-one assignment of track boxes to detections on a 1 - IoU cost
+ *        matrix, gated by a minimum IoU.
+ *
+ * The cost matrix and assignment workspace are allocated once for the given
+ * capacity; inputs beyond the capacity are ignored. A detection carrying the
+ * preferred nvtracker id of a track gets a cost bonus, so identity is kept when
+ * two objects overlap.
+ */
+class IouAssociator
+{
+public:
+    explicit IouAssociator(int maxTracks = 8, int maxDetections = 64);
+
+    void setMethod(AssociationMethod method) { m_method = method; }
+    void setMinIou(float iou) { m_minIou = iou; }
+    void setIdentityBonus(float bonus) { m_identityBonus = bonus; }
+
+    /**
+     * @brief Associates @p tracks with @p detections.
+     * @param preferredIds Optional per-track nvtracker id to favour (-1 = none).
+     * @param matches Cleared and filled with the accepted pairs.
+     * @return Number of matches.
+     */
+    int associate(const std::vector<QRect> &tracks,
+                  const std::vector<FusionDetection> &detections,
+                  std::vector<FusionMatch> &matches,
+                  const std::vector<int> *preferredIds = nullptr);
+
+private:
+    void solveGreedy(int rows, int cols, std::vector<FusionMatch> &matches);
+    void solveHungarian(int rows, int cols, std::vector<FusionMatch> &matches);
+
+    int m_maxTracks;
+    int m_maxDetections;
+    AssociationMethod m_method = AssociationMethod::Hungarian;
+    float m_minIou = 0.3f;
+    float m_identityBonus = 0.2f;
+
+    // Row-major [track][detection], stride m_maxDetections
+    std::vector<float> m_cost;
+    std::vector<float> m_iou;
+
+    // Hungarian workspace, 1-based as in the classic formulation
+    std::vector<double> m_u, m_v, m_minv;
+    std::vector<int> m_p, m_way;
+    std::vector<char> m_used;
+};
+
+/**
+ * @struct FusionCorrection
+ * @brief Result of DetectionFusion::update().
+ */
+struct FusionCorrection {
+    bool  matched = false;
+    bool  reseed = false;  ///< Corrected box differs enough to re-initialise the DCF.
+    QRect box;             ///< Corrected box (the DCF box if unmatched).
+    float iou = 0.0f;      ///< IoU of the DCF box with the matched detection.
+    int   trackId = -1;    ///< nvtracker id of the matched detection.
+};
+
+/**
+ * @class DetectionFusion
+ * @brief Corrects the single DCF target box from fresh detections.
+ *
+ * Position and size move towards the matched detection by separate gains; the
+ * DCF is re-seeded only when the correction is larger than its own jitter,
+ * since every re-initialisation restarts its filter.
+ */
+class DetectionFusion
+{
+public:
+    DetectionFusion();
+
+    /**
+     * @brief Fuses @p dcfBox with @p detections from a frame where inference ran.
+     */
+    FusionCorrection update(const QRect &dcfBox, const std::vector<FusionDetection> &detections);
+
+    /** @brief Forgets the associated nvtracker id (new target). */
+    void reset();
+
+    IouAssociator &associator() { return m_associator; }
+    void setPositionGain(float gain) { m_positionGain = gain; }
+    void setSizeGain(float gain) { m_sizeGain = gain; }
+    void setReseedIou(float iou) { m_reseedIou = iou; }
+
+    int fusedFrames() const { return m_fusedFrames; }
+    int reseeds() const { return m_reseeds; }
+
+private:
+    IouAssociator m_associator;
+    std::vector<QRect> m_tracks;
+    std::vector<int> m_preferredIds;
+    std::vector<FusionMatch> m_matches;
+
+    float m_positionGain = 0.6f;
+    float m_sizeGain = 0.4f;
+    float m_reseedIou = 0.85f;
+
+    int m_fusedFrames = 0;
+    int m_reseeds = 0;
+};
+
+/**
+ * @class DetectionTracker
+ * @brief Gives the detections of a frame backend persistent track ids, the role
+ *        nvtracker plays in the DeepStream pipeline.
+ *
+ * Each inference is associated with the boxes of the live tracks; matched
+ * detections inherit the track id, unmatched ones start new tracks, and tracks
+ * unmatched for maxMisses inferences are dropped.
+ */
+class DetectionTracker
+{
+public:
+    explicit DetectionTracker(int maxTracks = 32);
+
+    /** @brief Sets the trackId of every detection in @p detections. */
+    void update(std::vector<FusionDetection> &detections);
+    void reset();
+
+    IouAssociator &associator() { return m_associator; }
+    void setMaxMisses(int inferences) { m_maxMisses = inferences; }
+    int activeTracks() const { return static_cast<int>(m_tracks.size()); }
+
+private:
+    struct Track {
+        QRect box;
+        int id = -1;
+        int misses = 0;
+    };
+
+    IouAssociator m_associator;
+    int m_maxTracks;
+    int m_maxMisses = 5;
+    int m_nextId = 0;
+    std::vector<Track> m_tracks;
+    std::vector<QRect> m_boxes;
+    std::vector<FusionMatch> m_matches;
+    std::vector<char> m_trackMatched;
+    std::vector<char> m_detectionMatched;
+};
+
+#endif // DETECTIONFUSION_H
@@ -0,0 +1,199 @@
+#include "edgedescriptor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// Minimum region side for a meaningful gradient field
+constexpr int MIN_REGION_SIZE = 8;
+
+// SIFT-style clipping limits the influence of a few strong edges
+constexpr float DESCRIPTOR_CLIP = 0.2f;
+
+constexpr float BIN_SCALE = EDGE_DESCRIPTOR_BINS / static_cast<float>(M_PI);
+
+bool normalize(EdgeDescriptor &d)
+{
+    float norm = 0.0f;
+    for (float v : d)
+        norm += v * v;
+    if (norm <= 1e-12f)
+        return false;
+
+    float inv = 1.0f / std::sqrt(norm);
+    norm = 0.0f;
+    for (float &v : d) {
+        v = std::min(v * inv, DESCRIPTOR_CLIP);
+        norm += v * v;
+    }
+    inv = 1.0f / std::sqrt(norm);
+    for (float &v : d)
+        v *= inv;
+    return true;
+}
+}
+
+float edgeDescriptorSimilarity(const EdgeDescriptor &a, const EdgeDescriptor &b)
+{
+    float dot = 0.0f;
+    for (int i = 0; i < EDGE_DESCRIPTOR_SIZE; ++i)
+        dot += a[i] * b[i];
+    return dot;
+}
+
+bool EdgeOrientationMap::build(const GrayImageView &image, const QRect &region)
+{
+    m_region = QRect();
+    if (!image.data || image.width < 3 || image.height < 3)
+        return false;
+
+    const QRect clipped = region.intersected(QRect(1, 1, image.width - 2, image.height - 2));
+    if (clipped.width() < MIN_REGION_SIZE || clipped.height() < MIN_REGION_SIZE)
+        return false;
+
+    const int w = clipped.width();
+    const int h = clipped.height();
+    m_region = clipped;
+    m_stride = (w + 1) * EDGE_DESCRIPTOR_BINS;
+    m_integral.assign(static_cast<size_t>(h + 1) * m_stride, 0.0f);
+
+    std::array<float, EDGE_DESCRIPTOR_BINS> rowSum;
+    for (int y = 0; y < h; ++y) {
+        const uint8_t *row  = image.data + static_cast<size_t>(clipped.y() + y) * image.stride + clipped.x();
+        const uint8_t *up   = row - image.stride;
+        const uint8_t *down = row + image.stride;
+
+        const float *prevIntegral = &m_integral[static_cast<size_t>(y) * m_stride];
+        float *integral = &m_integral[static_cast<size_t>(y + 1) * m_stride];
+        rowSum.fill(0.0f);
+
+        for (int x = 0; x < w; ++x) {
+            const float gx = static_cast<float>(row[x + 1]) - static_cast<float>(row[x - 1]);
+            const float gy = static_cast<float>(down[x]) - static_cast<float>(up[x]);
+            const float magnitude = std::sqrt(gx * gx + gy * gy);
+            if (magnitude > 0.0f) {
+                // Unsigned orientation: polarity flips between bands map to the same bin
+                float angle = std::atan2(gy, gx);
+                if (angle < 0.0f)
+                    angle += static_cast<float>(M_PI);
+                const int bin = std::min(static_cast<int>(angle * BIN_SCALE), EDGE_DESCRIPTOR_BINS - 1);
+                rowSum[bin] += magnitude;
+            }
+
+            float *out = integral + (x + 1) * EDGE_DESCRIPTOR_BINS;
+            const float *above = prevIntegral + (x + 1) * EDGE_DESCRIPTOR_BINS;
+            for (int b = 0; b < EDGE_DESCRIPTOR_BINS; ++b)
+                out[b] = above[b] + rowSum[b];
+        }
+    }
+    return true;
+}
+
+float EdgeOrientationMap::cellSum(int x0, int y0, int x1, int y1, int bin) const
+{
+    const float *r0 = &m_integral[static_cast<size_t>(y0) * m_stride];
+    const float *r1 = &m_integral[static_cast<size_t>(y1) * m_stride];
+    return r1[x1 * EDGE_DESCRIPTOR_BINS + bin] - r1[x0 * EDGE_DESCRIPTOR_BINS + bin]
+         - r0[x1 * EDGE_DESCRIPTOR_BINS + bin] + r0[x0 * EDGE_DESCRIPTOR_BINS + bin];
+}
+
+bool EdgeOrientationMap::describe(const QRect &box, EdgeDescriptor &out) const
+{
+    if (m_region.isEmpty() || !m_region.contains(box) ||
+        box.width() < EDGE_DESCRIPTOR_CELLS || box.height() < EDGE_DESCRIPTOR_CELLS)
+        return false;
+
+    const int bx = box.x() - m_region.x();
+    const int by = box.y() - m_region.y();
+    int i = 0;
+    for (int cy = 0; cy < EDGE_DESCRIPTOR_CELLS; ++cy) {
+        const int y0 = by + cy * box.height() / EDGE_DESCRIPTOR_CELLS;
+        const int y1 = by + (cy + 1) * box.height() / EDGE_DESCRIPTOR_CELLS;
+        for (int cx = 0; cx < EDGE_DESCRIPTOR_CELLS; ++cx) {
+            const int x0 = bx + cx * box.width() / EDGE_DESCRIPTOR_CELLS;
+            const int x1 = bx + (cx + 1) * box.width() / EDGE_DESCRIPTOR_CELLS;
+            for (int b = 0; b < EDGE_DESCRIPTOR_BINS; ++b)
+                out[i++] = cellSum(x0, y0, x1, y1, b);
+        }
+    }
+    return normalize(out);
+}
+
+EdgeSearchResult searchEdgeDescriptor(const GrayImageView &image, const QRect &predicted,
+                                      const EdgeDescriptor &reference, int radius,
+                                      double budgetMs, float minScore)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::microseconds(static_cast<long long>(budgetMs * 1000.0));
+
+    EdgeSearchResult result;
+    if (predicted.isEmpty())
+        return result;
+
+    // The FOV-ratio box scaling is only as good as the calibration
+    static const double SCALES[] = {1.0, 0.9, 1.1};
+    const int margin = radius + static_cast<int>(std::ceil(0.06 * std::max(predicted.width(), predicted.height()))) + 1;
+
+    EdgeOrientationMap map;
+    if (!map.build(image, predicted.adjusted(-margin, -margin, margin, margin))) {
+        result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return result;
+    }
+
+    const QPoint center = predicted.center();
+    const int coarseStep = std::max(2, radius / 12);
+    float bestScore = -1.0f;
+    QRect bestBox;
+    EdgeDescriptor candidate;
+
+    auto evaluate = [&](const QRect &box) {
+        ++result.evaluated;
+        if (!map.describe(box, candidate))
+            return;
+        const float score = edgeDescriptorSimilarity(reference, candidate);
+        if (score > bestScore) {
+            bestScore = score;
+            bestBox = box;
+        }
+    };
+
+    // Coarse grid at each scale, checking the budget once per row
+    for (double scale : SCALES) {
+        const int w = std::max(EDGE_DESCRIPTOR_CELLS, static_cast<int>(std::lround(predicted.width() * scale)));
+        const int h = std::max(EDGE_DESCRIPTOR_CELLS, static_cast<int>(std::lround(predicted.height() * scale)));
+        for (int dy = -radius; dy <= radius && !result.budgetExhausted; dy += coarseStep) {
+            if (Clock::now() > deadline) {
+                result.budgetExhausted = true;
+                break;
+            }
+            for (int dx = -radius; dx <= radius; dx += coarseStep)
+                evaluate(QRect(center.x() + dx - w / 2, center.y() + dy - h / 2, w, h));
+        }
+    }
+
+    // Pixel refinement around the best coarse candidate
+    if (bestScore > -1.0f && !result.budgetExhausted) {
+        const QRect coarseBest = bestBox;
+        const QPoint c = coarseBest.center();
+        for (int dy = -coarseStep + 1; dy < coarseStep && !result.budgetExhausted; ++dy) {
+            if (Clock::now() > deadline) {
+                result.budgetExhausted = true;
+                break;
+            }
+            for (int dx = -coarseStep + 1; dx < coarseStep; ++dx) {
+                if (dx == 0 && dy == 0)
+                    continue;
+                QRect box = coarseBest;
+                box.moveCenter(QPoint(c.x() + dx, c.y() + dy));
+                evaluate(box);
+            }
+        }
+    }
+
+    result.score = std::max(bestScore, 0.0f);
+    result.box = bestBox;
+    result.found = bestScore >= minScore;
+    result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
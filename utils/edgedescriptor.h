@@ -0,0 +1,101 @@
+#ifndef EDGEDESCRIPTOR_H
+#define EDGEDESCRIPTOR_H
+
+/**
+ * @file edgedescriptor.h
+ * @brief Gradient-orientation descriptors and local search for matching a target
+ *        across the day (visible) and night (thermal) cameras.
+ *
+ * Intensities are not comparable between the two modalities and edge polarity
+ * may flip (a target darker than the background in one band can be brighter in
+ * the other), so the descriptor uses unsigned gradient orientation only,
+ * normalised per cell block.
+ */
+
+#include <QRect>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct GrayImageView
+ * @brief Non-owning view of an 8-bit grayscale image.
+ */
+struct GrayImageView {
+    const uint8_t *data = nullptr;
+    int width  = 0;
+    int height = 0;
+    int stride = 0; ///< Bytes per row.
+};
+
+constexpr int EDGE_DESCRIPTOR_CELLS = 4; ///< Cells per side of the box grid.
+constexpr int EDGE_DESCRIPTOR_BINS  = 8; ///< Unsigned orientation bins over 0..180 deg.
+constexpr int EDGE_DESCRIPTOR_SIZE  = EDGE_DESCRIPTOR_CELLS * EDGE_DESCRIPTOR_CELLS * EDGE_DESCRIPTOR_BINS;
+
+using EdgeDescriptor = std::array<float, EDGE_DESCRIPTOR_SIZE>;
+
+/**
+ * @brief Cosine similarity of two normalised descriptors (-1..1, 1 = identical).
+ */
+float edgeDescriptorSimilarity(const EdgeDescriptor &a, const EdgeDescriptor &b);
+
+/**
+ * @class EdgeOrientationMap
+ * @brief Per-bin integral images of gradient magnitude over an image region.
+ *
+ * After build(), the descriptor of any box inside the region costs a fixed
+ * number of lookups independent of the box size, which makes dense local
+ * search affordable within a frame period. Buffers are reused across builds.
+ */
+class EdgeOrientationMap
+{
+public:
+    /**
+     * @brief Computes gradients and integral histograms for @p region of @p image.
+     *        The region is clipped to the image minus a one-pixel border.
+     * @return False if the clipped region is too small.
+     */
+    bool build(const GrayImageView &image, const QRect &region);
+
+    /**
+     * @brief Descriptor of @p box (image coordinates).
+     * @return False if the box is not inside the built region or has no edges.
+     */
+    bool describe(const QRect &box, EdgeDescriptor &out) const;
+
+    const QRect &region() const { return m_region; }
+
+private:
+    // Sum of bin b over [x0,x1) x [y0,y1), region-local coordinates
+    float cellSum(int x0, int y0, int x1, int y1, int bin) const;
+
+    QRect m_region;
+    int m_stride = 0; // integral row length in floats
+    std::vector<float> m_integral;
+};
+
+/**
+ * @struct EdgeSearchResult
+ * @brief Outcome of searchEdgeDescriptor().
+ */
+struct EdgeSearchResult {
+    bool  found = false;
+    QRect box;
+    float score = 0.0f;
+    int   evaluated = 0;     ///< Candidate boxes scored.
+    bool  budgetExhausted = false;
+    double elapsedMs = 0.0;
+};
+
+/**
+ * @brief Searches around @p predicted for the box whose descriptor best matches
+ *        @p reference: a coarse grid over +/- @p radius pixels at three scales,
+ *        then a one-pixel refinement around the best candidate.
+ * @param budgetMs Time budget; the best candidate so far is returned when it runs out.
+ * @param minScore Minimum similarity for a match.
+ */
+EdgeSearchResult searchEdgeDescriptor(const GrayImageView &image, const QRect &predicted,
+                                      const EdgeDescriptor &reference, int radius,
+                                      double budgetMs, float minScore);
+
+#endif // EDGEDESCRIPTOR_H
@@ -0,0 +1,183 @@
+#ifndef GYROBINARYPARSER_H
+#define GYROBINARYPARSER_H
+
+/**
+ * @file gyrobinaryparser.h
+ * @brief Zero-allocation parser for the IMU binary output mode.
+ *
+ * Frame layout (little-endian, 28 bytes):
+ *
+ *   offset  size  field
+ *   0       2     sync 0xAA 0x55
+ *   2       1     payload length (24)
+ *   3       4     roll       int32, 0.001 deg
+ *   7       4     pitch      int32, 0.001 deg
+ *   11      4     yaw        int32, 0.001 deg
+ *   15      4     roll rate  int32, 0.001 deg/s
+ *   19      4     pitch rate int32, 0.001 deg/s
+ *   23      4     yaw rate   int32, 0.001 deg/s
+ *   27      1     checksum   8-bit sum of the payload bytes
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @struct GyroSample
+ * @brief One timestamped IMU sample, as queued for the control loop.
+ */
+struct GyroSample {
+    std::int64_t timestampNs = 0; ///< Monotonic receive time (steady clock).
+    double roll  = 0.0;           ///< deg
+    double pitch = 0.0;           ///< deg
+    double yaw   = 0.0;           ///< deg
+    double rollRate  = 0.0;       ///< deg/s
+    double pitchRate = 0.0;       ///< deg/s
+    double yawRate   = 0.0;       ///< deg/s
+    bool hasRates = false;        ///< False for the text protocol (angles only).
+};
+
+/**
+ * @class GyroBinaryParser
+ * @brief Byte-stream framer/decoder for the binary protocol.
+ *
+ * Bytes can arrive split arbitrarily across reads. On a length error the
+ * parser resynchronises on the next sync word; on a checksum error it rescans
+ * the rejected frame from its second byte, so a sync word inside it is not lost.
+ *
+ * Several frames decoded from one read were sent one sample period apart:
+ * with setSamplePeriodNs() the last one gets the read's timestamp and the
+ * earlier ones are spaced back by the period. Without a period they all share
+ * the read's timestamp (jitter of up to one read's worth of samples).
+ */
+class GyroBinaryParser
+{
+public:
+    static constexpr std::uint8_t SYNC1 = 0xAA;
+    static constexpr std::uint8_t SYNC2 = 0x55;
+    static constexpr std::size_t  PAYLOAD_SIZE = 24;
+    static constexpr std::size_t  FRAME_SIZE = 3 + PAYLOAD_SIZE + 1;
+
+    /**
+     * @brief Consumes @p len bytes and invokes @p onSample for every complete frame.
+     * @param timestampNs Receive time of the chunk (its last byte).
+     * @return Number of samples decoded.
+     */
+    template <typename Callback>
+    int feed(const char *data, std::size_t len, std::int64_t timestampNs, Callback &&onSample)
+    {
+        int decoded = 0;
+        for (std::size_t i = 0; i < len; ++i) {
+            // Whole frames still to come in this chunk, one sample period each
+            const std::int64_t framesAfter = static_cast<std::int64_t>((len - 1 - i) / FRAME_SIZE);
+            decoded += push(static_cast<std::uint8_t>(data[i]),
+                            timestampNs - framesAfter * m_samplePeriodNs, onSample);
+        }
+        return decoded;
+    }
+
+    /** @brief Output period of the IMU, used to space samples of one read (0 = off). */
+    void setSamplePeriodNs(std::int64_t periodNs) { m_samplePeriodNs = periodNs > 0 ? periodNs : 0; }
+    std::int64_t samplePeriodNs() const { return m_samplePeriodNs; }
+
+    /**
+     * @brief Decodes one complete frame starting at the sync word.
+     */
+    static bool decode(const std::uint8_t *frame, std::int64_t timestampNs, GyroSample &sample)
+    {
+        if (frame[0] != SYNC1 || frame[1] != SYNC2 || frame[2] != PAYLOAD_SIZE)
+            return false;
+
+        const std::uint8_t *payload = frame + 3;
+        std::uint8_t sum = 0;
+        for (std::size_t i = 0; i < PAYLOAD_SIZE; ++i)
+            sum = static_cast<std::uint8_t>(sum + payload[i]);
+        if (sum != frame[3 + PAYLOAD_SIZE])
+            return false;
+
+        constexpr double SCALE = 0.001;
+        sample.timestampNs = timestampNs;
+        sample.roll      = readInt32(payload + 0)  * SCALE;
+        sample.pitch     = readInt32(payload + 4)  * SCALE;
+        sample.yaw       = readInt32(payload + 8)  * SCALE;
+        sample.rollRate  = readInt32(payload + 12) * SCALE;
+        sample.pitchRate = readInt32(payload + 16) * SCALE;
+        sample.yawRate   = readInt32(payload + 20) * SCALE;
+        sample.hasRates  = true;
+        return true;
+    }
+
+    void reset() { m_fill = 0; }
+
+    std::uint64_t frameCount() const { return m_frames; }
+    std::uint64_t checksumErrors() const { return m_checksumErrors; }
+    std::uint64_t lengthErrors() const { return m_lengthErrors; }
+    std::uint64_t discardedBytes() const { return m_discardedBytes; }
+
+private:
+    template <typename Callback>
+    int push(std::uint8_t byte, std::int64_t timestampNs, Callback &onSample)
+    {
+        if (m_fill == 0) {
+            if (byte != SYNC1) { ++m_discardedBytes; return 0; }
+        } else if (m_fill == 1) {
+            if (byte != SYNC2) {
+                ++m_discardedBytes;
+                m_fill = (byte == SYNC1) ? 1 : 0;
+                return 0;
+            }
+        } else if (m_fill == 2) {
+            if (byte != PAYLOAD_SIZE) {
+                ++m_lengthErrors;
+                m_fill = (byte == SYNC1) ? 1 : 0;
+                if (m_fill) m_frame[0] = byte;
+                return 0;
+            }
+        }
+
+        m_frame[m_fill++] = byte;
+        if (m_fill < FRAME_SIZE)
+            return 0;
+
+        m_fill = 0;
+        GyroSample sample;
+        if (decode(m_frame.data(), timestampNs, sample)) {
+            ++m_frames;
+            onSample(sample);
+            return 1;
+        }
+        ++m_checksumErrors;
+
+        // The sync word may have been a corrupted frame's payload: rescan from
+        // the second byte. The rest is shorter than a frame, so this cannot
+        // complete (and rescan) another frame by itself.
+        std::array<std::uint8_t, FRAME_SIZE - 1> rest;
+        std::copy(m_frame.begin() + 1, m_frame.end(), rest.begin());
+        int decoded = 0;
+        for (std::uint8_t b : rest)
+            decoded += push(b, timestampNs, onSample);
+        return decoded;
+    }
+
+    static std::int32_t readInt32(const std::uint8_t *p)
+    {
+        const std::uint32_t v = std::uint32_t(p[0])
+                              | (std::uint32_t(p[1]) << 8)
+                              | (std::uint32_t(p[2]) << 16)
+                              | (std::uint32_t(p[3]) << 24);
+        return static_cast<std::int32_t>(v);
+    }
+
+    std::array<std::uint8_t, FRAME_SIZE> m_frame {};
+    std::size_t m_fill = 0;
+    std::int64_t m_samplePeriodNs = 0;
+
+    std::uint64_t m_frames = 0;
+    std::uint64_t m_checksumErrors = 0;
+    std::uint64_t m_lengthErrors = 0;
+    std::uint64_t m_discardedBytes = 0;
+};
+
+#endif // GYROBINARYPARSER_H
@@ -0,0 +1,31 @@
+#include "inferencebackend.h"
+#include "cpuinference.h"
+#include "deepstreaminference.h"
+
+bool InferenceBackend::frameDue()
+{
+    ++m_stats.frames;
+    if (m_skipped < m_config.interval) {
+        ++m_skipped;
+        return false;
+    }
+    m_skipped = 0;
+    return true;
+}
+
+InferenceBackendPtr createInferenceBackend(InferenceBackendType type)
+{
+    switch (type) {
+    case InferenceBackendType::DeepStream:
+        return std::make_unique<DeepStreamInferenceBackend>();
+    case InferenceBackendType::OpenCvDnn:
+        return std::make_unique<OpenCvDnnBackend>();
+    }
+    return nullptr;
+}
+
+InferenceBackendType preferredInferenceBackend()
+{
+    return DeepStreamInferenceBackend::isAvailable() ? InferenceBackendType::DeepStream
+                                                     : InferenceBackendType::OpenCvDnn;
+}
@@ -0,0 +1,117 @@
+#ifndef INFERENCEBACKEND_H
+#define INFERENCEBACKEND_H
+
+/**
+ * @file inferencebackend.h
+ * @brief Object detector abstraction: nvinfer inside the DeepStream graph, or a
+ *        CPU ONNX detector run on the appsink frames.
+ *
+ * Every backend reports FusionDetection records in frame coordinates, the same
+ * object model the OSD, the track list and the detector-tracker fusion read, so
+ * detection works unchanged on a machine without DeepStream.
+ */
+
+#include "utils/detectionfusion.h"
+#include "utils/targetfeatures.h"
+#include <QRect>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class InferenceBackendType {
+    DeepStream, ///< nvinfer element in the camera pipeline (TensorRT on the Jetson).
+    OpenCvDnn   ///< ONNX model on the CPU through OpenCV DNN.
+};
+
+/**
+ * @struct InferenceConfig
+ * @brief Detector settings shared by all backends. Fields a backend cannot
+ *        honour are ignored by it.
+ */
+struct InferenceConfig {
+    std::string modelPath;            ///< ONNX model (CPU backend). Int8 QDQ models run quantised.
+    std::string deepstreamConfigPath = "/home/rapit/DeepStream-Yolo/config_infer_primary_yoloV8.txt";
+    int   inputWidth = 640;           ///< Network input size.
+    int   inputHeight = 640;
+    int   roiInputWidth = 0;          ///< Network input for region inferences (dynamic-shape models); 0 = inputWidth.
+    int   roiInputHeight = 0;
+    int   batchSize = 1;              ///< Frames per forward pass; fixed-batch models need their export batch.
+    float confidenceThreshold = 0.25f;
+    float nmsThreshold = 0.45f;
+    bool  classAgnosticNms = false;
+    int   maxDetections = 64;         ///< Per frame, after NMS.
+    int   interval = -1;              ///< Frames skipped between inferences, as nvinfer's "interval"; -1 = backend default.
+    QRect roi;                        ///< Part of the frame to detect in; empty = whole frame.
+    int   threads = 0;                ///< CPU worker threads, 0 = library default.
+};
+
+/**
+ * @struct InferenceStats
+ * @brief Frame and timing counters of a backend.
+ */
+struct InferenceStats {
+    int    frames = 0;      ///< Frames offered through frameDue().
+    int    inferences = 0;  ///< Frames actually run through the network.
+    double totalMs = 0.0;   ///< Preprocess + forward + postprocess, summed.
+    double lastMs = 0.0;
+
+    double meanMs() const { return inferences > 0 ? totalMs / inferences : 0.0; }
+};
+
+/**
+ * @class InferenceBackend
+ * @brief Interface of a detector stage.
+ *
+ * In-pipeline backends (nvinfer) attach detections to the buffers themselves;
+ * the OSD probe collects them. Frame backends are called with detect() on the
+ * frames the camera device receives, every interval + 1 frames.
+ */
+class InferenceBackend
+{
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual const char *name() const = 0;
+
+    /** @brief Applies @p config and loads the model. */
+    virtual bool load(const InferenceConfig &config) = 0;
+    virtual bool isLoaded() const = 0;
+
+    /** @brief True when detections are produced inside the GStreamer graph. */
+    virtual bool runsInPipeline() const { return false; }
+
+    /**
+     * @brief Detects objects in @p count frames.
+     * @param regions Array of @p count frame regions to run on (region
+     *        inference, at the ROI input size), or nullptr for config().roi.
+     * @param detections Array of @p count vectors, each cleared and filled with
+     *        the detections of the matching frame, in frame coordinates.
+     * @return False if the backend is not loaded or does not run on frames.
+     */
+    virtual bool detect(const RgbaImageView *frames, const QRect *regions, int count,
+                        std::vector<FusionDetection> *detections) = 0;
+
+    /** @brief Counts one frame and returns whether inference is due on it. */
+    bool frameDue();
+
+    const InferenceConfig &config() const { return m_config; }
+    const InferenceStats &stats() const { return m_stats; }
+    void resetStats() { m_stats = InferenceStats(); }
+
+protected:
+    InferenceConfig m_config;
+    InferenceStats m_stats;
+
+private:
+    int m_skipped = 0;
+};
+
+using InferenceBackendPtr = std::unique_ptr<InferenceBackend>;
+
+/** @brief Creates an unloaded backend of @p type. */
+InferenceBackendPtr createInferenceBackend(InferenceBackendType type);
+
+/** @brief DeepStream when the nvinfer element is installed, the CPU backend otherwise. */
+InferenceBackendType preferredInferenceBackend();
+
+#endif // INFERENCEBACKEND_H
@@ -0,0 +1,339 @@
+#include "latencymonitor.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+int highestBit(quint64 v)
+{
+    return 63 - __builtin_clzll(v);
+}
+
+template <typename T>
+void atomicMin(std::atomic<T> &target, T value)
+{
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+template <typename T>
+void atomicMax(std::atomic<T> &target, T value)
+{
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+QString ms(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 1);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------
+
+int LatencyHistogram::bucketIndex(quint64 us)
+{
+    if (us < static_cast<quint64>(SUB_BUCKETS))
+        return static_cast<int>(us);
+    // Shift so the value lands in [HALF_BUCKETS, SUB_BUCKETS)
+    const int shift = highestBit(us) - (SUB_BUCKET_BITS - 1);
+    if (shift > MAX_MAGNITUDE)
+        return BUCKETS - 1;
+    return SUB_BUCKETS + (shift - 1) * HALF_BUCKETS + static_cast<int>((us >> shift) - HALF_BUCKETS);
+}
+
+quint64 LatencyHistogram::bucketUpper(int index)
+{
+    if (index < SUB_BUCKETS)
+        return static_cast<quint64>(index);
+    const int shift = (index - SUB_BUCKETS) / HALF_BUCKETS + 1;
+    const quint64 sub = static_cast<quint64>((index - SUB_BUCKETS) % HALF_BUCKETS + HALF_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 us)
+{
+    if (us < 0)
+        us = 0;
+    m_buckets[bucketIndex(static_cast<quint64>(us))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(static_cast<quint64>(us), std::memory_order_relaxed);
+    atomicMin(m_min, us);
+    atomicMax(m_max, us);
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<qint64>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::min() const
+{
+    return count() ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+double LatencyHistogram::mean() const
+{
+    const quint64 n = count();
+    return n ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    // Bucket totals are read without a snapshot; concurrent records only
+    // shift the result by a sample or two
+    quint64 total = 0;
+    for (const auto &bucket : m_buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    const quint64 rank = std::max<quint64>(1, static_cast<quint64>(std::ceil(percent / 100.0 * total)));
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min<qint64>(static_cast<qint64>(bucketUpper(i)), max());
+    }
+    return max();
+}
+
+// ---------------------------------------------------------------------------
+// LatencyMonitor
+// ---------------------------------------------------------------------------
+
+const char *latencyStageName(LatencyStage stage)
+{
+    switch (stage) {
+    case LatencyStage::CaptureToAppsink:     return "captureToAppsink";
+    case LatencyStage::AppsinkToProcessed:   return "appsinkToProcessed";
+    case LatencyStage::ProcessedToPublished: return "processedToPublished";
+    case LatencyStage::PublishedToPresent:   return "publishedToPresent";
+    case LatencyStage::GlassToGlass:         return "glassToGlass";
+    case LatencyStage::GlassToServo:         return "glassToServo";
+    case LatencyStage::OsdProbe:             return "osdProbe";
+    case LatencyStage::Count:                break;
+    }
+    return "unknown";
+}
+
+LatencyMonitor &LatencyMonitor::instance()
+{
+    static LatencyMonitor monitor;
+    return monitor;
+}
+
+qint64 LatencyMonitor::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int LatencyMonitor::registerSource(const QString &name)
+{
+    QMutexLocker locker(&m_sourceMutex);
+    const int count = m_sourceCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (m_sourceNames[i] == name)
+            return i;
+    }
+    if (count == MAX_SOURCES) {
+        qWarning() << "LatencyMonitor: no room for source" << name;
+        return -1;
+    }
+    m_sourceNames[count] = name;
+    m_sourceCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+QString LatencyMonitor::sourceName(int source) const
+{
+    return source >= 0 && source < sourceCount() ? m_sourceNames[source] : QString();
+}
+
+LatencyMonitor::FrameSlot *LatencyMonitor::slotFor(quint64 frameId)
+{
+    FrameSlot &slot = m_frames[frameId % FRAME_SLOTS];
+    // The slot is reused every FRAME_SLOTS frames; a stale id means the
+    // frame is too old to be matched
+    return slot.id.load(std::memory_order_acquire) == frameId ? &slot : nullptr;
+}
+
+quint64 LatencyMonitor::beginFrame(int source, qint64 captureUs, qint64 appsinkUs)
+{
+    if (source < 0 || source >= MAX_SOURCES)
+        return 0;
+    const quint64 id = m_nextFrameId.fetch_add(1, std::memory_order_relaxed);
+    FrameSlot &slot = m_frames[id % FRAME_SLOTS];
+    slot.id.store(0, std::memory_order_release);
+    slot.source.store(source, std::memory_order_relaxed);
+    slot.captureUs.store(captureUs, std::memory_order_relaxed);
+    slot.appsinkUs.store(appsinkUs, std::memory_order_relaxed);
+    slot.processedUs.store(0, std::memory_order_relaxed);
+    slot.publishedUs.store(0, std::memory_order_relaxed);
+    slot.id.store(id, std::memory_order_release);
+
+    record(source, LatencyStage::CaptureToAppsink, appsinkUs - captureUs);
+    return id;
+}
+
+void LatencyMonitor::markProcessed(quint64 frameId, bool targetUpdated)
+{
+    FrameSlot *slot = slotFor(frameId);
+    if (!slot)
+        return;
+    const qint64 now = nowUs();
+    slot->processedUs.store(now, std::memory_order_relaxed);
+    record(slot->source.load(std::memory_order_relaxed), LatencyStage::AppsinkToProcessed,
+           now - slot->appsinkUs.load(std::memory_order_relaxed));
+    if (targetUpdated)
+        m_latestTracked.store(frameId, std::memory_order_release);
+}
+
+void LatencyMonitor::markPublished(quint64 frameId)
+{
+    FrameSlot *slot = slotFor(frameId);
+    if (!slot)
+        return;
+    const qint64 now = nowUs();
+    slot->publishedUs.store(now, std::memory_order_release);
+    const qint64 processed = slot->processedUs.load(std::memory_order_relaxed);
+    if (processed > 0)
+        record(slot->source.load(std::memory_order_relaxed), LatencyStage::ProcessedToPublished, now - processed);
+}
+
+void LatencyMonitor::markPresented(quint64 frameId)
+{
+    FrameSlot *slot = slotFor(frameId);
+    if (!slot)
+        return;
+    const qint64 now = nowUs();
+    const int source = slot->source.load(std::memory_order_relaxed);
+    const qint64 published = slot->publishedUs.load(std::memory_order_acquire);
+    if (published > 0)
+        record(source, LatencyStage::PublishedToPresent, now - published);
+    record(source, LatencyStage::GlassToGlass, now - slot->captureUs.load(std::memory_order_relaxed));
+}
+
+void LatencyMonitor::markServoCommand()
+{
+    const quint64 frameId = m_latestTracked.load(std::memory_order_acquire);
+    if (!frameId || m_lastServoFrame.exchange(frameId, std::memory_order_relaxed) == frameId)
+        return;
+    FrameSlot *slot = slotFor(frameId);
+    if (!slot)
+        return;
+    record(slot->source.load(std::memory_order_relaxed), LatencyStage::GlassToServo,
+           nowUs() - slot->captureUs.load(std::memory_order_relaxed));
+}
+
+void LatencyMonitor::record(int source, LatencyStage stage, qint64 us)
+{
+    if (source < 0 || source >= MAX_SOURCES)
+        return;
+    m_histograms[source][static_cast<int>(stage)].record(us);
+}
+
+const LatencyHistogram &LatencyMonitor::histogram(int source, LatencyStage stage) const
+{
+    return m_histograms[source][static_cast<int>(stage)];
+}
+
+QStringList LatencyMonitor::summaryLines() const
+{
+    QStringList lines;
+    for (int source = 0; source < sourceCount(); ++source) {
+        lines << sourceName(source);
+        for (int s = 0; s < static_cast<int>(LatencyStage::Count); ++s) {
+            const LatencyHistogram &h = m_histograms[source][s];
+            if (h.count() == 0)
+                continue;
+            lines << QStringLiteral("  %1 p50 %2 p99 %3 max %4 ms")
+                         .arg(QString::fromLatin1(latencyStageName(static_cast<LatencyStage>(s))), -20)
+                         .arg(ms(h.percentile(50.0)), ms(h.percentile(99.0)), ms(h.max()));
+        }
+    }
+    if (lines.isEmpty())
+        lines << QStringLiteral("No frames recorded");
+    return lines;
+}
+
+QByteArray LatencyMonitor::toJson() const
+{
+    QJsonArray sources;
+    for (int source = 0; source < sourceCount(); ++source) {
+        QJsonObject stages;
+        for (int s = 0; s < static_cast<int>(LatencyStage::Count); ++s) {
+            const LatencyHistogram &h = m_histograms[source][s];
+            QJsonArray buckets;
+            for (int i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                const quint64 n = h.bucketCount(i);
+                if (n)
+                    buckets.append(QJsonArray{static_cast<qint64>(LatencyHistogram::bucketUpper(i)),
+                                              static_cast<qint64>(n)});
+            }
+            QJsonObject stage;
+            stage["count"] = static_cast<qint64>(h.count());
+            stage["min"] = h.min();
+            stage["mean"] = h.mean();
+            stage["max"] = h.max();
+            stage["p50"] = h.percentile(50.0);
+            stage["p90"] = h.percentile(90.0);
+            stage["p99"] = h.percentile(99.0);
+            stage["p999"] = h.percentile(99.9);
+            stage["buckets"] = buckets; // [upper edge us, count]
+            stages[QString::fromLatin1(latencyStageName(static_cast<LatencyStage>(s)))] = stage;
+        }
+        QJsonObject entry;
+        entry["name"] = sourceName(source);
+        entry["stages"] = stages;
+        sources.append(entry);
+    }
+
+    QJsonObject root;
+    root["generated"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["unit"] = QStringLiteral("us");
+    root["sources"] = sources;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool LatencyMonitor::writeJson(const QString &path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "LatencyMonitor: cannot write" << path;
+        return false;
+    }
+    file.write(toJson());
+    qDebug() << "LatencyMonitor: latency histograms written to" << path;
+    return true;
+}
+
+void LatencyMonitor::reset()
+{
+    for (auto &stages : m_histograms) {
+        for (LatencyHistogram &h : stages)
+            h.reset();
+    }
+}
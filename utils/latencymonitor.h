@@ -0,0 +1,147 @@
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+/**
+ * @file latencymonitor.h
+ * @brief Per-frame latency stamps from sensor capture to display and to the
+ *        servo command, aggregated in log-linear (HDR-style) histograms.
+ *
+ * A frame is stamped at capture (buffer PTS from v4l2src do-timestamp, mapped
+ * to the monotonic clock), appsink arrival, detector/tracker done, hand-off to
+ * Qt (newFrameAvailable) and paint in VideoDisplayWidget. The id of the frame
+ * travels with the QImage as text metadata (FRAME_ID_KEY). Servo commands of
+ * the tracking loop record the age of the newest tracked frame.
+ *
+ * Recording is lock-free (relaxed atomics), so the streaming threads, the GUI
+ * thread and the control loop stamp without contention.
+ */
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+/**
+ * @class LatencyHistogram
+ * @brief Microsecond histogram with 32 sub-buckets per power of two
+ *        (relative error <= 1/32) from 1 us to ~134 s.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;   // exact values below this
+    static constexpr int HALF_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr int MAX_MAGNITUDE = 22;                   // largest shift
+    static constexpr int BUCKETS = SUB_BUCKETS + MAX_MAGNITUDE * HALF_BUCKETS;
+
+    LatencyHistogram() { reset(); }
+
+    void record(qint64 us);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 min() const;
+    qint64 max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+    /** @brief Value at or below which @p percent (0..100) of the samples lie (bucket upper edge, us). */
+    qint64 percentile(double percent) const;
+    quint64 bucketCount(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+    static int bucketIndex(quint64 us);
+    /** @brief Largest value that falls in bucket @p index. */
+    static quint64 bucketUpper(int index);
+
+private:
+    std::array<std::atomic<quint64>, BUCKETS> m_buckets;
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sum{0};
+    std::atomic<qint64> m_min{0};
+    std::atomic<qint64> m_max{0};
+};
+
+enum class LatencyStage : int {
+    CaptureToAppsink,   ///< Sensor timestamp -> appsink callback.
+    AppsinkToProcessed, ///< Appsink -> detector and tracker done.
+    ProcessedToPublished, ///< Tracker done -> frame and target handed to Qt.
+    PublishedToPresent, ///< Hand-off -> painted by VideoDisplayWidget.
+    GlassToGlass,       ///< Capture -> painted.
+    GlassToServo,       ///< Capture of the newest tracked frame -> servo rate command.
+    OsdProbe,           ///< nvdsosd buffer probe processing time.
+    Count
+};
+
+const char *latencyStageName(LatencyStage stage);
+
+/**
+ * @class LatencyMonitor
+ * @brief Process-wide latency registry; one histogram set per camera.
+ */
+class LatencyMonitor
+{
+public:
+    static constexpr int MAX_SOURCES = 4;
+    static constexpr const char *FRAME_ID_KEY = "el7aress.frame";
+
+    static LatencyMonitor &instance();
+
+    /** @brief Monotonic time in microseconds (the clock of all stamps). */
+    static qint64 nowUs();
+
+    /** @brief Index of the camera named @p name, registered on first use; -1 when full. */
+    int registerSource(const QString &name);
+    int sourceCount() const { return m_sourceCount.load(std::memory_order_acquire); }
+    QString sourceName(int source) const;
+
+    /** @brief Starts a frame record. @return Frame id (never 0). */
+    quint64 beginFrame(int source, qint64 captureUs, qint64 appsinkUs);
+    /** @brief Detector/tracker done; @p targetUpdated when the tracker produced a target. */
+    void markProcessed(quint64 frameId, bool targetUpdated);
+    void markPublished(quint64 frameId);
+    void markPresented(quint64 frameId);
+    /**
+     * @brief A servo rate command derived from the newest tracked frame was
+     *        sent. Recorded once per tracked frame: later commands computed
+     *        from the same frame do not add samples.
+     */
+    void markServoCommand();
+
+    void record(int source, LatencyStage stage, qint64 us);
+    const LatencyHistogram &histogram(int source, LatencyStage stage) const;
+
+    /** @brief One line per camera and stage: p50 / p99 / max in ms. */
+    QStringList summaryLines() const;
+    /** @brief Counts, percentiles and non-empty buckets of every histogram. */
+    QByteArray toJson() const;
+    bool writeJson(const QString &path) const;
+    void reset();
+
+private:
+    LatencyMonitor() = default;
+
+    struct FrameSlot {
+        std::atomic<quint64> id{0};
+        std::atomic<int> source{-1};
+        std::atomic<qint64> captureUs{0};
+        std::atomic<qint64> appsinkUs{0};
+        std::atomic<qint64> processedUs{0};
+        std::atomic<qint64> publishedUs{0};
+    };
+    static constexpr int FRAME_SLOTS = 128;
+
+    FrameSlot *slotFor(quint64 frameId);
+
+    std::array<std::array<LatencyHistogram, static_cast<int>(LatencyStage::Count)>, MAX_SOURCES> m_histograms;
+    std::array<QString, MAX_SOURCES> m_sourceNames; // written under m_sourceMutex
+    QMutex m_sourceMutex;
+    std::atomic<int> m_sourceCount{0};
+    std::array<FrameSlot, FRAME_SLOTS> m_frames;
+    std::atomic<quint64> m_nextFrameId{1};
+    std::atomic<quint64> m_latestTracked{0};
+    std::atomic<quint64> m_lastServoFrame{0};
+};
+
+#endif // LATENCYMONITOR_H
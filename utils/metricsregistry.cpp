@@ -0,0 +1,271 @@
+#include "metricsregistry.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <array>
+
+namespace {
+
+// Cumulative bucket bounds of the exported histograms (seconds)
+constexpr std::array<double, 15> BUCKET_BOUNDS_SEC = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0};
+
+QString escapeLabelValue(QString value)
+{
+    value.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    value.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    value.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+    return value;
+}
+
+QString escapeHelp(QString help)
+{
+    help.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    help.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+    return help;
+}
+
+QString number(double value)
+{
+    return QString::number(value, 'g', 10);
+}
+
+// name{labels[,extra]}
+QString seriesName(const QString &name, const QString &labels, const QString &extra = QString())
+{
+    QString all = labels;
+    if (!extra.isEmpty())
+        all += (all.isEmpty() ? QString() : QStringLiteral(",")) + extra;
+    return all.isEmpty() ? name : QStringLiteral("%1{%2}").arg(name, all);
+}
+
+QString ms(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 2);
+}
+
+} // namespace
+
+void MetricGauge::add(double delta)
+{
+    double current = m_value.load(std::memory_order_relaxed);
+    while (!m_value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+    }
+}
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricCounter *MetricsRegistry::counter(const QString &name, const QString &help, const MetricLabels &labels)
+{
+    Series *s = series(name, help, Type::Counter, labels);
+    if (!s) {
+        static MetricCounter unregistered;
+        return &unregistered;
+    }
+    return s->counter.get();
+}
+
+MetricGauge *MetricsRegistry::gauge(const QString &name, const QString &help, const MetricLabels &labels)
+{
+    Series *s = series(name, help, Type::Gauge, labels);
+    if (!s) {
+        static MetricGauge unregistered;
+        return &unregistered;
+    }
+    return s->gauge.get();
+}
+
+MetricHistogram *MetricsRegistry::histogram(const QString &name, const QString &help, const MetricLabels &labels)
+{
+    Series *s = series(name, help, Type::Histogram, labels);
+    if (!s) {
+        static MetricHistogram unregistered;
+        return &unregistered;
+    }
+    return s->histogram.get();
+}
+
+MetricsRegistry::Series *MetricsRegistry::series(const QString &name, const QString &help, Type type,
+                                                 const MetricLabels &labels)
+{
+    const QString rendered = renderLabels(labels);
+    QMutexLocker locker(&m_mutex);
+
+    Family *family = nullptr;
+    for (const auto &f : m_families) {
+        if (f->name == name) {
+            family = f.get();
+            break;
+        }
+    }
+    if (!family) {
+        m_families.push_back(std::make_unique<Family>());
+        family = m_families.back().get();
+        family->name = name;
+        family->help = help;
+        family->type = type;
+    } else if (family->type != type) {
+        // A metric that is not exported rather than a crash in the caller
+        qWarning() << "MetricsRegistry:" << name << "is already registered as a" << typeName(family->type);
+        return nullptr;
+    }
+
+    for (const auto &s : family->series) {
+        if (s->labels == rendered)
+            return s.get();
+    }
+
+    auto s = std::make_unique<Series>();
+    s->labels = rendered;
+    switch (type) {
+    case Type::Counter:   s->counter = std::make_unique<MetricCounter>(); break;
+    case Type::Gauge:     s->gauge = std::make_unique<MetricGauge>(); break;
+    case Type::Histogram: s->histogram = std::make_unique<MetricHistogram>(); break;
+    }
+    family->series.push_back(std::move(s));
+    return family->series.back().get();
+}
+
+QString MetricsRegistry::renderLabels(const MetricLabels &labels)
+{
+    QStringList parts;
+    for (const auto &label : labels)
+        parts << QStringLiteral("%1=\"%2\"").arg(label.first, escapeLabelValue(label.second));
+    return parts.join(QLatin1Char(','));
+}
+
+const char *MetricsRegistry::typeName(Type type)
+{
+    switch (type) {
+    case Type::Counter:   return "counter";
+    case Type::Gauge:     return "gauge";
+    case Type::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+QByteArray MetricsRegistry::toPrometheus() const
+{
+    QMutexLocker locker(&m_mutex);
+    QString out;
+    for (const auto &family : m_families) {
+        out += QStringLiteral("# HELP %1 %2\n").arg(family->name, escapeHelp(family->help));
+        out += QStringLiteral("# TYPE %1 %2\n").arg(family->name, QLatin1String(typeName(family->type)));
+
+        for (const auto &s : family->series) {
+            switch (family->type) {
+            case Type::Counter:
+                out += QStringLiteral("%1 %2\n").arg(seriesName(family->name, s->labels)).arg(s->counter->value());
+                break;
+            case Type::Gauge:
+                out += QStringLiteral("%1 %2\n").arg(seriesName(family->name, s->labels), number(s->gauge->value()));
+                break;
+            case Type::Histogram: {
+                // Cumulative counts per bound from the HDR buckets; a bucket
+                // counts towards the first bound at or above its upper edge
+                const LatencyHistogram &h = s->histogram->histogram();
+                const QString bucketName = family->name + QLatin1String("_bucket");
+                quint64 cumulative = 0;
+                int index = 0;
+                for (double bound : BUCKET_BOUNDS_SEC) {
+                    const quint64 boundUs = static_cast<quint64>(bound * 1e6);
+                    for (; index < LatencyHistogram::BUCKETS && LatencyHistogram::bucketUpper(index) <= boundUs; ++index)
+                        cumulative += h.bucketCount(index);
+                    out += QStringLiteral("%1 %2\n")
+                               .arg(seriesName(bucketName, s->labels, QStringLiteral("le=\"%1\"").arg(number(bound))))
+                               .arg(cumulative);
+                }
+                for (; index < LatencyHistogram::BUCKETS; ++index)
+                    cumulative += h.bucketCount(index);
+                out += QStringLiteral("%1 %2\n")
+                           .arg(seriesName(bucketName, s->labels, QStringLiteral("le=\"+Inf\"")))
+                           .arg(cumulative);
+                out += QStringLiteral("%1 %2\n")
+                           .arg(seriesName(family->name + QLatin1String("_sum"), s->labels),
+                                number(h.mean() * cumulative / 1e6));
+                out += QStringLiteral("%1 %2\n")
+                           .arg(seriesName(family->name + QLatin1String("_count"), s->labels))
+                           .arg(cumulative);
+                break;
+            }
+            }
+        }
+    }
+    return out.toUtf8();
+}
+
+bool MetricsRegistry::writePrometheus(const QString &path) const
+{
+    // Collectors (node_exporter textfile) may read at any time: never expose
+    // a half-written file
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "MetricsRegistry: cannot write" << path;
+        return false;
+    }
+    file.write(toPrometheus());
+    if (!file.commit()) {
+        qWarning() << "MetricsRegistry: cannot write" << path << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QStringList MetricsRegistry::summaryLines() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList lines;
+    for (const auto &family : m_families) {
+        QString title = family->name;
+        if (title.startsWith(QLatin1String("el7aress_")))
+            title.remove(0, 9);
+        for (const auto &s : family->series) {
+            const QString name = seriesName(title, s->labels);
+            switch (family->type) {
+            case Type::Counter:
+                lines << QStringLiteral("%1 %2").arg(name, -44).arg(s->counter->value());
+                break;
+            case Type::Gauge:
+                lines << QStringLiteral("%1 %2").arg(name, -44).arg(s->gauge->value(), 0, 'f', 1);
+                break;
+            case Type::Histogram: {
+                const LatencyHistogram &h = s->histogram->histogram();
+                if (h.count() == 0)
+                    break;
+                lines << QStringLiteral("%1 p50 %2 p99 %3 max %4 ms")
+                             .arg(name, -44)
+                             .arg(ms(h.percentile(50.0)), ms(h.percentile(99.0)), ms(h.max()));
+                break;
+            }
+            }
+        }
+    }
+    if (lines.isEmpty())
+        lines << QStringLiteral("No metrics registered");
+    return lines;
+}
+
+void MetricsRegistry::resetHistograms()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const auto &family : m_families) {
+        for (const auto &s : family->series) {
+            if (s->histogram)
+                s->histogram->reset();
+        }
+    }
+}
+
+MetricCounter *serialChecksumErrorCounter(const QString &device)
+{
+    return MetricsRegistry::instance().counter(QStringLiteral("el7aress_serial_checksum_errors_total"),
+                                               QStringLiteral("Serial frames dropped on a checksum or CRC mismatch"),
+                                               {{QStringLiteral("device"), device}});
+}
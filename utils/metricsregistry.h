@@ -0,0 +1,161 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+/**
+ * @file metricsregistry.h
+ * @brief Process-wide registry of counters, gauges and histograms, shown on
+ *        the diagnostics page and exported in the Prometheus text format.
+ *
+ * Subsystems look their metrics up once (registration takes a lock) and keep
+ * the returned pointer; updating a metric is a relaxed atomic operation, so
+ * the streaming threads, serial handlers and the control loop record without
+ * contention. Metrics live as long as the process.
+ *
+ *     MetricCounter *timeouts = MetricsRegistry::instance().counter(
+ *         "el7aress_modbus_timeouts_total", "Modbus requests that timed out",
+ *         {{"slave", "servo_az"}});
+ *     timeouts->increment();
+ *
+ * Histograms take microseconds (as LatencyHistogram) and are exported in
+ * seconds, following the Prometheus base-unit convention.
+ */
+
+#include "utils/latencymonitor.h"
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using MetricLabels = QList<QPair<QString, QString>>;
+
+/**
+ * @class MetricCounter
+ * @brief Monotonically increasing count.
+ */
+class MetricCounter
+{
+public:
+    void increment(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+/**
+ * @class MetricGauge
+ * @brief Value that goes up and down (rates, queue depths, states).
+ */
+class MetricGauge
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+/**
+ * @class MetricHistogram
+ * @brief Distribution of durations in microseconds.
+ */
+class MetricHistogram
+{
+public:
+    void record(qint64 us) { m_histogram.record(us); }
+    const LatencyHistogram &histogram() const { return m_histogram; }
+    void reset() { m_histogram.reset(); }
+
+private:
+    LatencyHistogram m_histogram;
+};
+
+/**
+ * @class MetricTimer
+ * @brief Records the lifetime of the scope into a histogram (null = no-op).
+ */
+class MetricTimer
+{
+public:
+    explicit MetricTimer(MetricHistogram *histogram)
+        : m_histogram(histogram), m_startUs(histogram ? LatencyMonitor::nowUs() : 0) {}
+    ~MetricTimer()
+    {
+        if (m_histogram)
+            m_histogram->record(LatencyMonitor::nowUs() - m_startUs);
+    }
+    MetricTimer(const MetricTimer &) = delete;
+    MetricTimer &operator=(const MetricTimer &) = delete;
+
+private:
+    MetricHistogram *m_histogram;
+    qint64 m_startUs;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Owns all metrics; renders them for the UI and for fleet collection.
+ */
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry &instance();
+
+    /**
+     * @brief Returns the series @p name{labels}, creating it on first use.
+     *        Repeated calls with the same name and labels return the same
+     *        object. @p help is taken from the first registration of @p name.
+     */
+    MetricCounter *counter(const QString &name, const QString &help, const MetricLabels &labels = {});
+    MetricGauge *gauge(const QString &name, const QString &help, const MetricLabels &labels = {});
+    MetricHistogram *histogram(const QString &name, const QString &help, const MetricLabels &labels = {});
+
+    /** @brief All metrics in the Prometheus text exposition format (0.0.4). */
+    QByteArray toPrometheus() const;
+    /** @brief Writes toPrometheus() atomically (temporary file + rename). */
+    bool writePrometheus(const QString &path) const;
+
+    /** @brief One line per series for the diagnostics page. */
+    QStringList summaryLines() const;
+
+    /** @brief Clears histograms (counters keep counting, as Prometheus expects). */
+    void resetHistograms();
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        QString labels; // rendered: key="value",...
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    struct Family {
+        QString name;
+        QString help;
+        Type type = Type::Counter;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    Series *series(const QString &name, const QString &help, Type type, const MetricLabels &labels);
+    static QString renderLabels(const MetricLabels &labels);
+    static const char *typeName(Type type);
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Family>> m_families; // registration order
+};
+
+/** @brief Frames of a serial protocol dropped on a bad checksum/CRC, device="<name>". */
+MetricCounter *serialChecksumErrorCounter(const QString &device);
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,196 @@
+#include "modbuslinkmonitor.h"
+#include "metricsregistry.h"
+#include "modbustransport.h"
+#include <QDebug>
+#include <QHash>
+#include <QModbusReply>
+
+namespace {
+
+constexpr int MIN_TIMEOUT_MS = 30;
+constexpr int MAX_TIMEOUT_MS = 500;     // the former fixed value
+constexpr double TIMEOUT_FACTOR = 1.5;  // x p99 RTT
+constexpr int TIMEOUT_MARGIN_MS = 20;
+constexpr quint64 ADAPT_SAMPLES = 64;   // replies per adaptation window
+constexpr int BACKOFF_TIMEOUTS = 3;     // consecutive timeouts that double the timeout
+constexpr int WATCHDOG_MARGIN_MS = 100;
+constexpr qint64 RATE_WINDOW_US = 1000000;
+
+} // namespace
+
+struct ModbusLinkMonitor::State {
+    struct Field {
+        MetricGauge *rate = nullptr;
+        quint64 samples = 0; // successful replies in the current rate window
+        int pending = 0;
+    };
+
+    QString slave;
+    int timeoutMs = MAX_TIMEOUT_MS;
+    int consecutiveTimeouts = 0;
+    LatencyHistogram window; // first-attempt RTTs since the last adaptation
+    MetricGauge *timeoutGauge = nullptr;
+    QHash<QString, Field> fields;
+    qint64 rateWindowStartUs = 0;
+
+    void setTimeout(int ms)
+    {
+        if (ms == timeoutMs)
+            return;
+        qDebug() << "Modbus" << slave << "timeout" << timeoutMs << "->" << ms << "ms";
+        timeoutMs = ms;
+        timeoutGauge->set(ms / 1000.0);
+    }
+
+    void adapt()
+    {
+        const qint64 p99Us = window.percentile(99.0);
+        window.reset();
+        setTimeout(qBound(MIN_TIMEOUT_MS, static_cast<int>(p99Us * TIMEOUT_FACTOR / 1000.0) + TIMEOUT_MARGIN_MS,
+                          MAX_TIMEOUT_MS));
+    }
+
+    void rollRates(qint64 nowUs)
+    {
+        if (rateWindowStartUs == 0) {
+            rateWindowStartUs = nowUs;
+            return;
+        }
+        const qint64 elapsedUs = nowUs - rateWindowStartUs;
+        if (elapsedUs < RATE_WINDOW_US)
+            return;
+        for (auto it = fields.begin(); it != fields.end(); ++it) {
+            it->rate->set(it->samples * 1e6 / elapsedUs);
+            it->samples = 0;
+        }
+        rateWindowStartUs = nowUs;
+    }
+
+    Field &release(const QString &field)
+    {
+        Field &f = fields[field];
+        if (f.pending > 0)
+            --f.pending;
+        return f;
+    }
+
+    void finished(const QModbusReply *reply, qint64 sentUs, const QString &field)
+    {
+        const qint64 nowUs = LatencyMonitor::nowUs();
+        const qint64 rttUs = nowUs - sentUs;
+        Field &f = release(field);
+
+        switch (reply->error()) {
+        case QModbusDevice::NoError:
+            ++f.samples;
+            consecutiveTimeouts = 0;
+            // Replies that needed a retry say nothing about the RTT
+            if (rttUs < timeoutMs * 1000LL) {
+                window.record(rttUs);
+                if (window.count() >= ADAPT_SAMPLES)
+                    adapt();
+            }
+            break;
+        case QModbusDevice::TimeoutError:
+            if (++consecutiveTimeouts >= BACKOFF_TIMEOUTS) {
+                consecutiveTimeouts = 0;
+                window.reset();
+                setTimeout(qMin(timeoutMs * 2, MAX_TIMEOUT_MS));
+            }
+            break;
+        default:
+            break;
+        }
+        rollRates(nowUs);
+    }
+};
+
+ModbusLinkMonitor::ModbusLinkMonitor(const QString &slave)
+    : m_metrics(slave), m_state(std::make_shared<State>())
+{
+    m_state->slave = slave;
+    m_state->timeoutGauge = MetricsRegistry::instance().gauge(
+        QStringLiteral("el7aress_modbus_timeout_seconds"),
+        QStringLiteral("Adaptive Modbus response timeout"), {{QStringLiteral("slave"), slave}});
+    m_state->timeoutGauge->set(m_state->timeoutMs / 1000.0);
+}
+
+int ModbusLinkMonitor::retriesFor(ModbusRequestClass cls)
+{
+    switch (cls) {
+    case ModbusRequestClass::Telemetry:  return 0;
+    case ModbusRequestClass::Command:    return 3;
+    case ModbusRequestClass::Diagnostic: return 1;
+    }
+    return 0;
+}
+
+void ModbusLinkMonitor::prepare(ModbusTransport *client, ModbusRequestClass cls)
+{
+    if (!client)
+        return;
+    if (client->timeout() != m_state->timeoutMs)
+        client->setTimeout(m_state->timeoutMs);
+    client->setNumberOfRetries(retriesFor(cls));
+    m_state->rollRates(LatencyMonitor::nowUs());
+}
+
+void ModbusLinkMonitor::track(ModbusTransport *client, QModbusReply *reply, const QString &field)
+{
+    if (!reply)
+        return;
+    m_metrics.track(client, reply);
+
+    State::Field &f = m_state->fields[field];
+    if (!f.rate) {
+        f.rate = MetricsRegistry::instance().gauge(
+            QStringLiteral("el7aress_modbus_sample_rate_hz"),
+            QStringLiteral("Successful Modbus replies per second per polled field"),
+            {{QStringLiteral("slave"), m_state->slave}, {QStringLiteral("field"), field}});
+    }
+    ++f.pending;
+
+    const qint64 sentUs = LatencyMonitor::nowUs();
+    if (reply->isFinished()) {
+        m_state->finished(reply, sentUs, field);
+        return;
+    }
+    // A reply deleted without finishing must not leave its field pending
+    auto done = std::make_shared<bool>(false);
+    QObject::connect(reply, &QModbusReply::finished, reply, [state = m_state, reply, sentUs, field, done]() {
+        if (!*done) {
+            *done = true;
+            state->finished(reply, sentUs, field);
+        }
+    });
+    QObject::connect(reply, &QObject::destroyed, [state = m_state, field, done]() {
+        if (!*done) {
+            *done = true;
+            state->release(field);
+        }
+    });
+}
+
+bool ModbusLinkMonitor::isPending(const QString &field) const
+{
+    return m_state->fields.value(field).pending > 0;
+}
+
+int ModbusLinkMonitor::pendingCount() const
+{
+    const QHash<QString, State::Field> &fields = m_state->fields;
+    int pending = 0;
+    for (const State::Field &f : fields)
+        pending += f.pending;
+    return pending;
+}
+
+int ModbusLinkMonitor::timeoutMs() const
+{
+    return m_state->timeoutMs;
+}
+
+int ModbusLinkMonitor::watchdogMs(ModbusRequestClass cls) const
+{
+    return m_state->timeoutMs * (retriesFor(cls) + 1) + WATCHDOG_MARGIN_MS;
+}
@@ -0,0 +1,90 @@
+#ifndef MODBUSLINKMONITOR_H
+#define MODBUSLINKMONITOR_H
+
+/**
+ * @file modbuslinkmonitor.h
+ * @brief Link quality of one Modbus slave: RTT statistics, a response timeout
+ *        derived from the measured RTT, retry policies per request class and
+ *        the effective sample rate of every polled field.
+ *
+ * With a fixed 500 ms timeout and 3 retries one lost frame holds a poll for
+ * up to 2 s while newer polls queue behind it. The monitor shortens the
+ * timeout to what the slave actually needs and lets telemetry fail fast:
+ *
+ *     m_link.prepare(m_modbusDevice, ModbusRequestClass::Telemetry);
+ *     auto *reply = m_modbusDevice->sendReadRequest(unit, m_slaveId);
+ *     m_link.track(m_modbusDevice, reply, "status");
+ *     m_timeoutTimer->start(m_link.watchdogMs(ModbusRequestClass::Telemetry));
+ *
+ * Used from the thread of the Modbus client (the GUI thread).
+ */
+
+#include "utils/modbusmetrics.h"
+#include <QString>
+#include <memory>
+
+class ModbusTransport;
+class QModbusReply;
+
+/**
+ * @enum ModbusRequestClass
+ * @brief Decides how often a request is resent before it fails.
+ */
+enum class ModbusRequestClass {
+    Telemetry,  ///< Periodic reads: no retry, the next poll is fresher
+    Command,    ///< Writes that move or configure hardware: full retries
+    Diagnostic  ///< Alarm/history reads on demand: one retry
+};
+
+/**
+ * @class ModbusLinkMonitor
+ * @brief Adapts timeout and retries of a ModbusTransport per request.
+ *
+ * The timeout is 1.5 x p99 of the first-attempt RTT over the last 64 replies
+ * plus 20 ms, within [30, 500] ms; it starts at 500 ms and doubles after
+ * three consecutive timeouts so a slave that became slower is not starved.
+ *
+ * The transports capture the retry count when a request is queued, so
+ * prepare() right before sending gives each request its own policy. The
+ * timeout is a property of the link and applies to all queued requests.
+ * Frames with a bad CRC are dropped by the transports and surface as timeouts.
+ *
+ * Metrics (slave="<name>"): everything of ModbusMetrics plus
+ * el7aress_modbus_timeout_seconds and el7aress_modbus_sample_rate_hz{field}.
+ */
+class ModbusLinkMonitor
+{
+public:
+    explicit ModbusLinkMonitor(const QString &slave);
+
+    /** @brief Applies the timeout and the retry policy of @p cls to @p client. */
+    void prepare(ModbusTransport *client, ModbusRequestClass cls);
+
+    /**
+     * @brief Follows @p reply until it finishes. @p field names the data it
+     *        carries ("status", "alarm", ...) for the sample-rate report.
+     */
+    void track(ModbusTransport *client, QModbusReply *reply, const QString &field);
+
+    /** @brief True while a request for @p field is queued or in flight. */
+    bool isPending(const QString &field) const;
+
+    /** @brief Requests of all fields queued or in flight (0 = the bus is idle). */
+    int pendingCount() const;
+
+    /** @brief Current response timeout (ms). */
+    int timeoutMs() const;
+
+    /** @brief Upper bound for a whole request of @p cls, retries included (ms). */
+    int watchdogMs(ModbusRequestClass cls) const;
+
+    static int retriesFor(ModbusRequestClass cls);
+
+private:
+    struct State;
+
+    ModbusMetrics m_metrics;
+    std::shared_ptr<State> m_state; // shared with the reply handlers
+};
+
+#endif // MODBUSLINKMONITOR_H
@@ -0,0 +1,60 @@
+#include "modbusmetrics.h"
+#include "metricsregistry.h"
+#include "modbustransport.h"
+#include <QModbusReply>
+#include <algorithm>
+
+ModbusMetrics::ModbusMetrics(const QString &slave)
+{
+    MetricsRegistry &registry = MetricsRegistry::instance();
+    const MetricLabels labels = {{QStringLiteral("slave"), slave}};
+    m_rtt = registry.histogram(QStringLiteral("el7aress_modbus_rtt_seconds"),
+                               QStringLiteral("Modbus request to reply time, retries included"), labels);
+    m_requests = registry.counter(QStringLiteral("el7aress_modbus_requests_total"),
+                                  QStringLiteral("Modbus requests sent"), labels);
+    m_timeouts = registry.counter(QStringLiteral("el7aress_modbus_timeouts_total"),
+                                  QStringLiteral("Modbus requests that timed out after all retries"), labels);
+    m_errors = registry.counter(QStringLiteral("el7aress_modbus_errors_total"),
+                                QStringLiteral("Modbus requests that failed other than by timeout"), labels);
+    m_retries = registry.counter(QStringLiteral("el7aress_modbus_retries_total"),
+                                 QStringLiteral("Modbus requests resent after a timeout (inferred)"), labels);
+}
+
+void ModbusMetrics::track(const ModbusTransport *client, QModbusReply *reply)
+{
+    if (!reply)
+        return;
+    m_requests->increment();
+
+    const qint64 sentUs = LatencyMonitor::nowUs();
+    const qint64 timeoutUs = client ? static_cast<qint64>(client->timeout()) * 1000 : 0;
+    const int maxRetries = client ? client->numberOfRetries() : 0;
+
+    // Metrics are owned by the registry, so the lambda does not depend on
+    // the lifetime of this object
+    auto finish = [reply, sentUs, timeoutUs, maxRetries, rtt = m_rtt, timeouts = m_timeouts,
+                   errors = m_errors, retries = m_retries]() {
+        const qint64 rttUs = LatencyMonitor::nowUs() - sentUs;
+        rtt->record(rttUs);
+        switch (reply->error()) {
+        case QModbusDevice::NoError:
+            if (timeoutUs > 0)
+                retries->increment(static_cast<quint64>(std::min<qint64>(maxRetries, rttUs / timeoutUs)));
+            break;
+        case QModbusDevice::TimeoutError:
+            timeouts->increment();
+            retries->increment(static_cast<quint64>(maxRetries));
+            break;
+        default:
+            errors->increment();
+            break;
+        }
+    };
+
+    // Broadcasts finish immediately; everything else reports when done. The
+    // reply is the context object, so the connection dies with it.
+    if (reply->isFinished())
+        finish();
+    else
+        QObject::connect(reply, &QModbusReply::finished, reply, finish);
+}
@@ -0,0 +1,41 @@
+#ifndef MODBUSMETRICS_H
+#define MODBUSMETRICS_H
+
+/**
+ * @file modbusmetrics.h
+ * @brief Per-slave Modbus request metrics: round-trip time, timeouts, errors
+ *        and retries, registered in MetricsRegistry under slave="<name>".
+ */
+
+#include <QString>
+
+class MetricCounter;
+class MetricHistogram;
+class ModbusTransport;
+class QModbusReply;
+
+/**
+ * @class ModbusMetrics
+ * @brief Follows the replies of one slave until they finish.
+ *
+ * QModbusClient retries internally and does not report it, so retries are
+ * inferred from the round-trip time: a reply that took longer than N request
+ * timeouts was resent N times; a timed-out reply used all of them.
+ */
+class ModbusMetrics
+{
+public:
+    explicit ModbusMetrics(const QString &slave);
+
+    /** @brief Counts the request of @p reply and records its outcome when it finishes. */
+    void track(const ModbusTransport *client, QModbusReply *reply);
+
+private:
+    MetricHistogram *m_rtt = nullptr;
+    MetricCounter *m_requests = nullptr;
+    MetricCounter *m_timeouts = nullptr;
+    MetricCounter *m_errors = nullptr;
+    MetricCounter *m_retries = nullptr;
+};
+
+#endif // MODBUSMETRICS_H
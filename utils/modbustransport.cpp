@@ -0,0 +1,491 @@
+#include "modbustransport.h"
+#include <QDebug>
+#include <QModbusRtuSerialClient>
+#include <QModbusTcpClient>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+void appendU16(QByteArray &data, quint16 value)
+{
+    data.append(char(value >> 8));
+    data.append(char(value & 0xFF));
+}
+
+bool isReadFunction(quint8 function)
+{
+    return function >= 0x01 && function <= 0x04;
+}
+
+} // namespace
+
+// --- ModbusEndpoint ---------------------------------------------------------
+
+ModbusEndpoint ModbusEndpoint::parse(const QString &spec, int baudRate, QSerialPort::Parity parity)
+{
+    ModbusEndpoint endpoint;
+    endpoint.baudRate = baudRate;
+    endpoint.parity = parity;
+
+    if (spec.startsWith(QLatin1String("tcp://")) || spec.startsWith(QLatin1String("rtu+tcp://"))) {
+        const QUrl url(spec);
+        endpoint.kind = url.scheme() == QLatin1String("tcp") ? Kind::Tcp : Kind::RtuOverTcp;
+        endpoint.host = url.host();
+        endpoint.port = static_cast<quint16>(url.port(502));
+    } else {
+        endpoint.kind = Kind::RtuSerial;
+        endpoint.portName = spec.startsWith(QLatin1String("rtu:")) ? spec.mid(4) : spec;
+    }
+    return endpoint;
+}
+
+ModbusEndpoint ModbusEndpoint::resolve(const QString &slave, const QString &spec, int baudRate,
+                                       QSerialPort::Parity parity)
+{
+    const QByteArray variable = "EL7ARESS_MODBUS_" + slave.toUpper().toUtf8();
+    const QString override = qEnvironmentVariable(variable.constData());
+    if (override.isEmpty())
+        return parse(spec, baudRate, parity);
+
+    qDebug() << "Modbus" << slave << "endpoint" << override << "from" << variable;
+    return parse(override, baudRate, parity);
+}
+
+QString ModbusEndpoint::toString() const
+{
+    switch (kind) {
+    case Kind::RtuSerial:  return QStringLiteral("rtu:%1@%2").arg(portName).arg(baudRate);
+    case Kind::Tcp:        return QStringLiteral("tcp://%1:%2").arg(host).arg(port);
+    case Kind::RtuOverTcp: return QStringLiteral("rtu+tcp://%1:%2").arg(host).arg(port);
+    }
+    return QString();
+}
+
+// --- ModbusTransport --------------------------------------------------------
+
+ModbusTransport *ModbusTransport::create(const ModbusEndpoint &endpoint, QObject *parent)
+{
+    switch (endpoint.kind) {
+    case ModbusEndpoint::Kind::Tcp: {
+        auto *client = new QModbusTcpClient;
+        client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, endpoint.host);
+        client->setConnectionParameter(QModbusDevice::NetworkPortParameter, endpoint.port);
+        return new QtModbusTransport(client, parent);
+    }
+    case ModbusEndpoint::Kind::RtuOverTcp:
+        return new RtuOverTcpTransport(endpoint.host, endpoint.port, parent);
+    case ModbusEndpoint::Kind::RtuSerial:
+        break;
+    }
+
+    auto *client = new QModbusRtuSerialClient;
+    client->setConnectionParameter(QModbusDevice::SerialPortNameParameter, endpoint.portName);
+    client->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, endpoint.baudRate);
+    client->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QSerialPort::Data8);
+    client->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QSerialPort::OneStop);
+    client->setConnectionParameter(QModbusDevice::SerialParityParameter, endpoint.parity);
+    return new QtModbusTransport(client, parent);
+}
+
+// --- QtModbusTransport ------------------------------------------------------
+
+QtModbusTransport::QtModbusTransport(QModbusClient *client, QObject *parent)
+    : ModbusTransport(parent), m_client(client)
+{
+    m_client->setParent(this);
+    connect(m_client, &QModbusClient::stateChanged, this, &ModbusTransport::stateChanged);
+    connect(m_client, &QModbusClient::errorOccurred, this, &ModbusTransport::errorOccurred);
+}
+
+bool QtModbusTransport::connectDevice()
+{
+    return m_client->connectDevice();
+}
+
+void QtModbusTransport::disconnectDevice()
+{
+    m_client->disconnectDevice();
+}
+
+QModbusDevice::State QtModbusTransport::state() const
+{
+    return m_client->state();
+}
+
+QString QtModbusTransport::errorString() const
+{
+    return m_client->errorString();
+}
+
+QModbusReply *QtModbusTransport::sendReadRequest(const QModbusDataUnit &read, int serverAddress)
+{
+    return m_client->sendReadRequest(read, serverAddress);
+}
+
+QModbusReply *QtModbusTransport::sendWriteRequest(const QModbusDataUnit &write, int serverAddress)
+{
+    return m_client->sendWriteRequest(write, serverAddress);
+}
+
+int QtModbusTransport::timeout() const
+{
+    return m_client->timeout();
+}
+
+void QtModbusTransport::setTimeout(int newTimeout)
+{
+    m_client->setTimeout(newTimeout);
+}
+
+int QtModbusTransport::numberOfRetries() const
+{
+    return m_client->numberOfRetries();
+}
+
+void QtModbusTransport::setNumberOfRetries(int number)
+{
+    m_client->setNumberOfRetries(number);
+}
+
+// --- RtuOverTcpTransport ----------------------------------------------------
+
+RtuOverTcpTransport::RtuOverTcpTransport(const QString &host, quint16 port, QObject *parent)
+    : ModbusTransport(parent),
+    m_host(host),
+    m_port(port),
+    m_socket(new QTcpSocket(this)),
+    m_responseTimer(new QTimer(this))
+{
+    m_responseTimer->setSingleShot(true);
+    connect(m_responseTimer, &QTimer::timeout, this, &RtuOverTcpTransport::onResponseTimeout);
+
+    // Small request/response frames: do not let Nagle hold them back
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(m_socket, &QTcpSocket::readyRead, this, &RtuOverTcpTransport::onReadyRead);
+    connect(m_socket, &QAbstractSocket::stateChanged, this, &RtuOverTcpTransport::onSocketStateChanged);
+    connect(m_socket, &QAbstractSocket::errorOccurred, this, &RtuOverTcpTransport::onSocketError);
+}
+
+quint16 RtuOverTcpTransport::crc16(const QByteArray &data)
+{
+    quint16 crc = 0xFFFF;
+    for (char byte : data) {
+        crc ^= static_cast<quint8>(byte);
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? static_cast<quint16>((crc >> 1) ^ 0xA001) : static_cast<quint16>(crc >> 1);
+    }
+    return crc;
+}
+
+bool RtuOverTcpTransport::connectDevice()
+{
+    if (m_state != QModbusDevice::UnconnectedState)
+        return false;
+    setState(QModbusDevice::ConnectingState);
+    m_socket->connectToHost(m_host, m_port);
+    return true;
+}
+
+void RtuOverTcpTransport::disconnectDevice()
+{
+    if (m_state == QModbusDevice::UnconnectedState)
+        return;
+    setState(QModbusDevice::ClosingState);
+    m_socket->abort();
+    // abort() normally reports UnconnectedState synchronously
+    if (m_state != QModbusDevice::UnconnectedState) {
+        m_responseTimer->stop();
+        failAll(QModbusDevice::ReplyAbortedError, QStringLiteral("Connection closed."));
+        setState(QModbusDevice::UnconnectedState);
+    }
+}
+
+void RtuOverTcpTransport::setTimeout(int newTimeout)
+{
+    if (newTimeout >= 10)
+        m_timeoutMs = newTimeout;
+}
+
+void RtuOverTcpTransport::setNumberOfRetries(int number)
+{
+    if (number >= 0)
+        m_retries = number;
+}
+
+QModbusReply *RtuOverTcpTransport::sendReadRequest(const QModbusDataUnit &read, int serverAddress)
+{
+    quint8 function = 0;
+    switch (read.registerType()) {
+    case QModbusDataUnit::Coils:            function = 0x01; break;
+    case QModbusDataUnit::DiscreteInputs:   function = 0x02; break;
+    case QModbusDataUnit::HoldingRegisters: function = 0x03; break;
+    case QModbusDataUnit::InputRegisters:   function = 0x04; break;
+    default:
+        setError(QModbusDevice::ProtocolError, QStringLiteral("Invalid register type for a read."));
+        return nullptr;
+    }
+
+    QByteArray pdu(1, char(function));
+    appendU16(pdu, static_cast<quint16>(read.startAddress()));
+    appendU16(pdu, static_cast<quint16>(read.valueCount()));
+    return enqueue(serverAddress, pdu, read);
+}
+
+QModbusReply *RtuOverTcpTransport::sendWriteRequest(const QModbusDataUnit &write, int serverAddress)
+{
+    const int count = static_cast<int>(write.valueCount());
+    const quint16 start = static_cast<quint16>(write.startAddress());
+    QByteArray pdu;
+
+    // Single-value writes use the single function codes, as QModbusClient does
+    if (write.registerType() == QModbusDataUnit::Coils) {
+        if (count == 1) {
+            pdu.append(char(0x05));
+            appendU16(pdu, start);
+            appendU16(pdu, write.value(0) ? 0xFF00 : 0x0000);
+        } else {
+            QByteArray bits((count + 7) / 8, '\0');
+            for (int i = 0; i < count; ++i) {
+                if (write.value(i))
+                    bits[i / 8] = char(static_cast<quint8>(bits[i / 8]) | (1 << (i % 8)));
+            }
+            pdu.append(char(0x0F));
+            appendU16(pdu, start);
+            appendU16(pdu, static_cast<quint16>(count));
+            pdu.append(char(bits.size()));
+            pdu += bits;
+        }
+    } else if (write.registerType() == QModbusDataUnit::HoldingRegisters) {
+        if (count == 1) {
+            pdu.append(char(0x06));
+            appendU16(pdu, start);
+            appendU16(pdu, write.value(0));
+        } else {
+            pdu.append(char(0x10));
+            appendU16(pdu, start);
+            appendU16(pdu, static_cast<quint16>(count));
+            pdu.append(char(count * 2));
+            for (int i = 0; i < count; ++i)
+                appendU16(pdu, write.value(i));
+        }
+    } else {
+        setError(QModbusDevice::ProtocolError, QStringLiteral("Invalid register type for a write."));
+        return nullptr;
+    }
+    return enqueue(serverAddress, pdu, write);
+}
+
+QModbusReply *RtuOverTcpTransport::enqueue(int serverAddress, const QByteArray &pdu, const QModbusDataUnit &unit)
+{
+    if (m_state != QModbusDevice::ConnectedState) {
+        setError(QModbusDevice::ConnectionError, QStringLiteral("Device not connected."));
+        return nullptr;
+    }
+
+    QByteArray adu(1, char(serverAddress));
+    adu += pdu;
+    const quint16 crc = crc16(adu);
+    adu.append(char(crc & 0xFF)); // CRC is sent low byte first
+    adu.append(char(crc >> 8));
+
+    if (serverAddress == 0) {
+        // Broadcasts get no response
+        auto *reply = new QModbusReply(QModbusReply::Broadcast, serverAddress, this);
+        m_socket->write(adu);
+        reply->setFinished(true);
+        return reply;
+    }
+
+    auto *reply = new QModbusReply(QModbusReply::Common, serverAddress, this);
+    Request request;
+    request.reply = reply;
+    request.adu = adu;
+    request.unit = unit;
+    request.retriesLeft = m_retries;
+    m_queue.enqueue(request);
+    sendNext();
+    return reply;
+}
+
+void RtuOverTcpTransport::sendNext()
+{
+    if (m_inFlight || m_state != QModbusDevice::ConnectedState)
+        return;
+    // Replies the caller already deleted are not sent
+    while (!m_queue.isEmpty() && m_queue.head().reply.isNull())
+        m_queue.dequeue();
+    if (m_queue.isEmpty())
+        return;
+
+    m_buffer.clear();
+    m_socket->write(m_queue.head().adu);
+    m_inFlight = true;
+    m_responseTimer->start(m_timeoutMs);
+}
+
+void RtuOverTcpTransport::onResponseTimeout()
+{
+    if (!m_inFlight || m_queue.isEmpty())
+        return;
+
+    Request &request = m_queue.head();
+    if (request.retriesLeft > 0) {
+        --request.retriesLeft;
+        m_inFlight = false;
+        sendNext();
+        return;
+    }
+    failCurrent(QModbusDevice::TimeoutError, QStringLiteral("Request timeout."));
+}
+
+void RtuOverTcpTransport::onReadyRead()
+{
+    m_buffer += m_socket->readAll();
+
+    while (m_inFlight && m_buffer.size() >= 2) {
+        // Frame length from the function code (and the byte count of reads)
+        const quint8 function = static_cast<quint8>(m_buffer.at(1));
+        int length = 0;
+        if (function & 0x80) {
+            length = 5;
+        } else if (isReadFunction(function)) {
+            if (m_buffer.size() < 3)
+                return;
+            length = 5 + static_cast<quint8>(m_buffer.at(2));
+        } else if (function == 0x05 || function == 0x06 || function == 0x0F || function == 0x10) {
+            length = 8;
+        } else {
+            m_buffer.clear(); // out of sync; the timeout resends
+            return;
+        }
+        if (m_buffer.size() < length)
+            return;
+
+        const QByteArray frame = m_buffer.left(length);
+        m_buffer.remove(0, length);
+
+        const quint16 crc = static_cast<quint16>(static_cast<quint8>(frame.at(length - 2)) |
+                                                 (static_cast<quint8>(frame.at(length - 1)) << 8));
+        if (crc16(frame.left(length - 2)) != crc) {
+            qWarning() << "RTU over TCP" << m_host << ": discarding response with wrong CRC";
+            m_buffer.clear();
+            return;
+        }
+
+        // A late answer to an attempt that already timed out is not ours
+        const QByteArray &adu = m_queue.head().adu;
+        if (frame.at(0) != adu.at(0) || (function & 0x7F) != static_cast<quint8>(adu.at(1)))
+            continue;
+
+        finishCurrent(frame);
+    }
+
+    if (!m_inFlight)
+        m_buffer.clear();
+}
+
+void RtuOverTcpTransport::finishCurrent(const QByteArray &frame)
+{
+    const Request request = m_queue.dequeue();
+    m_inFlight = false;
+    m_responseTimer->stop();
+
+    if (request.reply) {
+        const quint8 function = static_cast<quint8>(frame.at(1));
+        if (function & 0x80) {
+            request.reply->setError(QModbusDevice::ProtocolError,
+                                    QStringLiteral("Modbus exception 0x%1")
+                                        .arg(static_cast<quint8>(frame.at(2)), 2, 16, QLatin1Char('0')));
+            if (!request.reply->isFinished())
+                request.reply->setFinished(true);
+        } else {
+            QModbusDataUnit result = request.unit;
+            if (isReadFunction(function)) {
+                const int count = static_cast<int>(request.unit.valueCount());
+                const int byteCount = static_cast<quint8>(frame.at(2));
+                const char *data = frame.constData() + 3;
+                QList<quint16> values;
+                values.reserve(count);
+                if (function <= 0x02) {
+                    for (int i = 0; i < count && i / 8 < byteCount; ++i)
+                        values << ((static_cast<quint8>(data[i / 8]) >> (i % 8)) & 1);
+                } else {
+                    for (int i = 0; i < count && 2 * i + 1 < byteCount; ++i)
+                        values << static_cast<quint16>((static_cast<quint8>(data[2 * i]) << 8) |
+                                                       static_cast<quint8>(data[2 * i + 1]));
+                }
+                result.setValues(values);
+            }
+            request.reply->setResult(result);
+            request.reply->setFinished(true);
+        }
+    }
+    sendNext();
+}
+
+void RtuOverTcpTransport::failCurrent(QModbusDevice::Error error, const QString &text)
+{
+    const Request request = m_queue.dequeue();
+    m_inFlight = false;
+    m_responseTimer->stop();
+    if (request.reply) {
+        request.reply->setError(error, text);
+        if (!request.reply->isFinished())
+            request.reply->setFinished(true);
+    }
+    sendNext();
+}
+
+void RtuOverTcpTransport::failAll(QModbusDevice::Error error, const QString &text)
+{
+    QQueue<Request> pending;
+    pending.swap(m_queue);
+    m_inFlight = false;
+    for (const Request &request : pending) {
+        if (request.reply) {
+            request.reply->setError(error, text);
+            if (!request.reply->isFinished())
+                request.reply->setFinished(true);
+        }
+    }
+}
+
+void RtuOverTcpTransport::onSocketStateChanged()
+{
+    switch (m_socket->state()) {
+    case QAbstractSocket::ConnectedState:
+        m_buffer.clear();
+        setState(QModbusDevice::ConnectedState);
+        sendNext();
+        break;
+    case QAbstractSocket::UnconnectedState:
+        m_responseTimer->stop();
+        m_buffer.clear();
+        failAll(QModbusDevice::ReplyAbortedError, QStringLiteral("Connection closed."));
+        setState(QModbusDevice::UnconnectedState);
+        break;
+    default:
+        break;
+    }
+}
+
+void RtuOverTcpTransport::onSocketError()
+{
+    setError(QModbusDevice::ConnectionError, m_socket->errorString());
+}
+
+void RtuOverTcpTransport::setState(QModbusDevice::State state)
+{
+    if (state == m_state)
+        return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+void RtuOverTcpTransport::setError(QModbusDevice::Error error, const QString &text)
+{
+    m_errorString = text;
+    emit errorOccurred(error);
+}
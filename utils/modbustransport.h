@@ -0,0 +1,187 @@
+#ifndef MODBUSTRANSPORT_H
+#define MODBUSTRANSPORT_H
+
+/**
+ * @file modbustransport.h
+ * @brief Transport of the Modbus devices: RTU on a serial line, Modbus TCP,
+ *        or RTU frames carried over TCP (serial gateways, simulators,
+ *        recorded-session servers).
+ *
+ * Endpoints are strings, so the device arguments that named a serial port
+ * keep working:
+ *
+ *     /dev/ttyUSB0, rtu:/dev/ttyUSB0   RTU serial (baud rate and parity of the device)
+ *     tcp://127.0.0.1:5020             Modbus TCP (MBAP header, no CRC)
+ *     rtu+tcp://10.0.0.7:4001          RTU frames with CRC over a TCP stream
+ *
+ * EL7ARESS_MODBUS_<SLAVE> overrides the endpoint of one slave, e.g.
+ * EL7ARESS_MODBUS_SERVO_AZ=tcp://127.0.0.1:5020 to run the azimuth driver
+ * against a local simulator.
+ */
+
+#include <QByteArray>
+#include <QModbusDataUnit>
+#include <QModbusDevice>
+#include <QModbusReply>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QSerialPort>
+#include <QString>
+
+class QModbusClient;
+class QTcpSocket;
+class QTimer;
+
+/**
+ * @struct ModbusEndpoint
+ * @brief Where a Modbus slave is reached and how.
+ */
+struct ModbusEndpoint {
+    enum class Kind { RtuSerial, Tcp, RtuOverTcp };
+
+    Kind kind = Kind::RtuSerial;
+    QString portName;                                   ///< RtuSerial
+    int baudRate = 115200;                              ///< RtuSerial
+    QSerialPort::Parity parity = QSerialPort::NoParity; ///< RtuSerial
+    QString host;                                       ///< Tcp, RtuOverTcp
+    quint16 port = 502;                                 ///< Tcp, RtuOverTcp
+
+    /** @brief Parses @p spec; a plain path is an RTU serial port. */
+    static ModbusEndpoint parse(const QString &spec, int baudRate, QSerialPort::Parity parity);
+    /** @brief As parse(), with the EL7ARESS_MODBUS_<SLAVE> override applied. */
+    static ModbusEndpoint resolve(const QString &slave, const QString &spec, int baudRate,
+                                  QSerialPort::Parity parity);
+    QString toString() const;
+};
+
+/**
+ * @class ModbusTransport
+ * @brief The part of QModbusClient the device drivers use.
+ *
+ * Replies are ordinary QModbusReply objects, so the drivers handle them the
+ * same way whatever the transport.
+ */
+class ModbusTransport : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+    /** @brief Creates the transport for @p endpoint (not yet connected). */
+    static ModbusTransport *create(const ModbusEndpoint &endpoint, QObject *parent = nullptr);
+
+    virtual bool connectDevice() = 0;
+    virtual void disconnectDevice() = 0;
+    virtual QModbusDevice::State state() const = 0;
+    virtual QString errorString() const = 0;
+
+    virtual QModbusReply *sendReadRequest(const QModbusDataUnit &read, int serverAddress) = 0;
+    virtual QModbusReply *sendWriteRequest(const QModbusDataUnit &write, int serverAddress) = 0;
+
+    virtual int timeout() const = 0;
+    virtual void setTimeout(int newTimeout) = 0;
+    virtual int numberOfRetries() const = 0;
+    virtual void setNumberOfRetries(int number) = 0;
+
+signals:
+    void stateChanged(QModbusDevice::State state);
+    void errorOccurred(QModbusDevice::Error error);
+};
+
+/**
+ * @class QtModbusTransport
+ * @brief RTU serial and Modbus TCP through the QtSerialBus clients.
+ */
+class QtModbusTransport : public ModbusTransport
+{
+    Q_OBJECT
+public:
+    /** @brief Takes ownership of @p client. */
+    explicit QtModbusTransport(QModbusClient *client, QObject *parent = nullptr);
+
+    bool connectDevice() override;
+    void disconnectDevice() override;
+    QModbusDevice::State state() const override;
+    QString errorString() const override;
+
+    QModbusReply *sendReadRequest(const QModbusDataUnit &read, int serverAddress) override;
+    QModbusReply *sendWriteRequest(const QModbusDataUnit &write, int serverAddress) override;
+
+    int timeout() const override;
+    void setTimeout(int newTimeout) override;
+    int numberOfRetries() const override;
+    void setNumberOfRetries(int number) override;
+
+private:
+    QModbusClient *m_client;
+};
+
+/**
+ * @class RtuOverTcpTransport
+ * @brief RTU frames (address, PDU, CRC-16) on a TCP stream, one request in
+ *        flight at a time as on the serial line.
+ *
+ * Supports the function codes the drivers use: 0x01-0x04 reads, 0x05/0x06
+ * single writes and 0x0F/0x10 multiple writes. Like the Qt RTU client,
+ * frames with a bad CRC are dropped and the request is resent on timeout.
+ */
+class RtuOverTcpTransport : public ModbusTransport
+{
+    Q_OBJECT
+public:
+    RtuOverTcpTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+
+    bool connectDevice() override;
+    void disconnectDevice() override;
+    QModbusDevice::State state() const override { return m_state; }
+    QString errorString() const override { return m_errorString; }
+
+    QModbusReply *sendReadRequest(const QModbusDataUnit &read, int serverAddress) override;
+    QModbusReply *sendWriteRequest(const QModbusDataUnit &write, int serverAddress) override;
+
+    int timeout() const override { return m_timeoutMs; }
+    void setTimeout(int newTimeout) override;
+    int numberOfRetries() const override { return m_retries; }
+    void setNumberOfRetries(int number) override;
+
+    /** @brief Modbus CRC-16 (polynomial 0xA001, initial 0xFFFF). */
+    static quint16 crc16(const QByteArray &data);
+
+private slots:
+    void onReadyRead();
+    void onResponseTimeout();
+    void onSocketStateChanged();
+    void onSocketError();
+
+private:
+    struct Request {
+        QPointer<QModbusReply> reply;
+        QByteArray adu;         ///< address + PDU + CRC
+        QModbusDataUnit unit;   ///< the request, to shape the result
+        int retriesLeft = 0;
+    };
+
+    QModbusReply *enqueue(int serverAddress, const QByteArray &pdu, const QModbusDataUnit &unit);
+    void sendNext();
+    void finishCurrent(const QByteArray &frame);
+    void failCurrent(QModbusDevice::Error error, const QString &text);
+    void failAll(QModbusDevice::Error error, const QString &text);
+    void setState(QModbusDevice::State state);
+    void setError(QModbusDevice::Error error, const QString &text);
+
+    QString m_host;
+    quint16 m_port;
+    QTcpSocket *m_socket;
+    QTimer *m_responseTimer;
+    QModbusDevice::State m_state = QModbusDevice::UnconnectedState;
+    QString m_errorString;
+    int m_timeoutMs = 1000;
+    int m_retries = 3;
+
+    QQueue<Request> m_queue;
+    bool m_inFlight = false; ///< head of m_queue was sent and awaits its response
+    QByteArray m_buffer;
+};
+
+#endif // MODBUSTRANSPORT_H
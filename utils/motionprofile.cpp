@@ -0,0 +1,127 @@
+#include "motionprofile.h"
+#include <algorithm>
+#include <cmath>
+
+bool SCurveProfile::plan(double distance, double maxVelocity, double maxAcceleration, double maxJerk)
+{
+    m_distance = std::fabs(distance);
+    m_direction = distance < 0.0 ? -1.0 : 1.0;
+    m_timeScale = 1.0;
+    m_Tj = m_Ta = m_Tv = m_T = 0.0;
+    m_alim = m_vlim = 0.0;
+    m_jerk = 0.0;
+
+    if (!(maxVelocity > 0.0) || !(maxAcceleration > 0.0))
+        return false;
+    if (m_distance == 0.0)
+        return true;
+
+    const double v = maxVelocity;
+    const double a = maxAcceleration;
+    const bool jerkLimited = maxJerk > 0.0;
+    const double j = maxJerk;
+
+    // 1) Assume vmax is reached
+    if (!jerkLimited) {
+        m_Tj = 0.0;
+        m_Ta = v / a;
+    } else if (v * j >= a * a) {
+        m_Tj = a / j;
+        m_Ta = m_Tj + v / a;
+    } else {
+        m_Tj = std::sqrt(v / j);
+        m_Ta = 2.0 * m_Tj;
+    }
+    m_Tv = m_distance / v - m_Ta;
+
+    if (m_Tv >= 0.0) {
+        m_vlim = v;
+    } else {
+        // 2) No cruise phase
+        m_Tv = 0.0;
+        const double Tj = jerkLimited ? a / j : 0.0;
+        const double a2j = jerkLimited ? a * a / j : 0.0;
+        const double delta = a2j * a2j + 4.0 * a * m_distance;
+        m_Tj = Tj;
+        m_Ta = (a2j + std::sqrt(delta)) / (2.0 * a);
+
+        if (jerkLimited && m_Ta < 2.0 * m_Tj) {
+            // 3) amax not reached either
+            m_Tj = std::cbrt(m_distance / (2.0 * j));
+            m_Ta = 2.0 * m_Tj;
+        }
+        m_vlim = jerkLimited ? (m_Ta - m_Tj) * j * m_Tj : a * m_Ta;
+    }
+
+    m_alim = jerkLimited ? j * m_Tj : a;
+    m_jerk = jerkLimited ? j : 0.0;
+    m_T = 2.0 * m_Ta + m_Tv;
+    return true;
+}
+
+void SCurveProfile::stretchTo(double duration)
+{
+    if (m_T > 0.0 && duration > m_T)
+        m_timeScale = duration / m_T;
+}
+
+ProfileState SCurveProfile::sampleAcceleration(double t) const
+{
+    // Acceleration phase from rest: jerk up, constant acceleration, jerk down
+    ProfileState s;
+    if (t <= 0.0)
+        return s;
+
+    const double Tj = m_Tj;
+    const double Ta = m_Ta;
+    if (t < Tj) {
+        s.acceleration = m_jerk * t;
+        s.velocity = m_jerk * t * t / 2.0;
+        s.position = m_jerk * t * t * t / 6.0;
+    } else if (t < Ta - Tj) {
+        s.acceleration = m_alim;
+        s.velocity = m_alim * (t - Tj / 2.0);
+        s.position = m_alim / 6.0 * (3.0 * t * t - 3.0 * Tj * t + Tj * Tj);
+    } else {
+        const double tau = std::max(0.0, Ta - t);
+        s.acceleration = m_jerk * tau;
+        s.velocity = m_vlim - m_jerk * tau * tau / 2.0;
+        s.position = m_vlim * Ta / 2.0 - m_vlim * tau + m_jerk * tau * tau * tau / 6.0;
+    }
+    return s;
+}
+
+ProfileState SCurveProfile::sampleUnscaled(double t) const
+{
+    if (t >= m_T) {
+        ProfileState s;
+        s.position = m_distance;
+        return s;
+    }
+    if (t <= m_Ta)
+        return sampleAcceleration(t);
+
+    if (t <= m_Ta + m_Tv) {
+        ProfileState s;
+        s.velocity = m_vlim;
+        s.position = m_vlim * m_Ta / 2.0 + m_vlim * (t - m_Ta);
+        return s;
+    }
+
+    // Deceleration mirrors the acceleration phase
+    ProfileState mirror = sampleAcceleration(m_T - t);
+    ProfileState s;
+    s.position = m_distance - mirror.position;
+    s.velocity = mirror.velocity;
+    s.acceleration = -mirror.acceleration;
+    return s;
+}
+
+ProfileState SCurveProfile::sample(double t) const
+{
+    ProfileState s = sampleUnscaled(t / m_timeScale);
+    s.position *= m_direction;
+    s.velocity *= m_direction / m_timeScale;
+    s.acceleration *= m_direction / (m_timeScale * m_timeScale);
+    return s;
+}
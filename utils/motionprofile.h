@@ -0,0 +1,67 @@
+#ifndef MOTIONPROFILE_H
+#define MOTIONPROFILE_H
+
+/**
+ * @file motionprofile.h
+ * @brief Time-optimal rest-to-rest point-to-point profiles (trapezoidal or S-curve).
+ */
+
+/**
+ * @struct ProfileState
+ * @brief Profile output at a given time. Position runs from 0 to the planned distance.
+ */
+struct ProfileState {
+    double position = 0.0;
+    double velocity = 0.0;
+    double acceleration = 0.0;
+};
+
+/**
+ * @class SCurveProfile
+ * @brief Single-axis rest-to-rest motion profile.
+ *
+ * With a jerk limit the profile is the 7-phase double-S (jerk-limited)
+ * profile; with maxJerk <= 0 it degenerates to the trapezoidal profile.
+ * In both cases the duration is the minimum allowed by the limits. Phases
+ * that cannot be reached (cruise, constant acceleration) are dropped.
+ */
+class SCurveProfile
+{
+public:
+    /**
+     * @brief Plans a move of @p distance (signed).
+     * @return False if the limits are invalid (vmax or amax <= 0).
+     */
+    bool plan(double distance, double maxVelocity, double maxAcceleration, double maxJerk = 0.0);
+
+    /**
+     * @brief Stretches the profile to @p duration (>= duration()) so several
+     *        axes can finish together. Velocity and acceleration scale down.
+     */
+    void stretchTo(double duration);
+
+    ProfileState sample(double t) const;
+
+    double duration() const { return m_timeScale * m_T; }
+    double distance() const { return m_direction * m_distance; }
+    double peakVelocity() const { return m_vlim / m_timeScale; }
+    double peakAcceleration() const { return m_alim / (m_timeScale * m_timeScale); }
+
+private:
+    // Profile for |distance| in unscaled time
+    ProfileState sampleUnscaled(double t) const;
+    ProfileState sampleAcceleration(double t) const;
+
+    double m_distance = 0.0;  ///< |distance|
+    double m_direction = 1.0;
+    double m_jerk = 0.0;
+    double m_Tj = 0.0;        ///< Jerk phase duration
+    double m_Ta = 0.0;        ///< Acceleration (and deceleration) phase duration
+    double m_Tv = 0.0;        ///< Cruise duration
+    double m_T = 0.0;         ///< Total duration
+    double m_alim = 0.0;      ///< Reached acceleration
+    double m_vlim = 0.0;      ///< Reached velocity
+    double m_timeScale = 1.0;
+};
+
+#endif // MOTIONPROFILE_H
@@ -0,0 +1,215 @@
+#ifndef PIDCONTROLLER_H
+#define PIDCONTROLLER_H
+
+/**
+ * @file pidcontroller.h
+ * @brief Header-only, allocation-free PID controller for the gimbal motion modes.
+ *
+ * Provides PID with integrator anti-windup, a first-order filtered derivative,
+ * reference velocity/acceleration feed-forward, output slew limiting and
+ * gain scheduling by camera field of view.
+ */
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @struct PidGains
+ * @brief Controller gains. Feed-forward gains multiply the reference motion.
+ */
+struct PidGains {
+    double Kp = 0.0; ///< Proportional gain.
+    double Ki = 0.0; ///< Integral gain (1/s).
+    double Kd = 0.0; ///< Derivative gain (s).
+    double Kv = 0.0; ///< Reference velocity feed-forward gain.
+    double Ka = 0.0; ///< Reference acceleration feed-forward gain.
+};
+
+/**
+ * @struct PidLimits
+ * @brief Output and internal limits. A value of 0 disables the limit.
+ */
+struct PidLimits {
+    double outputMax     = 0.0; ///< Absolute output limit.
+    double integralMax   = 0.0; ///< Absolute limit of the integral contribution.
+    double slewRate      = 0.0; ///< Maximum output rate of change (units/s).
+    double derivativeTau = 0.0; ///< Derivative low-pass time constant (s).
+};
+
+/**
+ * @class PidController
+ * @brief Single-axis PID + feed-forward controller.
+ *
+ * compute() is O(1), does not allocate and may be called from the control loop.
+ */
+class PidController
+{
+public:
+    PidController() = default;
+    PidController(const PidGains &gains, const PidLimits &limits)
+        : m_gains(gains), m_limits(limits) {}
+
+    void setGains(const PidGains &gains) { m_gains = gains; }
+    const PidGains &gains() const { return m_gains; }
+
+    void setLimits(const PidLimits &limits) { m_limits = limits; }
+    const PidLimits &limits() const { return m_limits; }
+
+    /**
+     * @brief Clears the integrator and derivative history.
+     * @param initialOutput Output the slew limiter starts from (bumpless entry).
+     */
+    void reset(double initialOutput = 0.0)
+    {
+        m_integral = 0.0;
+        m_prevError = 0.0;
+        m_derivative = 0.0;
+        m_output = initialOutput;
+        m_saturated = false;
+        m_first = true;
+    }
+
+    /**
+     * @brief Computes a new controller output.
+     * @param error Reference minus measurement.
+     * @param dt Time since the previous call (s). Non-positive values hold the last output.
+     * @param refVelocity Reference velocity, used by the Kv feed-forward term.
+     * @param refAcceleration Reference acceleration, used by the Ka feed-forward term.
+     * @return The limited controller output.
+     */
+    double compute(double error, double dt,
+                   double refVelocity = 0.0, double refAcceleration = 0.0)
+    {
+        if (!(dt > 0.0) || !std::isfinite(error))
+            return m_output;
+
+        // Filtered derivative on error; skip the first sample to avoid a kick.
+        if (m_first) {
+            m_derivative = 0.0;
+            m_first = false;
+        } else {
+            const double raw = (error - m_prevError) / dt;
+            const double alpha = dt / (m_limits.derivativeTau + dt);
+            m_derivative += alpha * (raw - m_derivative);
+        }
+        m_prevError = error;
+
+        const double feedForward = m_gains.Kv * refVelocity + m_gains.Ka * refAcceleration;
+        const double proportional = m_gains.Kp * error;
+        const double derivative = m_gains.Kd * m_derivative;
+
+        // Tentative integral step, clamped to its own limit.
+        double integral = m_integral + m_gains.Ki * error * dt;
+        if (m_limits.integralMax > 0.0)
+            integral = std::clamp(integral, -m_limits.integralMax, m_limits.integralMax);
+
+        double unsaturated = proportional + integral + derivative + feedForward;
+        double output = unsaturated;
+        if (m_limits.outputMax > 0.0)
+            output = std::clamp(output, -m_limits.outputMax, m_limits.outputMax);
+
+        // Anti-windup by conditional integration: keep the old integral when the
+        // output is saturated and the error would drive it further into saturation.
+        m_saturated = (output != unsaturated);
+        if (!m_saturated || (unsaturated > output) != (error > 0.0))
+            m_integral = integral;
+
+        if (m_limits.slewRate > 0.0) {
+            const double step = m_limits.slewRate * dt;
+            output = std::clamp(output, m_output - step, m_output + step);
+        }
+
+        m_output = output;
+        return m_output;
+    }
+
+    double output() const { return m_output; }
+    double integral() const { return m_integral; }
+    bool saturated() const { return m_saturated; }
+
+private:
+    PidGains  m_gains;
+    PidLimits m_limits;
+
+    double m_integral   = 0.0;
+    double m_prevError  = 0.0;
+    double m_derivative = 0.0;
+    double m_output     = 0.0;
+    bool   m_saturated  = false;
+    bool   m_first      = true;
+};
+
+/**
+ * @class GainSchedule
+ * @brief Fixed-capacity table of gains keyed by horizontal FOV (degrees).
+ *
+ * Gains are linearly interpolated between points and held constant outside
+ * the table range.
+ */
+template <int Capacity>
+class GainSchedule
+{
+public:
+    struct Point {
+        double fovDeg = 0.0;
+        PidGains gains;
+    };
+
+    /**
+     * @brief Inserts a point, keeping the table sorted by FOV.
+     * @return False if the table is full.
+     */
+    bool addPoint(double fovDeg, const PidGains &gains)
+    {
+        if (m_count >= Capacity)
+            return false;
+
+        int i = m_count;
+        while (i > 0 && m_points[i - 1].fovDeg > fovDeg) {
+            m_points[i] = m_points[i - 1];
+            --i;
+        }
+        m_points[i] = {fovDeg, gains};
+        ++m_count;
+        return true;
+    }
+
+    void clear() { m_count = 0; }
+    int size() const { return m_count; }
+
+    /**
+     * @brief Returns gains for the given FOV. An empty table yields zero gains.
+     */
+    PidGains gainsFor(double fovDeg) const
+    {
+        if (m_count == 0)
+            return PidGains();
+        if (fovDeg <= m_points[0].fovDeg)
+            return m_points[0].gains;
+        if (fovDeg >= m_points[m_count - 1].fovDeg)
+            return m_points[m_count - 1].gains;
+
+        int hi = 1;
+        while (m_points[hi].fovDeg < fovDeg)
+            ++hi;
+        const Point &a = m_points[hi - 1];
+        const Point &b = m_points[hi];
+        const double span = b.fovDeg - a.fovDeg;
+        const double t = span > 0.0 ? (fovDeg - a.fovDeg) / span : 0.0;
+
+        PidGains g;
+        g.Kp = a.gains.Kp + t * (b.gains.Kp - a.gains.Kp);
+        g.Ki = a.gains.Ki + t * (b.gains.Ki - a.gains.Ki);
+        g.Kd = a.gains.Kd + t * (b.gains.Kd - a.gains.Kd);
+        g.Kv = a.gains.Kv + t * (b.gains.Kv - a.gains.Kv);
+        g.Ka = a.gains.Ka + t * (b.gains.Ka - a.gains.Ka);
+        return g;
+    }
+
+private:
+    std::array<Point, Capacity> m_points {};
+    int m_count = 0;
+};
+
+#endif // PIDCONTROLLER_H
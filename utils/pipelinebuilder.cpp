@@ -0,0 +1,85 @@
+#include "pipelinebuilder.h"
+#include <QFileInfo>
+#include <gst/gst.h>
+
+const char *pipelineVariantName(PipelineVariant variant)
+{
+    return variant == PipelineVariant::DeepStream ? "DeepStream" : "CPU";
+}
+
+QStringList PipelineCapabilities::deepStreamElements()
+{
+    return {QStringLiteral("nvvideoconvert"), QStringLiteral("nvstreammux"), QStringLiteral("nvinfer"),
+            QStringLiteral("nvtracker"), QStringLiteral("nvdsosd"), QStringLiteral("nvdslogger")};
+}
+
+const PipelineCapabilities &PipelineCapabilities::probe()
+{
+    static const PipelineCapabilities capabilities = [] {
+        PipelineCapabilities result;
+        for (const QString &name : deepStreamElements()) {
+            GstElementFactory *factory = gst_element_factory_find(name.toUtf8().constData());
+            if (factory)
+                gst_object_unref(factory);
+            else
+                result.missing << name;
+        }
+        return result;
+    }();
+    return capabilities;
+}
+
+CameraSourceKind cameraSourceKind(const QString &path)
+{
+    if (path.isEmpty())
+        return CameraSourceKind::TestPattern;
+    const QFileInfo info(path);
+    if (path.startsWith(QLatin1String("/dev/video")))
+        return info.exists() ? CameraSourceKind::V4l2 : CameraSourceKind::TestPattern;
+    return info.isFile() ? CameraSourceKind::File : CameraSourceKind::TestPattern;
+}
+
+QString cpuPipelineDescription(const CpuPipelineSettings &settings)
+{
+    const CameraSourceKind kind = cameraSourceKind(settings.devicePath);
+    const QString rawCaps = QStringLiteral("video/x-raw,format=%1,width=%2,height=%3,framerate=%4/1")
+                                .arg(settings.sourceFormat)
+                                .arg(settings.sourceWidth)
+                                .arg(settings.sourceHeight)
+                                .arg(settings.framerate);
+
+    QString source;
+    switch (kind) {
+    case CameraSourceKind::V4l2:
+        source = QStringLiteral("v4l2src device=%1 do-timestamp=true ! %2").arg(settings.devicePath, rawCaps);
+        break;
+    case CameraSourceKind::File:
+        source = QStringLiteral("filesrc location=\"%1\" ! decodebin").arg(settings.devicePath);
+        break;
+    case CameraSourceKind::TestPattern:
+        source = QStringLiteral("videotestsrc is-live=true pattern=ball ! %1").arg(rawCaps);
+        break;
+    }
+
+    // Crop in the source format before converting, so fewer pixels are converted
+    QString crop;
+    if (kind != CameraSourceKind::File && !settings.crop.isEmpty()) {
+        crop = QStringLiteral(" ! videocrop left=%1 top=%2 right=%3 bottom=%4")
+                   .arg(settings.crop.x())
+                   .arg(settings.crop.y())
+                   .arg(settings.sourceWidth - settings.crop.x() - settings.crop.width())
+                   .arg(settings.sourceHeight - settings.crop.y() - settings.crop.height());
+    }
+
+    // Files play at their own rate; live sources drop late frames instead
+    const QString sync = kind == CameraSourceKind::File ? QStringLiteral("true") : QStringLiteral("false");
+
+    return source + crop +
+           QStringLiteral(" ! videoconvert ! videoscale"
+                          " ! video/x-raw,format=RGBA,width=%1,height=%2"
+                          " ! queue max-size-buffers=1 leaky=downstream"
+                          " ! appsink name=%3 emit-signals=true sync=%4 max-buffers=1 drop=true")
+               .arg(settings.outputWidth)
+               .arg(settings.outputHeight)
+               .arg(settings.appSinkName, sync);
+}
@@ -0,0 +1,81 @@
+#ifndef PIPELINEBUILDER_H
+#define PIPELINEBUILDER_H
+
+/**
+ * @file pipelinebuilder.h
+ * @brief Capability probing for the camera pipelines and the description of
+ *        the plain-GStreamer (CPU) variant used when DeepStream is missing.
+ *
+ * The DeepStream graph needs nvvideoconvert, nvstreammux, nvinfer, nvtracker,
+ * nvdsosd and nvdslogger. Without them the cameras fall back to standard
+ * elements (v4l2src / filesrc / videotestsrc, videocrop, videoconvert,
+ * videoscale, appsink); detection, tracking and the OSD then run on the
+ * appsink frames on the CPU.
+ */
+
+#include <QRect>
+#include <QString>
+#include <QStringList>
+
+enum class PipelineVariant {
+    DeepStream, ///< NVIDIA elements, NVMM buffers.
+    Cpu         ///< Standard GStreamer elements, system memory.
+};
+
+const char *pipelineVariantName(PipelineVariant variant);
+
+/**
+ * @struct PipelineCapabilities
+ * @brief Which of the DeepStream elements are installed.
+ */
+struct PipelineCapabilities {
+    QStringList missing; ///< DeepStream elements that could not be found.
+
+    bool hasDeepStream() const { return missing.isEmpty(); }
+
+    /** @brief Elements the DeepStream camera pipelines are built from. */
+    static QStringList deepStreamElements();
+
+    /**
+     * @brief Looks the DeepStream elements up in the GStreamer registry. The
+     *        result is computed once per process (gst_init must have run).
+     */
+    static const PipelineCapabilities &probe();
+};
+
+enum class CameraSourceKind {
+    V4l2,       ///< Capture device (/dev/video*).
+    File,       ///< Recorded video, decoded with decodebin.
+    TestPattern ///< videotestsrc, when no device or file is available.
+};
+
+/**
+ * @brief Source for @p path: a capture device if it is a /dev/video* node that
+ *        exists, a file if it exists, the test pattern otherwise.
+ */
+CameraSourceKind cameraSourceKind(const QString &path);
+
+/**
+ * @struct CpuPipelineSettings
+ * @brief Geometry of the CPU pipeline. The defaults match the DeepStream
+ *        graph: 1280x720 YUY2 at 30 fps, cropped to 960x720 RGBA.
+ */
+struct CpuPipelineSettings {
+    QString devicePath;
+    int     sourceWidth = 1280;
+    int     sourceHeight = 720;
+    int     framerate = 30;
+    QString sourceFormat = QStringLiteral("YUY2");
+    QRect   crop = QRect(162, 0, 960, 720); ///< Source pixels kept; ignored for files.
+    int     outputWidth = 960;
+    int     outputHeight = 720;
+    QString appSinkName = QStringLiteral("appsink");
+};
+
+/**
+ * @brief gst-launch description of the CPU pipeline, ending in an appsink
+ *        named settings.appSinkName that delivers RGBA frames.
+ */
+QString cpuPipelineDescription(const CpuPipelineSettings &settings);
+
+#endif // PIPELINEBUILDER_H
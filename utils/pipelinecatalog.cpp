@@ -0,0 +1,338 @@
+#include "pipelinecatalog.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QRegularExpression>
+#include <gst/app/gstappsink.h>
+#include <gst/gst.h>
+
+namespace {
+
+QMap<QString, QString> readParameters(const QJsonObject &object)
+{
+    QMap<QString, QString> parameters;
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        // Numbers are accepted as well as strings: "width": 960. Integers are
+        // written in full (no "1e+06"), fractions with all their digits.
+        const QJsonValue value = it.value();
+        if (!value.isDouble()) {
+            parameters.insert(it.key(), value.toString());
+            continue;
+        }
+        const double number = value.toDouble();
+        const qint64 integral = static_cast<qint64>(number);
+        parameters.insert(it.key(), integral == number ? QString::number(integral)
+                                                       : QString::number(number, 'g', QLocale::FloatingPointShortest));
+    }
+    return parameters;
+}
+
+// "crop" (x:y:width:height of the source, nvvideoconvert src-crop syntax) is
+// the only crop setting; the videocrop margins are derived from it
+bool deriveCropMargins(QMap<QString, QString> &parameters, QString *error)
+{
+    const auto crop = parameters.constFind(QStringLiteral("crop"));
+    if (crop == parameters.constEnd())
+        return true;
+
+    const QStringList fields = crop.value().split(QLatin1Char(':'));
+    bool ok = fields.size() == 4;
+    int values[4] = {};
+    for (int i = 0; ok && i < 4; ++i)
+        values[i] = fields[i].toInt(&ok);
+    bool widthOk = false, heightOk = false;
+    const int sourceWidth = parameters.value(QStringLiteral("sourceWidth")).toInt(&widthOk);
+    const int sourceHeight = parameters.value(QStringLiteral("sourceHeight")).toInt(&heightOk);
+    if (!ok || !widthOk || !heightOk) {
+        if (error)
+            *error = QStringLiteral("\"crop\" must be x:y:width:height and needs sourceWidth/sourceHeight");
+        return false;
+    }
+
+    parameters.insert(QStringLiteral("cropLeft"), QString::number(values[0]));
+    parameters.insert(QStringLiteral("cropTop"), QString::number(values[1]));
+    parameters.insert(QStringLiteral("cropRight"), QString::number(sourceWidth - values[0] - values[2]));
+    parameters.insert(QStringLiteral("cropBottom"), QString::number(sourceHeight - values[1] - values[3]));
+    return true;
+}
+
+// Keys of the "inference" section present in @p object, over @p inference
+void readInference(const QJsonObject &object, PipelineInference &inference)
+{
+    InferenceConfig &config = inference.config;
+    if (object.contains(QStringLiteral("model")))
+        config.modelPath = object.value(QStringLiteral("model")).toString().toStdString();
+    config.inputWidth = object.value(QStringLiteral("inputWidth")).toInt(config.inputWidth);
+    config.inputHeight = object.value(QStringLiteral("inputHeight")).toInt(config.inputHeight);
+    config.roiInputWidth = object.value(QStringLiteral("roiInputWidth")).toInt(config.roiInputWidth);
+    config.roiInputHeight = object.value(QStringLiteral("roiInputHeight")).toInt(config.roiInputHeight);
+    config.confidenceThreshold = float(object.value(QStringLiteral("confidence")).toDouble(config.confidenceThreshold));
+    config.nmsThreshold = float(object.value(QStringLiteral("nms")).toDouble(config.nmsThreshold));
+    config.maxDetections = object.value(QStringLiteral("maxDetections")).toInt(config.maxDetections);
+    config.interval = object.value(QStringLiteral("interval")).toInt(config.interval);
+    config.threads = object.value(QStringLiteral("threads")).toInt(config.threads);
+
+    if (object.contains(QStringLiteral("roiWindow"))) {
+        const int window = object.value(QStringLiteral("roiWindow")).toInt();
+        inference.roiWindow = window > 0 ? QSize(window, window) : QSize();
+    }
+    inference.roiFullFrameInterval = object.value(QStringLiteral("roiFullFrameInterval"))
+                                         .toInt(inference.roiFullFrameInterval);
+}
+
+QString joinLaunch(const QJsonValue &value)
+{
+    // A launch line may be split into an array of segments for readability
+    if (!value.isArray())
+        return value.toString();
+    QStringList parts;
+    for (const QJsonValue &part : value.toArray())
+        parts << part.toString().trimmed();
+    return parts.join(QLatin1Char(' '));
+}
+
+} // namespace
+
+bool PipelineCatalog::loadFromFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "PipelineCatalog: cannot open" << path;
+        return false;
+    }
+    QString error;
+    if (!loadFromJson(file.readAll(), &error)) {
+        qWarning() << "PipelineCatalog:" << path << ":" << error;
+        return false;
+    }
+    qDebug() << "PipelineCatalog: loaded" << m_pipelines.size() << "pipelines from" << path;
+    return true;
+}
+
+bool PipelineCatalog::loadFromJson(const QByteArray &json, QString *error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        if (error)
+            *error = parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    const QMap<QString, QString> shared = readParameters(root.value(QStringLiteral("parameters")).toObject());
+
+    std::vector<PipelineDescription> pipelines;
+    const QJsonObject entries = root.value(QStringLiteral("pipelines")).toObject();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        PipelineDescription description;
+        description.name = it.key();
+        description.camera = entry.value(QStringLiteral("camera")).toString();
+        const QString variant = entry.value(QStringLiteral("variant")).toString(QStringLiteral("deepstream"));
+        description.variant = variant.compare(QLatin1String("cpu"), Qt::CaseInsensitive) == 0 ? PipelineVariant::Cpu
+                                                                                               : PipelineVariant::DeepStream;
+        description.launch = joinLaunch(entry.value(QStringLiteral("launch")));
+
+        // Pipeline parameters override the shared ones
+        description.parameters = shared;
+        const QMap<QString, QString> own = readParameters(entry.value(QStringLiteral("parameters")).toObject());
+        for (auto p = own.begin(); p != own.end(); ++p)
+            description.parameters.insert(p.key(), p.value());
+        QString cropError;
+        if (!deriveCropMargins(description.parameters, &cropError)) {
+            if (error)
+                *error = QStringLiteral("pipeline %1: %2").arg(description.name, cropError);
+            return false;
+        }
+
+        const QJsonObject taps = entry.value(QStringLiteral("taps")).toObject();
+        description.taps.appSink = taps.value(QStringLiteral("appsink")).toString(description.taps.appSink);
+        description.taps.osdProbe = taps.value(QStringLiteral("osdProbe")).toString();
+        description.taps.inference = taps.value(QStringLiteral("inference")).toString();
+
+        if (description.camera.isEmpty() || description.launch.isEmpty()) {
+            if (error)
+                *error = QStringLiteral("pipeline %1 needs \"camera\" and \"launch\"").arg(description.name);
+            return false;
+        }
+        pipelines.push_back(std::move(description));
+    }
+
+    QMap<QString, QString> active;
+    const QJsonObject activeObject = root.value(QStringLiteral("active")).toObject();
+    for (auto it = activeObject.begin(); it != activeObject.end(); ++it)
+        active.insert(it.key(), it.value().toString());
+
+    const QJsonObject inferenceObject = root.value(QStringLiteral("inference")).toObject();
+    PipelineInference inference;
+    readInference(inferenceObject, inference);
+    QMap<QString, QJsonObject> cameraInference;
+    const QJsonObject cameras = inferenceObject.value(QStringLiteral("cameras")).toObject();
+    for (auto it = cameras.begin(); it != cameras.end(); ++it)
+        cameraInference.insert(it.key(), it.value().toObject());
+
+    m_pipelines = std::move(pipelines);
+    m_active = active;
+    m_inference = inference;
+    m_cameraInference = cameraInference;
+    return true;
+}
+
+PipelineInference PipelineCatalog::inference(const QString &camera) const
+{
+    PipelineInference inference = m_inference;
+    readInference(m_cameraInference.value(camera), inference);
+    return inference;
+}
+
+QString PipelineCatalog::resolve(const QString &launch, const QMap<QString, QString> &parameters, QStringList *missing)
+{
+    static const QRegularExpression placeholder(QStringLiteral("\\$\\{([A-Za-z0-9_]+)\\}"));
+
+    QString result;
+    result.reserve(launch.size());
+    int last = 0;
+    QRegularExpressionMatchIterator it = placeholder.globalMatch(launch);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        result += launch.mid(last, match.capturedStart() - last);
+        const QString key = match.captured(1);
+        const auto value = parameters.constFind(key);
+        if (value != parameters.constEnd()) {
+            result += value.value();
+        } else {
+            result += match.captured(0);
+            if (missing && !missing->contains(key))
+                *missing << key;
+        }
+        last = match.capturedEnd();
+    }
+    result += launch.mid(last);
+    return result;
+}
+
+bool PipelineCatalog::splitPadTap(const QString &tap, QString &element, QString &pad)
+{
+    const int dot = tap.lastIndexOf(QLatin1Char('.'));
+    if (dot <= 0 || dot == tap.size() - 1)
+        return false;
+    element = tap.left(dot);
+    pad = tap.mid(dot + 1);
+    return true;
+}
+
+QString PipelineCatalog::checkTaps(GstElement *pipeline, const PipelineDescription &description) const
+{
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), description.taps.appSink.toUtf8().constData());
+    if (!sink)
+        return QStringLiteral("no appsink named %1").arg(description.taps.appSink);
+    const bool isAppSink = GST_IS_APP_SINK(sink);
+    gst_object_unref(sink);
+    if (!isAppSink)
+        return QStringLiteral("%1 is not an appsink").arg(description.taps.appSink);
+
+    if (!description.taps.osdProbe.isEmpty()) {
+        QString elementName, padName;
+        if (!splitPadTap(description.taps.osdProbe, elementName, padName))
+            return QStringLiteral("osdProbe must be \"element.pad\", got %1").arg(description.taps.osdProbe);
+        GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), elementName.toUtf8().constData());
+        if (!element)
+            return QStringLiteral("no element named %1 for the OSD probe").arg(elementName);
+        GstPad *pad = gst_element_get_static_pad(element, padName.toUtf8().constData());
+        gst_object_unref(element);
+        if (!pad)
+            return QStringLiteral("%1 has no static pad %2").arg(elementName, padName);
+        gst_object_unref(pad);
+    }
+
+    if (!description.taps.inference.isEmpty()) {
+        GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), description.taps.inference.toUtf8().constData());
+        if (!element)
+            return QStringLiteral("no inference element named %1").arg(description.taps.inference);
+        gst_object_unref(element);
+    }
+    return QString();
+}
+
+int PipelineCatalog::validate(const PipelineCapabilities &capabilities)
+{
+    int valid = 0;
+    for (PipelineDescription &description : m_pipelines) {
+        description.valid = false;
+        description.error.clear();
+
+        QStringList missing;
+        description.resolved = resolve(description.launch, description.parameters, &missing);
+        if (!missing.isEmpty()) {
+            description.error = QStringLiteral("unresolved parameters: %1").arg(missing.join(QStringLiteral(", ")));
+        } else if (description.variant == PipelineVariant::DeepStream && !capabilities.hasDeepStream()) {
+            description.error = QStringLiteral("DeepStream not installed");
+        } else {
+            // Instantiate the graph (NULL state, no device opened) to catch
+            // unknown elements, bad properties and missing taps now
+            GError *error = nullptr;
+            GstElement *pipeline = gst_parse_launch(description.resolved.toUtf8().constData(), &error);
+            if (error) {
+                description.error = QString::fromUtf8(error->message);
+                g_error_free(error);
+            } else if (pipeline) {
+                description.error = checkTaps(pipeline, description);
+            } else {
+                description.error = QStringLiteral("gst_parse_launch returned no pipeline");
+            }
+            if (pipeline)
+                gst_object_unref(pipeline);
+        }
+
+        description.valid = description.error.isEmpty();
+        if (description.valid) {
+            ++valid;
+            qDebug() << "PipelineCatalog:" << description.name << "valid";
+        } else {
+            qWarning() << "PipelineCatalog:" << description.name << "unusable:" << description.error;
+        }
+    }
+    return valid;
+}
+
+const PipelineDescription *PipelineCatalog::find(const QString &name) const
+{
+    for (const PipelineDescription &description : m_pipelines) {
+        if (description.name == name)
+            return &description;
+    }
+    return nullptr;
+}
+
+const PipelineDescription *PipelineCatalog::select(const QString &camera) const
+{
+    // Environment override for A/B runs, e.g. EL7ARESS_PIPELINE_DAY=day-cpu
+    const QByteArray variable = "EL7ARESS_PIPELINE_" + camera.toUpper().toUtf8();
+    QString name = qEnvironmentVariable(variable.constData());
+    if (name.isEmpty())
+        name = m_active.value(camera);
+
+    if (!name.isEmpty()) {
+        const PipelineDescription *chosen = find(name);
+        if (chosen && chosen->valid && chosen->camera == camera)
+            return chosen;
+        qWarning() << "PipelineCatalog: pipeline" << name << "not usable for" << camera
+                   << (chosen ? chosen->error : QStringLiteral("(not defined)"));
+    }
+
+    // Otherwise the first valid pipeline of the camera, DeepStream first
+    const PipelineDescription *fallback = nullptr;
+    for (const PipelineDescription &description : m_pipelines) {
+        if (description.camera != camera || !description.valid)
+            continue;
+        if (description.variant == PipelineVariant::DeepStream)
+            return &description;
+        if (!fallback)
+            fallback = &description;
+    }
+    return fallback;
+}
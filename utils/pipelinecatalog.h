@@ -0,0 +1,154 @@
+#ifndef PIPELINECATALOG_H
+#define PIPELINECATALOG_H
+
+/**
+ * @file pipelinecatalog.h
+ * @brief Camera pipelines described in a JSON file as gst-launch strings, with
+ *        named taps for the appsink, the OSD probe and the inference element.
+ *
+ * Resolution, crop, inference interval, sink and the element chain itself can
+ * be changed in config/pipelines.json without a rebuild, and several variants
+ * of one camera can be kept side by side and selected per run for A/B tests.
+ * Descriptions are validated once at startup (parameters resolved, the graph
+ * instantiated, taps found) and the resolved strings are cached.
+ *
+ * File layout:
+ * @code
+ * {
+ *   "parameters": { "width": "960", ... },        // shared defaults
+ *   "active": { "day": "day-deepstream", ... },   // selected variant per camera
+ *   "pipelines": {
+ *     "day-deepstream": {
+ *       "camera": "day",
+ *       "variant": "deepstream",                  // or "cpu"
+ *       "parameters": { "device": "/dev/video0" },
+ *       "launch": "v4l2src device=${device} ! ... ! appsink name=appsink",
+ *       "taps": { "appsink": "appsink", "osdProbe": "osd.sink", "inference": "pgie" }
+ *     }
+ *   }
+ * }
+ * @endcode
+ * "crop" ("x:y:width:height" of the source) is the only crop parameter; the
+ * videocrop margins ${cropLeft}, ${cropRight}, ${cropTop} and ${cropBottom}
+ * are derived from it and sourceWidth/sourceHeight.
+ *
+ * The optional "inference" section configures the frame detector of the CPU
+ * pipelines (nvinfer keeps its own config file):
+ * @code
+ * "inference": {
+ *   "model": "models/yolov8n.onnx",   // relative to the application directory
+ *   "inputWidth": 640, "inputHeight": 640,
+ *   "confidence": 0.25, "nms": 0.45, "maxDetections": 64,
+ *   "roiInputWidth": 0, "roiInputHeight": 0,  // dynamic-shape models only
+ *   "interval": 0, "threads": 0,
+ *   "roiWindow": 320,                 // RoiInferencePlanner window (px)
+ *   "roiFullFrameInterval": 10,
+ *   "cameras": { "night": { "model": "models/yolov8n-ir.onnx" } }
+ * }
+ * @endcode
+ * The environment variable EL7ARESS_PIPELINE_<CAMERA> (e.g.
+ * EL7ARESS_PIPELINE_DAY=day-deepstream-fast) overrides "active".
+ */
+
+#include "utils/pipelinebuilder.h"
+#include "utils/inferencebackend.h"
+#include <QJsonObject>
+#include <QMap>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+typedef struct _GstElement GstElement;
+
+/**
+ * @struct PipelineTaps
+ * @brief Names of the elements/pads the application attaches to.
+ */
+struct PipelineTaps {
+    QString appSink = QStringLiteral("appsink"); ///< appsink element delivering RGBA frames.
+    QString osdProbe;                            ///< "element.pad" for the OSD buffer probe; empty = none.
+    QString inference;                           ///< nvinfer element, for interval control; empty = none.
+};
+
+/**
+ * @struct PipelineDescription
+ * @brief One named pipeline of the catalog.
+ */
+struct PipelineDescription {
+    QString name;
+    QString camera;                   ///< "day" or "night".
+    PipelineVariant variant = PipelineVariant::DeepStream;
+    QString launch;                   ///< gst-launch syntax with ${parameter} placeholders.
+    QMap<QString, QString> parameters;
+    PipelineTaps taps;
+
+    QString resolved;                 ///< launch with the parameters substituted (after validation).
+    bool valid = false;
+    QString error;                    ///< Why validation failed or was skipped.
+};
+
+/**
+ * @struct PipelineInference
+ * @brief Frame detector settings of one camera from the "inference" section.
+ */
+struct PipelineInference {
+    InferenceConfig config;        ///< modelPath as written (may be relative).
+    QSize roiWindow;               ///< RoiInferencePlanner window; empty = planner default.
+    int roiFullFrameInterval = -1; ///< Full frame every N inferences; -1 = planner default.
+};
+
+/**
+ * @class PipelineCatalog
+ * @brief Loads, validates and selects camera pipeline descriptions.
+ *
+ * Published to the camera devices as a shared const pointer once loaded and
+ * validated, like the calibration tables.
+ */
+class PipelineCatalog
+{
+public:
+    bool loadFromFile(const QString &path);
+    bool loadFromJson(const QByteArray &json, QString *error = nullptr);
+
+    /**
+     * @brief Resolves and test-instantiates every pipeline. DeepStream
+     *        pipelines are skipped (left invalid) when @p capabilities lacks
+     *        DeepStream. gst_init must have run.
+     * @return Number of valid pipelines.
+     */
+    int validate(const PipelineCapabilities &capabilities);
+
+    /**
+     * @brief Pipeline to build for @p camera: the active one if valid, else the
+     *        first valid pipeline of the camera (DeepStream first).
+     * @return nullptr if the camera has no valid pipeline.
+     */
+    const PipelineDescription *select(const QString &camera) const;
+
+    void setActive(const QString &camera, const QString &name) { m_active[camera] = name; }
+    const PipelineDescription *find(const QString &name) const;
+    const std::vector<PipelineDescription> &pipelines() const { return m_pipelines; }
+
+    /** @brief Detector settings for @p camera: the shared keys, then the camera's own. */
+    PipelineInference inference(const QString &camera) const;
+
+    /** @brief Substitutes ${key} in @p launch; unresolved names are listed in @p missing. */
+    static QString resolve(const QString &launch, const QMap<QString, QString> &parameters, QStringList *missing);
+
+    /** @brief Splits an "element.pad" tap. */
+    static bool splitPadTap(const QString &tap, QString &element, QString &pad);
+
+private:
+    QString checkTaps(GstElement *pipeline, const PipelineDescription &description) const;
+
+    std::vector<PipelineDescription> m_pipelines;
+    QMap<QString, QString> m_active;
+    PipelineInference m_inference;                  ///< Shared "inference" keys.
+    QMap<QString, QJsonObject> m_cameraInference;   ///< "inference"."cameras" overrides.
+};
+
+using PipelineCatalogPtr = std::shared_ptr<const PipelineCatalog>;
+
+#endif // PIPELINECATALOG_H
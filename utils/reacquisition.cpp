@@ -0,0 +1,397 @@
+#include "reacquisition.h"
+#include "simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// Template's longer side at the working scale; larger boxes are block-averaged
+constexpr int WORKING_SIZE = 32;
+
+// Pyramid levels stop when the template's shorter side would drop below this
+constexpr int MIN_TEMPLATE_SIDE = 6;
+constexpr int MAX_LEVELS = 3;
+
+// Candidates kept from the exhaustive top-level search
+constexpr int TOP_CANDIDATES = 3;
+constexpr int REFINE_RADIUS = 2;
+
+// Motion model: velocity smoothing, and the largest frame gap still differentiated
+constexpr double VELOCITY_GAIN = 0.3;
+constexpr double MAX_MOTION_GAP_SEC = 0.5;
+
+inline float luma(const uint8_t *px)
+{
+    return 0.299f * px[0] + 0.587f * px[1] + 0.114f * px[2];
+}
+
+inline float dot(const float *a, const float *b, int n)
+{
+    simd::f32x4 acc = simd::set1(0.0f);
+    int i = 0;
+    for (; i + simd::LANES <= n; i += simd::LANES)
+        acc = simd::mulAdd(simd::load(a + i), simd::load(b + i), acc);
+    float sum = simd::horizontalSum(acc);
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+}
+
+void ReacquisitionEngine::sampleLuma(const RgbaImageView &image, int x, int y, int w, int h, int factor, Plane &out)
+{
+    out.width = w / factor;
+    out.height = h / factor;
+    out.data.assign(static_cast<size_t>(out.width) * out.height, 0.0f);
+
+    const float scale = 1.0f / (factor * factor);
+    for (int oy = 0; oy < out.height; ++oy) {
+        float *dst = out.data.data() + static_cast<size_t>(oy) * out.width;
+        for (int dy = 0; dy < factor; ++dy) {
+            const uint8_t *src = image.data + static_cast<size_t>(y + oy * factor + dy) * image.stride + x * 4;
+            for (int ox = 0; ox < out.width; ++ox) {
+                const uint8_t *px = src + ox * factor * 4;
+                float sum = 0.0f;
+                for (int dx = 0; dx < factor; ++dx)
+                    sum += luma(px + dx * 4);
+                dst[ox] += sum;
+            }
+        }
+        for (int ox = 0; ox < out.width; ++ox)
+            dst[ox] *= scale;
+    }
+}
+
+void ReacquisitionEngine::downsample(const Plane &in, Plane &out)
+{
+    out.width = in.width / 2;
+    out.height = in.height / 2;
+    out.data.resize(static_cast<size_t>(out.width) * out.height);
+    for (int y = 0; y < out.height; ++y) {
+        const float *r0 = in.data.data() + static_cast<size_t>(2 * y) * in.width;
+        const float *r1 = r0 + in.width;
+        float *dst = out.data.data() + static_cast<size_t>(y) * out.width;
+        for (int x = 0; x < out.width; ++x)
+            dst[x] = 0.25f * (r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1]);
+    }
+}
+
+void ReacquisitionEngine::prepareTemplate(TemplateLevel &level)
+{
+    std::vector<float> &d = level.plane.data;
+    if (d.empty()) {
+        level.norm = 0.0f;
+        return;
+    }
+    float mean = 0.0f;
+    for (float v : d)
+        mean += v;
+    mean /= d.size();
+    float sq = 0.0f;
+    for (float &v : d) {
+        v -= mean;
+        sq += v * v;
+    }
+    level.norm = std::sqrt(sq);
+}
+
+void ReacquisitionEngine::updateModel(const RgbaImageView &image, const QRect &box, double timestampSec)
+{
+    const QRect clipped = box.intersected(QRect(0, 0, image.width, image.height));
+    if (!image.data || clipped.width() < 4 || clipped.height() < 4)
+        return;
+
+    // Motion
+    const double cx = clipped.x() + clipped.width() / 2.0;
+    const double cy = clipped.y() + clipped.height() / 2.0;
+    const double dt = timestampSec - m_lastUpdate;
+    if (m_lastUpdate >= 0.0 && dt > 0.0 && dt < MAX_MOTION_GAP_SEC) {
+        m_velocityX += VELOCITY_GAIN * ((cx - m_centerX) / dt - m_velocityX);
+        m_velocityY += VELOCITY_GAIN * ((cy - m_centerY) / dt - m_velocityY);
+    } else {
+        m_velocityX = 0.0;
+        m_velocityY = 0.0;
+    }
+    m_centerX = cx;
+    m_centerY = cy;
+    m_lastUpdate = timestampSec;
+
+    // Template, refreshed periodically so a single drifting frame does not replace it
+    if (!m_levels.empty() && ++m_updates % std::max(1, m_templateInterval) != 0)
+        return;
+
+    int factor = 1;
+    while (std::max(clipped.width(), clipped.height()) / factor > WORKING_SIZE)
+        factor *= 2;
+
+    m_factor = factor;
+    m_boxSize = clipped.size();
+    m_levels.resize(1);
+    sampleLuma(image, clipped.x(), clipped.y(), clipped.width(), clipped.height(), factor, m_levels[0].plane);
+    while (static_cast<int>(m_levels.size()) < MAX_LEVELS) {
+        const Plane &finer = m_levels.back().plane;
+        if (std::min(finer.width, finer.height) / 2 < MIN_TEMPLATE_SIDE)
+            break;
+        TemplateLevel coarser;
+        downsample(finer, coarser.plane);
+        m_levels.push_back(std::move(coarser));
+    }
+    // Zero-mean only after the pyramid is built from the raw intensities
+    for (TemplateLevel &level : m_levels)
+        prepareTemplate(level);
+
+    // Appearance descriptor, refreshed with the template
+    m_hasAppearance = m_extractor.extract(image, clipped.x(), clipped.y(), clipped.width(), clipped.height(),
+                                          m_appearance);
+}
+
+void ReacquisitionEngine::clearModel()
+{
+    m_levels.clear();
+    m_hasAppearance = false;
+    m_updates = 0;
+    m_lastUpdate = -1.0;
+    m_velocityX = m_velocityY = 0.0;
+    m_active = false;
+}
+
+bool ReacquisitionEngine::begin(double timestampSec)
+{
+    if (m_levels.empty())
+        return false;
+    m_active = true;
+    m_lostAt = timestampSec;
+    m_pendingHits = 0;
+    ++m_stats.attempts;
+    return true;
+}
+
+void ReacquisitionEngine::cancel()
+{
+    if (!m_active)
+        return;
+    m_active = false;
+    ++m_stats.cancelled;
+}
+
+QRect ReacquisitionEngine::predictedBox(double timestampSec) const
+{
+    const double dt = std::clamp(timestampSec - m_lastUpdate, 0.0, m_windowSec);
+    const double cx = m_centerX + m_velocityX * dt;
+    const double cy = m_centerY + m_velocityY * dt;
+    return QRect(static_cast<int>(std::lround(cx - m_boxSize.width() / 2.0)),
+                 static_cast<int>(std::lround(cy - m_boxSize.height() / 2.0)),
+                 m_boxSize.width(), m_boxSize.height());
+}
+
+void ReacquisitionEngine::buildIntegrals(int level)
+{
+    const Plane &p = m_pyramid[level];
+    const int stride = p.width + 1;
+    std::vector<double> &sum = m_sum[level];
+    std::vector<double> &sumSq = m_sumSq[level];
+    sum.assign(static_cast<size_t>(p.height + 1) * stride, 0.0);
+    sumSq.assign(static_cast<size_t>(p.height + 1) * stride, 0.0);
+
+    for (int y = 0; y < p.height; ++y) {
+        const float *row = p.data.data() + static_cast<size_t>(y) * p.width;
+        double rowSum = 0.0, rowSq = 0.0;
+        for (int x = 0; x < p.width; ++x) {
+            rowSum += row[x];
+            rowSq += static_cast<double>(row[x]) * row[x];
+            const size_t i = static_cast<size_t>(y + 1) * stride + x + 1;
+            sum[i] = sum[i - stride] + rowSum;
+            sumSq[i] = sumSq[i - stride] + rowSq;
+        }
+    }
+}
+
+float ReacquisitionEngine::correlate(int level, int x, int y) const
+{
+    const TemplateLevel &t = m_levels[level];
+    const Plane &img = m_pyramid[level];
+    const int tw = t.plane.width;
+    const int th = t.plane.height;
+
+    // The template is zero-mean, so sum(I * T) equals sum((I - mean(I)) * T)
+    float cross = 0.0f;
+    for (int r = 0; r < th; ++r)
+        cross += dot(img.data.data() + static_cast<size_t>(y + r) * img.width + x,
+                     t.plane.data.data() + static_cast<size_t>(r) * tw, tw);
+
+    const int stride = img.width + 1;
+    const std::vector<double> &s = m_sum[level];
+    const std::vector<double> &q = m_sumSq[level];
+    const size_t a = static_cast<size_t>(y) * stride + x;
+    const size_t b = a + tw;
+    const size_t c = a + static_cast<size_t>(th) * stride;
+    const size_t d = c + tw;
+    const double n = static_cast<double>(tw) * th;
+    const double sum = s[d] - s[b] - s[c] + s[a];
+    const double sumSq = q[d] - q[b] - q[c] + q[a];
+    const double variance = sumSq - sum * sum / n;
+
+    // Flat image patches or templates carry no match information
+    if (variance <= n * 1e-2 || t.norm <= 1e-3f)
+        return 0.0f;
+    return static_cast<float>(cross / (std::sqrt(variance) * t.norm));
+}
+
+ReacquisitionResult ReacquisitionEngine::search(const RgbaImageView &image, double timestampSec)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::microseconds(static_cast<long long>(m_budgetMs * 1000.0));
+
+    ReacquisitionResult result;
+    if (!m_active || m_levels.empty() || !image.data)
+        return result;
+
+    const double sinceLoss = timestampSec - m_lostAt;
+    if (sinceLoss > m_windowSec) {
+        m_active = false;
+        ++m_stats.expiries;
+        result.expired = true;
+        return result;
+    }
+
+    // Search window grows with the time since the loss to cover acceleration
+    const QRect predicted = predictedBox(timestampSec);
+    const int radius = std::min(m_maxRadius, m_baseRadius + static_cast<int>(m_radiusGrowth * sinceLoss));
+    const QRect region = predicted.adjusted(-radius, -radius, radius, radius)
+                                  .intersected(QRect(0, 0, image.width, image.height));
+    result.searchRegion = region;
+    const Plane &tpl0 = m_levels[0].plane;
+    if (region.width() / m_factor < tpl0.width || region.height() / m_factor < tpl0.height)
+        return result;
+
+    // Search pyramid over the region only
+    m_pyramid.resize(m_levels.size());
+    m_sum.resize(m_levels.size());
+    m_sumSq.resize(m_levels.size());
+    sampleLuma(image, region.x(), region.y(), region.width(), region.height(), m_factor, m_pyramid[0]);
+    int levels = 1;
+    while (levels < static_cast<int>(m_levels.size())) {
+        downsample(m_pyramid[levels - 1], m_pyramid[levels]);
+        const Plane &tpl = m_levels[levels].plane;
+        if (m_pyramid[levels].width < tpl.width || m_pyramid[levels].height < tpl.height)
+            break;
+        ++levels;
+    }
+    for (int l = 0; l < levels; ++l)
+        buildIntegrals(l);
+
+    // Exhaustive NCC at the top level, keeping the best few separated peaks
+    const int top = levels - 1;
+    const Plane &topPlane = m_pyramid[top];
+    const Plane &topTpl = m_levels[top].plane;
+    const int separation = std::max(2, std::min(topTpl.width, topTpl.height) / 2);
+    Candidate candidates[TOP_CANDIDATES];
+
+    for (int y = 0; y + topTpl.height <= topPlane.height; ++y) {
+        if (Clock::now() > deadline) {
+            result.budgetExhausted = true;
+            break;
+        }
+        for (int x = 0; x + topTpl.width <= topPlane.width; ++x) {
+            const float score = correlate(top, x, y);
+            ++result.evaluated;
+            if (score <= candidates[TOP_CANDIDATES - 1].score)
+                continue;
+
+            // Replace a nearby weaker peak, otherwise the weakest candidate
+            int slot = TOP_CANDIDATES - 1;
+            bool dominated = false;
+            for (int i = 0; i < TOP_CANDIDATES; ++i) {
+                if (candidates[i].score < 0.0f ||
+                    std::abs(candidates[i].x - x) > separation || std::abs(candidates[i].y - y) > separation)
+                    continue;
+                if (candidates[i].score >= score)
+                    dominated = true;
+                else
+                    slot = i;
+                break;
+            }
+            if (dominated)
+                continue;
+            candidates[slot] = {x, y, score};
+            std::sort(std::begin(candidates), std::end(candidates),
+                      [](const Candidate &a, const Candidate &b) { return a.score > b.score; });
+        }
+    }
+
+    // Refine each candidate down the pyramid
+    Candidate best;
+    for (const Candidate &seed : candidates) {
+        if (seed.score < 0.0f)
+            break;
+        if (result.budgetExhausted || Clock::now() > deadline) {
+            result.budgetExhausted = true;
+            break;
+        }
+        Candidate c = seed;
+        for (int l = top - 1; l >= 0; --l) {
+            const Plane &plane = m_pyramid[l];
+            const Plane &tpl = m_levels[l].plane;
+            const int cx = c.x * 2;
+            const int cy = c.y * 2;
+            c.score = -1.0f;
+            for (int y = std::max(0, cy - REFINE_RADIUS); y <= std::min(plane.height - tpl.height, cy + REFINE_RADIUS); ++y) {
+                for (int x = std::max(0, cx - REFINE_RADIUS); x <= std::min(plane.width - tpl.width, cx + REFINE_RADIUS); ++x) {
+                    const float score = correlate(l, x, y);
+                    ++result.evaluated;
+                    if (score > c.score)
+                        c = {x, y, score};
+                }
+            }
+        }
+        if (c.score > best.score)
+            best = c;
+    }
+
+    if (best.score > -1.0f) {
+        const double cx = region.x() + (best.x + tpl0.width / 2.0) * m_factor;
+        const double cy = region.y() + (best.y + tpl0.height / 2.0) * m_factor;
+        result.box = QRect(static_cast<int>(std::lround(cx - m_boxSize.width() / 2.0)),
+                           static_cast<int>(std::lround(cy - m_boxSize.height() / 2.0)),
+                           m_boxSize.width(), m_boxSize.height());
+        result.score = best.score;
+        result.candidate = best.score >= m_minScore;
+
+        // NCC works on luma only; the descriptor also checks colour and edges
+        if (result.candidate && m_hasAppearance &&
+            m_extractor.extract(image, result.box.x(), result.box.y(), result.box.width(), result.box.height(),
+                                m_candidateAppearance)) {
+            result.appearance = targetFeatureSimilarity(m_appearance, m_candidateAppearance);
+            result.candidate = result.appearance >= m_minAppearance;
+        }
+    }
+
+    // Confirmation: consecutive candidates must agree on the position
+    if (result.candidate) {
+        const int tolerance = std::max(8, std::max(m_boxSize.width(), m_boxSize.height()) / 4);
+        const bool consistent = m_pendingHits > 0 &&
+                std::abs(result.box.center().x() - m_pendingBox.center().x()) <= tolerance &&
+                std::abs(result.box.center().y() - m_pendingBox.center().y()) <= tolerance;
+        m_pendingHits = consistent ? m_pendingHits + 1 : 1;
+        m_pendingBox = result.box;
+        result.found = m_pendingHits >= std::max(1, m_confirmFrames);
+    } else {
+        m_pendingHits = 0;
+    }
+
+    if (result.found) {
+        m_active = false;
+        ++m_stats.successes;
+        m_stats.totalSearchTimeSec += sinceLoss;
+
+        // Restart the motion model from the match
+        m_centerX = result.box.x() + result.box.width() / 2.0;
+        m_centerY = result.box.y() + result.box.height() / 2.0;
+        m_velocityX = m_velocityY = 0.0;
+        m_lastUpdate = timestampSec;
+    }
+
+    result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
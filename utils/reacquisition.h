@@ -0,0 +1,185 @@
+#ifndef REACQUISITION_H
+#define REACQUISITION_H
+
+/**
+ * @file reacquisition.h
+ * @brief Automatic re-acquisition of a lost track: coarse-to-fine normalised
+ *        cross-correlation around the position predicted from the last motion.
+ *
+ * While the tracker is healthy the engine keeps a grayscale template of the
+ * target and a smoothed image-plane velocity. After a loss, each frame is
+ * searched once within a fixed compute budget, in a window that grows with the
+ * time since the loss, until a confident match is found or the re-acquisition
+ * window expires.
+ */
+
+#include "utils/targetfeatures.h"
+#include <QRect>
+#include <vector>
+
+/**
+ * @struct ReacquisitionResult
+ * @brief Outcome of one ReacquisitionEngine::search() call.
+ */
+struct ReacquisitionResult {
+    bool   found = false;       ///< Confirmed match; the window has ended.
+    bool   candidate = false;   ///< Match above the score that still awaits confirmation.
+    bool   expired = false;     ///< The re-acquisition window has run out.
+    QRect  box;                 ///< Best candidate, frame coordinates.
+    QRect  searchRegion;        ///< Region searched this frame.
+    float  score = 0.0f;        ///< NCC of the best candidate (-1..1).
+    float  appearance = -1.0f;  ///< Descriptor similarity of the candidate (0..1, -1 = not checked).
+    int    evaluated = 0;       ///< NCC positions scored.
+    bool   budgetExhausted = false;
+    double elapsedMs = 0.0;
+};
+
+/**
+ * @struct ReacquisitionStats
+ * @brief Outcome counters since construction (or resetStats()).
+ */
+struct ReacquisitionStats {
+    int attempts  = 0; ///< Losses for which a search was started.
+    int successes = 0; ///< Searches that ended in a match.
+    int expiries  = 0; ///< Searches that ran out of window.
+    int cancelled = 0; ///< Searches stopped by the operator.
+    double totalSearchTimeSec = 0.0; ///< Loss-to-match time summed over successes.
+
+    double successRate() const { return attempts > 0 ? static_cast<double>(successes) / attempts : 0.0; }
+};
+
+/**
+ * @class ReacquisitionEngine
+ * @brief Keeps the last good appearance/motion model and searches for it after a loss.
+ *
+ * All matching runs at a working scale where the template's longer side is at
+ * most 32 px, on an image pyramid of the search region only. The top level is
+ * searched exhaustively and the best candidates are refined by +/- 2 px at each
+ * finer level. Correlation rows use the SIMD layer (simd.h). A candidate must
+ * also match the colour/gradient descriptor (targetfeatures.h) kept with the
+ * template, which rejects grayscale look-alikes of a different colour, and is
+ * only reported once it has been seen at a consistent position in consecutive
+ * frames, which rejects single-frame background look-alikes.
+ *
+ * Times are monotonic seconds supplied by the caller. Buffers are reused across
+ * frames. One instance per camera.
+ */
+class ReacquisitionEngine
+{
+public:
+    ReacquisitionEngine() = default;
+
+    /**
+     * @brief Feeds a frame in which the tracker is healthy. Updates the motion
+     *        estimate every call and the template every templateInterval calls.
+     */
+    void updateModel(const RgbaImageView &image, const QRect &box, double timestampSec);
+
+    /** @brief Forgets the template and motion (operator stopped tracking). */
+    void clearModel();
+    bool hasModel() const { return !m_levels.empty(); }
+
+    /**
+     * @brief Starts a re-acquisition window at @p timestampSec.
+     * @return False if there is no model to search for.
+     */
+    bool begin(double timestampSec);
+    /** @brief Ends the current window without a result. */
+    void cancel();
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Searches @p image for the target. Ends the window on a match or expiry.
+     */
+    ReacquisitionResult search(const RgbaImageView &image, double timestampSec);
+
+    /** @brief Predicted target box at @p timestampSec (frame coordinates). */
+    QRect predictedBox(double timestampSec) const;
+
+    const ReacquisitionStats &stats() const { return m_stats; }
+    void resetStats() { m_stats = ReacquisitionStats(); }
+
+    // Configuration
+    void setWindow(double seconds) { m_windowSec = seconds; }
+    void setBudget(double milliseconds) { m_budgetMs = milliseconds; }
+    void setMinScore(float score) { m_minScore = score; }
+    void setMinAppearance(float similarity) { m_minAppearance = similarity; }
+    void setSearchRadius(int basePixels, double growthPixelsPerSec, int maxPixels)
+    {
+        m_baseRadius = basePixels;
+        m_radiusGrowth = growthPixelsPerSec;
+        m_maxRadius = maxPixels;
+    }
+    void setTemplateInterval(int frames) { m_templateInterval = frames; }
+    void setConfirmFrames(int frames) { m_confirmFrames = frames; }
+
+    double window() const { return m_windowSec; }
+
+private:
+    struct Plane {
+        std::vector<float> data;
+        int width = 0;
+        int height = 0;
+    };
+
+    struct Candidate {
+        int x = 0;
+        int y = 0;
+        float score = -1.0f;
+    };
+
+    // Luma of image region (x, y, w, h) averaged over factor x factor blocks
+    static void sampleLuma(const RgbaImageView &image, int x, int y, int w, int h, int factor, Plane &out);
+    static void downsample(const Plane &in, Plane &out);
+
+    // Zero-mean template level and its norm
+    struct TemplateLevel {
+        Plane plane;
+        float norm = 0.0f;
+    };
+    static void prepareTemplate(TemplateLevel &level);
+
+    // NCC at (x, y) of plane level l of the search pyramid
+    float correlate(int level, int x, int y) const;
+    void buildIntegrals(int level);
+
+    // Model
+    std::vector<TemplateLevel> m_levels; // [0] = working scale
+    TargetFeatureExtractor m_extractor;
+    TargetFeatures m_appearance{};       // descriptor of the template box
+    TargetFeatures m_candidateAppearance{};
+    bool m_hasAppearance = false;
+    int m_factor = 1;                    // frame pixels per working-scale pixel
+    QSize m_boxSize;
+    int m_updates = 0;
+
+    // Motion, frame pixels
+    double m_centerX = 0.0;
+    double m_centerY = 0.0;
+    double m_velocityX = 0.0;
+    double m_velocityY = 0.0;
+    double m_lastUpdate = -1.0;
+
+    // Search state
+    bool m_active = false;
+    double m_lostAt = 0.0;
+    QRect m_pendingBox;
+    int m_pendingHits = 0;
+    std::vector<Plane> m_pyramid;
+    std::vector<std::vector<double>> m_sum;   // integral images per level
+    std::vector<std::vector<double>> m_sumSq;
+    ReacquisitionStats m_stats;
+
+    // Configuration
+    double m_windowSec = 3.0;
+    double m_budgetMs = 4.0;
+    float m_minScore = 0.8f;
+    float m_minAppearance = 0.6f;
+    int m_baseRadius = 24;
+    double m_radiusGrowth = 120.0;
+    int m_maxRadius = 160;
+    int m_templateInterval = 5;
+    int m_confirmFrames = 2;
+};
+
+#endif // REACQUISITION_H
@@ -0,0 +1,41 @@
+#include "roiinference.h"
+#include <algorithm>
+#include <cmath>
+
+QRect RoiInferencePlanner::window(const QSize &frameSize, const QPoint &reticle, const QRect &target) const
+{
+    const bool hasTarget = !target.isEmpty();
+    const double cx = hasTarget ? target.x() + target.width() / 2.0 : reticle.x();
+    const double cy = hasTarget ? target.y() + target.height() / 2.0 : reticle.y();
+
+    int w = m_windowSize.width();
+    int h = m_windowSize.height();
+    if (hasTarget) {
+        w = std::max(w, static_cast<int>(std::ceil(target.width() * m_contextScale)));
+        h = std::max(h, static_cast<int>(std::ceil(target.height() * m_contextScale)));
+    }
+    w = std::min(w, frameSize.width());
+    h = std::min(h, frameSize.height());
+
+    const int x = std::clamp(static_cast<int>(std::lround(cx - w / 2.0)), 0, frameSize.width() - w);
+    const int y = std::clamp(static_cast<int>(std::lround(cy - h / 2.0)), 0, frameSize.height() - h);
+    return QRect(x, y, w, h);
+}
+
+InferenceRegion RoiInferencePlanner::next(const QSize &frameSize, const QPoint &reticle, const QRect &target)
+{
+    InferenceRegion result;
+    result.region = QRect(QPoint(0, 0), frameSize);
+
+    if (!isEnabled() || (m_fullFrameInterval > 0 && m_sinceFullFrame >= m_fullFrameInterval)) {
+        m_sinceFullFrame = 0;
+        ++m_stats.fullFrames;
+        return result;
+    }
+
+    result.region = window(frameSize, reticle, target);
+    result.fullFrame = result.region.size() == frameSize;
+    ++m_sinceFullFrame;
+    ++m_stats.windowed;
+    return result;
+}
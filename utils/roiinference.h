@@ -0,0 +1,99 @@
+#ifndef ROIINFERENCE_H
+#define ROIINFERENCE_H
+
+/**
+ * @file roiinference.h
+ * @brief Choice of the frame region the detector runs on: a window around the
+ *        reticle or the tracked/predicted target, with a periodic full frame.
+ *
+ * In tracking and engagement only the area around the aim point matters.
+ * Running the detector on a small window costs a fraction of a full frame, and
+ * when the window is smaller than the network input it is upsampled, so small
+ * targets are seen at a higher effective resolution. A full frame every few
+ * inferences keeps the rest of the scene (and new threats) in the track list.
+ *
+ * Only frame backends use the planner, i.e. the CPU detector of the CPU
+ * pipelines (window size and full-frame interval from the "inference" section
+ * of config/pipelines.json). DeepStream pipelines are out of scope: nvinfer
+ * always sees the whole streammux frame, and steering it would need an
+ * nvdspreprocess ROI fed from this planner.
+ */
+
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <atomic>
+
+/**
+ * @struct InferenceRegion
+ * @brief Region selected for one inference, frame coordinates.
+ */
+struct InferenceRegion {
+    QRect region;
+    bool  fullFrame = true;
+};
+
+/**
+ * @struct RoiInferenceStats
+ * @brief Number of windowed and full-frame inferences planned.
+ */
+struct RoiInferenceStats {
+    int windowed = 0;
+    int fullFrames = 0;
+};
+
+/**
+ * @class RoiInferencePlanner
+ * @brief Plans the region of each inference.
+ *
+ * The window is centred on the target when one is given, on the reticle
+ * otherwise. It is at least the configured size and at least contextScale
+ * times the target, so the whole target and some background are always in it,
+ * and it is shifted (not clipped) to stay inside the frame.
+ *
+ * setEnabled() may be called from any thread (the state model's); everything
+ * else belongs to the thread that runs the detector.
+ */
+class RoiInferencePlanner
+{
+public:
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /** @brief Window size in frame pixels (default 320 x 320). */
+    void setWindowSize(const QSize &size) { m_windowSize = size; }
+    /** @brief Every @p inferences-th inference covers the full frame (0 = never). */
+    void setFullFrameInterval(int inferences) { m_fullFrameInterval = inferences; }
+    /** @brief Minimum window size relative to the target box (default 2). */
+    void setContextScale(double scale) { m_contextScale = scale; }
+
+    QSize windowSize() const { return m_windowSize; }
+    int fullFrameInterval() const { return m_fullFrameInterval; }
+
+    /**
+     * @brief Region of the next inference.
+     * @param reticle Aim point in frame pixels.
+     * @param target Tracked or predicted target box; empty if there is none.
+     */
+    InferenceRegion next(const QSize &frameSize, const QPoint &reticle, const QRect &target);
+
+    /** @brief Window for @p target / @p reticle without touching the cadence. */
+    QRect window(const QSize &frameSize, const QPoint &reticle, const QRect &target) const;
+
+    /** @brief Makes the next inference a full frame (e.g. after a lost track). */
+    void requestFullFrame() { m_sinceFullFrame = m_fullFrameInterval; }
+
+    const RoiInferenceStats &stats() const { return m_stats; }
+    void resetStats() { m_stats = RoiInferenceStats(); }
+
+private:
+    std::atomic<bool> m_enabled{false};
+    QSize m_windowSize = QSize(320, 320);
+    int m_fullFrameInterval = 10;
+    double m_contextScale = 2.0;
+
+    int m_sinceFullFrame = 0;
+    RoiInferenceStats m_stats;
+};
+
+#endif // ROIINFERENCE_H
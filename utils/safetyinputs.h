@@ -0,0 +1,92 @@
+#ifndef SAFETYINPUTS_H
+#define SAFETYINPUTS_H
+
+/**
+ * @file safetyinputs.h
+ * @brief Safety-critical discrete inputs: debouncing and the edge events
+ *        handed from the PLC poller to the control loop.
+ */
+
+#include <QtGlobal>
+#include "utils/spscqueue.h"
+
+/**
+ * @enum SafetyInput
+ * @brief PLC42 discrete inputs on the fast poll (value = input address).
+ */
+enum class SafetyInput : quint8 {
+    UpperLimit    = 0,
+    LowerLimit    = 1,
+    EmergencyStop = 2
+};
+
+static constexpr int SAFETY_INPUT_COUNT = 3;
+
+/**
+ * @struct SafetyInputEvent
+ * @brief A debounced edge of one safety input.
+ */
+struct SafetyInputEvent {
+    SafetyInput input = SafetyInput::EmergencyStop;
+    bool active = false;
+    qint64 timestampUs = 0; ///< Reply that produced the edge (LatencyMonitor::nowUs() clock).
+};
+
+// Edges handed from the PLC poller to the control loop
+using SafetyInputQueue = SpscQueue<SafetyInputEvent, 64>;
+
+/**
+ * @class SafetyDebouncer
+ * @brief Fail-safe debouncing of one active-high safety input.
+ *
+ * Activation is taken from the first sample: a bouncing E-stop contact must
+ * stop the gimbal, not be filtered. Release needs @p releaseSamples
+ * consecutive inactive samples.
+ */
+class SafetyDebouncer
+{
+public:
+    explicit SafetyDebouncer(int releaseSamples = 3) : m_releaseSamples(releaseSamples) {}
+
+    /** @brief Feeds one raw sample; true if the debounced state changed. */
+    bool update(bool raw)
+    {
+        if (raw) {
+            m_inactiveSamples = 0;
+            if (m_active)
+                return false;
+            m_active = true;
+            return true;
+        }
+        if (!m_active || ++m_inactiveSamples < m_releaseSamples)
+            return false;
+        m_active = false;
+        m_inactiveSamples = 0;
+        return true;
+    }
+
+    bool active() const { return m_active; }
+
+    /** @brief Forces the active state (fail-safe); true if it changed. */
+    bool forceActive()
+    {
+        m_inactiveSamples = 0;
+        if (m_active)
+            return false;
+        m_active = true;
+        return true;
+    }
+
+    void reset()
+    {
+        m_active = false;
+        m_inactiveSamples = 0;
+    }
+
+private:
+    int m_releaseSamples;
+    int m_inactiveSamples = 0;
+    bool m_active = false;
+};
+
+#endif // SAFETYINPUTS_H
@@ -0,0 +1,106 @@
+#include "scantrajectory.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Peak values of the normalised quintic s(u) = 10u^3 - 15u^4 + 6u^5 on u in [0, 1]:
+// max s' = 1.875, max |s''| = 5.7735, max |s'''| = 60.
+constexpr double PEAK_VELOCITY     = 1.875;
+constexpr double PEAK_ACCELERATION = 5.773502691896258;
+constexpr double PEAK_JERK         = 60.0;
+}
+
+void ScanTrajectory::clear()
+{
+    m_segments.clear();
+}
+
+void ScanTrajectory::setStart(double az, double el)
+{
+    m_segments.clear();
+    m_endAz = az;
+    m_endEl = el;
+}
+
+double ScanTrajectory::segmentDuration(double distance) const
+{
+    const double d = std::fabs(distance);
+    double T = m_limits.minSegmentTime;
+    if (m_limits.maxVelocity > 0.0)
+        T = std::max(T, PEAK_VELOCITY * d / m_limits.maxVelocity);
+    if (m_limits.maxAcceleration > 0.0)
+        T = std::max(T, std::sqrt(PEAK_ACCELERATION * d / m_limits.maxAcceleration));
+    if (m_limits.maxJerk > 0.0)
+        T = std::max(T, std::cbrt(PEAK_JERK * d / m_limits.maxJerk));
+    return T;
+}
+
+void ScanTrajectory::addWaypoint(double az, double el, double dwellSec)
+{
+    const double t0 = duration();
+
+    Segment move;
+    move.t0 = t0;
+    move.az0 = m_endAz;
+    move.el0 = m_endEl;
+    move.dAz = az - m_endAz;
+    move.dEl = el - m_endEl;
+    // Both axes share the duration of the slower one
+    move.T = std::max(segmentDuration(move.dAz), segmentDuration(move.dEl));
+    if (move.dAz != 0.0 || move.dEl != 0.0)
+        m_segments.push_back(move);
+
+    m_endAz = az;
+    m_endEl = el;
+
+    if (dwellSec > 0.0) {
+        Segment dwell;
+        dwell.t0 = duration();
+        dwell.T = dwellSec;
+        dwell.az0 = az;
+        dwell.el0 = el;
+        m_segments.push_back(dwell);
+    }
+}
+
+double ScanTrajectory::duration() const
+{
+    if (m_segments.empty())
+        return 0.0;
+    const Segment &last = m_segments.back();
+    return last.t0 + last.T;
+}
+
+TrajectoryPoint ScanTrajectory::sample(double t) const
+{
+    TrajectoryPoint p;
+    p.az = m_endAz;
+    p.el = m_endEl;
+    if (m_segments.empty())
+        return p;
+
+    if (t <= 0.0) {
+        p.az = m_segments.front().az0;
+        p.el = m_segments.front().el0;
+        return p;
+    }
+    if (t >= duration())
+        return p;
+
+    // Last segment starting at or before t
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), t,
+                               [](double value, const Segment &s) { return value < s.t0; });
+    const Segment &s = *(it - 1);
+
+    const double u = std::clamp((t - s.t0) / s.T, 0.0, 1.0);
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    const double pos = u3 * (10.0 - 15.0 * u + 6.0 * u2);
+    const double vel = 30.0 * u2 * (1.0 - 2.0 * u + u2) / s.T;
+
+    p.az = s.az0 + s.dAz * pos;
+    p.el = s.el0 + s.dEl * pos;
+    p.azRate = s.dAz * vel;
+    p.elRate = s.dEl * vel;
+    return p;
+}
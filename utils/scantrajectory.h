@@ -0,0 +1,93 @@
+#ifndef SCANTRAJECTORY_H
+#define SCANTRAJECTORY_H
+
+/**
+ * @file scantrajectory.h
+ * @brief Precomputed, time-parameterised az/el trajectories for scan patterns.
+ *
+ * A trajectory is a chain of point-to-point segments. Each segment follows a
+ * quintic minimum-jerk profile (zero velocity and acceleration at both ends),
+ * both axes share the segment duration so the path is a straight line in
+ * az/el, and the duration is the shortest one that respects the velocity,
+ * acceleration and jerk limits.
+ */
+
+#include <vector>
+
+/**
+ * @struct TrajectoryLimits
+ * @brief Per-axis kinematic limits used to time each segment.
+ */
+struct TrajectoryLimits {
+    double maxVelocity     = 20.0;  ///< deg/s
+    double maxAcceleration = 40.0;  ///< deg/s^2
+    double maxJerk         = 200.0; ///< deg/s^3
+    double minSegmentTime  = 0.1;   ///< s
+};
+
+/**
+ * @struct TrajectoryPoint
+ * @brief Reference position and rate at a given time.
+ */
+struct TrajectoryPoint {
+    double az = 0.0;      ///< deg
+    double el = 0.0;      ///< deg
+    double azRate = 0.0;  ///< deg/s
+    double elRate = 0.0;  ///< deg/s
+};
+
+/**
+ * @class ScanTrajectory
+ * @brief Chain of jerk-limited segments, sampled by time.
+ *
+ * All planning (and allocation) happens in the builders; sample() is O(log n)
+ * and allocation-free, so it can run in the control loop.
+ */
+class ScanTrajectory
+{
+public:
+    void clear();
+    void setLimits(const TrajectoryLimits &limits) { m_limits = limits; }
+    const TrajectoryLimits &limits() const { return m_limits; }
+
+    /**
+     * @brief Sets the start position. Clears any existing segments.
+     */
+    void setStart(double az, double el);
+
+    /**
+     * @brief Appends a move to (az, el), optionally followed by a dwell.
+     */
+    void addWaypoint(double az, double el, double dwellSec = 0.0);
+
+    /**
+     * @brief Reference at time @p t, clamped to [0, duration()].
+     */
+    TrajectoryPoint sample(double t) const;
+
+    double duration() const;
+    bool isEmpty() const { return m_segments.empty(); }
+    int segmentCount() const { return static_cast<int>(m_segments.size()); }
+
+    double endAz() const { return m_endAz; }
+    double endEl() const { return m_endEl; }
+
+private:
+    struct Segment {
+        double t0 = 0.0;   ///< Start time (s)
+        double T = 0.0;    ///< Duration (s)
+        double az0 = 0.0;
+        double el0 = 0.0;
+        double dAz = 0.0;
+        double dEl = 0.0;
+    };
+
+    double segmentDuration(double distance) const;
+
+    TrajectoryLimits m_limits;
+    std::vector<Segment> m_segments;
+    double m_endAz = 0.0;
+    double m_endEl = 0.0;
+};
+
+#endif // SCANTRAJECTORY_H
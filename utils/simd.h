@@ -0,0 +1,113 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * @file simd.h
+ * @brief Minimal portable 4-lane float SIMD layer: SSE2 on x86-64, NEON on
+ *        AArch64 (Jetson), scalar fallback elsewhere.
+ *
+ * Only the operations needed by the image feature code are provided. Loads and
+ * stores are unaligned.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define EL7ARESS_SIMD_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EL7ARESS_SIMD_NEON 1
+#endif
+
+#include <cmath>
+#include <cstdint>
+
+namespace simd {
+
+constexpr int LANES = 4;
+
+struct f32x4 {
+#if defined(EL7ARESS_SIMD_SSE2)
+    __m128 v;
+#elif defined(EL7ARESS_SIMD_NEON)
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+};
+
+#if defined(EL7ARESS_SIMD_SSE2)
+
+inline f32x4 load(const float *p) { return {_mm_loadu_ps(p)}; }
+inline void store(float *p, f32x4 a) { _mm_storeu_ps(p, a.v); }
+inline f32x4 set1(float x) { return {_mm_set1_ps(x)}; }
+inline f32x4 add(f32x4 a, f32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline f32x4 sub(f32x4 a, f32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline f32x4 mul(f32x4 a, f32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline f32x4 sqrt(f32x4 a) { return {_mm_sqrt_ps(a.v)}; }
+/// 1.0f in lanes where a > b, 0.0f elsewhere.
+inline f32x4 greaterThan(f32x4 a, f32x4 b) { return {_mm_and_ps(_mm_cmpgt_ps(a.v, b.v), _mm_set1_ps(1.0f))}; }
+/// Byte @p byte (0 = lowest) of each of four packed 32-bit pixels, as float.
+inline f32x4 unpackByte(const uint32_t *p, int byte)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i b = _mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(byte * 8)), _mm_set1_epi32(0xFF));
+    return {_mm_cvtepi32_ps(b)};
+}
+/// Truncating conversion to int32.
+inline void storeInt(int32_t *p, f32x4 a) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_cvttps_epi32(a.v)); }
+inline float horizontalSum(f32x4 a)
+{
+    __m128 shuf = _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(a.v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+#elif defined(EL7ARESS_SIMD_NEON)
+
+inline f32x4 load(const float *p) { return {vld1q_f32(p)}; }
+inline void store(float *p, f32x4 a) { vst1q_f32(p, a.v); }
+inline f32x4 set1(float x) { return {vdupq_n_f32(x)}; }
+inline f32x4 add(f32x4 a, f32x4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline f32x4 sub(f32x4 a, f32x4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline f32x4 mul(f32x4 a, f32x4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline f32x4 sqrt(f32x4 a) { return {vsqrtq_f32(a.v)}; }
+inline f32x4 greaterThan(f32x4 a, f32x4 b)
+{
+    return {vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(a.v, b.v), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))};
+}
+inline f32x4 unpackByte(const uint32_t *p, int byte)
+{
+    const uint32x4_t v = vshlq_u32(vld1q_u32(p), vdupq_n_s32(-byte * 8));
+    return {vcvtq_f32_u32(vandq_u32(v, vdupq_n_u32(0xFF)))};
+}
+inline void storeInt(int32_t *p, f32x4 a) { vst1q_s32(p, vcvtq_s32_f32(a.v)); }
+inline float horizontalSum(f32x4 a) { return vaddvq_f32(a.v); }
+
+#else
+
+inline f32x4 load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float *p, f32x4 a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+inline f32x4 set1(float x) { return {{x, x, x, x}}; }
+inline f32x4 add(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+inline f32x4 sub(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+inline f32x4 mul(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+inline f32x4 sqrt(f32x4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::sqrt(a.v[i]); return a; }
+inline f32x4 greaterThan(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f; return a; }
+inline f32x4 unpackByte(const uint32_t *p, int byte)
+{
+    f32x4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = static_cast<float>((p[i] >> (byte * 8)) & 0xFF);
+    return r;
+}
+inline void storeInt(int32_t *p, f32x4 a) { for (int i = 0; i < 4; ++i) p[i] = static_cast<int32_t>(a.v[i]); }
+inline float horizontalSum(f32x4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+
+#endif
+
+/// a * b + c
+inline f32x4 mulAdd(f32x4 a, f32x4 b, f32x4 c) { return add(mul(a, b), c); }
+
+} // namespace simd
+
+#endif // SIMD_H
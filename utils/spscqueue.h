@@ -0,0 +1,71 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+/**
+ * @file spscqueue.h
+ * @brief Bounded lock-free single-producer / single-consumer ring buffer.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity wait-free queue for exactly one producer and one consumer thread.
+ *
+ * tryPush() must only be called from the producer and tryPop() only from the
+ * consumer. Neither allocates. When the queue is full the new element is
+ * rejected and counted in droppedCount(), the consumer never blocks the producer.
+ *
+ * @tparam T        Trivially copyable element type.
+ * @tparam Capacity Number of slots, must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    bool tryPush(const T &value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head)
+            return false;
+        value = m_slots[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+    std::size_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::array<T, Capacity> m_slots {};
+    alignas(64) std::atomic<std::size_t> m_head {0}; ///< Written by the producer.
+    alignas(64) std::atomic<std::size_t> m_tail {0}; ///< Written by the consumer.
+    alignas(64) std::atomic<std::size_t> m_dropped {0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,119 @@
+#ifndef STEPRESPONSE_H
+#define STEPRESPONSE_H
+
+/**
+ * @file stepresponse.h
+ * @brief Offline helpers for tuning the gimbal controllers: a velocity-commanded
+ *        axis plant model and step-response metrics (rise time, overshoot, settling).
+ */
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @struct AxisPlantModel
+ * @brief Velocity-commanded servo axis: transport delay followed by a first-order lag.
+ *
+ * Models the command path GimbalController -> Modbus -> drive, where the drive
+ * tracks the commanded speed with time constant @c tau.
+ */
+struct AxisPlantModel {
+    static constexpr int MAX_DELAY_STEPS = 32;
+
+    double tau        = 0.08;  ///< Drive velocity loop time constant (s).
+    double maxRate    = 48.0;  ///< Axis rate limit (deg/s).
+    int    delaySteps = 1;     ///< Command transport delay in control periods.
+
+    double position = 0.0;     ///< Axis angle (deg).
+    double velocity = 0.0;     ///< Axis rate (deg/s).
+
+    void reset(double initialPosition = 0.0)
+    {
+        position = initialPosition;
+        velocity = 0.0;
+        m_delayLine.fill(0.0);
+        m_head = 0;
+    }
+
+    /**
+     * @brief Advances the model by one control period.
+     * @param commandRate Commanded axis rate (deg/s).
+     * @param dt Control period (s).
+     */
+    void step(double commandRate, double dt)
+    {
+        const int delay = std::clamp(delaySteps, 0, MAX_DELAY_STEPS - 1);
+        m_delayLine[m_head] = commandRate;
+        const double applied = m_delayLine[(m_head + MAX_DELAY_STEPS - delay) % MAX_DELAY_STEPS];
+        m_head = (m_head + 1) % MAX_DELAY_STEPS;
+
+        const double target = std::clamp(applied, -maxRate, maxRate);
+        velocity += (target - velocity) * (dt / (tau + dt));
+        position += velocity * dt;
+    }
+
+private:
+    std::array<double, MAX_DELAY_STEPS> m_delayLine {};
+    int m_head = 0;
+};
+
+/**
+ * @struct StepResponseMetrics
+ * @brief Classic step-response figures of merit.
+ */
+struct StepResponseMetrics {
+    double riseTime         = -1.0; ///< 10% -> 90% time (s), -1 if never reached.
+    double overshootPercent = 0.0;  ///< Peak overshoot relative to the step size.
+    double settlingTime     = -1.0; ///< Time after which the output stays in band (s), -1 if never.
+    double steadyStateError = 0.0;  ///< |target - final sample|.
+};
+
+/**
+ * @brief Analyses a sampled response to a step from @p initial to @p target.
+ * @param samples Output samples at a fixed period.
+ * @param count Number of samples.
+ * @param dt Sample period (s).
+ * @param initial Output value before the step.
+ * @param target Step target value.
+ * @param settleBand Settling band as a fraction of the step size (default 2%).
+ */
+inline StepResponseMetrics analyzeStepResponse(const double *samples, int count, double dt,
+                                               double initial, double target,
+                                               double settleBand = 0.02)
+{
+    StepResponseMetrics m;
+    const double stepSize = target - initial;
+    if (!samples || count <= 0 || stepSize == 0.0)
+        return m;
+
+    const double dir = stepSize > 0.0 ? 1.0 : -1.0;
+    const double magnitude = std::fabs(stepSize);
+    const double band = settleBand * magnitude;
+
+    double t10 = -1.0;
+    double t90 = -1.0;
+    double peak = 0.0;
+    int lastOutside = -1;
+
+    for (int i = 0; i < count; ++i) {
+        const double progress = (samples[i] - initial) * dir;
+        if (t10 < 0.0 && progress >= 0.1 * magnitude)
+            t10 = i * dt;
+        if (t90 < 0.0 && progress >= 0.9 * magnitude)
+            t90 = i * dt;
+        peak = std::max(peak, progress);
+        if (std::fabs(samples[i] - target) > band)
+            lastOutside = i;
+    }
+
+    if (t10 >= 0.0 && t90 >= 0.0)
+        m.riseTime = t90 - t10;
+    m.overshootPercent = std::max(0.0, (peak - magnitude) / magnitude * 100.0);
+    if (lastOutside < count - 1)
+        m.settlingTime = (lastOutside + 1) * dt;
+    m.steadyStateError = std::fabs(target - samples[count - 1]);
+    return m;
+}
+
+#endif // STEPRESPONSE_H
@@ -0,0 +1,213 @@
+#include "targetfeatures.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr int GRID = TARGET_FEATURE_GRID;
+constexpr int CELL = TARGET_FEATURE_GRID / TARGET_FEATURE_CELLS;
+
+static_assert(GRID % simd::LANES == 0, "grid rows must be whole SIMD vectors");
+static_assert(GRID % TARGET_FEATURE_CELLS == 0, "cells must tile the grid");
+static_assert(TARGET_FEATURE_GRADIENT_SIZE % simd::LANES == 0, "histogram must be whole SIMD vectors");
+
+// Orientation binning without atan2: after folding the gradient into the upper
+// half plane, the bin is the number of boundaries k * 22.5 deg it lies beyond,
+// i.e. the count of cross(boundary_k, g) < 0 for k = 1..7.
+struct OrientationBoundaries {
+    float cosine[TARGET_FEATURE_ORIENTATIONS - 1];
+    float sine[TARGET_FEATURE_ORIENTATIONS - 1];
+    OrientationBoundaries()
+    {
+        for (int k = 1; k < TARGET_FEATURE_ORIENTATIONS; ++k) {
+            const double phi = k * M_PI / TARGET_FEATURE_ORIENTATIONS;
+            cosine[k - 1] = static_cast<float>(std::cos(phi));
+            sine[k - 1]   = static_cast<float>(std::sin(phi));
+        }
+    }
+};
+const OrientationBoundaries BOUNDARIES;
+
+// Skewness and kurtosis are unbounded; keep them from dominating distances
+constexpr float MOMENT_CLAMP = 10.0f;
+}
+
+float targetFeatureSimilarity(const TargetFeatures &a, const TargetFeatures &b)
+{
+    float intersection = 0.0f;
+    for (int i = TARGET_FEATURE_COLOR_OFFSET; i < TARGET_FEATURE_GRADIENT_OFFSET; ++i)
+        intersection += std::min(a[i], b[i]);
+
+    float dot = 0.0f;
+    for (int i = TARGET_FEATURE_GRADIENT_OFFSET; i < TARGET_FEATURE_MOMENT_OFFSET; ++i)
+        dot += a[i] * b[i];
+
+    // Mean and std are in 0..1; higher moments are scaled down to a similar range
+    const float *ma = a.data() + TARGET_FEATURE_MOMENT_OFFSET;
+    const float *mb = b.data() + TARGET_FEATURE_MOMENT_OFFSET;
+    const float distance = std::abs(ma[0] - mb[0]) + std::abs(ma[1] - mb[1])
+                         + 0.1f * (std::abs(ma[2] - mb[2]) + std::abs(ma[3] - mb[3])) / 2.0f;
+    const float closeness = std::max(0.0f, 1.0f - distance);
+
+    return (intersection + std::max(dot, 0.0f) + closeness) / 3.0f;
+}
+
+bool TargetFeatureExtractor::extract(const RgbaImageView &image, int x, int y, int w, int h, TargetFeatures &out)
+{
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, image.width);
+    const int y1 = std::min(y + h, image.height);
+    if (!image.data || x1 <= x0 || y1 <= y0)
+        return false;
+
+    out.fill(0.0f);
+    gather(image, x0, y0, x1 - x0, y1 - y0, out.data() + TARGET_FEATURE_COLOR_OFFSET);
+    gradientHistogram(out.data() + TARGET_FEATURE_GRADIENT_OFFSET);
+    moments(out.data() + TARGET_FEATURE_MOMENT_OFFSET);
+    return true;
+}
+
+void TargetFeatureExtractor::gather(const RgbaImageView &image, int x, int y, int w, int h, float *colorHist)
+{
+    // Nearest-neighbour resampling at cell centres; small boxes repeat pixels
+    for (int c = 0; c < GRID; ++c)
+        m_columnOffset[c] = x + (2 * c + 1) * w / (2 * GRID);
+
+    std::fill(std::begin(m_colorCounts), std::end(m_colorCounts), 0);
+    for (int r = 0; r < GRID; ++r) {
+        const uint8_t *row = image.data + static_cast<size_t>(y + (2 * r + 1) * h / (2 * GRID)) * image.stride;
+        uint32_t *pixels = m_pixels + r * GRID;
+        for (int c = 0; c < GRID; ++c) {
+            const uint8_t *px = row + m_columnOffset[c] * 4;
+            std::memcpy(&pixels[c], px, sizeof(uint32_t));
+            const int bin = ((px[0] >> 6) << 4) | ((px[1] >> 6) << 2) | (px[2] >> 6);
+            ++m_colorCounts[(c % PARTIALS) * TARGET_FEATURE_COLOR_BINS + bin];
+        }
+    }
+
+    const float inv = 1.0f / PIXELS;
+    for (int i = 0; i < TARGET_FEATURE_COLOR_BINS; ++i) {
+        int count = 0;
+        for (int p = 0; p < PARTIALS; ++p)
+            count += m_colorCounts[p * TARGET_FEATURE_COLOR_BINS + i];
+        colorHist[i] = count * inv;
+    }
+
+    // Rec. 601 luma, written both flat (moments) and padded (gradients).
+    // RGBA8888 in memory is R in the low byte of a little-endian word.
+    const simd::f32x4 kr = simd::set1(0.299f);
+    const simd::f32x4 kg = simd::set1(0.587f);
+    const simd::f32x4 kb = simd::set1(0.114f);
+    for (int r = 0; r < GRID; ++r) {
+        float *padded = m_padded + (r + 1) * PADDED + 1;
+        for (int c = 0; c < GRID; c += simd::LANES) {
+            const int i = r * GRID + c;
+            const simd::f32x4 luma = simd::mulAdd(simd::unpackByte(m_pixels + i, 0), kr,
+                                     simd::mulAdd(simd::unpackByte(m_pixels + i, 1), kg,
+                                                  simd::mul(simd::unpackByte(m_pixels + i, 2), kb)));
+            simd::store(m_luma + i, luma);
+            simd::store(padded + c, luma);
+        }
+        padded[-1]   = padded[0];
+        padded[GRID] = padded[GRID - 1];
+    }
+    std::copy(m_padded + PADDED, m_padded + 2 * PADDED, m_padded);
+    std::copy(m_padded + GRID * PADDED, m_padded + (GRID + 1) * PADDED, m_padded + (GRID + 1) * PADDED);
+}
+
+void TargetFeatureExtractor::gradientHistogram(float *out)
+{
+    const simd::f32x4 zero = simd::set1(0.0f);
+    const simd::f32x4 one  = simd::set1(1.0f);
+    const simd::f32x4 two  = simd::set1(2.0f);
+    simd::f32x4 cosine[TARGET_FEATURE_ORIENTATIONS - 1];
+    simd::f32x4 sine[TARGET_FEATURE_ORIENTATIONS - 1];
+    for (int k = 0; k < TARGET_FEATURE_ORIENTATIONS - 1; ++k) {
+        cosine[k] = simd::set1(BOUNDARIES.cosine[k]);
+        sine[k]   = simd::set1(BOUNDARIES.sine[k]);
+    }
+
+    // Accumulator index of each column without the bin: partial copy + cell column
+    alignas(16) float columnBase[GRID];
+    for (int c = 0; c < GRID; ++c)
+        columnBase[c] = static_cast<float>((c % PARTIALS) * TARGET_FEATURE_GRADIENT_SIZE +
+                                           (c / CELL) * TARGET_FEATURE_ORIENTATIONS);
+
+    std::fill(std::begin(m_cellAccumulator), std::end(m_cellAccumulator), 0.0f);
+    for (int r = 0; r < GRID; ++r) {
+        const float *center = m_padded + (r + 1) * PADDED + 1;
+        const float *up     = center - PADDED;
+        const float *down   = center + PADDED;
+
+        for (int c = 0; c < GRID; c += simd::LANES) {
+            simd::f32x4 gx = simd::sub(simd::load(center + c + 1), simd::load(center + c - 1));
+            simd::f32x4 gy = simd::sub(simd::load(down + c), simd::load(up + c));
+            simd::store(m_magnitude + c, simd::sqrt(simd::mulAdd(gx, gx, simd::mul(gy, gy))));
+
+            // Unsigned orientation: reflect gradients with gy < 0 through the origin
+            const simd::f32x4 sign = simd::sub(one, simd::mul(two, simd::greaterThan(zero, gy)));
+            gx = simd::mul(gx, sign);
+            gy = simd::mul(gy, sign);
+
+            simd::f32x4 index = simd::load(columnBase + c);
+            for (int k = 0; k < TARGET_FEATURE_ORIENTATIONS - 1; ++k)
+                index = simd::add(index, simd::greaterThan(simd::mul(cosine[k], gy), simd::mul(sine[k], gx)));
+            simd::storeInt(m_index + c, index);
+        }
+
+        float *cellRow = m_cellAccumulator + (r / CELL) * TARGET_FEATURE_CELLS * TARGET_FEATURE_ORIENTATIONS;
+        for (int c = 0; c < GRID; ++c)
+            cellRow[m_index[c]] += m_magnitude[c];
+    }
+
+    simd::f32x4 sum = zero;
+    for (int i = 0; i < TARGET_FEATURE_GRADIENT_SIZE; i += simd::LANES) {
+        const float *acc = m_cellAccumulator + i;
+        simd::f32x4 v = simd::load(acc);
+        for (int p = 1; p < PARTIALS; ++p)
+            v = simd::add(v, simd::load(acc + p * TARGET_FEATURE_GRADIENT_SIZE));
+        simd::store(out + i, v);
+        sum = simd::mulAdd(v, v, sum);
+    }
+    const float norm = simd::horizontalSum(sum);
+    if (norm <= 1e-12f)
+        return;
+
+    const simd::f32x4 inv = simd::set1(1.0f / std::sqrt(norm));
+    for (int i = 0; i < TARGET_FEATURE_GRADIENT_SIZE; i += simd::LANES)
+        simd::store(out + i, simd::mul(simd::load(out + i), inv));
+}
+
+void TargetFeatureExtractor::moments(float *out)
+{
+    simd::f32x4 sum = simd::set1(0.0f);
+    for (int i = 0; i < PIXELS; i += simd::LANES)
+        sum = simd::add(sum, simd::load(m_luma + i));
+    const float mean = simd::horizontalSum(sum) / PIXELS;
+
+    // Central moments in a second pass for accuracy on flat patches
+    const simd::f32x4 meanV = simd::set1(mean);
+    simd::f32x4 m2 = simd::set1(0.0f);
+    simd::f32x4 m3 = simd::set1(0.0f);
+    simd::f32x4 m4 = simd::set1(0.0f);
+    for (int i = 0; i < PIXELS; i += simd::LANES) {
+        const simd::f32x4 d  = simd::sub(simd::load(m_luma + i), meanV);
+        const simd::f32x4 d2 = simd::mul(d, d);
+        m2 = simd::add(m2, d2);
+        m3 = simd::mulAdd(d2, d, m3);
+        m4 = simd::mulAdd(d2, d2, m4);
+    }
+    const float variance = simd::horizontalSum(m2) / PIXELS;
+    const float stddev = std::sqrt(variance);
+
+    out[0] = mean / 255.0f;
+    out[1] = stddev / 255.0f;
+    if (variance > 1e-6f) {
+        const float skewness = simd::horizontalSum(m3) / PIXELS / (variance * stddev);
+        const float kurtosis = simd::horizontalSum(m4) / PIXELS / (variance * variance) - 3.0f;
+        out[2] = std::clamp(skewness, -MOMENT_CLAMP, MOMENT_CLAMP);
+        out[3] = std::clamp(kurtosis, -MOMENT_CLAMP, MOMENT_CLAMP);
+    }
+}
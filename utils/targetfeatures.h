@@ -0,0 +1,89 @@
+#ifndef TARGETFEATURES_H
+#define TARGETFEATURES_H
+
+/**
+ * @file targetfeatures.h
+ * @brief Fixed-size appearance descriptor of a tracked target, computed directly
+ *        from an RGBA frame buffer.
+ *
+ * The box is resampled onto a fixed grid so the cost per frame does not depend
+ * on the target size. The descriptor concatenates:
+ *   - a 4x4x4 RGB colour histogram (sums to 1),
+ *   - a 4x4-cell, 8-bin unsigned gradient orientation histogram (L2-normalised),
+ *   - intensity moments: mean, standard deviation, skewness, excess kurtosis.
+ */
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @struct RgbaImageView
+ * @brief Non-owning view of an 8-bit RGBA (Format_RGBA8888) image.
+ */
+struct RgbaImageView {
+    const uint8_t *data = nullptr;
+    int width  = 0;
+    int height = 0;
+    int stride = 0; ///< Bytes per row.
+};
+
+constexpr int TARGET_FEATURE_GRID         = 32; ///< Resampling grid side, pixels.
+constexpr int TARGET_FEATURE_COLOR_BINS   = 64; ///< 4 levels per channel.
+constexpr int TARGET_FEATURE_CELLS        = 4;  ///< Gradient cells per side.
+constexpr int TARGET_FEATURE_ORIENTATIONS = 8;  ///< Unsigned orientation bins over 0..180 deg.
+constexpr int TARGET_FEATURE_GRADIENT_SIZE = TARGET_FEATURE_CELLS * TARGET_FEATURE_CELLS * TARGET_FEATURE_ORIENTATIONS;
+constexpr int TARGET_FEATURE_MOMENTS      = 4;
+
+constexpr int TARGET_FEATURE_COLOR_OFFSET    = 0;
+constexpr int TARGET_FEATURE_GRADIENT_OFFSET = TARGET_FEATURE_COLOR_OFFSET + TARGET_FEATURE_COLOR_BINS;
+constexpr int TARGET_FEATURE_MOMENT_OFFSET   = TARGET_FEATURE_GRADIENT_OFFSET + TARGET_FEATURE_GRADIENT_SIZE;
+constexpr int TARGET_FEATURE_SIZE            = TARGET_FEATURE_MOMENT_OFFSET + TARGET_FEATURE_MOMENTS;
+
+using TargetFeatures = std::array<float, TARGET_FEATURE_SIZE>;
+
+/**
+ * @brief Similarity of two descriptors in 0..1: the mean of the colour histogram
+ *        intersection, the gradient cosine and a moment closeness term.
+ */
+float targetFeatureSimilarity(const TargetFeatures &a, const TargetFeatures &b);
+
+/**
+ * @class TargetFeatureExtractor
+ * @brief Computes TargetFeatures with SSE2/NEON arithmetic (see simd.h).
+ *
+ * All working buffers are members, so extract() does not allocate. One
+ * instance per thread.
+ */
+class TargetFeatureExtractor
+{
+public:
+    /**
+     * @brief Describes the box (x, y, w, h) of @p image into @p out.
+     *        The box is clipped to the image.
+     * @return False if the clipped box is empty.
+     */
+    bool extract(const RgbaImageView &image, int x, int y, int w, int h, TargetFeatures &out);
+
+private:
+    // Luma with a one-pixel replicated border for central differences
+    static constexpr int PADDED = TARGET_FEATURE_GRID + 2;
+    static constexpr int PIXELS = TARGET_FEATURE_GRID * TARGET_FEATURE_GRID;
+    static constexpr int PARTIALS = 4;
+
+    void gather(const RgbaImageView &image, int x, int y, int w, int h, float *colorHist);
+    void gradientHistogram(float *out);
+    void moments(float *out);
+
+    alignas(16) uint32_t m_pixels[PIXELS];
+    alignas(16) float m_luma[PIXELS];
+    alignas(16) float m_padded[PADDED * PADDED];
+    alignas(16) float m_magnitude[TARGET_FEATURE_GRID];
+    alignas(16) int32_t m_index[TARGET_FEATURE_GRID];
+    // Partial histograms interleaved by column, so runs of pixels that fall in
+    // the same bin do not serialise on a single accumulator
+    alignas(16) float m_cellAccumulator[PARTIALS * TARGET_FEATURE_GRADIENT_SIZE];
+    int m_colorCounts[PARTIALS * TARGET_FEATURE_COLOR_BINS];
+    int m_columnOffset[TARGET_FEATURE_GRID];
+};
+
+#endif // TARGETFEATURES_H
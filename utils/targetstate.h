@@ -3,8 +3,6 @@
 #include <QVector3D>
 #include <QRect>
 #include <chrono>
-#include <vector>
-#include <QImage>
 
 struct TargetState {
     QRect bbox;                  // 2D bounding box in image
@@ -13,9 +11,8 @@ struct TargetState {
     double confidence;           // Tracking confidence score
     std::chrono::system_clock::time_point timestamp;
 
-    // Target appearance descriptors for re-identification
-    std::vector<float> visualFeatures;    // Visual features for matching
-    QImage targetPatch;                   // Visual appearance
+    // The appearance descriptor used for re-identification is kept with the
+    // re-acquisition template (ReacquisitionEngine)
 
     TargetState() :
         bbox(0, 0, 100, 100),
@@ -0,0 +1,244 @@
+#include "trace.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+thread_local TraceBuffer *t_buffer = nullptr;
+thread_local bool t_bufferRefused = false;
+
+void appendEscaped(QByteArray &out, const QByteArray &text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+}
+
+void appendMicros(QByteArray &out, qint64 ns)
+{
+    // Microseconds with nanosecond resolution, as the format expects
+    out += QByteArray::number(ns / 1000);
+    out += '.';
+    out += QByteArray::number(ns % 1000).rightJustified(3, '0');
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// TraceBuffer
+// ---------------------------------------------------------------------------
+
+void TraceBuffer::snapshot(std::vector<TraceEvent> &out) const
+{
+    const quint64 end = m_head.load(std::memory_order_acquire);
+    const quint64 begin = end > CAPACITY ? end - CAPACITY : 0;
+    const size_t first = out.size();
+    for (quint64 i = begin; i < end; ++i)
+        out.push_back(m_events[i & (CAPACITY - 1)]);
+
+    // Drop the events the writer may have overwritten while they were copied
+    const quint64 after = m_head.load(std::memory_order_acquire);
+    if (after >= begin + CAPACITY) {
+        const quint64 stale = std::min<quint64>(after - CAPACITY + 1 - begin, end - begin);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                  out.begin() + static_cast<std::ptrdiff_t>(first + stale));
+    }
+}
+
+QString TraceBuffer::threadName() const
+{
+    QMutexLocker locker(&m_nameMutex);
+    return m_threadName;
+}
+
+void TraceBuffer::setThreadName(const QString &name)
+{
+    QMutexLocker locker(&m_nameMutex);
+    m_threadName = name;
+}
+
+// ---------------------------------------------------------------------------
+// Tracer
+// ---------------------------------------------------------------------------
+
+Tracer::Tracer()
+{
+    if (qEnvironmentVariable("EL7ARESS_TRACE") == QLatin1String("0"))
+        m_enabled.store(false, std::memory_order_relaxed);
+}
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+qint64 Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceBuffer *Tracer::threadBuffer()
+{
+    if (t_buffer || t_bufferRefused)
+        return t_buffer;
+
+    // First event of this thread: register a ring named after the thread
+    const quint32 tid = static_cast<quint32>(::syscall(SYS_gettid));
+    QString name;
+    if (QThread *thread = QThread::currentThread()) {
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            name = QStringLiteral("main");
+        else
+            name = thread->objectName();
+    }
+    if (name.isEmpty()) {
+        char osName[32] = {};
+        if (pthread_getname_np(pthread_self(), osName, sizeof(osName)) == 0 && osName[0])
+            name = QString::fromLocal8Bit(osName);
+        else
+            name = QStringLiteral("thread-%1").arg(tid);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (static_cast<int>(m_buffers.size()) >= MAX_THREADS) {
+        t_bufferRefused = true;
+        qWarning() << "Tracer: more than" << MAX_THREADS << "threads, not tracing" << name;
+        return nullptr;
+    }
+    m_buffers.push_back(std::make_unique<TraceBuffer>(tid, name));
+    t_buffer = m_buffers.back().get();
+    return t_buffer;
+}
+
+void Tracer::setThreadName(const QString &name)
+{
+    if (TraceBuffer *buffer = threadBuffer())
+        buffer->setThreadName(name);
+}
+
+void Tracer::push(const TraceEvent &event)
+{
+    if (TraceBuffer *buffer = threadBuffer())
+        buffer->push(event);
+}
+
+void Tracer::complete(const char *category, const char *name, qint64 startNs, qint64 durationNs)
+{
+    push({category, name, startNs, durationNs, 0, TracePhase::Complete});
+}
+
+void Tracer::instant(const char *category, const char *name)
+{
+    push({category, name, nowNs(), 0, 0, TracePhase::Instant});
+}
+
+void Tracer::counter(const char *category, const char *name, qint64 value)
+{
+    push({category, name, nowNs(), 0, value, TracePhase::Counter});
+}
+
+void Tracer::asyncBegin(const char *category, const char *name, quintptr id)
+{
+    push({category, name, nowNs(), 0, static_cast<qint64>(id), TracePhase::AsyncBegin});
+}
+
+void Tracer::asyncEnd(const char *category, const char *name, quintptr id)
+{
+    push({category, name, nowNs(), 0, static_cast<qint64>(id), TracePhase::AsyncEnd});
+}
+
+quint64 Tracer::eventCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 total = 0;
+    for (const auto &buffer : m_buffers)
+        total += buffer->written();
+    return total;
+}
+
+QByteArray Tracer::chromeJson() const
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QMutexLocker locker(&m_mutex);
+    bool first = true;
+    auto separator = [&]() {
+        if (!first)
+            out += ",\n";
+        first = false;
+    };
+
+    std::vector<TraceEvent> events;
+    events.reserve(TraceBuffer::CAPACITY);
+    for (const auto &buffer : m_buffers) {
+        const QByteArray tid = QByteArray::number(buffer->threadId());
+
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->threadName().toUtf8());
+        out += "\"}}";
+
+        events.clear();
+        buffer->snapshot(events);
+        for (const TraceEvent &e : events) {
+            separator();
+            out += "{\"name\":\"";
+            appendEscaped(out, e.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, e.category);
+            out += "\",\"ph\":\"";
+            out += static_cast<char>(e.phase);
+            out += "\",\"ts\":";
+            appendMicros(out, e.timestampNs);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            switch (e.phase) {
+            case TracePhase::Complete:
+                out += ",\"dur\":";
+                appendMicros(out, e.durationNs);
+                break;
+            case TracePhase::Instant:
+                out += ",\"s\":\"t\"";
+                break;
+            case TracePhase::Counter:
+                out += ",\"args\":{\"value\":" + QByteArray::number(e.value) + "}";
+                break;
+            case TracePhase::AsyncBegin:
+            case TracePhase::AsyncEnd:
+                out += ",\"id\":\"0x" + QByteArray::number(static_cast<quint64>(e.value), 16) + "\"";
+                break;
+            }
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::writeChromeJson(const QString &path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Tracer: cannot write" << path;
+        return false;
+    }
+    file.write(chromeJson());
+    qDebug() << "Tracer: trace written to" << path;
+    return true;
+}
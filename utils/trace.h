@@ -0,0 +1,176 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file trace.h
+ * @brief Always-on, low-overhead tracing with Chrome/Perfetto JSON export.
+ *
+ * Every thread that records gets its own ring buffer, written by that thread
+ * only (one relaxed load, a copy and one release store per event), so tracing
+ * never takes a lock on the hot path. The rings keep the most recent events;
+ * Tracer::writeChromeJson() snapshots all of them into a file that
+ * chrome://tracing and ui.perfetto.dev open directly.
+ *
+ * @code
+ * void GimbalController::update()
+ * {
+ *     TRACE_SCOPE("control", "gimbal.update");
+ *     ...
+ * }
+ * @endcode
+ *
+ * Category and name arguments must be string literals (only the pointer is
+ * stored). Tracing can be switched off at run time (Tracer::setEnabled, or
+ * EL7ARESS_TRACE=0 in the environment), which leaves a single relaxed load
+ * per macro, or compiled out entirely with DEFINES += EL7ARESS_NO_TRACE.
+ */
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+enum class TracePhase : char {
+    Complete   = 'X', ///< Scope with a duration.
+    Instant    = 'i',
+    Counter    = 'C',
+    AsyncBegin = 'b', ///< Spans callbacks, e.g. a Modbus request until its reply.
+    AsyncEnd   = 'e'
+};
+
+struct TraceEvent {
+    const char *category;
+    const char *name;
+    qint64 timestampNs;
+    qint64 durationNs;  ///< Complete events.
+    qint64 value;       ///< Counter value or async id.
+    TracePhase phase;
+};
+
+/**
+ * @class TraceBuffer
+ * @brief Ring of the most recent events of one thread (single writer).
+ */
+class TraceBuffer
+{
+public:
+    static constexpr quint64 CAPACITY = 1 << 14;
+
+    explicit TraceBuffer(quint32 threadId, const QString &threadName)
+        : m_threadId(threadId), m_threadName(threadName) {}
+
+    void push(const TraceEvent &event)
+    {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        m_events[head & (CAPACITY - 1)] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /** @brief Appends the events still in the ring to @p out (any thread). */
+    void snapshot(std::vector<TraceEvent> &out) const;
+
+    quint32 threadId() const { return m_threadId; }
+    QString threadName() const;
+    void setThreadName(const QString &name);
+    quint64 written() const { return m_head.load(std::memory_order_relaxed); }
+
+private:
+    std::array<TraceEvent, CAPACITY> m_events;
+    std::atomic<quint64> m_head{0};
+    quint32 m_threadId;
+    QString m_threadName;
+    mutable QMutex m_nameMutex;
+};
+
+/**
+ * @class Tracer
+ * @brief Process-wide registry of the per-thread buffers.
+ */
+class Tracer
+{
+public:
+    static constexpr int MAX_THREADS = 64;
+
+    static Tracer &instance();
+    static qint64 nowNs();
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    /** @brief Names the calling thread in the trace (default: the OS thread name). */
+    void setThreadName(const QString &name);
+
+    void complete(const char *category, const char *name, qint64 startNs, qint64 durationNs);
+    void instant(const char *category, const char *name);
+    void counter(const char *category, const char *name, qint64 value);
+    void asyncBegin(const char *category, const char *name, quintptr id);
+    void asyncEnd(const char *category, const char *name, quintptr id);
+
+    /** @brief Trace Event Format JSON of every buffered event. */
+    QByteArray chromeJson() const;
+    bool writeChromeJson(const QString &path) const;
+
+    /** @brief Events recorded since start, all threads (for overhead accounting). */
+    quint64 eventCount() const;
+
+private:
+    Tracer();
+    TraceBuffer *threadBuffer();
+    void push(const TraceEvent &event);
+
+    std::atomic<bool> m_enabled{true};
+    mutable QMutex m_mutex; // guards m_buffers (registration and export)
+    std::vector<std::unique_ptr<TraceBuffer>> m_buffers;
+};
+
+/**
+ * @class ScopedTrace
+ * @brief Records a Complete event from construction to destruction.
+ */
+class ScopedTrace
+{
+public:
+    ScopedTrace(const char *category, const char *name)
+        : m_category(category), m_name(name),
+          m_startNs(Tracer::instance().isEnabled() ? Tracer::nowNs() : -1) {}
+    ~ScopedTrace()
+    {
+        if (m_startNs >= 0)
+            Tracer::instance().complete(m_category, m_name, m_startNs, Tracer::nowNs() - m_startNs);
+    }
+    ScopedTrace(const ScopedTrace &) = delete;
+    ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_startNs;
+};
+
+#define EL7ARESS_TRACE_CONCAT_(a, b) a##b
+#define EL7ARESS_TRACE_CONCAT(a, b) EL7ARESS_TRACE_CONCAT_(a, b)
+
+#ifndef EL7ARESS_NO_TRACE
+#define TRACE_SCOPE(category, name) \
+    ScopedTrace EL7ARESS_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#define TRACE_INSTANT(category, name) \
+    do { if (Tracer::instance().isEnabled()) Tracer::instance().instant(category, name); } while (0)
+#define TRACE_COUNTER(category, name, value) \
+    do { if (Tracer::instance().isEnabled()) Tracer::instance().counter(category, name, value); } while (0)
+#define TRACE_ASYNC_BEGIN(category, name, id) \
+    do { if (Tracer::instance().isEnabled()) Tracer::instance().asyncBegin(category, name, reinterpret_cast<quintptr>(id)); } while (0)
+#define TRACE_ASYNC_END(category, name, id) \
+    do { if (Tracer::instance().isEnabled()) Tracer::instance().asyncEnd(category, name, reinterpret_cast<quintptr>(id)); } while (0)
+#else
+#define TRACE_SCOPE(category, name) do {} while (0)
+#define TRACE_INSTANT(category, name) do {} while (0)
+#define TRACE_COUNTER(category, name, value) do {} while (0)
+#define TRACE_ASYNC_BEGIN(category, name, id) do {} while (0)
+#define TRACE_ASYNC_END(category, name, id) do {} while (0)
+#endif
+
+#endif // TRACE_H